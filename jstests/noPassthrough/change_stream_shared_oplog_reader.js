@@ -0,0 +1,112 @@
+/**
+ * Test that change streams receiving their events from the shared oplog reader see the same events
+ * as change streams that scan the oplog themselves, and that a change stream which falls too far
+ * behind the shared reader, in events or in bytes, fails with a resumable error and can resume.
+ * @tags: [requires_replication, requires_majority_read_concern, uses_change_streams]
+ */
+(function() {
+"use strict";
+
+const rst = new ReplSetTest({
+    nodes: 1,
+    nodeOptions: {
+        setParameter: {
+            internalChangeStreamUseSharedOplogReader: true,
+            internalChangeStreamSharedOplogReaderMaxBufferedEvents: 10,
+        }
+    }
+});
+rst.startSet();
+rst.initiate();
+
+const testDB = rst.getPrimary().getDB(jsTestName());
+const collNames = ["a", "b", "c"];
+collNames.forEach(collName => assert.commandWorked(testDB.createCollection(collName)));
+
+// Open one change stream per collection and one on the whole database.
+const collStreams = collNames.map(collName => testDB[collName].watch());
+const dbStream = testDB.watch();
+
+// Write to each collection, and confirm that each change stream sees only its own events.
+collNames.forEach((collName, i) => {
+    assert.commandWorked(testDB[collName].insert({_id: i}));
+});
+collNames.forEach((collName, i) => {
+    assert.soon(() => collStreams[i].hasNext());
+    const event = collStreams[i].next();
+    assert.eq(event.operationType, "insert", event);
+    assert.eq(event.ns.coll, collName, event);
+    assert.eq(event.documentKey._id, i, event);
+});
+collNames.forEach((collName, i) => {
+    assert.soon(() => dbStream.hasNext());
+    const event = dbStream.next();
+    assert.eq(event.ns.coll, collName, event);
+    assert.eq(event.documentKey._id, i, event);
+});
+
+// Let the change stream on 'a' fall behind while the others keep consuming.
+const kNumDocs = 30;
+let resumeToken = collStreams[0].getResumeToken();
+for (let i = 0; i < kNumDocs; ++i) {
+    assert.commandWorked(testDB.a.insert({_id: "late" + i}));
+    assert.commandWorked(testDB.b.insert({_id: "late" + i}));
+    assert.soon(() => collStreams[1].hasNext());
+    assert.eq(collStreams[1].next().documentKey._id, "late" + i);
+}
+
+// The change stream on 'a' receives the events buffered for it, then fails with a resumable error.
+let numSeen = 0;
+const err = assert.throws(() => {
+    while (true) {
+        assert.soon(() => collStreams[0].hasNext());
+        const event = collStreams[0].next();
+        assert.eq(event.documentKey._id, "late" + numSeen, event);
+        resumeToken = event._id;
+        ++numSeen;
+    }
+});
+assert.commandFailedWithCode(err, ErrorCodes.RetryChangeStream);
+assert.contains("ResumableChangeStreamError", err.errorLabels, err);
+assert.gt(numSeen, 0);
+assert.lt(numSeen, kNumDocs);
+
+// Resuming scans the oplog from the resume token and sees the remaining events.
+const resumed = testDB.a.watch([], {resumeAfter: resumeToken});
+for (let i = numSeen; i < kNumDocs; ++i) {
+    assert.soon(() => resumed.hasNext());
+    assert.eq(resumed.next().documentKey._id, "late" + i);
+}
+
+// A change stream also falls too far behind once the events buffered for it exceed the byte limit,
+// even though they are fewer than the event limit.
+assert.commandWorked(testDB.adminCommand({
+    setParameter: 1,
+    internalChangeStreamSharedOplogReaderMaxBufferedEvents: 1000,
+    internalChangeStreamSharedOplogReaderMaxBufferedBytes: 16 * 1024,
+}));
+const padding = "x".repeat(4 * 1024);
+for (let i = 0; i < kNumDocs; ++i) {
+    assert.commandWorked(testDB.c.insert({_id: "large" + i, padding: padding}));
+    assert.commandWorked(testDB.b.insert({_id: "large" + i}));
+    assert.soon(() => collStreams[1].hasNext());
+    assert.eq(collStreams[1].next().documentKey._id, "large" + i);
+}
+numSeen = 0;
+const bytesErr = assert.throws(() => {
+    while (true) {
+        assert.soon(() => collStreams[2].hasNext());
+        assert.eq(collStreams[2].next().documentKey._id, "large" + numSeen);
+        ++numSeen;
+    }
+});
+assert.commandFailedWithCode(bytesErr, ErrorCodes.RetryChangeStream);
+assert.contains("ResumableChangeStreamError", bytesErr.errorLabels, bytesErr);
+assert.gt(numSeen, 0);
+assert.lte(numSeen, 4);
+
+resumed.close();
+collStreams.slice(1).forEach(stream => stream.close());
+dbStream.close();
+rst.stopSet();
+})();
@@ -0,0 +1,119 @@
+/**
+ * Tests that $queryShapeStats reports the cost of a query by its shape, including the getMores of
+ * its cursor, that clearing the statistics requires the 'clearQueryShapeStats' action, and that
+ * mongos forwards the stage to a shard with its options.
+ *
+ * @tags: [requires_sharding, requires_wiredtiger]
+ */
+(function() {
+"use strict";
+
+const conn = MongoRunner.runMongod({auth: "", setParameter: {collectQueryShapeStats: true}});
+const admin = conn.getDB("admin");
+admin.createUser({user: "admin", pwd: "pwd", roles: ["root"]});
+assert(admin.auth("admin", "pwd"));
+admin.createUser({user: "monitor", pwd: "pwd", roles: ["clusterMonitor"]});
+
+const db = conn.getDB("test");
+const coll = db.query_shape_stats;
+
+const numDocs = 10;
+const padding = "x".repeat(1000);
+const docs = [];
+for (let i = 0; i < numDocs; i++) {
+    docs.push({_id: i, a: i, padding: padding});
+}
+assert.commandWorked(coll.insert(docs));
+assert.commandWorked(coll.createIndex({a: 1}));
+
+const query = {
+    a: {$gte: 0}
+};
+const queryHash = coll.explain().find(query).finish().queryPlanner.queryHash;
+assert(queryHash, "no queryHash in explain output");
+
+const shapeStats = (adminDB, clearStats) => {
+    const spec = clearStats ? {clearStats: true} : {};
+    return adminDB.aggregate([{$queryShapeStats: spec}]).toArray();
+};
+const queryStats = (stats) => stats.find((entry) => entry.ns == coll.getFullName() &&
+                                             entry.queryHash == queryHash);
+
+// Start from a clean slate, as the inserts and the explain above may have recorded costs.
+shapeStats(admin, true);
+
+// The find returns the first two documents, and the getMores the others.
+assert.eq(numDocs, coll.find(query).batchSize(2).itcount());
+let stats = queryStats(shapeStats(admin, false));
+assert(stats, "no statistics for the query: " + tojson(shapeStats(admin, false)));
+
+// The getMores add their costs to the query that opened the cursor, but are not executions of it.
+assert.eq(1, stats.execCount, tojson(stats));
+assert.eq(numDocs, stats.docsExamined, tojson(stats));
+assert.gte(stats.keysExamined, numDocs, tojson(stats));
+assert.gte(stats.cpuNanos, 0, tojson(stats));
+// Each document was read once, mostly by the getMores.
+assert.gte(stats.docBytesRead, numDocs * padding.length, tojson(stats));
+assert.lt(stats.docBytesRead, 2 * numDocs * Object.bsonsize(docs[0]), tojson(stats));
+
+// A second execution adds to the same entry.
+assert.eq(numDocs, coll.find(query).batchSize(2).itcount());
+stats = queryStats(shapeStats(admin, false));
+assert.eq(2, stats.execCount, tojson(stats));
+assert.eq(2 * numDocs, stats.docsExamined, tojson(stats));
+assert.gte(stats.docBytesRead, 2 * numDocs * padding.length, tojson(stats));
+
+// A user who may read the statistics may not clear them.
+const monitorConn = new Mongo(conn.host);
+const monitorAdmin = monitorConn.getDB("admin");
+assert(monitorAdmin.auth("monitor", "pwd"));
+assert.eq(2, queryStats(shapeStats(monitorAdmin, false)).execCount);
+assert.commandFailedWithCode(
+    monitorAdmin.runCommand(
+        {aggregate: 1, pipeline: [{$queryShapeStats: {clearStats: true}}], cursor: {}}),
+    ErrorCodes.Unauthorized);
+assert.eq(2, queryStats(shapeStats(admin, false)).execCount);
+
+// Clearing returns the statistics accumulated so far.
+assert.eq(2, queryStats(shapeStats(admin, true)).execCount);
+assert.eq(undefined, queryStats(shapeStats(admin, false)));
+
+MongoRunner.stopMongod(conn);
+
+// In a sharded cluster, mongos forwards the stage to a shard with its options.
+const st = new ShardingTest({
+    shards: 1,
+    mongos: 1,
+    other: {
+        mongosOptions: {setParameter: {collectQueryShapeStats: true}},
+        shardOptions: {setParameter: {collectQueryShapeStats: true}},
+    }
+});
+const mongosAdmin = st.s.getDB("admin");
+const mongosColl = st.s.getDB("test").query_shape_stats;
+assert.commandWorked(mongosColl.insert(docs));
+assert.commandWorked(mongosColl.createIndex({a: 1}));
+
+const shardedStats = (clearStats) =>
+    shapeStats(mongosAdmin, clearStats).filter((entry) => entry.ns == mongosColl.getFullName());
+
+shardedStats(true);
+assert.eq(numDocs, mongosColl.find(query).batchSize(2).itcount());
+assert.eq(1, shardedStats(false).length, tojson(shardedStats(false)));
+
+// Explaining the stage shows the shard the same stage, and does not clear the statistics.
+const explain = assert.commandWorked(mongosAdmin.runCommand(
+    {explain: {aggregate: 1, pipeline: [{$queryShapeStats: {clearStats: true}}], cursor: {}}}));
+const shardNames = Object.keys(explain.shards);
+assert.eq(1, shardNames.length, tojson(explain));
+assert.docEq({$queryShapeStats: {clearStats: true}},
+             explain.shards[shardNames[0]].stages[0],
+             tojson(explain));
+assert.eq(1, shardedStats(false).length);
+
+// Clearing through mongos clears the statistics on the shard.
+assert.eq(1, shardedStats(true).length);
+assert.eq(0, shardedStats(false).length);
+
+st.stop();
+})();
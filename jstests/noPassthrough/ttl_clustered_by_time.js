@@ -0,0 +1,81 @@
+/**
+ * Tests that the TTL monitor removes the expired documents of a collection clustered by time with
+ * range truncates, that the clustering field of its documents cannot be changed, and that the
+ * 'clusteredByTime' option requires featureCompatibilityVersion 4.9.
+ *
+ * @tags: [requires_wiredtiger]
+ */
+(function() {
+"use strict";
+
+const conn = MongoRunner.runMongod(
+    {setParameter: {ttlMonitorSleepSecs: 1, ttlMonitorTruncateBatchSize: 10}});
+const db = conn.getDB("test");
+const coll = db.ttl_clustered_by_time;
+
+assert.commandWorked(
+    db.createCollection(coll.getName(), {clusteredByTime: "t", expireAfterSeconds: 60}));
+assert.commandWorked(coll.createIndex({a: 1}));
+
+// Documents that expired an hour ago, one millisecond apart, and documents that have not expired.
+const numExpired = 50;
+const numLive = 5;
+const now = new Date().getTime();
+const docs = [];
+for (let i = 0; i < numExpired; i++) {
+    docs.push({_id: i, t: new Date(now - 3600 * 1000 - i), a: i});
+}
+for (let i = numExpired; i < numExpired + numLive; i++) {
+    docs.push({_id: i, t: new Date(now), a: i});
+}
+
+const ttlMetrics = () => db.serverStatus().metrics.ttl;
+const metricsBefore = ttlMetrics();
+assert.commandWorked(coll.insert(docs));
+
+assert.soon(() => coll.find().itcount() == numLive, "TTL monitor didn't truncate");
+const metricsAfter = ttlMetrics();
+assert.eq(numExpired, metricsAfter.deletedDocuments - metricsBefore.deletedDocuments);
+// Each truncate removes about ttlMonitorTruncateBatchSize documents.
+assert.gte(metricsAfter.truncatedRanges - metricsBefore.truncatedRanges,
+           numExpired / 10,
+           tojson(metricsAfter));
+
+// The truncates also removed the index keys of the documents.
+assert.eq(numLive, coll.find().hint({a: 1}).itcount());
+assert.eq(numLive, coll.find({_id: {$gte: 0}}).hint({_id: 1}).itcount());
+const validateRes = assert.commandWorked(coll.validate({full: true}));
+assert(validateRes.valid, tojson(validateRes));
+
+// The clustering field of a document cannot be changed, removed, or given another type, but the
+// other fields can be.
+const liveId = numExpired;
+assert.commandFailedWithCode(coll.update({_id: liveId}, {$set: {t: new Date(now + 1)}}),
+                             ErrorCodes.ImmutableField);
+assert.commandFailedWithCode(coll.update({_id: liveId}, {$unset: {t: 1}}),
+                             ErrorCodes.ImmutableField);
+assert.commandFailedWithCode(coll.update({_id: liveId}, {$set: {t: now}}),
+                             ErrorCodes.ImmutableField);
+assert.commandFailedWithCode(coll.update({_id: liveId}, {a: -1}), ErrorCodes.ImmutableField);
+assert.commandWorked(coll.update({_id: liveId}, {$set: {a: -1}}));
+assert.commandWorked(coll.update({_id: liveId}, {$set: {t: new Date(now)}}));
+assert.commandWorked(coll.update({_id: liveId}, {t: new Date(now), a: -2}));
+assert.eq({_id: liveId, t: new Date(now), a: -2}, coll.findOne({_id: liveId}));
+
+// Below FCV 4.9, the option is rejected, and the TTL monitor stops truncating, as nodes of the
+// older version do not understand the 'truncateRange' oplog entries.
+assert.commandWorked(db.adminCommand({setFeatureCompatibilityVersion: lastContinuousFCV}));
+assert.commandFailedWithCode(db.createCollection("clustered_downgraded", {clusteredByTime: "t"}),
+                             ErrorCodes.InvalidOptions);
+
+assert.commandWorked(coll.insert({_id: -1, t: new Date(now - 3600 * 1000)}));
+const ttlPasses = ttlMetrics().passes;
+assert.soon(() => ttlMetrics().passes >= ttlPasses + 2);
+assert.eq(1, coll.find({_id: -1}).itcount());
+
+assert.commandWorked(db.adminCommand({setFeatureCompatibilityVersion: latestFCV}));
+assert.soon(() => coll.find({_id: -1}).itcount() == 0, "TTL monitor didn't truncate after upgrade");
+assert.commandWorked(db.createCollection("clustered_upgraded", {clusteredByTime: "t"}));
+
+MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,89 @@
+/**
+ * Tests that the TTL monitor deletes the expired documents of different collections in parallel
+ * when 'ttlMonitorThreads' is greater than 1, and that the 'ttl' serverStatus section reports the
+ * deletions and the lag of each TTL index.
+ */
+(function() {
+"use strict";
+
+load("jstests/libs/fail_point_util.js");
+
+// Keep the TTL monitor from running until all collections are set up, so that its first pass
+// sees all of their TTL indexes.
+const conn = MongoRunner.runMongod(
+    {setParameter: {ttlMonitorSleepSecs: 1, ttlMonitorThreads: 4, ttlMonitorEnabled: false}});
+const db = conn.getDB("test");
+
+const numDocs = 20;
+const expiredFor = 3600 * 1000;
+const collNames = ["ttl_parallel_a", "ttl_parallel_b", "ttl_parallel_c"];
+
+const past = new Date(new Date().getTime() - expiredFor);
+for (let collName of collNames) {
+    const coll = db[collName];
+    const docs = [];
+    for (let i = 0; i < numDocs; i++) {
+        docs.push({_id: i, x: past});
+    }
+    assert.commandWorked(coll.insert(docs));
+    assert.commandWorked(coll.createIndex({x: 1}, {expireAfterSeconds: 0}));
+}
+// An index with nothing to delete.
+assert.commandWorked(db.ttl_parallel_none.insert({x: new Date()}));
+assert.commandWorked(db.ttl_parallel_none.createIndex({x: 1}, {expireAfterSeconds: 3600}));
+
+const fp = configureFailPoint(db, "hangTTLMonitorWithLock");
+assert.commandWorked(db.adminCommand({setParameter: 1, ttlMonitorEnabled: true}));
+
+// Two threads of the same pass hang in different collections at once. A serial pass would only
+// ever hang in one.
+assert.commandWorked(db.adminCommand({
+    waitForFailPoint: "hangTTLMonitorWithLock",
+    timesEntered: fp.timesEntered + 2,
+    maxTimeMS: kDefaultWaitForFailPointTimeout
+}));
+fp.off();
+
+for (let collName of collNames) {
+    assert.soon(() => db[collName].find().itcount() == 0, "TTL monitor didn't delete " + collName);
+}
+assert.eq(1, db.ttl_parallel_none.find().itcount());
+
+// The section is not included by default, as it grows with the number of TTL indexes.
+assert(!db.serverStatus().hasOwnProperty("ttl"));
+
+const indexStats = (collName) => {
+    const indexes = assert.commandWorked(db.serverStatus({ttl: 1})).ttl.indexes;
+    return indexes.find((index) => index.ns == "test." + collName && index.name == "x_1");
+};
+
+for (let collName of collNames) {
+    let stats;
+    assert.soon(() => {
+        stats = indexStats(collName);
+        return stats && stats.deletedDocuments == numDocs;
+    }, () => "Wrong TTL stats for " + collName + ": " + tojson(stats));
+
+    // The oldest document had been expired for at least an hour when the pass reached it.
+    assert.gte(stats.lagMillis, expiredFor, tojson(stats));
+    assert.gte(stats.lastPass.durationMillis, 0, tojson(stats));
+    assert(stats.lastPass.end instanceof Date, tojson(stats));
+}
+
+// Later passes find nothing expired, and report that the deletions are caught up.
+const ttlPasses = db.serverStatus().metrics.ttl.passes;
+assert.soon(() => db.serverStatus().metrics.ttl.passes >= ttlPasses + 2);
+for (let collName of collNames.concat(["ttl_parallel_none"])) {
+    const stats = indexStats(collName);
+    assert.eq(collName == "ttl_parallel_none" ? 0 : numDocs, stats.deletedDocuments, tojson(stats));
+    assert.eq(0, stats.lastPass.deletedDocuments, tojson(stats));
+    assert.eq(0, stats.lagMillis, tojson(stats));
+}
+
+// Dropping a TTL index drops its statistics.
+assert.commandWorked(db.ttl_parallel_a.dropIndex({x: 1}));
+assert.soon(() => db.serverStatus().metrics.ttl.passes >= ttlPasses + 4);
+assert.eq(undefined, indexStats("ttl_parallel_a"));
+
+MongoRunner.stopMongod(conn);
+})();
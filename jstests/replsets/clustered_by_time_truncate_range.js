@@ -0,0 +1,92 @@
+/**
+ * Tests that secondaries apply the 'truncateRange' oplog entries with which the TTL monitor
+ * removes the expired documents of a collection clustered by time, and that rollback restores the
+ * documents removed by a 'truncateRange' entry that is rolled back.
+ *
+ * @tags: [requires_wiredtiger]
+ */
+(function() {
+"use strict";
+
+load("jstests/replsets/libs/rollback_test.js");
+
+const dbName = "test";
+const collName = "clustered_by_time";
+
+// The TTL monitor only runs on the node and at the time that the test enables it.
+const rst = new ReplSetTest({
+    name: jsTestName(),
+    nodes: 3,
+    useBridge: true,
+    nodeOptions: {setParameter: {ttlMonitorSleepSecs: 1, ttlMonitorEnabled: false}}
+});
+rst.startSet();
+const config = rst.getReplSetConfig();
+config.members[2].priority = 0;
+config.settings = {chainingAllowed: false};
+rst.initiateWithHighElectionTimeout(config);
+
+const rollbackTest = new RollbackTest(jsTestName(), rst);
+
+const setTTLMonitorEnabled = (node, enabled) => {
+    assert.commandWorked(node.adminCommand({setParameter: 1, ttlMonitorEnabled: enabled}));
+};
+
+const insertExpired = (node, firstId, numDocs) => {
+    const past = new Date().getTime() - 3600 * 1000;
+    const docs = [];
+    for (let i = firstId; i < firstId + numDocs; i++) {
+        docs.push({_id: i, t: new Date(past - i), a: i});
+    }
+    assert.commandWorked(node.getDB(dbName)[collName].insert(docs, {writeConcern: {w: 2}}));
+};
+
+// Removes the expired documents on 'node' with the TTL monitor.
+const truncateExpired = (node) => {
+    const coll = node.getDB(dbName)[collName];
+    setTTLMonitorEnabled(node, true);
+    assert.soon(() => coll.find().itcount() == 0, "TTL monitor didn't truncate on " + node.host);
+    setTTLMonitorEnabled(node, false);
+};
+
+const numDocs = 20;
+let primary = rollbackTest.getPrimary();
+assert.commandWorked(primary.getDB(dbName).createCollection(
+    collName, {clusteredByTime: "t", expireAfterSeconds: 0, writeConcern: {w: 2}}));
+// The tiebreaker does not replicate until the rollback, so it cannot vote to commit the index.
+assert.commandWorked(
+    primary.getDB(dbName)[collName].createIndex({a: 1}, {}, 2 /* commitQuorum */));
+
+// The secondary applies the truncate, removing the documents and their index keys.
+insertExpired(primary, 0, numDocs);
+truncateExpired(primary);
+const entry = primary.getDB("local").oplog.rs.findOne({op: "c", "o.truncateRange": collName});
+assert(entry, "no truncateRange oplog entry");
+assert.eq(dbName + ".$cmd", entry.ns, tojson(entry));
+
+const secondary = rollbackTest.getSecondary();
+secondary.setSecondaryOk();
+const secondaryColl = secondary.getDB(dbName)[collName];
+assert.soon(() => secondaryColl.find().itcount() == 0, "secondary didn't apply truncateRange");
+assert.eq(0, secondaryColl.find().hint({a: 1}).itcount());
+
+// A truncate on a primary that loses its writes in a rollback.
+insertExpired(primary, numDocs, numDocs);
+const rollbackNode = rollbackTest.transitionToRollbackOperations();
+truncateExpired(rollbackNode);
+
+rollbackTest.transitionToSyncSourceOperationsBeforeRollback();
+rollbackTest.transitionToSyncSourceOperationsDuringRollback();
+rollbackTest.transitionToSteadyStateOperations();
+
+// The rolled back node has the documents again, matching its sync source, which never removed
+// them.
+rollbackNode.setSecondaryOk();
+const rolledBackColl = rollbackNode.getDB(dbName)[collName];
+assert.eq(numDocs, rolledBackColl.find().itcount());
+assert.eq(numDocs, rolledBackColl.find().hint({a: 1}).itcount());
+primary = rollbackTest.getPrimary();
+assert.eq(numDocs, primary.getDB(dbName)[collName].find().itcount());
+
+rollbackTest.stop();
+})();
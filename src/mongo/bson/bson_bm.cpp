@@ -34,6 +34,7 @@
 #include <benchmark/benchmark.h>
 
 #include "mongo/bson/bson_validate.h"
+#include "mongo/bson/bsonobj_field_index.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/logv2/log.h"
 
@@ -59,6 +60,31 @@ BSONObj buildSampleObj(long long unsigned int i) {
                        << "random" << random << "phone_no" << phone_no << "long_string"
                        << long_string);
 }
+
+/**
+ * Builds an object with 'numFields' fields named like the fields of a typical wide document.
+ */
+BSONObj buildWideObj(int numFields) {
+    BSONObjBuilder builder;
+    for (int i = 0; i < numFields; ++i) {
+        builder.append(fmt::format("attribute_{}", i), i);
+    }
+    return builder.obj();
+}
+
+/**
+ * Finds a field by comparing the name of every element returned by BSONObjIterator, the way
+ * BSONObj::getField() used to.
+ */
+BSONElement getFieldByIteration(const BSONObj& obj, StringData name) {
+    BSONObjIterator i(obj);
+    while (i.more()) {
+        BSONElement e = i.next();
+        if (name == e.fieldNameStringData())
+            return e;
+    }
+    return BSONElement();
+}
 }  // namespace
 
 void BM_arrayBuilder(benchmark::State& state) {
@@ -112,8 +138,66 @@ void BM_validate(benchmark::State& state) {
     state.SetBytesProcessed(totalSize);
 }
 
+// Looks up the last field of the sample object, and of wide objects, where every element has to be
+// skipped to find it.
+void BM_getFieldByIteration(benchmark::State& state) {
+    const BSONObj obj = state.range(0) ? buildWideObj(state.range(0)) : buildSampleObj(1);
+    const std::string name = state.range(0) ? fmt::format("attribute_{}", state.range(0) - 1)
+                                            : std::string("long_string");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(getFieldByIteration(obj, name));
+    }
+    state.SetItemsProcessed(state.iterations() * obj.nFields());
+}
+
+void BM_getField(benchmark::State& state) {
+    const BSONObj obj = state.range(0) ? buildWideObj(state.range(0)) : buildSampleObj(1);
+    const std::string name = state.range(0) ? fmt::format("attribute_{}", state.range(0) - 1)
+                                            : std::string("long_string");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(obj.getField(name));
+    }
+    state.SetItemsProcessed(state.iterations() * obj.nFields());
+}
+
+// Looks up every field of a wide object, once by scanning and once through a field index built
+// for the whole batch of lookups.
+void BM_getAllFields(benchmark::State& state) {
+    const BSONObj obj = buildWideObj(state.range(0));
+    std::vector<std::string> names;
+    for (int i = 0; i < state.range(0); ++i) {
+        names.push_back(fmt::format("attribute_{}", i));
+    }
+    for (auto _ : state) {
+        for (auto&& name : names) {
+            benchmark::DoNotOptimize(obj.getField(name));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * names.size());
+}
+
+void BM_getAllFieldsIndexed(benchmark::State& state) {
+    const BSONObj obj = buildWideObj(state.range(0));
+    std::vector<std::string> names;
+    for (int i = 0; i < state.range(0); ++i) {
+        names.push_back(fmt::format("attribute_{}", i));
+    }
+    for (auto _ : state) {
+        BSONObjFieldIndex index(obj);
+        for (auto&& name : names) {
+            benchmark::DoNotOptimize(index.getField(name));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * names.size());
+}
+
 BENCHMARK(BM_arrayBuilder)->Ranges({{{1}, {100'000}}});
 BENCHMARK(BM_arrayLookup)->Ranges({{{1}, {100'000}}});
 BENCHMARK(BM_validate)->Ranges({{{1}, {1'000}}});
+// An argument of 0 looks up the sample object, otherwise a wide object with that many fields.
+BENCHMARK(BM_getFieldByIteration)->Arg(0)->Arg(16)->Arg(256);
+BENCHMARK(BM_getField)->Arg(0)->Arg(16)->Arg(256);
+BENCHMARK(BM_getAllFields)->Arg(16)->Arg(256);
+BENCHMARK(BM_getAllFieldsIndexed)->Arg(16)->Arg(256);
 
 }  // namespace mongo
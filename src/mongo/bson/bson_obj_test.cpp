@@ -29,6 +29,7 @@
 
 #include "mongo/bson/bsonelement_comparator.h"
 #include "mongo/bson/bsonobj_comparator.h"
+#include "mongo/bson/bsonobj_field_index.h"
 #include "mongo/bson/simple_bsonelement_comparator.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/bson/unordered_fields_bsonobj_comparator.h"
@@ -37,6 +38,7 @@
 #include "mongo/platform/decimal128.h"
 
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/str.h"
 
 namespace {
 using namespace mongo;
@@ -647,6 +649,55 @@ TEST(BSONObj, getFieldsWithDuplicates) {
     ASSERT_EQUALS(fields[1].str(), "3");
 }
 
+TEST(BSONObj, getField) {
+    const std::string longName(40, 'x');
+    auto obj = BSON("a" << 1 << "ab" << 2 << "abc" << 3 << "" << 4 << longName << 5
+                        << "exactly15bytes_" << 6 << "a" << 7 << "z" << 8);
+    ASSERT_EQUALS(obj.getField("a").numberInt(), 1);
+    ASSERT_EQUALS(obj.getField("ab").numberInt(), 2);
+    ASSERT_EQUALS(obj.getField("abc").numberInt(), 3);
+    ASSERT_EQUALS(obj.getField("").numberInt(), 4);
+    ASSERT_EQUALS(obj.getField(longName).numberInt(), 5);
+    ASSERT_EQUALS(obj.getField("exactly15bytes_").numberInt(), 6);
+    ASSERT_EQUALS(obj.getField("z").numberInt(), 8);
+    ASSERT_EQUALS(obj.getField("z").fieldNameStringData(), "z");
+
+    ASSERT(obj.getField("abcd").eoo());
+    ASSERT(obj.getField("b").eoo());
+    ASSERT(obj.getField(longName + "x").eoo());
+    ASSERT(obj.getField(StringData("a\0", 2)).eoo());
+    ASSERT(BSONObj().getField("a").eoo());
+}
+
+TEST(BSONObj, getFieldNearEndOfObject) {
+    // Field names within a vector width of the end of the object are read without overrunning
+    // the buffer. The object is copied so that its buffer ends right after the EOO byte.
+    for (int len = 0; len < 20; ++len) {
+        const std::string name(len, 'n');
+        auto obj = BSON("first" << 1 << name << 2).copy();
+        ASSERT_EQUALS(obj.getField(name).numberInt(), 2);
+        ASSERT(obj.getField(name + "n").eoo());
+    }
+}
+
+TEST(BSONObjFieldIndex, getField) {
+    BSONObjBuilder builder;
+    for (int i = 0; i < 100; ++i) {
+        builder.append(str::stream() << "field" << i, i);
+    }
+    builder.append("field7", -1);
+    BSONObjFieldIndex index(builder.obj());
+
+    for (int i = 0; i < 100; ++i) {
+        const std::string name = str::stream() << "field" << i;
+        ASSERT_EQUALS(index.getField(name).numberInt(), i);
+        ASSERT_BSONELT_EQ(index.getField(name), index.getObject().getField(name));
+    }
+    ASSERT(index.getField("field100").eoo());
+    ASSERT(index.getField("").eoo());
+    ASSERT(BSONObjFieldIndex(BSONObj()).getField("a").eoo());
+}
+
 TEST(BSONObj, ShareOwnershipWith) {
     BSONObj obj;
     {
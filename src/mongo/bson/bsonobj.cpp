@@ -31,6 +31,13 @@
 
 #include "mongo/db/jsobj.h"
 
+#include <cstring>
+
+#if defined(_M_AMD64) || defined(__amd64__)
+#include <emmintrin.h>
+#define MONGO_BSON_SSE2_FIELD_SCAN
+#endif
+
 #include "mongo/base/data_range.h"
 #include "mongo/bson/bson_validate.h"
 #include "mongo/bson/bsonelement_comparator_interface.h"
@@ -39,6 +46,7 @@
 #include "mongo/bson/generator_legacy_strict.h"
 #include "mongo/db/json.h"
 #include "mongo/logv2/log.h"
+#include "mongo/platform/bits.h"
 #include "mongo/util/allocator.h"
 #include "mongo/util/hex.h"
 #include "mongo/util/str.h"
@@ -83,6 +91,72 @@ int compareObjects(const BSONObj& firstObj,
     MONGO_UNREACHABLE;
 }
 
+/**
+ * Returns the first element named 'name' among the elements starting at 'pos', or EOO if there is
+ * none. 'end' points at the EOO byte terminating the object.
+ *
+ * Each element costs one pass over its field name to find its length, which is needed to skip to
+ * the next element, and compares the name in the same pass. On x86-64, field names shorter than
+ * 16 bytes are loaded into a single SSE2 register, where a byte-wise compare against zero gives
+ * their length and a byte-wise compare against 'name' tells whether they match. Longer names and
+ * names within 16 bytes of the end of the object fall back to strlen() and memcmp().
+ */
+BSONElement findElement(const char* pos, const char* end, StringData name) {
+    const size_t nameSize = name.size();
+
+#ifdef MONGO_BSON_SSE2_FIELD_SCAN
+    constexpr size_t kChunkSize = sizeof(__m128i);
+
+    // 'name' followed by its NUL terminator, padded to a whole register. Only usable if the
+    // terminator fits, and if 'name' has no NUL of its own that a shorter field name would match.
+    const bool nameFitsInChunk = nameSize < kChunkSize && name.find('\0') == std::string::npos;
+    alignas(kChunkSize) char nameBytes[kChunkSize] = {};
+    if (nameFitsInChunk && nameSize > 0) {
+        std::memcpy(nameBytes, name.rawData(), nameSize);
+    }
+    const __m128i nameChunk = _mm_load_si128(reinterpret_cast<const __m128i*>(nameBytes));
+    const __m128i zeroChunk = _mm_setzero_si128();
+    const uint32_t nameMask = nameFitsInChunk ? (uint32_t{1} << (nameSize + 1)) - 1 : 0;
+#endif
+
+    while (pos < end) {
+        const char* fieldName = pos + 1;
+        int fieldNameSize = -1;  // Includes the NUL terminator.
+        bool compared = false;
+        bool matches = false;
+
+#ifdef MONGO_BSON_SSE2_FIELD_SCAN
+        // The load must stay within the object, which ends with the EOO byte at 'end'.
+        if (fieldName + kChunkSize <= end + 1) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(fieldName));
+            const uint32_t zeros = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, zeroChunk));
+            if (zeros != 0) {
+                fieldNameSize = countTrailingZeros64(zeros) + 1;
+                if (nameFitsInChunk) {
+                    const uint32_t equal = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, nameChunk));
+                    compared = true;
+                    matches = (equal & nameMask) == nameMask;
+                }
+            }
+        }
+#endif
+
+        if (fieldNameSize == -1) {
+            fieldNameSize = std::strlen(fieldName) + 1;
+        }
+        if (!compared && static_cast<size_t>(fieldNameSize) == nameSize + 1) {
+            matches = nameSize == 0 || std::memcmp(fieldName, name.rawData(), nameSize) == 0;
+        }
+
+        BSONElement e(pos, fieldNameSize, -1, BSONElement::CachedSizeTag{});
+        if (matches) {
+            return e;
+        }
+        pos += e.size();
+    }
+    return BSONElement();
+}
+
 }  // namespace
 
 /* BSONObj ------------------------------------------------------------*/
@@ -561,17 +635,11 @@ void BSONObj::getFields(unsigned n, const char** fieldNames, BSONElement* fields
 }
 
 BSONElement BSONObj::getField(StringData name) const {
-    BSONObjIterator i(*this);
-    while (i.more()) {
-        BSONElement e = i.next();
-        // We know that e has a cached field length since BSONObjIterator::next internally
-        // called BSONElement::size on the BSONElement that it returned, so it is more
-        // efficient to re-use that information by obtaining the field name as a
-        // StringData, which will be pre-populated with the cached length.
-        if (name == e.fieldNameStringData())
-            return e;
+    const int size = objsize();
+    if (MONGO_unlikely(size == 0)) {
+        return BSONElement();
     }
-    return BSONElement();
+    return findElement(objdata() + 4, objdata() + size - 1, name);
 }
 
 int BSONObj::getIntField(StringData name) const {
@@ -0,0 +1,67 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+/**
+ * An index of the top-level fields of a BSONObj, for wide objects whose fields are looked up many
+ * times. Building the index takes one pass over the object, after which each lookup is a binary
+ * search over the field names rather than a scan of the elements preceding the field.
+ *
+ * Lookups return the same element BSONObj::getField() would: the first field with the name.
+ */
+class BSONObjFieldIndex {
+public:
+    explicit BSONObjFieldIndex(BSONObj obj);
+
+    /**
+     * Returns the field named 'name', or EOO if there is none.
+     */
+    BSONElement getField(StringData name) const;
+
+    const BSONObj& getObject() const {
+        return _obj;
+    }
+
+private:
+    BSONObj _obj;
+
+    // The elements of '_obj', sorted by field name, and in object order among equal names.
+    std::vector<BSONElement> _elements;
+};
+
+}  // namespace mongo
@@ -70,6 +70,7 @@ namespace mongo {
     X(checkFreeMonitoringStatus)                                                      \
     X(cleanupOrphaned)                                                                \
     X(clearJumboFlag)                                                                 \
+    X(clearQueryShapeStats)                                                           \
     X(closeAllDatabases) /* Deprecated (backwards compatibility) */                   \
     X(collMod)                                                                        \
     X(collStats)                                                                      \
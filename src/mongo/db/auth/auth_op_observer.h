@@ -173,6 +173,11 @@ public:
                        const NamespaceString& collectionName,
                        OptionalCollectionUUID uuid) final;
 
+    void onTruncateRange(OperationContext* opCtx,
+                         const NamespaceString& collectionName,
+                         OptionalCollectionUUID uuid,
+                         Date_t removedBefore) final {}
+
     void onUnpreparedTransactionCommit(OperationContext* opCtx,
                                        std::vector<repl::ReplOperation>* statements,
                                        size_t numberOfPreImagesToWrite) final {}
@@ -207,6 +207,7 @@ MONGO_INITIALIZER(AuthorizationBuiltinRoles)(InitializerContext* context) {
     // hostManager role actions that target the cluster resource
     hostManagerRoleClusterActions
         << ActionType::applicationMessage  // clusterManager gets this also
+        << ActionType::clearQueryShapeStats
         << ActionType::connPoolSync
         << ActionType::dropConnections
         << ActionType::logRotate
@@ -67,9 +67,11 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/clustered_by_time.h"
 #include "mongo/db/storage/durable_catalog.h"
 #include "mongo/db/storage/key_string.h"
 #include "mongo/db/storage/record_store.h"
+#include "mongo/db/ttl_collection_cache.h"
 #include "mongo/db/update/update_driver.h"
 
 #include "mongo/db/auth/user_document_parser.h"  // XXX-ANDY
@@ -346,6 +348,11 @@ void CollectionImpl::init(OperationContext* opCtx) {
         _recordPreImages = true;
     }
 
+    _clusteredByTimeField = collectionOptions.clusteredByTime;
+    if (collectionOptions.expireAfterSeconds) {
+        TTLCollectionCache::get(opCtx->getServiceContext()).registerClusteredCollection(_uuid);
+    }
+
     // Store the result (OK / error) of parsing the validator, but do not enforce that the result is
     // OK. This is intentional, as users may have validators on disk which were considered well
     // formed in older versions but not in newer versions.
@@ -853,6 +860,17 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
     if (!oldId.eoo() && SimpleBSONElementComparator::kInstance.evaluate(oldId != newDoc["_id"]))
         uasserted(13596, "in Collection::updateDocument _id mismatch");
 
+    // The RecordId of a document clustered by time is derived from its time, so the time cannot
+    // change, nor can the field be removed or hold anything but a Date.
+    if (!_clusteredByTimeField.empty()) {
+        auto swTime = clustered_by_time::extractTime(
+            _clusteredByTimeField, newDoc.objdata(), newDoc.objsize());
+        uassert(ErrorCodes::ImmutableField,
+                str::stream() << "the field '" << _clusteredByTimeField
+                              << "' that the collection is clustered by cannot be changed",
+                swTime.isOK() && swTime.getValue() == clustered_by_time::timeOf(oldLocation));
+    }
+
     // The MMAPv1 storage engine implements capped collections in a way that does not allow records
     // to grow beyond their original size. If MMAPv1 part of a replicaset with storage engines that
     // do not have this limitation, replication could result in errors, so it is necessary to set a
@@ -907,6 +925,10 @@ bool CollectionImpl::updateWithDamagesSupported() const {
     if (!_validator.isOK() || _validator.filter.getValue() != nullptr)
         return false;
 
+    // In-place updates would bypass the check that the clustering time is unchanged.
+    if (!_clusteredByTimeField.empty())
+        return false;
+
     return _shared->_recordStore->updateWithDamagesSupported();
 }
 
@@ -452,6 +452,9 @@ private:
 
     bool _recordPreImages = false;
 
+    // The field whose time orders the records, if the collection is clustered by time.
+    std::string _clusteredByTimeField;
+
     // The earliest snapshot that is allowed to use this collection.
     boost::optional<Timestamp> _minVisibleSnapshot;
 
@@ -170,6 +170,24 @@ StatusWith<CollectionOptions> CollectionOptions::parse(const BSONObj& options, P
             collectionOptions.temp = e.trueValue();
         } else if (fieldName == "recordPreImages") {
             collectionOptions.recordPreImages = e.trueValue();
+        } else if (fieldName == "clusteredByTime") {
+            if (e.type() != mongo::String) {
+                return Status(ErrorCodes::BadValue, "'clusteredByTime' has to be a string.");
+            }
+
+            collectionOptions.clusteredByTime = e.String();
+            if (collectionOptions.clusteredByTime.empty()) {
+                return Status(ErrorCodes::BadValue, "'clusteredByTime' cannot be empty.");
+            }
+        } else if (fieldName == "expireAfterSeconds") {
+            if (!e.isNumber()) {
+                return Status(ErrorCodes::BadValue, "'expireAfterSeconds' has to be a number.");
+            }
+
+            collectionOptions.expireAfterSeconds = e.safeNumberLong();
+            if (*collectionOptions.expireAfterSeconds < 0) {
+                return Status(ErrorCodes::BadValue, "'expireAfterSeconds' has to be >= 0.");
+            }
         } else if (fieldName == "storageEngine") {
             Status status = checkStorageEngineOptions(e);
             if (!status.isOK()) {
@@ -260,6 +278,17 @@ StatusWith<CollectionOptions> CollectionOptions::parse(const BSONObj& options, P
         return Status(ErrorCodes::BadValue, "'pipeline' cannot be specified without 'viewOn'");
     }
 
+    if (collectionOptions.clusteredByTime.empty() && collectionOptions.expireAfterSeconds) {
+        return Status(ErrorCodes::BadValue,
+                      "'expireAfterSeconds' cannot be specified without 'clusteredByTime'");
+    }
+
+    if (!collectionOptions.clusteredByTime.empty() &&
+        (collectionOptions.capped || !collectionOptions.viewOn.empty())) {
+        return Status(ErrorCodes::BadValue,
+                      "'clusteredByTime' cannot be specified for a capped collection or a view");
+    }
+
     return collectionOptions;
 }
 
@@ -292,6 +321,14 @@ void CollectionOptions::appendBSON(BSONObjBuilder* builder) const {
         builder->appendBool("recordPreImages", true);
     }
 
+    if (!clusteredByTime.empty()) {
+        builder->append("clusteredByTime", clusteredByTime);
+    }
+
+    if (expireAfterSeconds) {
+        builder->appendNumber("expireAfterSeconds", *expireAfterSeconds);
+    }
+
     if (!storageEngine.isEmpty()) {
         builder->append("storageEngine", storageEngine);
     }
@@ -351,6 +388,14 @@ bool CollectionOptions::matchesStorageOptions(const CollectionOptions& other,
         return false;
     }
 
+    if (clusteredByTime != other.clusteredByTime) {
+        return false;
+    }
+
+    if (expireAfterSeconds != other.expireAfterSeconds) {
+        return false;
+    }
+
     if (temp != other.temp) {
         return false;
     }
@@ -121,6 +121,13 @@ struct CollectionOptions {
     bool temp = false;
     bool recordPreImages = false;
 
+    // The name of the Date field whose value keys the collection's records, or the empty string if
+    // the collection is not clustered by time. See 'clustered_by_time.h'.
+    std::string clusteredByTime;
+    // For a collection clustered by time, how long after the time in 'clusteredByTime' a document
+    // is removed by the TTL monitor. Not set if documents never expire.
+    boost::optional<long long> expireAfterSeconds;
+
     // Storage engine collection options. Always owned or empty.
     BSONObj storageEngine;
 
@@ -353,4 +353,24 @@ TEST(CollectionOptions, NExtentsNoError) {
     // Check that $nExtents does not cause an error for backwards compatability
     assertGet(CollectionOptions::parse(fromjson("{$nExtents: 'a'}")));
 }
+
+TEST(CollectionOptions, ClusteredByTimeRoundTrip) {
+    CollectionOptions options = assertGet(CollectionOptions::parse(
+        fromjson("{clusteredByTime: 'createdAt', expireAfterSeconds: 60}")));
+    ASSERT_EQ(options.clusteredByTime, "createdAt");
+    ASSERT_EQ(*options.expireAfterSeconds, 60);
+    checkRoundTrip(options);
+}
+
+TEST(CollectionOptions, ClusteredByTimeInvalidOptions) {
+    ASSERT_NOT_OK(CollectionOptions::parse(fromjson("{clusteredByTime: 1}")).getStatus());
+    ASSERT_NOT_OK(CollectionOptions::parse(fromjson("{clusteredByTime: ''}")).getStatus());
+    ASSERT_NOT_OK(CollectionOptions::parse(fromjson("{expireAfterSeconds: 60}")).getStatus());
+    ASSERT_NOT_OK(
+        CollectionOptions::parse(fromjson("{clusteredByTime: 'createdAt', expireAfterSeconds: -1}"))
+            .getStatus());
+    ASSERT_NOT_OK(
+        CollectionOptions::parse(fromjson("{clusteredByTime: 'createdAt', capped: true, size: 1}"))
+            .getStatus());
+}
 }  // namespace mongo
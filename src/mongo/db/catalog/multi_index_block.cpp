@@ -33,6 +33,7 @@
 
 #include "mongo/db/catalog/multi_index_block.h"
 
+#include <algorithm>
 #include <ostream>
 
 #include "mongo/base/error_codes.h"
@@ -41,6 +42,7 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/catalog/multi_index_block_gen.h"
+#include "mongo/db/catalog/shared_collection_scan.h"
 #include "mongo/db/catalog/uncommitted_collections.h"
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -56,7 +58,9 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/write_unit_of_work.h"
 #include "mongo/logv2/log.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/progress_meter.h"
 #include "mongo/util/quick_exit.h"
@@ -73,6 +77,14 @@ MONGO_FAIL_POINT_DEFINE(hangIndexBuildDuringCollectionScanPhaseBeforeInsertion);
 MONGO_FAIL_POINT_DEFINE(hangIndexBuildDuringCollectionScanPhaseAfterInsertion);
 MONGO_FAIL_POINT_DEFINE(leaveIndexBuildUnfinishedForShutdown);
 
+namespace {
+
+// When keys are generated on more than one thread, the collection scan hands documents to the
+// key generation threads in batches of about this many bytes.
+constexpr size_t kKeyGenerationBatchBytes = 4 * 1024 * 1024;
+
+}  // namespace
+
 MultiIndexBlock::~MultiIndexBlock() {
     invariant(_buildIsCleanedUp);
 }
@@ -416,6 +428,48 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(
 
     unsigned long long n = 0;
 
+    // A build joins the collection scan of another build of the same collection that is in
+    // progress, and then only scans the records it did not receive from that scan. A build that
+    // finds no scan to join lets later builds join its own.
+    auto& sharedScans = SharedCollectionScanRegistry::get(opCtx->getServiceContext());
+    std::shared_ptr<SharedCollectionScan> sharedScan;
+    boost::optional<SharedCollectionScan::RideResult> ride;
+    const auto scanReadSource = opCtx->recoveryUnit()->getTimestampReadSource();
+    if (indexBuildsShareCollectionScans.load() && isBackgroundBuilding() && !resumeAfterRecordId &&
+        (scanReadSource == RecoveryUnit::ReadSource::kNoTimestamp ||
+         scanReadSource == RecoveryUnit::ReadSource::kMajorityCommitted)) {
+        // The leader inserts into this build's bulk builders on its own thread, while this thread
+        // is blocked in _rideSharedCollectionScan() and does not touch them. The scan's mutex,
+        // which the leader holds while inserting and the rider takes to stop waiting, orders those
+        // inserts before anything this thread does next, and an interrupted rider leaves the scan
+        // under that mutex before tearing anything down. The leader leaves this build's other
+        // state, like _lastRecordIdInserted, alone.
+        auto rider = sharedScans.join(
+            collection->uuid(),
+            scanReadSource,
+            [this](OperationContext* leaderOpCtx, const BSONObj& doc, const RecordId& loc) {
+                return _insertDocumentIntoIndexes(leaderOpCtx, doc, loc);
+            });
+        if (rider) {
+            _rodeSharedCollectionScan = true;
+            auto swRide = _rideSharedCollectionScan(opCtx, collection, rider.get());
+            if (!swRide.isOK()) {
+                return swRide.getStatus();
+            }
+            ride = swRide.getValue();
+        } else {
+            sharedScan = sharedScans.startScan(collection->uuid(), scanReadSource);
+        }
+    }
+    bool sharedScanCompleted = false;
+    auto finishSharedScan = [&] {
+        if (sharedScan) {
+            sharedScans.finishScan(sharedScan, sharedScanCompleted);
+            sharedScan = nullptr;
+        }
+    };
+    ON_BLOCK_EXIT(finishSharedScan);
+
     PlanYieldPolicy::YieldPolicy yieldPolicy;
     if (isBackgroundBuilding()) {
         yieldPolicy = PlanYieldPolicy::YieldPolicy::YIELD_AUTO;
@@ -429,6 +483,43 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(
     bool readOnce = useReadOnceCursorsForIndexBuilds.load();
     opCtx->recoveryUnit()->setReadOnce(readOnce);
 
+    // If more than one thread may generate keys, the scan collects the documents into batches,
+    // and the keys of each batch are generated and sorted for all indexes at once, one thread per
+    // index.
+    std::unique_ptr<ThreadPool> keyGenerationPool;
+    const size_t numKeyGenerationThreads =
+        std::min(_indexes.size(), static_cast<size_t>(indexBuildKeyGenerationThreads.load()));
+    if (numKeyGenerationThreads > 1) {
+        ThreadPool::Options options;
+        options.poolName = "IndexBuildKeyGeneration";
+        options.minThreads = 0;
+        options.maxThreads = numKeyGenerationThreads;
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+        };
+        keyGenerationPool = std::make_unique<ThreadPool>(options);
+        keyGenerationPool->startup();
+    }
+    ON_BLOCK_EXIT([&] {
+        if (keyGenerationPool) {
+            keyGenerationPool->shutdown();
+            keyGenerationPool->join();
+        }
+    });
+
+    DocumentBatch batch;
+    size_t batchBytes = 0;
+    auto flushBatch = [&] {
+        if (batch.empty()) {
+            return;
+        }
+        uassertStatusOK(
+            _insertBatchInParallel(opCtx, collection, keyGenerationPool.get(), batch));
+        _lastRecordIdInserted = batch.back().second;
+        batch.clear();
+        batchBytes = 0;
+    };
+
     try {
         // The phase will be kCollectionScan when resuming an index build from the collection scan
         // phase.
@@ -448,6 +539,15 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(
                 continue;
             }
 
+            // Skip the records received from the scan of another build. Past them, nothing is
+            // left to scan if that scan reached the end of the collection.
+            if (ride && ride->covers(loc)) {
+                if (ride->scanCompleted) {
+                    break;
+                }
+                continue;
+            }
+
             progress->setTotalWhileRunning(collection->numRecords(opCtx));
 
             uassertStatusOK(
@@ -459,7 +559,20 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(
 
             // The external sorter is not part of the storage engine and therefore does not need a
             // WriteUnitOfWork to write keys.
-            uassertStatusOK(insertSingleDocumentForInitialSyncOrRecovery(opCtx, objToIndex, loc));
+            if (keyGenerationPool) {
+                batch.emplace_back(objToIndex.getOwned(), loc);
+                batchBytes += objToIndex.objsize();
+                if (batchBytes >= kKeyGenerationBatchBytes) {
+                    flushBatch();
+                }
+            } else {
+                uassertStatusOK(
+                    insertSingleDocumentForInitialSyncOrRecovery(opCtx, objToIndex, loc));
+            }
+
+            if (sharedScan && sharedScan->hasActiveRiders()) {
+                sharedScan->insert(opCtx, objToIndex, loc);
+            }
 
             _failPointHangDuringBuild(opCtx,
                                       &hangIndexBuildDuringCollectionScanPhaseAfterInsertion,
@@ -468,10 +581,23 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(
                                       n)
                 .ignore();
 
+            if (sharedScan && sharedScan->hasPendingRiders()) {
+                // Builds that joined since the current snapshot was opened may not intercept the
+                // writes it misses, so only hand them documents from a new snapshot.
+                exec->saveState();
+                opCtx->recoveryUnit()->abandonSnapshot();
+                exec->restoreState(&collection);
+                sharedScan->startPendingRiders(loc);
+            }
+
             // Go to the next document.
             progress->hit();
             n++;
         }
+
+        flushBatch();
+        sharedScanCompleted = true;
+        finishSharedScan();
     } catch (DBException& ex) {
         if (ex.isA<ErrorCategory::Interruption>() || ex.isA<ErrorCategory::ShutdownError>() ||
             ErrorCodes::IndexBuildAborted == ex.code()) {
@@ -552,6 +678,19 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(
 Status MultiIndexBlock::insertSingleDocumentForInitialSyncOrRecovery(OperationContext* opCtx,
                                                                      const BSONObj& doc,
                                                                      const RecordId& loc) {
+    Status status = _insertDocumentIntoIndexes(opCtx, doc, loc);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    _lastRecordIdInserted = loc;
+
+    return Status::OK();
+}
+
+Status MultiIndexBlock::_insertDocumentIntoIndexes(OperationContext* opCtx,
+                                                   const BSONObj& doc,
+                                                   const RecordId& loc) {
     invariant(!_buildIsCleanedUp);
     for (size_t i = 0; i < _indexes.size(); i++) {
         if (_indexes[i].filterExpression && !_indexes[i].filterExpression->matchesBSON(doc)) {
@@ -572,11 +711,137 @@ Status MultiIndexBlock::insertSingleDocumentForInitialSyncOrRecovery(OperationCo
             return idxStatus;
     }
 
-    _lastRecordIdInserted = loc;
+    return Status::OK();
+}
+
+Status MultiIndexBlock::_insertBatchInParallel(OperationContext* opCtx,
+                                               const CollectionPtr& collection,
+                                               ThreadPool* pool,
+                                               const DocumentBatch& batch) {
+    auto mutex = MONGO_MAKE_LATCH("MultiIndexBlock::_insertBatchInParallel");
+    stdx::condition_variable allIndexesDone;
+    size_t indexesRemaining = _indexes.size();
+    Status firstError = Status::OK();
+    std::vector<std::vector<RecordId>> skippedRecords(_indexes.size());
+
+    for (size_t i = 0; i < _indexes.size(); i++) {
+        pool->schedule([&, i](Status status) {
+            if (status.isOK()) {
+                // Each task has its own OperationContext, since key generation uses buffers
+                // decorating it.
+                auto taskOpCtx = cc().makeOperationContext();
+                status = _insertBatchIntoIndex(taskOpCtx.get(), i, batch, &skippedRecords[i]);
+            }
 
+            stdx::lock_guard<Latch> lk(mutex);
+            if (!status.isOK() && firstError.isOK()) {
+                firstError = status;
+            }
+            if (--indexesRemaining == 0) {
+                allIndexesDone.notify_one();
+            }
+        });
+    }
+
+    // The tasks refer to this stack frame, so wait for all of them, without interruption. Each
+    // task only generates the keys of a bounded batch.
+    {
+        stdx::unique_lock<Latch> lk(mutex);
+        allIndexesDone.wait(lk, [&] { return indexesRemaining == 0; });
+    }
+    if (!firstError.isOK()) {
+        return firstError;
+    }
+
+    // Record the skipped documents here, where the index build's locks are held.
+    for (size_t i = 0; i < _indexes.size(); i++) {
+        if (skippedRecords[i].empty()) {
+            continue;
+        }
+        auto interceptor = _indexes[i].block->getEntry(opCtx, collection)->indexBuildInterceptor();
+        if (!interceptor || !interceptor->getSkippedRecordTracker()) {
+            continue;
+        }
+        try {
+            for (auto&& loc : skippedRecords[i]) {
+                interceptor->getSkippedRecordTracker()->record(opCtx, loc);
+            }
+        } catch (...) {
+            return exceptionToStatus();
+        }
+    }
+    return Status::OK();
+}
+
+Status MultiIndexBlock::_insertBatchIntoIndex(OperationContext* opCtx,
+                                              size_t indexNo,
+                                              const DocumentBatch& batch,
+                                              std::vector<RecordId>* skippedRecords) {
+    auto& index = _indexes[indexNo];
+    auto onSkippedRecord = [&](const RecordId& loc) { skippedRecords->push_back(loc); };
+    for (auto&& [doc, loc] : batch) {
+        if (index.filterExpression && !index.filterExpression->matchesBSON(doc)) {
+            continue;
+        }
+
+        // When calling insert, BulkBuilderImpl's Sorter performs file I/O that may result in an
+        // exception.
+        try {
+            Status status = index.bulk->insert(opCtx, doc, loc, index.options, onSkippedRecord);
+            if (!status.isOK()) {
+                return status;
+            }
+        } catch (...) {
+            return exceptionToStatus();
+        }
+    }
     return Status::OK();
 }
 
+StatusWith<SharedCollectionScan::RideResult> MultiIndexBlock::_rideSharedCollectionScan(
+    OperationContext* opCtx, const CollectionPtr& collection, SharedCollectionScan::Rider* rider) {
+    LOGV2(5121508,
+          "Index build: joined the collection scan of another index build",
+          "buildUUID"_attr = _buildUUID,
+          "collectionUUID"_attr = collection->uuid());
+
+    // Release the locks while waiting, as the other build yields its own during the scan.
+    const auto collectionUUID = collection->uuid();
+    collection.yield();
+    Locker::LockSnapshot lockInfo;
+    invariant(opCtx->lockState()->saveLockStateAndUnlock(&lockInfo));
+
+    // As when a collection scan yields, an interrupted build returns without its locks. Taking
+    // them back uninterruptibly could deadlock with an abort, which kills this operation while it
+    // holds the collection X lock and waits for the build to finish.
+    SharedCollectionScan::RideResult ride;
+    try {
+        ride = rider->wait(opCtx);
+        opCtx->lockState()->restoreLockState(opCtx, lockInfo);
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+    opCtx->recoveryUnit()->abandonSnapshot();
+    collection.restore();
+
+    if (!collection) {
+        return Status(ErrorCodes::QueryPlanKilled,
+                      str::stream() << "collection dropped. UUID " << collectionUUID);
+    }
+
+    if (!ride.status.isOK()) {
+        return ride.status;
+    }
+
+    LOGV2(5121509,
+          "Index build: left the collection scan of another index build",
+          "buildUUID"_attr = _buildUUID,
+          "totalRecords"_attr = ride.numInserted,
+          "joinedAfter"_attr = ride.joinedAfter,
+          "scanCompleted"_attr = ride.scanCompleted);
+    return ride;
+}
+
 Status MultiIndexBlock::dumpInsertsFromBulk(OperationContext* opCtx,
                                             const CollectionPtr& collection) {
     return dumpInsertsFromBulk(opCtx, collection, nullptr);
@@ -819,6 +1084,13 @@ void MultiIndexBlock::abortWithoutCleanup(OperationContext* opCtx,
 
     auto action = TemporaryRecordStore::FinalizationAction::kDelete;
 
+    // The collection scan of a build that received documents from the scan of another build cannot
+    // be resumed from a single position.
+    if (_rodeSharedCollectionScan && (_phase == IndexBuildPhaseEnum::kInitialized ||
+                                      _phase == IndexBuildPhaseEnum::kCollectionScan)) {
+        isResumable = false;
+    }
+
     if (isResumable) {
         invariant(_buildUUID);
         invariant(_method == IndexBuildMethod::kHybrid);
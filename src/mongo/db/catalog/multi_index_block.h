@@ -43,6 +43,7 @@
 #include "mongo/db/catalog/collection_options.h"
 #include "mongo/db/catalog/index_build_block.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog/shared_collection_scan.h"
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_build_interceptor.h"
@@ -60,6 +61,7 @@ class CollectionPtr;
 class MatchExpression;
 class NamespaceString;
 class OperationContext;
+class ThreadPool;
 
 /**
  * Builds one or more indexes.
@@ -300,6 +302,47 @@ private:
         InsertDeleteOptions options;
     };
 
+    using DocumentBatch = std::vector<std::pair<BSONObj, RecordId>>;
+
+    /**
+     * Inserts the keys of the documents in 'batch' into the bulk builders of all indexes being
+     * built, with one task per index on 'pool'. Returns once every task has finished. The
+     * documents whose key generation errors were suppressed are then recorded on 'opCtx'.
+     */
+    Status _insertBatchInParallel(OperationContext* opCtx,
+                                  const CollectionPtr& collection,
+                                  ThreadPool* pool,
+                                  const DocumentBatch& batch);
+
+    /**
+     * Inserts the keys of the documents in 'batch' into the bulk builder of index 'indexNo', and
+     * appends the RecordIds of the documents whose key generation errors were suppressed to
+     * 'skippedRecords'.
+     */
+    Status _insertBatchIntoIndex(OperationContext* opCtx,
+                                 size_t indexNo,
+                                 const DocumentBatch& batch,
+                                 std::vector<RecordId>* skippedRecords);
+
+    /**
+     * Inserts the keys of 'doc' into the bulk builders of the indexes that it belongs in, without
+     * recording 'loc' as the collection scan position.
+     */
+    Status _insertDocumentIntoIndexes(OperationContext* opCtx,
+                                      const BSONObj& doc,
+                                      const RecordId& loc);
+
+    /**
+     * Waits, without holding any locks, for the collection scan of another index build that
+     * 'rider' joined to stop inserting documents into this build's indexes. Returns the range of
+     * records this build received. If interrupted, returns the error without taking the locks
+     * back, as a collection scan that is interrupted while yielding does.
+     */
+    StatusWith<SharedCollectionScan::RideResult> _rideSharedCollectionScan(
+        OperationContext* opCtx,
+        const CollectionPtr& collection,
+        SharedCollectionScan::Rider* rider);
+
     void _writeStateToDisk(OperationContext* opCtx, const CollectionPtr& collection) const;
 
     BSONObj _constructStateObject(OperationContext* opCtx, const CollectionPtr& collection) const;
@@ -333,5 +376,10 @@ private:
 
     // The current phase of the index build.
     IndexBuildPhaseEnum _phase = IndexBuildPhaseEnum::kInitialized;
+
+    // Set when this build received documents from the collection scan of another index build. The
+    // records it scanned during the collection scan phase are then not a single range that it
+    // could resume after.
+    bool _rodeSharedCollectionScan = false;
 };
 }  // namespace mongo
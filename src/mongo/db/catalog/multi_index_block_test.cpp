@@ -32,10 +32,24 @@
 #include "mongo/db/catalog/multi_index_block.h"
 
 #include "mongo/db/catalog/catalog_test_fixture.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog/multi_index_block_gen.h"
+#include "mongo/db/catalog/shared_collection_scan.h"
+#include "mongo/db/catalog/validate_results.h"
 #include "mongo/db/catalog_raii.h"
+#include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/fail_point.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace {
@@ -53,13 +67,19 @@ protected:
         return _nss;
     }
 
+    UUID getCollectionUUID() const {
+        return *_collectionUUID;
+    }
+
     MultiIndexBlock* getIndexer() const {
         return _indexer.get();
     }
 
 private:
     NamespaceString _nss;
+    boost::optional<UUID> _collectionUUID;
     std::unique_ptr<MultiIndexBlock> _indexer;
+    bool _originalShareCollectionScans = false;
 };
 
 void MultiIndexBlockTest::setUp() {
@@ -73,12 +93,19 @@ void MultiIndexBlockTest::setUp() {
 
     CollectionOptions options;
     options.uuid = UUID::gen();
+    _collectionUUID = options.uuid;
 
     ASSERT_OK(storageInterface()->createCollection(operationContext(), _nss, options));
     _indexer = std::make_unique<MultiIndexBlock>();
+
+    // Builds share their collection scans in all tests.
+    _originalShareCollectionScans = indexBuildsShareCollectionScans.load();
+    indexBuildsShareCollectionScans.store(true);
 }
 
 void MultiIndexBlockTest::tearDown() {
+    indexBuildsShareCollectionScans.store(_originalShareCollectionScans);
+
     auto service = getServiceContext();
     repl::ReplicationCoordinator::set(service, {});
 
@@ -87,6 +114,149 @@ void MultiIndexBlockTest::tearDown() {
     CatalogTestFixture::tearDown();
 }
 
+using RecordedDocuments = std::vector<std::pair<BSONObj, RecordId>>;
+
+/**
+ * Inserts the documents {_id: i, a: i} for i in [0, numDocs) and returns them with their
+ * RecordIds, in RecordId order.
+ */
+RecordedDocuments insertDocuments(OperationContext* opCtx,
+                                  const NamespaceString& nss,
+                                  int numDocs) {
+    AutoGetCollection autoColl(opCtx, nss, MODE_X);
+    {
+        WriteUnitOfWork wuow(opCtx);
+        for (int i = 0; i < numDocs; ++i) {
+            ASSERT_OK(autoColl->insertDocument(
+                opCtx, InsertStatement(BSON("_id" << i << "a" << i)), nullptr));
+        }
+        wuow.commit();
+    }
+
+    RecordedDocuments docs;
+    auto cursor = autoColl->getRecordStore()->getCursor(opCtx);
+    while (auto record = cursor->next()) {
+        docs.emplace_back(record->data.toBson().getOwned(), record->id);
+    }
+    ASSERT_EQ(static_cast<size_t>(numDocs), docs.size());
+    return docs;
+}
+
+void initIndexBuild(OperationContext* opCtx, const NamespaceString& nss, MultiIndexBlock* indexer) {
+    AutoGetCollection autoColl(opCtx, nss, MODE_X);
+    CollectionWriter coll(autoColl);
+
+    auto spec = BSON("key" << BSON("a" << 1) << "name"
+                           << "a_1"
+                           << "v" << static_cast<int>(IndexDescriptor::kLatestIndexVersion));
+    WriteUnitOfWork wuow(opCtx);
+    ASSERT_OK(indexer->init(opCtx, coll, {spec}, MultiIndexBlock::kNoopOnInitFn).getStatus());
+    wuow.commit();
+}
+
+/**
+ * Commits the index build and returns the number of keys in the index it built.
+ */
+int64_t commitIndexBuild(OperationContext* opCtx,
+                         const NamespaceString& nss,
+                         MultiIndexBlock* indexer) {
+    AutoGetCollection autoColl(opCtx, nss, MODE_X);
+    CollectionWriter coll(autoColl);
+
+    ASSERT_OK(indexer->dumpInsertsFromBulk(opCtx, coll.get()));
+    ASSERT_OK(indexer->checkConstraints(opCtx, coll.get()));
+    {
+        WriteUnitOfWork wuow(opCtx);
+        ASSERT_OK(indexer->commit(opCtx,
+                                  coll.getWritableCollection(),
+                                  MultiIndexBlock::kNoopOnCreateEachFn,
+                                  MultiIndexBlock::kNoopOnCommitFn));
+        wuow.commit();
+    }
+
+    auto indexCatalog = coll->getIndexCatalog();
+    auto desc = indexCatalog->findIndexByName(opCtx, "a_1");
+    ASSERT(desc);
+    int64_t numKeys;
+    IndexValidateResults fullResults;
+    indexCatalog->getEntry(desc)->accessMethod()->validate(opCtx, &numKeys, &fullResults);
+    return numKeys;
+}
+
+/**
+ * Runs insertAllDocumentsInCollection() for 'indexer' on a thread of its own, like an index build
+ * started while another one is in progress. The thread stores its OperationContext in 'opCtxOut'
+ * and the result in 'statusOut'.
+ */
+stdx::thread insertAllDocumentsOnThread(ServiceContext* service,
+                                        const NamespaceString& nss,
+                                        MultiIndexBlock* indexer,
+                                        AtomicWord<OperationContext*>* opCtxOut,
+                                        Status* statusOut) {
+    return stdx::thread([=] {
+        ThreadClient tc("MultiIndexBlockTest", service);
+        auto opCtx = tc->makeOperationContext();
+        opCtxOut->store(opCtx.get());
+        ON_BLOCK_EXIT([&] { opCtxOut->store(nullptr); });
+
+        try {
+            AutoGetCollection autoColl(opCtx.get(), nss, MODE_IX);
+            *statusOut =
+                indexer->insertAllDocumentsInCollection(opCtx.get(), autoColl.getCollection());
+        } catch (const DBException& ex) {
+            *statusOut = ex.toStatus();
+        }
+    });
+}
+
+void waitForPendingRider(const std::shared_ptr<SharedCollectionScan>& scan) {
+    while (!scan->hasPendingRiders()) {
+        sleepmillis(1);
+    }
+}
+
+/**
+ * A build that joins the scan of another build only scans the records that it did not receive from
+ * that scan. The documents handed to the rider differ from the stored ones in their indexed field,
+ * so any record the rider scanned itself as well would add a second key.
+ */
+void runRiderTest(OperationContext* opCtx,
+                  const NamespaceString& nss,
+                  const UUID& collectionUUID,
+                  MultiIndexBlock* indexer,
+                  bool scanCompleted) {
+    const int numDocs = 10;
+    auto docs = insertDocuments(opCtx, nss, numDocs);
+    initIndexBuild(opCtx, nss, indexer);
+
+    auto& registry = SharedCollectionScanRegistry::get(opCtx->getServiceContext());
+    auto scan = registry.startScan(collectionUUID, RecoveryUnit::ReadSource::kNoTimestamp);
+    ASSERT(scan);
+
+    AtomicWord<OperationContext*> riderOpCtx{nullptr};
+    Status riderStatus = Status::OK();
+    auto rider = insertAllDocumentsOnThread(
+        opCtx->getServiceContext(), nss, indexer, &riderOpCtx, &riderStatus);
+    waitForPendingRider(scan);
+
+    // Act as the leader, which scanned through the fourth document when the build joined. If its
+    // scan does not complete, it only hands over the next two documents.
+    const int joinedAfter = 3;
+    const int handedThrough = scanCompleted ? numDocs - 1 : joinedAfter + 2;
+    {
+        AutoGetCollection autoColl(opCtx, nss, MODE_IX);
+        scan->startPendingRiders(docs[joinedAfter].second);
+        for (int i = joinedAfter + 1; i <= handedThrough; ++i) {
+            scan->insert(opCtx, BSON("_id" << i << "a" << -i), docs[i].second);
+        }
+    }
+    registry.finishScan(scan, scanCompleted);
+    rider.join();
+    ASSERT_OK(riderStatus);
+
+    ASSERT_EQ(numDocs, commitIndexBuild(opCtx, nss, indexer));
+}
+
 TEST_F(MultiIndexBlockTest, CommitWithoutInsertingDocuments) {
     auto indexer = getIndexer();
 
@@ -183,5 +353,190 @@ TEST_F(MultiIndexBlockTest, InitWriteConflictException) {
     indexer->abortIndexBuild(operationContext(), coll, MultiIndexBlock::kNoopOnCleanUpFn);
 }
 
+TEST_F(MultiIndexBlockTest, InsertAllDocumentsWithParallelKeyGeneration) {
+    const auto originalThreads = indexBuildKeyGenerationThreads.load();
+    indexBuildKeyGenerationThreads.store(2);
+    ON_BLOCK_EXIT([&] { indexBuildKeyGenerationThreads.store(originalThreads); });
+
+    auto indexer = getIndexer();
+
+    AutoGetCollection autoColl(operationContext(), getNSS(), MODE_X);
+    CollectionWriter coll(autoColl);
+
+    const int numDocs = 100;
+    {
+        WriteUnitOfWork wuow(operationContext());
+        for (int i = 0; i < numDocs; ++i) {
+            // Every other document has an array, so the index on 'b' becomes multikey.
+            BSONObj doc = (i % 2) ? BSON("_id" << i << "a" << i << "b" << BSON_ARRAY(i << -i))
+                                  : BSON("_id" << i << "a" << i << "b" << i);
+            ASSERT_OK(coll->insertDocument(operationContext(), InsertStatement(doc), nullptr));
+        }
+        wuow.commit();
+    }
+
+    const auto version = static_cast<int>(IndexDescriptor::kLatestIndexVersion);
+    std::vector<BSONObj> specs = {BSON("key" << BSON("a" << 1) << "name"
+                                             << "a_1"
+                                             << "v" << version),
+                                  BSON("key" << BSON("b" << 1) << "name"
+                                             << "b_1"
+                                             << "v" << version)};
+    {
+        WriteUnitOfWork wuow(operationContext());
+        ASSERT_OK(
+            indexer->init(operationContext(), coll, specs, MultiIndexBlock::kNoopOnInitFn)
+                .getStatus());
+        wuow.commit();
+    }
+
+    ASSERT_OK(indexer->insertAllDocumentsInCollection(operationContext(), coll.get()));
+    ASSERT_OK(indexer->checkConstraints(operationContext(), coll.get()));
+
+    {
+        WriteUnitOfWork wuow(operationContext());
+        ASSERT_OK(indexer->commit(operationContext(),
+                                  coll.getWritableCollection(),
+                                  MultiIndexBlock::kNoopOnCreateEachFn,
+                                  MultiIndexBlock::kNoopOnCommitFn));
+        wuow.commit();
+    }
+
+    auto indexCatalog = coll->getIndexCatalog();
+    auto countKeys = [&](StringData indexName) {
+        auto desc = indexCatalog->findIndexByName(operationContext(), indexName);
+        ASSERT(desc);
+        int64_t numKeys;
+        IndexValidateResults fullResults;
+        indexCatalog->getEntry(desc)->accessMethod()->validate(
+            operationContext(), &numKeys, &fullResults);
+        return numKeys;
+    };
+    ASSERT_EQ(numDocs, countKeys("a_1"));
+    ASSERT_EQ(numDocs + numDocs / 2, countKeys("b_1"));
+
+    // Multikeyness detected on the key generation threads must reach the catalog.
+    auto isMultikey = [&](StringData indexName) {
+        auto desc = indexCatalog->findIndexByName(operationContext(), indexName);
+        ASSERT(desc);
+        return indexCatalog->getEntry(desc)->isMultikey();
+    };
+    ASSERT_FALSE(isMultikey("a_1"));
+    ASSERT_TRUE(isMultikey("b_1"));
+}
+
+TEST_F(MultiIndexBlockTest, RiderStopsScanningWhereCompletedSharedScanStarted) {
+    runRiderTest(operationContext(), getNSS(), getCollectionUUID(), getIndexer(), true);
+}
+
+TEST_F(MultiIndexBlockTest, RiderSkipsRecordsReceivedFromIncompleteSharedScan) {
+    runRiderTest(operationContext(), getNSS(), getCollectionUUID(), getIndexer(), false);
+}
+
+TEST_F(MultiIndexBlockTest, LeaderStartsRidersFromNewSnapshot) {
+    // Keep the leader from yielding, which would open a new snapshot on its own.
+    const auto originalYieldIterations = internalQueryExecYieldIterations.load();
+    const auto originalYieldPeriod = internalQueryExecYieldPeriodMS.load();
+    internalQueryExecYieldIterations.store(1000 * 1000);
+    internalQueryExecYieldPeriodMS.store(1000 * 1000);
+    ON_BLOCK_EXIT([&] {
+        internalQueryExecYieldIterations.store(originalYieldIterations);
+        internalQueryExecYieldPeriodMS.store(originalYieldPeriod);
+    });
+
+    auto opCtx = operationContext();
+    const int numDocs = 10;
+    auto docs = insertDocuments(opCtx, getNSS(), numDocs);
+    initIndexBuild(opCtx, getNSS(), getIndexer());
+
+    AtomicWord<OperationContext*> leaderOpCtx{nullptr};
+    Status leaderStatus = Status::OK();
+    stdx::thread leader;
+    std::shared_ptr<SharedCollectionScan::Rider> rider;
+    std::vector<RecordId> received;
+    {
+        FailPointEnableBlock fp("hangIndexBuildDuringCollectionScanPhaseAfterInsertion",
+                                BSON("fieldsToMatch" << BSON("_id" << 3)));
+        leader = insertAllDocumentsOnThread(
+            getServiceContext(), getNSS(), getIndexer(), &leaderOpCtx, &leaderStatus);
+        fp->waitForTimesEntered(fp.initialTimesEntered() + 1);
+
+        rider = SharedCollectionScanRegistry::get(getServiceContext())
+                    .join(getCollectionUUID(),
+                          RecoveryUnit::ReadSource::kNoTimestamp,
+                          [&](OperationContext*, const BSONObj&, const RecordId& loc) {
+                              received.push_back(loc);
+                              return Status::OK();
+                          });
+        ASSERT(rider);
+
+        // The leader's current snapshot does not see this document, but the rider must receive
+        // it, as its build would not intercept the write.
+        AutoGetCollection autoColl(opCtx, getNSS(), MODE_IX);
+        WriteUnitOfWork wuow(opCtx);
+        ASSERT_OK(autoColl->insertDocument(
+            opCtx, InsertStatement(BSON("_id" << numDocs << "a" << numDocs)), nullptr));
+        wuow.commit();
+    }
+    leader.join();
+    ASSERT_OK(leaderStatus);
+
+    auto ride = rider->wait(opCtx);
+    ASSERT_OK(ride.status);
+    ASSERT(ride.started);
+    ASSERT(ride.scanCompleted);
+    ASSERT_EQ(docs[3].second, *ride.joinedAfter);
+    ASSERT_EQ(static_cast<size_t>(numDocs - 4 + 1), received.size());
+    for (int i = 4; i < numDocs; ++i) {
+        ASSERT_EQ(docs[i].second, received[i - 4]);
+    }
+    ASSERT_GT(received.back(), docs.back().second);
+
+    ASSERT_EQ(numDocs + 1, commitIndexBuild(opCtx, getNSS(), getIndexer()));
+}
+
+TEST_F(MultiIndexBlockTest, InterruptedRiderIsNotResumable) {
+    auto opCtx = operationContext();
+    auto indexer = getIndexer();
+    indexer->setTwoPhaseBuildUUID(UUID::gen());
+    insertDocuments(opCtx, getNSS(), 10);
+    initIndexBuild(opCtx, getNSS(), indexer);
+
+    auto& registry = SharedCollectionScanRegistry::get(getServiceContext());
+    auto scan = registry.startScan(getCollectionUUID(), RecoveryUnit::ReadSource::kNoTimestamp);
+    ASSERT(scan);
+    ON_BLOCK_EXIT([&] { registry.finishScan(scan, false); });
+
+    AtomicWord<OperationContext*> riderOpCtx{nullptr};
+    Status riderStatus = Status::OK();
+    auto rider = insertAllDocumentsOnThread(
+        getServiceContext(), getNSS(), indexer, &riderOpCtx, &riderStatus);
+    waitForPendingRider(scan);
+    {
+        // As an abort does, kill the build and wait for it to stop while holding the collection X
+        // lock. The rider must not wait for its locks to stop.
+        AutoGetCollection autoColl(opCtx, getNSS(), MODE_X);
+        {
+            auto killedOpCtx = riderOpCtx.load();
+            ASSERT(killedOpCtx);
+            stdx::lock_guard<Client> lk(*killedOpCtx->getClient());
+            getServiceContext()->killOperation(lk, killedOpCtx, ErrorCodes::Interrupted);
+        }
+        rider.join();
+    }
+    ASSERT_EQ(ErrorCodes::Interrupted, riderStatus.code());
+
+    // The build may not be resumed from a single position in the collection, so aborting it for
+    // shutdown does not save its state.
+    {
+        AutoGetCollection autoColl(opCtx, getNSS(), MODE_X);
+        indexer->abortWithoutCleanup(opCtx, autoColl.getCollection(), true /* isResumable */);
+    }
+    for (const auto& ident :
+         getServiceContext()->getStorageEngine()->getEngine()->getAllIdents(opCtx)) {
+        ASSERT_EQ(std::string::npos, ident.find("resumable-index-build-")) << ident;
+    }
+}
+
 }  // namespace
 }  // namespace mongo
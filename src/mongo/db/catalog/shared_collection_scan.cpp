@@ -0,0 +1,197 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog/shared_collection_scan.h"
+
+#include <algorithm>
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace {
+
+const auto getSharedCollectionScanRegistry =
+    ServiceContext::declareDecoration<SharedCollectionScanRegistry>();
+
+}  // namespace
+
+bool SharedCollectionScan::RideResult::covers(const RecordId& loc) const {
+    if (!started || (joinedAfter && loc <= *joinedAfter)) {
+        return false;
+    }
+    return scanCompleted || (insertedThrough && loc <= *insertedThrough);
+}
+
+SharedCollectionScan::Rider::Rider(std::shared_ptr<SharedCollectionScan> scan, InsertFn insertFn)
+    : _scan(std::move(scan)), _insertFn(std::move(insertFn)) {}
+
+SharedCollectionScan::RideResult SharedCollectionScan::Rider::wait(OperationContext* opCtx) {
+    stdx::unique_lock<Latch> lk(_scan->_mutex);
+    try {
+        opCtx->waitForConditionOrInterrupt(_scan->_ridersDone, lk, [&] { return _done; });
+    } catch (const DBException&) {
+        // Leave the scan, so that the leader does not insert into the indexes of a build that is
+        // being torn down.
+        auto leave = [&](std::vector<std::shared_ptr<Rider>>& riders) {
+            riders.erase(std::remove_if(riders.begin(),
+                                        riders.end(),
+                                        [&](const auto& rider) { return rider.get() == this; }),
+                         riders.end());
+        };
+        leave(_scan->_pendingRiders);
+        leave(_scan->_activeRiders);
+        _scan->_updateRiderFlags(lk);
+        throw;
+    }
+    return _result;
+}
+
+SharedCollectionScan::SharedCollectionScan(UUID collectionUUID,
+                                           RecoveryUnit::ReadSource readSource)
+    : _collectionUUID(std::move(collectionUUID)), _readSource(readSource) {}
+
+void SharedCollectionScan::startPendingRiders(const boost::optional<RecordId>& lastScanned) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    for (auto&& rider : _pendingRiders) {
+        rider->_result.started = true;
+        rider->_result.joinedAfter = lastScanned;
+        _activeRiders.push_back(std::move(rider));
+    }
+    _pendingRiders.clear();
+    _updateRiderFlags(lk);
+}
+
+void SharedCollectionScan::insert(OperationContext* opCtx,
+                                  const BSONObj& doc,
+                                  const RecordId& loc) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    bool anyFailed = false;
+    for (auto&& rider : _activeRiders) {
+        auto status = rider->_insertFn(opCtx, doc, loc);
+        if (!status.isOK()) {
+            rider->_result.status = status;
+            rider->_done = true;
+            anyFailed = true;
+            continue;
+        }
+        rider->_result.insertedThrough = loc;
+        rider->_result.numInserted++;
+    }
+
+    if (anyFailed) {
+        _activeRiders.erase(std::remove_if(_activeRiders.begin(),
+                                           _activeRiders.end(),
+                                           [](const auto& rider) { return rider->_done; }),
+                            _activeRiders.end());
+        _updateRiderFlags(lk);
+        _ridersDone.notify_all();
+    }
+}
+
+std::shared_ptr<SharedCollectionScan::Rider> SharedCollectionScan::_join(
+    std::shared_ptr<SharedCollectionScan> self, InsertFn insertFn) {
+    auto rider = std::make_shared<Rider>(std::move(self), std::move(insertFn));
+    stdx::lock_guard<Latch> lk(_mutex);
+    _pendingRiders.push_back(rider);
+    _updateRiderFlags(lk);
+    return rider;
+}
+
+void SharedCollectionScan::_finish(bool scanCompleted) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    for (auto&& rider : _activeRiders) {
+        rider->_result.scanCompleted = scanCompleted;
+        rider->_done = true;
+    }
+    // Riders that never started receiving documents have to scan the whole collection.
+    for (auto&& rider : _pendingRiders) {
+        rider->_done = true;
+    }
+    _activeRiders.clear();
+    _pendingRiders.clear();
+    _updateRiderFlags(lk);
+    _ridersDone.notify_all();
+}
+
+void SharedCollectionScan::_updateRiderFlags(WithLock) {
+    _hasPendingRiders.store(!_pendingRiders.empty());
+    _hasActiveRiders.store(!_activeRiders.empty());
+}
+
+SharedCollectionScanRegistry& SharedCollectionScanRegistry::get(ServiceContext* service) {
+    return getSharedCollectionScanRegistry(service);
+}
+
+std::shared_ptr<SharedCollectionScan> SharedCollectionScanRegistry::startScan(
+    const UUID& collectionUUID, RecoveryUnit::ReadSource readSource) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto scan = std::make_shared<SharedCollectionScan>(collectionUUID, readSource);
+    if (!_scans.emplace(collectionUUID, scan).second) {
+        return nullptr;
+    }
+    return scan;
+}
+
+void SharedCollectionScanRegistry::finishScan(const std::shared_ptr<SharedCollectionScan>& scan,
+                                              bool scanCompleted) {
+    {
+        // Once unregistered, no more riders can join the scan.
+        stdx::lock_guard<Latch> lk(_mutex);
+        auto it = _scans.find(scan->collectionUUID());
+        invariant(it != _scans.end() && it->second == scan);
+        _scans.erase(it);
+    }
+    scan->_finish(scanCompleted);
+}
+
+std::shared_ptr<SharedCollectionScan::Rider> SharedCollectionScanRegistry::join(
+    const UUID& collectionUUID,
+    RecoveryUnit::ReadSource readSource,
+    SharedCollectionScan::InsertFn insertFn) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto it = _scans.find(collectionUUID);
+    if (it == _scans.end()) {
+        return nullptr;
+    }
+
+    // A leader reading at the majority commit point only sees all writes before the rider set up
+    // its indexes if the rider waited for those writes to be majority committed, which builds
+    // reading at the majority commit point have done.
+    auto& scan = it->second;
+    if (scan->readSource() != RecoveryUnit::ReadSource::kNoTimestamp &&
+        scan->readSource() != readSource) {
+        return nullptr;
+    }
+    return scan->_join(scan, std::move(insertFn));
+}
+
+}  // namespace mongo
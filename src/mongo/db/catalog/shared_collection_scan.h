@@ -0,0 +1,222 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/recovery_unit.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+/**
+ * A collection scan by one index build that builds of the same collection starting later can ride
+ * along on, rather than each scanning the whole collection.
+ *
+ * The build that scans, the leader, hands every document it scans to its riders through insert().
+ * A rider joins at the leader's current position and receives every document after it. Once the
+ * leader reaches the end of the collection, the rider only has to scan the records up to the
+ * position at which it joined.
+ */
+class SharedCollectionScan {
+    SharedCollectionScan(const SharedCollectionScan&) = delete;
+    SharedCollectionScan& operator=(const SharedCollectionScan&) = delete;
+
+public:
+    /**
+     * Inserts a document scanned by the leader into the indexes of a rider. Runs on the leader's
+     * thread, with the leader's OperationContext.
+     */
+    using InsertFn = std::function<Status(OperationContext*, const BSONObj&, const RecordId&)>;
+
+    /**
+     * The range of records a rider received from the leader's scan.
+     */
+    struct RideResult {
+        /**
+         * Returns true if the rider received the record 'loc' from the leader, or would have if
+         * the record existed.
+         */
+        bool covers(const RecordId& loc) const;
+
+        // Whether the leader handed any documents to the rider.
+        bool started = false;
+
+        // The rider received the records after this one, or from the start of the collection if
+        // not set.
+        boost::optional<RecordId> joinedAfter;
+
+        // The last record the rider received.
+        boost::optional<RecordId> insertedThrough;
+
+        // Whether the leader scanned to the end of the collection, so the rider received every
+        // record after 'joinedAfter'.
+        bool scanCompleted = false;
+
+        long long numInserted = 0;
+
+        // The error inserting into the rider's indexes, which ended the ride.
+        Status status = Status::OK();
+    };
+
+    /**
+     * A build riding along on the scan.
+     */
+    class Rider {
+    public:
+        Rider(std::shared_ptr<SharedCollectionScan> scan, InsertFn insertFn);
+
+        /**
+         * Waits until the leader stops handing documents to this rider, either because its scan
+         * ended or because inserting into this rider failed. If 'opCtx' is interrupted, the rider
+         * leaves the scan, and the leader no longer uses it, before this throws.
+         */
+        RideResult wait(OperationContext* opCtx);
+
+    private:
+        friend class SharedCollectionScan;
+
+        const std::shared_ptr<SharedCollectionScan> _scan;
+        const InsertFn _insertFn;
+
+        // Guarded by the scan's mutex.
+        bool _done = false;
+        RideResult _result;
+    };
+
+    SharedCollectionScan(UUID collectionUUID, RecoveryUnit::ReadSource readSource);
+
+    const UUID& collectionUUID() const {
+        return _collectionUUID;
+    }
+
+    RecoveryUnit::ReadSource readSource() const {
+        return _readSource;
+    }
+
+    /**
+     * Returns true if riders joined that the leader has not started handing documents to.
+     */
+    bool hasPendingRiders() const {
+        return _hasPendingRiders.load();
+    }
+
+    /**
+     * Returns true if the leader hands the documents it scans to any riders.
+     */
+    bool hasActiveRiders() const {
+        return _hasActiveRiders.load();
+    }
+
+    /**
+     * Starts handing the documents scanned after 'lastScanned', or all documents if not set, to
+     * the riders that joined since the last call.
+     *
+     * The leader must have opened a new storage snapshot since those riders joined. A rider's
+     * index build intercepts the writes that happen after it set up its indexes, so the documents
+     * the leader hands to it must reflect all writes before that.
+     */
+    void startPendingRiders(const boost::optional<RecordId>& lastScanned);
+
+    /**
+     * Inserts the document into the indexes of the active riders. A rider that fails to insert it
+     * stops receiving documents and sees the error in its RideResult.
+     */
+    void insert(OperationContext* opCtx, const BSONObj& doc, const RecordId& loc);
+
+private:
+    friend class SharedCollectionScanRegistry;
+
+    std::shared_ptr<Rider> _join(std::shared_ptr<SharedCollectionScan> self, InsertFn insertFn);
+
+    void _finish(bool scanCompleted);
+
+    void _updateRiderFlags(WithLock);
+
+    const UUID _collectionUUID;
+    const RecoveryUnit::ReadSource _readSource;
+
+    AtomicWord<bool> _hasPendingRiders{false};
+    AtomicWord<bool> _hasActiveRiders{false};
+
+    Mutex _mutex = MONGO_MAKE_LATCH("SharedCollectionScan::_mutex");
+    stdx::condition_variable _ridersDone;
+    std::vector<std::shared_ptr<Rider>> _pendingRiders;
+    std::vector<std::shared_ptr<Rider>> _activeRiders;
+};
+
+/**
+ * Tracks the collection scans of the index builds in progress that other builds may ride along
+ * on. There is at most one such scan per collection.
+ */
+class SharedCollectionScanRegistry {
+public:
+    static SharedCollectionScanRegistry& get(ServiceContext* service);
+
+    /**
+     * Registers a collection scan by an index build reading with 'readSource'. Returns nullptr if
+     * another build already registered a scan of the collection.
+     */
+    std::shared_ptr<SharedCollectionScan> startScan(const UUID& collectionUUID,
+                                                    RecoveryUnit::ReadSource readSource);
+
+    /**
+     * Unregisters the scan and ends the ride of all of its riders. 'scanCompleted' is true if the
+     * leader scanned to the end of the collection.
+     */
+    void finishScan(const std::shared_ptr<SharedCollectionScan>& scan, bool scanCompleted);
+
+    /**
+     * Joins the registered scan of the collection, if there is one that an index build reading
+     * with 'readSource' may ride along on. Returns nullptr otherwise.
+     */
+    std::shared_ptr<SharedCollectionScan::Rider> join(const UUID& collectionUUID,
+                                                      RecoveryUnit::ReadSource readSource,
+                                                      SharedCollectionScan::InsertFn insertFn);
+
+private:
+    Mutex _mutex = MONGO_MAKE_LATCH("SharedCollectionScanRegistry::_mutex");
+    stdx::unordered_map<UUID, std::shared_ptr<SharedCollectionScan>, UUID::Hash> _scans;
+};
+
+}  // namespace mongo
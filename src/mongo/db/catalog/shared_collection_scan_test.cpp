@@ -0,0 +1,194 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog/shared_collection_scan.h"
+
+#include "mongo/db/service_context_test_fixture.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using ReadSource = RecoveryUnit::ReadSource;
+
+class SharedCollectionScanTest : public ServiceContextTest {
+protected:
+    SharedCollectionScanRegistry& registry() {
+        return SharedCollectionScanRegistry::get(getServiceContext());
+    }
+
+    /**
+     * Returns an InsertFn that records the RecordIds of the documents it receives in 'inserted'.
+     */
+    SharedCollectionScan::InsertFn recordInto(std::vector<RecordId>* inserted) {
+        return [inserted](OperationContext*, const BSONObj&, const RecordId& loc) {
+            inserted->push_back(loc);
+            return Status::OK();
+        };
+    }
+
+    const UUID _collectionUUID = UUID::gen();
+    const BSONObj _doc = BSON("a" << 1);
+};
+
+TEST_F(SharedCollectionScanTest, RiderReceivesDocumentsAfterJoining) {
+    auto opCtx = makeOperationContext();
+    auto scan = registry().startScan(_collectionUUID, ReadSource::kNoTimestamp);
+    ASSERT(scan);
+
+    // Only one build may lead the scan of a collection.
+    ASSERT_FALSE(registry().startScan(_collectionUUID, ReadSource::kNoTimestamp));
+
+    scan->insert(opCtx.get(), _doc, RecordId(1));
+
+    std::vector<RecordId> inserted;
+    auto rider = registry().join(_collectionUUID, ReadSource::kNoTimestamp, recordInto(&inserted));
+    ASSERT(rider);
+    ASSERT_TRUE(scan->hasPendingRiders());
+    ASSERT_FALSE(scan->hasActiveRiders());
+
+    // Documents scanned before the rider starts are not handed to it.
+    scan->insert(opCtx.get(), _doc, RecordId(2));
+    scan->startPendingRiders(RecordId(2));
+    ASSERT_FALSE(scan->hasPendingRiders());
+    ASSERT_TRUE(scan->hasActiveRiders());
+
+    scan->insert(opCtx.get(), _doc, RecordId(3));
+    scan->insert(opCtx.get(), _doc, RecordId(4));
+    registry().finishScan(scan, true /* scanCompleted */);
+
+    auto ride = rider->wait(opCtx.get());
+    ASSERT_OK(ride.status);
+    ASSERT_TRUE(ride.started);
+    ASSERT_TRUE(ride.scanCompleted);
+    ASSERT_EQ(RecordId(2), *ride.joinedAfter);
+    ASSERT_EQ(2, ride.numInserted);
+    ASSERT(inserted == std::vector<RecordId>({RecordId(3), RecordId(4)}));
+
+    ASSERT_FALSE(ride.covers(RecordId(1)));
+    ASSERT_FALSE(ride.covers(RecordId(2)));
+    ASSERT_TRUE(ride.covers(RecordId(3)));
+    ASSERT_TRUE(ride.covers(RecordId(10)));
+
+    // The finished scan can no longer be joined.
+    ASSERT_FALSE(registry().join(_collectionUUID, ReadSource::kNoTimestamp, recordInto(&inserted)));
+}
+
+TEST_F(SharedCollectionScanTest, IncompleteScanCoversOnlyDocumentsInserted) {
+    auto opCtx = makeOperationContext();
+    auto scan = registry().startScan(_collectionUUID, ReadSource::kNoTimestamp);
+
+    std::vector<RecordId> inserted;
+    auto rider = registry().join(_collectionUUID, ReadSource::kNoTimestamp, recordInto(&inserted));
+    scan->startPendingRiders(boost::none);
+    scan->insert(opCtx.get(), _doc, RecordId(1));
+    scan->insert(opCtx.get(), _doc, RecordId(2));
+    registry().finishScan(scan, false /* scanCompleted */);
+
+    auto ride = rider->wait(opCtx.get());
+    ASSERT_OK(ride.status);
+    ASSERT_FALSE(ride.scanCompleted);
+    ASSERT_FALSE(ride.joinedAfter);
+    ASSERT_TRUE(ride.covers(RecordId(1)));
+    ASSERT_TRUE(ride.covers(RecordId(2)));
+    ASSERT_FALSE(ride.covers(RecordId(3)));
+}
+
+TEST_F(SharedCollectionScanTest, RiderThatNeverStartedCoversNothing) {
+    auto opCtx = makeOperationContext();
+    auto scan = registry().startScan(_collectionUUID, ReadSource::kNoTimestamp);
+
+    std::vector<RecordId> inserted;
+    auto rider = registry().join(_collectionUUID, ReadSource::kNoTimestamp, recordInto(&inserted));
+    scan->insert(opCtx.get(), _doc, RecordId(1));
+    registry().finishScan(scan, true /* scanCompleted */);
+
+    auto ride = rider->wait(opCtx.get());
+    ASSERT_OK(ride.status);
+    ASSERT_FALSE(ride.started);
+    ASSERT_FALSE(ride.covers(RecordId(1)));
+    ASSERT_TRUE(inserted.empty());
+}
+
+TEST_F(SharedCollectionScanTest, FailedInsertEndsRide) {
+    auto opCtx = makeOperationContext();
+    auto scan = registry().startScan(_collectionUUID, ReadSource::kNoTimestamp);
+
+    int numCalls = 0;
+    auto rider = registry().join(
+        _collectionUUID,
+        ReadSource::kNoTimestamp,
+        [&](OperationContext*, const BSONObj&, const RecordId&) -> Status {
+            ++numCalls;
+            return {ErrorCodes::InternalError, "failed insert"};
+        });
+    scan->startPendingRiders(boost::none);
+    scan->insert(opCtx.get(), _doc, RecordId(1));
+    ASSERT_FALSE(scan->hasActiveRiders());
+
+    // The rider learns of the error without waiting for the scan to finish.
+    auto ride = rider->wait(opCtx.get());
+    ASSERT_EQ(ErrorCodes::InternalError, ride.status);
+
+    scan->insert(opCtx.get(), _doc, RecordId(2));
+    ASSERT_EQ(1, numCalls);
+    registry().finishScan(scan, true /* scanCompleted */);
+}
+
+TEST_F(SharedCollectionScanTest, InterruptedRiderLeavesScan) {
+    auto opCtx = makeOperationContext();
+    auto scan = registry().startScan(_collectionUUID, ReadSource::kNoTimestamp);
+
+    std::vector<RecordId> inserted;
+    auto rider = registry().join(_collectionUUID, ReadSource::kNoTimestamp, recordInto(&inserted));
+    scan->startPendingRiders(boost::none);
+
+    opCtx->markKilled(ErrorCodes::Interrupted);
+    ASSERT_THROWS_CODE(rider->wait(opCtx.get()), DBException, ErrorCodes::Interrupted);
+    ASSERT_FALSE(scan->hasActiveRiders());
+
+    scan->insert(opCtx.get(), _doc, RecordId(1));
+    ASSERT_TRUE(inserted.empty());
+    registry().finishScan(scan, true /* scanCompleted */);
+}
+
+TEST_F(SharedCollectionScanTest, MajorityReadScanOnlyJoinedByMajorityReadBuilds) {
+    auto scan = registry().startScan(_collectionUUID, ReadSource::kMajorityCommitted);
+
+    std::vector<RecordId> inserted;
+    ASSERT_FALSE(registry().join(_collectionUUID, ReadSource::kNoTimestamp, recordInto(&inserted)));
+    ASSERT(registry().join(
+        _collectionUUID, ReadSource::kMajorityCommitted, recordInto(&inserted)));
+    registry().finishScan(scan, false /* scanCompleted */);
+}
+
+}  // namespace
+}  // namespace mongo
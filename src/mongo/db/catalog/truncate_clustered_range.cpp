@@ -0,0 +1,107 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog/truncate_clustered_range.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/op_observer.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/clustered_by_time.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/write_unit_of_work.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+TruncateClusteredRangeResult truncateClusteredRange(OperationContext* opCtx,
+                                                    const CollectionPtr& collection,
+                                                    Date_t before,
+                                                    long long maxDocs) {
+    invariant(opCtx->lockState()->isCollectionLockedForMode(collection->ns(), MODE_X));
+
+    TruncateClusteredRangeResult result;
+    result.removedBefore = before;
+    long long dataSize = 0;
+
+    WriteUnitOfWork wuow(opCtx);
+
+    // The records are ordered by time, so the ones to remove are a prefix of the collection.
+    auto cursor = collection->getCursor(opCtx);
+    Date_t lastRemoved;
+    while (auto record = cursor->next()) {
+        const Date_t time = clustered_by_time::timeOf(record->id);
+        if (time >= before) {
+            break;
+        }
+        if (result.numRemoved >= maxDocs && time > lastRemoved) {
+            result.removedBefore = time;
+            break;
+        }
+
+        collection->getIndexCatalog()->unindexRecord(
+            opCtx, record->data.toBson(), record->id, false, nullptr);
+        ++result.numRemoved;
+        dataSize += record->data.size();
+        lastRemoved = time;
+    }
+    cursor.reset();
+
+    if (result.numRemoved == 0) {
+        return result;
+    }
+
+    const RecordId end = clustered_by_time::minRecordId(result.removedBefore);
+    collection->getRecordStore()->truncateRange(opCtx, end, result.numRemoved, dataSize);
+    opCtx->getServiceContext()->getOpObserver()->onTruncateRange(
+        opCtx, collection->ns(), collection->uuid(), result.removedBefore);
+
+    wuow.commit();
+    return result;
+}
+
+Status truncateClusteredRangeForApplyOps(OperationContext* opCtx,
+                                         const NamespaceString& collectionName,
+                                         Date_t before) {
+    AutoGetCollection collection(opCtx, collectionName, MODE_X);
+    if (!collection) {
+        return Status(ErrorCodes::NamespaceNotFound,
+                      str::stream() << "Cannot truncate a range of a non-existent collection: "
+                                    << collectionName);
+    }
+
+    truncateClusteredRange(opCtx, collection.getCollection(), before);
+    return Status::OK();
+}
+
+}  // namespace mongo
@@ -0,0 +1,73 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <limits>
+
+#include "mongo/base/status.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+class CollectionPtr;
+class NamespaceString;
+class OperationContext;
+
+struct TruncateClusteredRangeResult {
+    // The number of documents removed.
+    long long numRemoved = 0;
+    // Every document with a clustering time before this was removed.
+    Date_t removedBefore;
+};
+
+/**
+ * Removes the oldest documents of 'collection', which must be clustered by time, up to but
+ * excluding those with a clustering time of 'before' or later. The records are removed with a
+ * single record store truncate, their index keys one by one, and the removal is logged as one
+ * 'truncateRange' oplog entry.
+ *
+ * At most about 'maxDocs' documents are removed. The range always ends on a millisecond boundary
+ * so that another node applying the oplog entry removes exactly the same documents.
+ *
+ * The caller must hold the collection lock in MODE_X and handle write conflicts.
+ */
+TruncateClusteredRangeResult truncateClusteredRange(
+    OperationContext* opCtx,
+    const CollectionPtr& collection,
+    Date_t before,
+    long long maxDocs = std::numeric_limits<long long>::max());
+
+/**
+ * Applies a 'truncateRange' oplog entry for the collection 'collectionName'.
+ */
+Status truncateClusteredRangeForApplyOps(OperationContext* opCtx,
+                                         const NamespaceString& collectionName,
+                                         Date_t before);
+
+}  // namespace mongo
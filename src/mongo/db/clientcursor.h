@@ -249,6 +249,13 @@ public:
         return StringData(_planSummary);
     }
 
+    /**
+     * Returns the hash of the shape of the query which created this cursor, if it has one.
+     */
+    boost::optional<uint32_t> getQueryHash() const {
+        return _queryHash;
+    }
+
     /**
      * Returns a generic cursor containing diagnostics about this cursor.
      * The caller must either have this cursor pinned or hold a mutex from the cursor manager.
@@ -417,6 +424,9 @@ private:
     // A string with the plan summary of the cursor's query.
     std::string _planSummary;
 
+    // The hash of the shape of the cursor's query, see OpDebug::queryHash.
+    const boost::optional<uint32_t> _queryHash;
+
     // Commit point at the time the last batch was returned. This is only used by internal exhaust
     // oplog fetching. Also see lastKnownCommittedOpTime in GetMoreRequest.
     boost::optional<repl::OpTime> _lastKnownCommittedOpTime;
@@ -85,6 +85,7 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/stats/storage_stats.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/storage/storage_engine_init.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/logv2/log.h"
@@ -321,6 +322,8 @@ public:
             << "  viewOn: <string: name of source collection or view>,\n"
             << "  pipeline: <array<object>: aggregation pipeline stage>,\n"
             << "  collation: <document: default collation for the collection or view>,\n"
+            << "  clusteredByTime: <string: Date field that orders the collection's records>,\n"
+            << "  expireAfterSeconds: <int: seconds after the clustering time to remove>,\n"
             << "  writeConcern: <document: write concern expression for the operation>]\n"
             << "}";
     }
@@ -372,6 +375,21 @@ public:
                          transport::Session::kInternalClient));
         }
 
+        // Clustering records by time needs support from the storage engine's record store, and
+        // a featureCompatibilityVersion whose binaries all understand the collection option and
+        // the 'truncateRange' oplog entries that remove its expired documents.
+        if (cmd.getClusteredByTime()) {
+            uassert(ErrorCodes::InvalidOptions,
+                    str::stream() << "the 'clusteredByTime' option is not supported by the "
+                                  << "storage engine",
+                    opCtx->getServiceContext()->getStorageEngine()->supportsClusteredByTime());
+            uassert(ErrorCodes::InvalidOptions,
+                    "the 'clusteredByTime' option requires featureCompatibilityVersion 4.9",
+                    serverGlobalParams.featureCompatibility.isVersionInitialized() &&
+                        serverGlobalParams.featureCompatibility.isGreaterThanOrEqualTo(
+                            ServerGlobalParams::FeatureCompatibility::Version::kVersion49));
+        }
+
         // Validate _id index spec and fill in missing fields.
         if (cmd.getIdIndex()) {
             auto idIndexSpec = *cmd.getIdIndex();
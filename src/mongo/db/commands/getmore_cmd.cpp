@@ -536,6 +536,9 @@ public:
                 curOp->setGenericCursor_inlock(cursorPin->toGenericCursor());
             }
 
+            // Attribute the cost of this batch to the shape of the cursor's query.
+            curOp->debug().queryHash = cursorPin->getQueryHash();
+
             // If the 'failGetMoreAfterCursorCheckout' failpoint is enabled, throw an exception with
             // the given 'errorCode' value, or ErrorCodes::InternalError if 'errorCode' is omitted.
             failGetMoreAfterCursorCheckout.executeIf(
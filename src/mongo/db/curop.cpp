@@ -40,6 +40,7 @@
 #include "mongo/bson/mutable/document.h"
 #include "mongo/config.h"
 #include "mongo/db/auth/authorization_manager.h"
+#include "mongo/db/bytes_read_tracker.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/server_status_metric.h"
@@ -50,6 +51,7 @@
 #include "mongo/db/profile_filter.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/stats/query_shape_stats.h"
 #include "mongo/db/stats/resource_consumption_metrics.h"
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/metadata/client_metadata.h"
@@ -513,6 +515,8 @@ bool CurOp::completeAndLogOperation(OperationContext* opCtx,
         shouldProfileAtLevel1 = shouldLogSlowOp && shouldSample;
     }
 
+    _recordQueryShapeStats(opCtx);
+
     if (forceLog || shouldLogSlowOp) {
         auto lockerInfo = opCtx->lockState()->getLockerInfo(_lockStatsBase);
         if (_debug.storageStats == nullptr && opCtx->lockState()->wasGlobalLockTaken() &&
@@ -579,6 +583,24 @@ bool CurOp::completeAndLogOperation(OperationContext* opCtx,
     return shouldProfileAtLevel1;
 }
 
+void CurOp::_recordQueryShapeStats(OperationContext* opCtx) {
+    if (!_debug.queryHash || !QueryShapeStats::isEnabled()) {
+        return;
+    }
+
+    QueryShapeStats::Metrics metrics;
+    // A getMore adds the cost of its batch to the query which created the cursor.
+    metrics.execCount = _logicalOp == LogicalOp::opGetMore ? 0 : 1;
+    if (auto cpuTime = QueryShapeStats::getOperationCPUTime(opCtx)) {
+        metrics.cpuNanos = durationCount<Nanoseconds>(*cpuTime);
+    }
+    metrics.docsExamined = _debug.additiveMetrics.docsExamined.value_or(0);
+    metrics.keysExamined = _debug.additiveMetrics.keysExamined.value_or(0);
+    metrics.docBytesRead = BytesReadTracker::get(opCtx).getDocBytesRead();
+
+    QueryShapeStats::get(opCtx).add(getNSS(), *_debug.queryHash, metrics);
+}
+
 Command::ReadWriteType CurOp::getReadWriteType() const {
     if (_command) {
         return _command->getReadWriteType();
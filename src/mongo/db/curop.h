@@ -753,6 +753,11 @@ private:
     Microseconds computeElapsedTimeTotal(TickSource::Tick startTime,
                                          TickSource::Tick endTime) const;
 
+    /**
+     * Adds the cost of this operation to the statistics of its query shape, if it has one.
+     */
+    void _recordQueryShapeStats(OperationContext* opCtx);
+
     static const OperationContext::Decoration<CurOpStack> _curopStack;
 
     CurOp(OperationContext*, CurOpStack*);
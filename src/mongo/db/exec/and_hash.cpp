@@ -29,6 +29,7 @@
 
 #include "mongo/db/exec/and_hash.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/db/exec/and_common.h"
@@ -55,9 +56,10 @@ const size_t AndHashStage::kLookAheadWorks = 10;
 // static
 const char* AndHashStage::kStageType = "AND_HASH";
 
-AndHashStage::AndHashStage(ExpressionContext* expCtx, WorkingSet* ws)
+AndHashStage::AndHashStage(ExpressionContext* expCtx, WorkingSet* ws, bool recordIdsOnly)
     : PlanStage(kStageType, expCtx),
       _ws(ws),
+      _recordIdsOnly(recordIdsOnly),
       _hashingChildren(true),
       _currentChild(0),
       _memUsage(0),
@@ -93,7 +95,7 @@ bool AndHashStage::isEOF() {
     // Or we're streaming in results from the last child.
 
     // If there's nothing to probe against, we're EOF.
-    if (_dataMap.empty()) {
+    if (intersectionIsEmpty()) {
         return true;
     }
 
@@ -134,6 +136,7 @@ PlanStage::StageState AndHashStage::doWork(WorkingSetID* out) {
                     // A child went right to EOF.  Bail out.
                     _hashingChildren = false;
                     _dataMap.clear();
+                    _recordIds.clear();
                     return PlanStage::IS_EOF;
                 } else if (PlanStage::ADVANCED == childStatus) {
                     // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we
@@ -164,9 +167,9 @@ PlanStage::StageState AndHashStage::doWork(WorkingSetID* out) {
         }
 
         if (0 == _currentChild) {
-            return readFirstChild(out);
+            return _recordIdsOnly ? readFirstChildRecordIds(out) : readFirstChild(out);
         } else if (_currentChild < _children.size() - 1) {
-            return hashOtherChildren(out);
+            return _recordIdsOnly ? intersectOtherChildRecordIds(out) : hashOtherChildren(out);
         } else {
             _hashingChildren = false;
             // We don't hash our last child.  Instead, we probe the table created from the
@@ -177,6 +180,9 @@ PlanStage::StageState AndHashStage::doWork(WorkingSetID* out) {
 
     // Returning results.  We read from the last child and return the results that are in our
     // hash map.
+    if (_recordIdsOnly) {
+        return probeRecordIds(out);
+    }
 
     // We should be EOF if we're not hashing results and the dataMap is empty.
     verify(!_dataMap.empty());
@@ -357,10 +363,130 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
     }
 }
 
+boost::optional<size_t> AndHashStage::findRecordId(const RecordId& recordId) const {
+    auto it = std::lower_bound(_recordIds.begin(), _recordIds.end(), recordId);
+    if (it == _recordIds.end() || *it != recordId) {
+        return boost::none;
+    }
+    return it - _recordIds.begin();
+}
+
+PlanStage::StageState AndHashStage::readFirstChildRecordIds(WorkingSetID* out) {
+    verify(_currentChild == 0);
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState childStatus = workChild(0, &id);
+
+    if (PlanStage::ADVANCED == childStatus) {
+        WorkingSetMember* member = _ws->get(id);
+        invariant(member->hasRecordId());
+
+        // Duplicates are removed once the child is exhausted.
+        _recordIds.push_back(member->recordId);
+        _ws->free(id);
+
+        _memUsage += sizeof(RecordId);
+        return PlanStage::NEED_TIME;
+    } else if (PlanStage::IS_EOF == childStatus) {
+        _currentChild = 1;
+
+        std::sort(_recordIds.begin(), _recordIds.end());
+        _recordIds.erase(std::unique(_recordIds.begin(), _recordIds.end()), _recordIds.end());
+        _recordIds.shrink_to_fit();
+        _recordIdsSeen.assign(_recordIds.size(), false);
+        _memUsage = _recordIds.size() * sizeof(RecordId) + _recordIdsSeen.size() / 8;
+
+        if (_recordIds.empty()) {
+            _hashingChildren = false;
+            return PlanStage::IS_EOF;
+        }
+
+        _specificStats.mapAfterChild.push_back(_recordIds.size());
+        return PlanStage::NEED_TIME;
+    } else {
+        if (PlanStage::NEED_YIELD == childStatus) {
+            *out = id;
+        }
+
+        return childStatus;
+    }
+}
+
+PlanStage::StageState AndHashStage::intersectOtherChildRecordIds(WorkingSetID* out) {
+    verify(_currentChild > 0);
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState childStatus = workChild(_currentChild, &id);
+
+    if (PlanStage::ADVANCED == childStatus) {
+        WorkingSetMember* member = _ws->get(id);
+        invariant(member->hasRecordId());
+
+        if (auto pos = findRecordId(member->recordId)) {
+            _recordIdsSeen[*pos] = true;
+        }
+        _ws->free(id);
+        return PlanStage::NEED_TIME;
+    } else if (PlanStage::IS_EOF == childStatus) {
+        ++_currentChild;
+
+        // Keep the record ids which this child produced. Their order is preserved.
+        size_t kept = 0;
+        for (size_t i = 0; i < _recordIds.size(); ++i) {
+            if (_recordIdsSeen[i]) {
+                _recordIds[kept++] = _recordIds[i];
+            }
+        }
+        _recordIds.resize(kept);
+        _recordIdsSeen.assign(_recordIds.size(), false);
+        _memUsage = _recordIds.size() * sizeof(RecordId) + _recordIdsSeen.size() / 8;
+
+        _specificStats.mapAfterChild.push_back(_recordIds.size());
+
+        if (_recordIds.empty()) {
+            _hashingChildren = false;
+            return PlanStage::IS_EOF;
+        }
+
+        return PlanStage::NEED_TIME;
+    } else {
+        if (PlanStage::NEED_YIELD == childStatus) {
+            *out = id;
+        }
+
+        return childStatus;
+    }
+}
+
+PlanStage::StageState AndHashStage::probeRecordIds(WorkingSetID* out) {
+    verify(!_recordIds.empty());
+    verify(_currentChild == _children.size() - 1);
+
+    StageState childStatus = workChild(_children.size() - 1, out);
+    if (PlanStage::ADVANCED != childStatus) {
+        return childStatus;
+    }
+
+    WorkingSetMember* member = _ws->get(*out);
+    invariant(member->hasRecordId());
+
+    // While probing, '_recordIdsSeen' marks the record ids that were already output, so that a
+    // record id which the last child produces more than once is output once.
+    auto pos = findRecordId(member->recordId);
+    if (!pos || _recordIdsSeen[*pos]) {
+        _ws->free(*out);
+        return PlanStage::NEED_TIME;
+    }
+
+    _recordIdsSeen[*pos] = true;
+    return PlanStage::ADVANCED;
+}
+
 unique_ptr<PlanStageStats> AndHashStage::getStats() {
     _commonStats.isEOF = isEOF();
 
     _specificStats.memLimit = _maxMemUsage;
+    _specificStats.recordIdsOnly = _recordIdsOnly;
     _specificStats.memUsage = _memUsage;
 
     unique_ptr<PlanStageStats> ret = std::make_unique<PlanStageStats>(_commonStats, STAGE_AND_HASH);
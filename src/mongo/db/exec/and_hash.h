@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
@@ -44,11 +45,17 @@ namespace mongo {
  * Reads from N children, each of which must have a valid RecordId. Uses a hash table to intersect
  * the outputs of the N children based on their record ids, and outputs the intersection.
  *
+ * If 'recordIdsOnly' is true, the data of the WorkingSetMembers produced by all children but the
+ * last is not needed, as is the case when the documents are fetched after the intersection. Then
+ * only the record ids of those children are kept, in a sorted array of 8 bytes per record, and
+ * the output is the last child's WorkingSetMember for each record id in the intersection. This
+ * lets the stage intersect far more results within its memory limit.
+ *
  * Preconditions: Valid RecordId. More than one child.
  */
 class AndHashStage final : public PlanStage {
 public:
-    AndHashStage(ExpressionContext* expCtx, WorkingSet* ws);
+    AndHashStage(ExpressionContext* expCtx, WorkingSet* ws, bool recordIdsOnly = false);
 
     /**
      * For testing only. Allows tests to set memory usage threshold.
@@ -83,6 +90,26 @@ private:
     StageState hashOtherChildren(WorkingSetID* out);
     StageState workChild(size_t childNo, WorkingSetID* out);
 
+    /**
+     * Versions of readFirstChild(), hashOtherChildren() and the probe with the last child which
+     * keep only the record ids of the children's results. Used if '_recordIdsOnly' is true.
+     */
+    StageState readFirstChildRecordIds(WorkingSetID* out);
+    StageState intersectOtherChildRecordIds(WorkingSetID* out);
+    StageState probeRecordIds(WorkingSetID* out);
+
+    /**
+     * Returns the position of 'recordId' in '_recordIds', or boost::none if it is not there.
+     */
+    boost::optional<size_t> findRecordId(const RecordId& recordId) const;
+
+    /**
+     * True if the intersection of the children read so far is empty.
+     */
+    bool intersectionIsEmpty() const {
+        return _recordIdsOnly ? _recordIds.empty() : _dataMap.empty();
+    }
+
     // Not owned by us.
     WorkingSet* _ws;
 
@@ -101,6 +128,14 @@ private:
     typedef stdx::unordered_set<RecordId, RecordId::Hasher> SeenMap;
     SeenMap _seenMap;
 
+    // If true, '_recordIds' and '_recordIdsSeen' are used in place of '_dataMap' and '_seenMap'.
+    const bool _recordIdsOnly = false;
+
+    // The record ids in the intersection of the children read so far, sorted once the first child
+    // is exhausted. '_recordIdsSeen[i]' is set once the current child produces '_recordIds[i]'.
+    std::vector<RecordId> _recordIds;
+    std::vector<bool> _recordIdsSeen;
+
     // True if we're still intersecting _children[0..._children.size()-1].
     bool _hashingChildren;
 
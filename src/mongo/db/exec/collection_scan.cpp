@@ -41,6 +41,7 @@
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/logv2/log.h"
@@ -64,6 +65,9 @@ CollectionScan::CollectionScan(ExpressionContext* expCtx,
     : RequiresCollectionStage(kStageType, expCtx, collection),
       _workingSet(workingSet),
       _filter((filter && !filter->isTriviallyTrue()) ? filter : nullptr),
+      _compiledFilter(_filter && internalQueryCompileMatchExpressions.load()
+                          ? CompiledMatchExpression::compile(_filter)
+                          : nullptr),
       _params(params) {
     // Explain reports the direction of the collection scan.
     _specificStats.direction = params.direction;
@@ -254,7 +258,7 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
                                                       WorkingSetID memberID,
                                                       WorkingSetID* out) {
     ++_specificStats.docsTested;
-    if (Filter::passes(member, _filter)) {
+    if (Filter::passes(member, _filter, _compiledFilter.get())) {
         if (_params.stopApplyingFilterAfterFirstMatch) {
             _filter = nullptr;
         }
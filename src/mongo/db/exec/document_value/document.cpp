@@ -118,7 +118,7 @@ bool DocumentStorageIterator::shouldSkipDeleted() {
             _it = nullptr;
         }
     } else if (!atEnd()) {
-        if (_it->val.missing() || _it->kind == ValueElement::Kind::kCached) {
+        if (_it->val.missing() || _it->hasImageInBson()) {
             return true;
         }
     }
@@ -174,7 +174,10 @@ Position DocumentStorage::constructInCache(const BSONElement& elem) {
     auto savedModified = _modified;
     auto pos = getNextPosition();
     const auto fieldName = elem.fieldNameStringData();
-    appendField(fieldName, ValueElement::Kind::kCached) = Value(elem);
+    // Nested objects are copied rather than sharing the backing buffer, as a subdocument kept by a
+    // stage (a $group key or accumulator, a $sort key) would otherwise keep the whole parent
+    // alive while being charged only for its own size.
+    appendField(fieldName, ValueElement::Kind::kCachedUnmodified) = Value(elem);
     _modified = savedModified;
 
     return pos;
@@ -208,7 +211,7 @@ Value& DocumentStorage::appendField(StringData name, ValueElement::Kind kind) {
 #undef append
 
     // Make sure next field starts where we expect it
-    fassert(16486, getField(pos).next()->ptr() == _cache + _usedBytes);
+    fassert(16486, elementAt(pos).next()->ptr() == _cache + _usedBytes);
 
     _numFields++;
 
@@ -219,12 +222,12 @@ Value& DocumentStorage::appendField(StringData name, ValueElement::Kind kind) {
         rehash();
     }
 
-    return getField(pos).val;
+    return elementAt(pos).val;
 }
 
 // Call after adding field to _fields and increasing _numFields
 void DocumentStorage::addFieldToHashTable(Position pos) {
-    ValueElement& elem = getField(pos);
+    ValueElement& elem = elementAt(pos);
     elem.nextCollision = Position();
 
     const unsigned bucket = bucketForKey(elem.nameSD());
@@ -232,7 +235,7 @@ void DocumentStorage::addFieldToHashTable(Position pos) {
     Position* posPtr = &_hashTab[bucket];
     while (posPtr->found()) {
         // collision: walk links and add new to end
-        posPtr = &getField(*posPtr).nextCollision;
+        posPtr = &elementAt(*posPtr).nextCollision;
     }
     *posPtr = Position(pos.index);
 }
@@ -253,13 +256,16 @@ void DocumentStorage::alloc(unsigned newSize) {
 
     uassert(16490, "Tried to make oversized document", capacity <= size_t(BufferMaxSize));
 
-    std::unique_ptr<char[]> oldBuf(_cache);
-    _cache = new char[capacity];
+    // Keep the old buffer alive until its contents have been copied.
+    const char* oldBuf = _cache;
+    const boost::intrusive_ptr<DocumentArena> oldArena = _arena;
+    _cache = allocateBuffer(capacity);
+    std::unique_ptr<const char[]> oldHeapBuf(oldArena ? nullptr : oldBuf);
     _cacheEnd = _cache + capacity - hashTabBytes();
 
     if (!firstAlloc) {
         // This just copies the elements
-        memcpy(_cache, oldBuf.get(), _usedBytes);
+        memcpy(_cache, oldBuf, _usedBytes);
 
         if (_numFields >= HASH_TAB_MIN) {
             // if we were hashing, deal with the hash table
@@ -267,12 +273,58 @@ void DocumentStorage::alloc(unsigned newSize) {
                 rehash();
             } else {
                 // no rehash needed so just slide table down to new position
-                memcpy(_hashTab, oldBuf.get() + oldCapacity, hashTabBytes());
+                memcpy(_hashTab, oldBuf + oldCapacity, hashTabBytes());
             }
         }
     }
 }
 
+char* DocumentStorage::allocateBuffer(size_t bytes) {
+    if (auto arena = DocumentArena::current()) {
+        char* buffer = arena->allocate(bytes);
+        if (_arena.get() != arena) {
+            _arena = arena;
+        }
+        return buffer;
+    }
+
+    char* buffer = new char[bytes];
+    _arena.reset();
+    return buffer;
+}
+
+bool DocumentStorage::hasUnownedFields() const {
+    for (auto it = iteratorCacheOnly(); !it.atEnd(); it.advance()) {
+        if (!it->val.isOwned()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DocumentStorage::makeOwned() {
+    _bson = _bson.getOwned();
+
+    if (_arena && _arena.get() != DocumentArena::current()) {
+        // Move the field buffer out of the arena. The values are moved along with their bytes, so
+        // their reference counts do not change.
+        const boost::intrusive_ptr<DocumentArena> oldArena = _arena;
+        const size_t bufferBytes = allocatedBytes();
+        const size_t cacheBytes = _cacheEnd - _cache;
+        char* const oldCache = _cache;
+        _cache = allocateBuffer(bufferBytes);
+        _cacheEnd = _cache + cacheBytes;
+        memcpy(_cache, oldCache, bufferBytes);
+    }
+
+    // Owned copies are equal to the values they replace, so the fields are not marked modified.
+    for (auto it = iteratorCacheOnly(); !it.atEnd(); it.advance()) {
+        if (!it->val.isOwned()) {
+            elementAt(it.position()).val = it->val.getOwned();
+        }
+    }
+}
+
 void DocumentStorage::reserveFields(size_t expectedFields) {
     fassert(16487, !_cache);
 
@@ -286,7 +338,7 @@ void DocumentStorage::reserveFields(size_t expectedFields) {
 
     uassert(16491, "Tried to make oversized document", newSize <= size_t(BufferMaxSize));
 
-    _cache = new char[newSize + hashTabBytes()];
+    _cache = allocateBuffer(newSize + hashTabBytes());
     _cacheEnd = _cache + newSize;
 }
 
@@ -297,7 +349,7 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
         // Make a copy of the buffer with the fields.
         // It is very important that the positions of each field are the same after cloning.
         const size_t bufferBytes = allocatedBytes();
-        out->_cache = new char[bufferBytes];
+        out->_cache = out->allocateBuffer(bufferBytes);
         out->_cacheEnd = out->_cache + (_cacheEnd - _cache);
         memcpy(out->_cache, _cache, bufferBytes);
 
@@ -329,7 +381,7 @@ size_t DocumentStorage::getMetadataApproximateSize() const {
 }
 
 DocumentStorage::~DocumentStorage() {
-    std::unique_ptr<char[]> deleteBufferAtScopeEnd(_cache);
+    std::unique_ptr<char[]> deleteBufferAtScopeEnd(_arena ? nullptr : _cache);
 
     for (auto it = iteratorCacheOnly(); !it.atEnd(); it.advance()) {
         it->val.~Value();  // explicit destructor call
@@ -442,13 +494,33 @@ void Document::toBson(BSONObjBuilder* builder, size_t recursionLevel) const {
                           << BSONDepth::getMaxAllowableDepth() << " levels of nesting",
             recursionLevel <= BSONDepth::getMaxAllowableDepth());
 
+    // Fields which are unchanged from the backing BSON are copied as raw bytes. Consecutive such
+    // fields are adjacent in the backing BSON, so they are gathered into a single range.
+    const char* rawBegin = nullptr;
+    const char* rawEnd = nullptr;
+    auto flushRaw = [&] {
+        if (rawBegin != rawEnd) {
+            builder->bb().appendBuf(rawBegin, rawEnd - rawBegin);
+        }
+        rawBegin = rawEnd = nullptr;
+    };
+
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
-        if (auto cached = it.cachedValue()) {
+        auto cached = it.cachedValue();
+        if (cached && cached->kind != ValueElement::Kind::kCachedUnmodified) {
+            flushRaw();
             cached->val.addToBsonObj(builder, cached->nameSD(), recursionLevel);
-        } else {
-            builder->append(*it.bsonIter());
+            continue;
+        }
+
+        const BSONElement elem = *it.bsonIter();
+        if (elem.rawdata() != rawEnd) {
+            flushRaw();
+            rawBegin = elem.rawdata();
         }
+        rawEnd = elem.rawdata() + elem.size();
     }
+    flushRaw();
 }
 
 BSONObj Document::toBson() const {
@@ -513,7 +585,8 @@ Document Document::fromBsonWithMetaData(const BSONObj& bson) {
 }
 
 Document Document::getOwned() const {
-    if (isOwned()) {
+    // Nested documents can only be unowned if they have fields in an arena.
+    if (isOwned() && !(_storage && DocumentArena::anyExist() && _storage->hasUnownedFields())) {
         return *this;
     } else {
         MutableDocument md(*this);
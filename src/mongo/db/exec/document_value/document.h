@@ -308,12 +308,15 @@ public:
     }
 
     /**
-     * Returns a document that owns the underlying BSONObj.
+     * Returns a document that owns the underlying BSONObj, and whose fields do not live in a
+     * DocumentArena other than the one installed on the current thread. Retaining stages call this
+     * so that a document they keep does not pin the memory of a whole batch.
      */
     Document getOwned() const;
 
     /**
-     * Returns true if the underlying BSONObj is owned.
+     * Returns true if the underlying BSONObj is owned and the document's own field buffer is not in
+     * a foreign DocumentArena. Nested documents are not checked.
      */
     bool isOwned() const {
         return _storage ? _storage->isOwned() : true;
@@ -340,6 +343,7 @@ private:
     friend class ValueStorage;
     friend class MutableDocument;
     friend class MutableValue;
+    friend class Value;
 
     explicit Document(boost::intrusive_ptr<const DocumentStorage>&& ptr)
         : _storage(std::move(ptr)) {}
@@ -450,6 +454,9 @@ private:
  *  To preserve the immutability of Documents, MutableDocument will
  *  shallow-clone its storage on write (COW) if it is shared with any other
  *  Documents.
+ *
+ *  While a DocumentArena is installed on the current thread (see DocumentArena::Scope), the field
+ *  buffers of new and growing documents are allocated from that arena instead of the heap.
  */
 class MutableDocument {
     MutableDocument(const MutableDocument&) = delete;
@@ -0,0 +1,93 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/document_value/document_arena.h"
+
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+namespace {
+thread_local DocumentArena* currentArena = nullptr;
+
+// Number of arenas alive in the process.
+AtomicWord<long long> numArenas{0};
+}  // namespace
+
+DocumentArena::DocumentArena(size_t blockSize) : _blockSize(blockSize) {
+    numArenas.fetchAndAdd(1);
+}
+
+DocumentArena::~DocumentArena() {
+    numArenas.fetchAndSubtract(1);
+}
+
+DocumentArena::Scope::Scope(DocumentArena* arena) : _previous(currentArena) {
+    currentArena = arena;
+}
+
+DocumentArena::Scope::~Scope() {
+    currentArena = _previous;
+}
+
+DocumentArena* DocumentArena::current() {
+    return currentArena;
+}
+
+bool DocumentArena::anyExist() {
+    return numArenas.loadRelaxed() > 0;
+}
+
+char* DocumentArena::allocate(size_t bytes) {
+    bytes = (bytes + kAlignment - 1) & ~(kAlignment - 1);
+    _bytesAllocated += bytes;
+
+    // Large buffers get a block of their own so they don't waste the tail of the current block.
+    if (bytes > _blockSize / 4) {
+        return allocateBlock(bytes);
+    }
+
+    if (static_cast<size_t>(_end - _pos) < bytes) {
+        _pos = allocateBlock(_blockSize);
+        _end = _pos + _blockSize;
+    }
+
+    char* out = _pos;
+    _pos += bytes;
+    return out;
+}
+
+char* DocumentArena::allocateBlock(size_t bytes) {
+    _blocks.emplace_back(new char[bytes]);
+    _bytesReserved += bytes;
+    return _blocks.back().get();
+}
+
+}  // namespace mongo
@@ -0,0 +1,127 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/util/intrusive_counter.h"
+
+namespace mongo {
+
+/**
+ * A bump-pointer allocator for the field buffers of DocumentStorage. While an arena is installed
+ * on a thread with DocumentArena::Scope, every DocumentStorage buffer allocated on that thread is
+ * carved out of the arena instead of coming from the heap. This turns the malloc/free pair paid
+ * per document (and per buffer growth) into a pointer bump.
+ *
+ * Each storage whose buffer lives in an arena holds a reference to that arena, so the arena's
+ * memory is released once the last such document is destroyed. Buffers abandoned when a storage
+ * grows are only reclaimed at that point, so an arena is meant to be used for one batch of
+ * documents and then replaced by a fresh one. Outside of the scope that installed it, a document
+ * in an arena is not owned: stages that keep documents past their batch, like $sort and $group,
+ * copy them to the heap with getOwned() so that one kept document does not pin the whole arena.
+ *
+ * Allocation is not synchronized: an arena must only be installed on one thread at a time. The
+ * reference count is atomic, so documents built in an arena may be released on any thread.
+ */
+class DocumentArena : public RefCountable {
+public:
+    static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+    /**
+     * Installs an arena on the current thread for the lifetime of the scope, restoring the
+     * previously installed arena (if any) on destruction. A null arena disables arena allocation
+     * within the scope.
+     */
+    class Scope {
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    public:
+        explicit Scope(DocumentArena* arena);
+        ~Scope();
+
+    private:
+        DocumentArena* const _previous;
+    };
+
+    explicit DocumentArena(size_t blockSize = kDefaultBlockSize);
+    ~DocumentArena();
+
+    /**
+     * Returns the arena installed on the current thread, or nullptr if there is none.
+     */
+    static DocumentArena* current();
+
+    /**
+     * Returns true if any arena exists. When none does, no document has fields in an arena, so
+     * looking for them in nested documents can be skipped.
+     */
+    static bool anyExist();
+
+    /**
+     * Returns 'bytes' of uninitialized memory suitably aligned for a DocumentStorage buffer. The
+     * memory stays valid for as long as the arena is alive.
+     */
+    char* allocate(size_t bytes);
+
+    /**
+     * Total number of bytes handed out by allocate().
+     */
+    size_t bytesAllocated() const {
+        return _bytesAllocated;
+    }
+
+    /**
+     * Total number of bytes reserved from the heap by this arena.
+     */
+    size_t bytesReserved() const {
+        return _bytesReserved;
+    }
+
+private:
+    static constexpr size_t kAlignment = 16;
+
+    char* allocateBlock(size_t bytes);
+
+    const size_t _blockSize;
+
+    std::vector<std::unique_ptr<char[]>> _blocks;
+
+    // The unused tail of the current block.
+    char* _pos = nullptr;
+    char* _end = nullptr;
+
+    size_t _bytesAllocated = 0;
+    size_t _bytesReserved = 0;
+};
+
+}  // namespace mongo
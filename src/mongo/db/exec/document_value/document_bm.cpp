@@ -0,0 +1,155 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/document_value/document_arena.h"
+#include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/pipeline/field_path.h"
+
+namespace mongo {
+namespace {
+
+// The number of documents built between replacing the arena, mimicking one batch of a pipeline.
+constexpr size_t kBatchSize = 128;
+
+const std::vector<std::string>& fieldNames() {
+    static const std::vector<std::string> names = {
+        "_id", "customer", "status", "total", "currency", "items", "created", "updated",
+        "region", "channel", "priority", "notes", "discount", "tax", "shipping", "flags"};
+    return names;
+}
+
+BSONObj buildInput() {
+    BSONObjBuilder bob;
+    for (size_t i = 0; i < fieldNames().size(); ++i) {
+        if (i % 3 == 0) {
+            bob.append(fieldNames()[i], static_cast<int>(i));
+        } else if (i % 3 == 1) {
+            bob.append(fieldNames()[i], "value of " + fieldNames()[i]);
+        } else {
+            bob.append(fieldNames()[i], 0.5 * i);
+        }
+    }
+    return bob.obj();
+}
+
+/**
+ * Builds a document with 'numFields' fields from scratch, as $addFields or $group output does.
+ */
+Document buildDocument(size_t numFields) {
+    MutableDocument md;
+    for (size_t i = 0; i < numFields; ++i) {
+        md.addField(fieldNames()[i % fieldNames().size()], Value(static_cast<int>(i)));
+    }
+    return md.freeze();
+}
+
+/**
+ * Copies every other field of 'input' and adds a computed one, as an inclusion $project does.
+ */
+Document projectDocument(const Document& input) {
+    MutableDocument md;
+    for (size_t i = 0; i < fieldNames().size(); i += 2) {
+        md.addField(fieldNames()[i], input[fieldNames()[i]]);
+    }
+    md.addField("computed", Value(input["total"].getInt() + 1));
+    return md.freeze();
+}
+
+template <typename Fn>
+void runBatches(benchmark::State& state, bool useArena, Fn&& fn) {
+    boost::intrusive_ptr<DocumentArena> arena;
+    std::vector<Document> batch;
+    batch.reserve(kBatchSize);
+
+    for (auto keepRunning : state) {
+        if (useArena) {
+            arena = make_intrusive<DocumentArena>();
+        }
+        {
+            DocumentArena::Scope scope(arena.get());
+            for (size_t i = 0; i < kBatchSize; ++i) {
+                batch.push_back(fn());
+            }
+        }
+        benchmark::DoNotOptimize(batch.data());
+        batch.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+void BM_buildDocument(benchmark::State& state, bool useArena) {
+    const size_t numFields = state.range(0);
+    runBatches(state, useArena, [&] { return buildDocument(numFields); });
+}
+
+void BM_projectDocument(benchmark::State& state, bool useArena) {
+    const Document input(buildInput());
+    runBatches(state, useArena, [&] { return projectDocument(input); });
+}
+
+/**
+ * Reads and updates a couple of fields of a large BSON-backed document and serializes the result,
+ * as a $set on a few fields of a wide document does.
+ */
+void BM_modifyAndSerialize(benchmark::State& state) {
+    BSONObjBuilder bob;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        const std::string name = "field" + std::to_string(i);
+        if (i % 2 == 0) {
+            bob.append(name, buildInput());
+        } else {
+            bob.append(name, static_cast<int>(i));
+        }
+    }
+    const BSONObj bson = bob.obj();
+
+    for (auto keepRunning : state) {
+        Document input(bson);
+        MutableDocument md(input);
+        md.setField("field1", Value(md.peek()["field1"].getInt() + 1));
+        md.setNestedField(FieldPath("field0.total"), Value(0));
+        benchmark::DoNotOptimize(md.freeze().toBson());
+    }
+    state.SetBytesProcessed(state.iterations() * bson.objsize());
+}
+
+BENCHMARK_CAPTURE(BM_buildDocument, heap, false)->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK_CAPTURE(BM_buildDocument, arena, true)->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK_CAPTURE(BM_projectDocument, heap, false);
+BENCHMARK_CAPTURE(BM_projectDocument, arena, true);
+BENCHMARK(BM_modifyAndSerialize)->Arg(8)->Arg(64)->Arg(512);
+
+}  // namespace
+}  // namespace mongo
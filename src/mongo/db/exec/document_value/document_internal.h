@@ -35,6 +35,7 @@
 #include <boost/intrusive_ptr.hpp>
 
 #include "mongo/base/static_assert.h"
+#include "mongo/db/exec/document_value/document_arena.h"
 #include "mongo/db/exec/document_value/document_metadata_fields.h"
 #include "mongo/db/exec/document_value/value.h"
 #include "mongo/stdx/variant.h"
@@ -89,6 +90,9 @@ public:
         kInserted,
         // The value has the image in the underlying BSON.
         kCached,
+        // The value has the image in the underlying BSON and has not been handed out for
+        // modification since, so the BSON element can be serialized in place of the value.
+        kCachedUnmodified,
         // The value has been opportunistically inserted into the cache without checking the BSON.
         kMaybeInserted
     };
@@ -111,6 +115,10 @@ public:
         return StringData(_name, nameLen);
     }
 
+    bool hasImageInBson() const {
+        return kind == Kind::kCached || kind == Kind::kCachedUnmodified;
+    }
+
 
     // helpers for doing pointer arithmetic with this class
     char* ptr() {
@@ -342,8 +350,11 @@ public:
     // MutableDocument uses these
     ValueElement& getField(Position pos) {
         _modified = true;
-        verify(pos.found());
-        return *(_firstElement->plusBytes(pos.index));
+        ValueElement& elem = elementAt(pos);
+        if (elem.kind == ValueElement::Kind::kCachedUnmodified) {
+            elem.kind = ValueElement::Kind::kCached;
+        }
+        return elem;
     }
     Value& getField(StringData name, LookupPolicy policy) {
         _modified = true;
@@ -404,13 +415,23 @@ public:
 
     bool isOwned() const {
         // An empty BSON is a special case, it can be treated 'owned'. We save on memory allocation
-        // when constructing an empty Document.
-        return _bson.isEmpty() || _bson.isOwned();
+        // when constructing an empty Document. A field buffer in an arena other than the one
+        // installed on this thread is not owned either, since it keeps that whole arena alive.
+        return (_bson.isEmpty() || _bson.isOwned()) &&
+            (!_arena || _arena.get() == DocumentArena::current());
     }
 
-    void makeOwned() {
-        _bson = _bson.getOwned();
-    }
+    /**
+     * Returns true if any of the cached field values is a document or array that is not owned
+     * (see Value::isOwned()).
+     */
+    bool hasUnownedFields() const;
+
+    /**
+     * Takes ownership of the underlying BSONObj, moves the field buffer out of a foreign arena and
+     * makes every cached field value owned.
+     */
+    void makeOwned();
 
     /**
      * Compute the space allocated for the metadata fields. Will account for space allocated for
@@ -492,13 +513,31 @@ public:
         return _bson;
     }
 
+    /// Returns the arena the field buffer was allocated in, or nullptr if it is on the heap.
+    const DocumentArena* arena() const {
+        return _arena.get();
+    }
+
 private:
     /// Returns the position of the named field in the cache or Position()
     Position findFieldInCache(StringData name) const;
 
+    /// Like getField(Position) but does not mark anything as modified.
+    ValueElement& elementAt(Position pos) {
+        verify(pos.found());
+        return *(_firstElement->plusBytes(pos.index));
+    }
+
     /// Allocates space in _cache. Copies existing data if there is any.
     void alloc(unsigned newSize);
 
+    /**
+     * Returns a new buffer for _cache, taken from the current thread's DocumentArena if one is
+     * installed and from the heap otherwise. Updates _arena to match, so the caller must keep a
+     * reference to the previous arena while it still needs the previous buffer.
+     */
+    char* allocateBuffer(size_t bytes);
+
     /// Call after adding field to _cache and increasing _numFields
     void addFieldToHashTable(Position pos);
 
@@ -563,6 +602,9 @@ private:
     unsigned _numFields;    // this includes removed fields
     unsigned _hashTabMask;  // equal to hashTabBuckets()-1 but used more often
 
+    // The arena owning _cache, or null if _cache was allocated with new[].
+    boost::intrusive_ptr<DocumentArena> _arena;
+
     BSONObj _bson;
 
     // If '_stripMetadata' is true, tracks whether or not the metadata has been lazy-loaded from the
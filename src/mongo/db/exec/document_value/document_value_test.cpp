@@ -137,6 +137,146 @@ TEST(DocumentConstruction, FromBsonReset) {
     ASSERT_BSONOBJ_EQ(bson, toBson(newDocument));
 }
 
+const DocumentArena* arenaOf(const Document& document) {
+    return static_cast<const DocumentStorage*>(document.getPtr())->arena();
+}
+
+Document buildDocumentWithFields(size_t numFields) {
+    MutableDocument md;
+    for (size_t i = 0; i < numFields; ++i) {
+        md.addField("field" + std::to_string(i), Value(static_cast<int>(i)));
+    }
+    return md.freeze();
+}
+
+TEST(DocumentArena, BuffersAreAllocatedInInstalledArena) {
+    auto arena = make_intrusive<DocumentArena>();
+    Document inArena;
+    {
+        DocumentArena::Scope scope(arena.get());
+        inArena = buildDocumentWithFields(100);
+    }
+    Document onHeap = buildDocumentWithFields(100);
+
+    ASSERT_EQ(arena.get(), arenaOf(inArena));
+    ASSERT_GT(arena->bytesAllocated(), 0U);
+    ASSERT(arenaOf(onHeap) == nullptr);
+    ASSERT_DOCUMENT_EQ(onHeap, inArena);
+    assertRoundTrips(inArena);
+}
+
+TEST(DocumentArena, DocumentsOutliveTheirArenaReference) {
+    Document document;
+    {
+        auto arena = make_intrusive<DocumentArena>(256);
+        DocumentArena::Scope scope(arena.get());
+        document = buildDocumentWithFields(50);
+    }
+    ASSERT_EQUALS(50ULL, document.computeSize());
+    ASSERT_EQUALS(49, document["field49"].getInt());
+    assertRoundTrips(document);
+}
+
+TEST(DocumentArena, ModifyingOutsideScopeMovesBufferToHeap) {
+    auto arena = make_intrusive<DocumentArena>();
+    MutableDocument md;
+    {
+        DocumentArena::Scope scope(arena.get());
+        md.addField("a", Value(1));
+    }
+    ASSERT_EQ(arena.get(), arenaOf(md.peek()));
+
+    // Growing past the initial buffer outside of the scope must not touch the arena.
+    const size_t bytesAllocated = arena->bytesAllocated();
+    for (int i = 0; i < 100; ++i) {
+        md.addField("field" + std::to_string(i), Value(i));
+    }
+    ASSERT_EQ(bytesAllocated, arena->bytesAllocated());
+    ASSERT(arenaOf(md.peek()) == nullptr);
+    ASSERT_EQUALS(1, md.peek()["a"].getInt());
+    ASSERT_EQUALS(99, md.peek()["field99"].getInt());
+
+    // A clone made within a scope lives in that scope's arena.
+    Document frozen = md.freeze();
+    DocumentArena::Scope scope(arena.get());
+    MutableDocument copy(frozen);
+    copy.setField("a", Value(2));
+    ASSERT_EQ(arena.get(), arenaOf(copy.peek()));
+    ASSERT_EQUALS(1, frozen["a"].getInt());
+    ASSERT_EQUALS(2, copy.peek()["a"].getInt());
+}
+
+TEST(DocumentArena, GetOwnedCopiesDocumentsOutOfTheArena) {
+    auto arena = make_intrusive<DocumentArena>();
+    Document inArena;
+    {
+        DocumentArena::Scope scope(arena.get());
+        MutableDocument md(buildDocumentWithFields(10));
+        md.addField("nested", Value(buildDocumentWithFields(3)));
+        md.addField("array",
+                    Value(std::vector<Value>{Value(1), Value(buildDocumentWithFields(2))}));
+        inArena = md.freeze();
+
+        // Within the scope that installed the arena, its documents are owned.
+        ASSERT(inArena.isOwned());
+        ASSERT_EQ(inArena.getPtr(), inArena.getOwned().getPtr());
+    }
+    ASSERT_FALSE(inArena.isOwned());
+    ASSERT_FALSE(inArena["nested"].isOwned());
+    ASSERT_FALSE(inArena["array"].isOwned());
+
+    // A kept copy lives on the heap, nested documents included.
+    Document owned = inArena.getOwned();
+    ASSERT(arenaOf(owned) == nullptr);
+    ASSERT(arenaOf(owned["nested"].getDocument()) == nullptr);
+    ASSERT(arenaOf(owned["array"][1].getDocument()) == nullptr);
+    ASSERT(owned.isOwned());
+    ASSERT(Value(owned).isOwned());
+    ASSERT_DOCUMENT_EQ(inArena, owned);
+
+    // Wrapping a document from a foreign arena in a Value also copies it out.
+    Value wrapped(inArena["nested"].getDocument());
+    ASSERT(arenaOf(wrapped.getDocument()) == nullptr);
+
+    ASSERT_EQ(owned.getPtr(), owned.getOwned().getPtr());
+}
+
+TEST(DocumentArena, GetOwnedDoesNotModifyBsonBackedDocuments) {
+    const BSONObj bson = BSON("a" << BSON("b" << 1) << "c" << 2);
+    auto arena = make_intrusive<DocumentArena>();
+    Document document(bson);
+    {
+        // Reading the nested field builds both field caches in the arena.
+        DocumentArena::Scope scope(arena.get());
+        ASSERT_EQUALS(1, document["a"]["b"].getInt());
+    }
+    ASSERT_FALSE(document["a"].isOwned());
+
+    // Copying the fields out of the arena does not count as a modification, so the owned copy is
+    // still serialized as its backing BSON.
+    Document owned = document.getOwned();
+    ASSERT(owned["a"].isOwned());
+    auto ownedBson = owned.toBsonIfTriviallyConvertible();
+    ASSERT(ownedBson);
+    ASSERT_BSONOBJ_EQ(bson, *ownedBson);
+}
+
+TEST(DocumentArena, ScopesNest) {
+    auto outer = make_intrusive<DocumentArena>();
+    auto inner = make_intrusive<DocumentArena>();
+    DocumentArena::Scope outerScope(outer.get());
+    {
+        DocumentArena::Scope innerScope(inner.get());
+        ASSERT_EQ(inner.get(), DocumentArena::current());
+        {
+            DocumentArena::Scope heapScope(nullptr);
+            ASSERT(DocumentArena::current() == nullptr);
+        }
+        ASSERT_EQ(inner.get(), DocumentArena::current());
+    }
+    ASSERT_EQ(outer.get(), DocumentArena::current());
+}
+
 /**
  * Appends to 'builder' an object nested 'depth' levels deep.
  */
@@ -176,6 +316,60 @@ TEST(DocumentSerialization, CannotSerializeDocumentThatExceedsDepthLimit) {
     throwaway.abandon();
 }
 
+TEST(DocumentSerialization, ModifiedDocumentKeepsUnmodifiedFieldsFromBson) {
+    BSONObj bson = BSON("a" << 1 << "b" << BSON("c" << 2 << "d" << BSON_ARRAY(3 << 4)) << "e"
+                            << "x"
+                            << "f" << 5.5);
+    Document document(bson);
+
+    // Bring some fields into the cache without modifying them.
+    ASSERT_EQUALS(2, document["b"]["c"].getInt());
+    ASSERT_EQUALS("x", document["e"].getString());
+
+    MutableDocument md(document);
+    md.setField("a", Value(10));
+    md.setNestedField(FieldPath("b.c"), Value(20));
+    md.addField("g", Value(true));
+    ASSERT_BSONOBJ_EQ(BSON("a" << 10 << "b" << BSON("c" << 20 << "d" << BSON_ARRAY(3 << 4))
+                               << "e"
+                               << "x"
+                               << "f" << 5.5 << "g" << true),
+                      md.freeze().toBson());
+    ASSERT_BSONOBJ_EQ(bson, document.toBson());
+}
+
+TEST(DocumentSerialization, RemovedFieldsAreSkippedBetweenUnmodifiedFields) {
+    Document document(BSON("a" << 1 << "b" << 2 << "c" << 3 << "d" << 4 << "e" << 5));
+    MutableDocument md(document);
+    md.remove("b");
+    md.remove("d");
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "c" << 3 << "e" << 5), md.freeze().toBson());
+}
+
+TEST(DocumentSerialization, ModifiedDocumentStripsMetadata) {
+    Document document = Document::fromBsonWithMetaData(
+        BSON("a" << 1 << Document::metaFieldTextScore << 2.0 << "b" << 3));
+    MutableDocument md(document);
+    md.setField("b", Value(4));
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "b" << 4), md.freeze().toBson());
+}
+
+TEST(DocumentSerialization, NestedObjectDoesNotShareBackingBuffer) {
+    BSONObj bson = BSON("a" << BSON("b" << 1) << "c" << BSON_ARRAY(BSON("d" << 2)));
+    Document document(bson);
+
+    // A subdocument kept on its own must not hold on to the buffer of its parent.
+    const BSONObj nested = document["a"].getDocument().toBson();
+    ASSERT_FALSE(nested.objdata() >= bson.objdata() &&
+                 nested.objdata() < bson.objdata() + bson.objsize());
+    ASSERT_BSONOBJ_EQ(BSON("b" << 1), nested);
+
+    MutableDocument md(document);
+    md.setField("e", Value(3));
+    ASSERT_BSONOBJ_EQ(BSON("a" << BSON("b" << 1) << "c" << BSON_ARRAY(BSON("d" << 2)) << "e" << 3),
+                      md.freeze().toBson());
+}
+
 TEST(DocumentGetFieldNonCaching, UncachedTopLevelFields) {
     BSONObj bson = BSON("scalar" << 1 << "array" << BSON_ARRAY(1 << 2 << 3) << "scalar2" << true);
     Document document = fromBson(bson);
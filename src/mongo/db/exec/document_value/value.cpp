@@ -401,6 +401,11 @@ void Value::addToBsonObj(BSONObjBuilder* builder,
             recursionLevel <= BSONDepth::getMaxAllowableDepth());
 
     if (getType() == BSONType::Object) {
+        // A document which still matches its backing BSON is copied in one piece.
+        if (auto bson = getDocument().toBsonIfTriviallyConvertible()) {
+            builder->append(fieldName, *bson);
+            return;
+        }
         BSONObjBuilder subobjBuilder(builder->subobjStart(fieldName));
         getDocument().toBson(&subobjBuilder, recursionLevel + 1);
         subobjBuilder.doneFast();
@@ -427,6 +432,10 @@ void Value::addToBsonArray(BSONArrayBuilder* builder, size_t recursionLevel) con
     }
 
     if (getType() == BSONType::Object) {
+        if (auto bson = getDocument().toBsonIfTriviallyConvertible()) {
+            builder->append(*bson);
+            return;
+        }
         BSONObjBuilder subobjBuilder(builder->subobjStart());
         getDocument().toBson(&subobjBuilder, recursionLevel + 1);
         subobjBuilder.doneFast();
@@ -1212,6 +1221,47 @@ ostream& operator<<(ostream& out, const Value& val) {
     verify(false);
 }
 
+bool Value::isOwned() const {
+    // Without an arena, the documents in a value are owned as soon as their BSON is.
+    const bool anyArena = DocumentArena::anyExist();
+    switch (getType()) {
+        case Object: {
+            const Document doc = getDocument();
+            return doc.isOwned() && !(anyArena && doc.storage().hasUnownedFields());
+        }
+        case Array:
+            if (!anyArena) {
+                return true;
+            }
+            for (auto&& value : getArray()) {
+                if (!value.isOwned()) {
+                    return false;
+                }
+            }
+            return true;
+        default:
+            return true;
+    }
+}
+
+Value Value::getOwned() const {
+    if (isOwned()) {
+        return *this;
+    }
+
+    if (getType() == Object) {
+        return Value(getDocument().getOwned());
+    }
+
+    const auto& values = getArray();
+    std::vector<Value> owned;
+    owned.reserve(values.size());
+    for (auto&& value : values) {
+        owned.push_back(value.getOwned());
+    }
+    return Value(std::move(owned));
+}
+
 void Value::serializeForSorter(BufBuilder& buf) const {
     buf.appendChar(getType());
     switch (getType()) {
@@ -352,9 +352,17 @@ public:
     int memUsageForSorter() const {
         return getApproximateSize();
     }
-    Value getOwned() const {
-        return *this;
-    }
+
+    /**
+     * Returns true unless this is a document or array containing a document that is not owned (see
+     * Document::getOwned()).
+     */
+    bool isOwned() const;
+
+    /**
+     * Returns a value whose documents are all owned, copying only the documents that are not.
+     */
+    Value getOwned() const;
 
     /// Members to support parsing/deserialization from IDL generated code.
     void serializeForIDL(StringData fieldName, BSONObjBuilder* builder) const;
@@ -38,6 +38,7 @@
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/str.h"
 
@@ -57,6 +58,9 @@ FetchStage::FetchStage(ExpressionContext* expCtx,
     : RequiresCollectionStage(kStageType, expCtx, collection),
       _ws(ws),
       _filter((filter && !filter->isTriviallyTrue()) ? filter : nullptr),
+      _compiledFilter(_filter && internalQueryCompileMatchExpressions.load()
+                          ? CompiledMatchExpression::compile(_filter)
+                          : nullptr),
       _idRetrying(WorkingSet::INVALID_ID) {
     _children.emplace_back(std::move(child));
 }
@@ -167,7 +171,7 @@ PlanStage::StageState FetchStage::returnIfMatches(WorkingSetMember* member,
     // predicate.
     ++_specificStats.docsExamined;
 
-    if (Filter::passes(member, _filter)) {
+    if (Filter::passes(member, _filter, _compiledFilter.get())) {
         *out = memberID;
         return PlanStage::ADVANCED;
     } else {
@@ -33,6 +33,7 @@
 
 #include "mongo/db/exec/requires_collection_stage.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
 
@@ -95,6 +96,9 @@ private:
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
+    // The compiled form of '_filter', if it was compiled.
+    std::unique_ptr<CompiledMatchExpression> _compiledFilter;
+
     // If not Null, we use this rather than asking our child what to do next.
     WorkingSetID _idRetrying;
 
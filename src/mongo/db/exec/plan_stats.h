@@ -188,6 +188,9 @@ struct AndHashStats : public SpecificStats {
 
     // What's our memory limit?
     size_t memLimit = 0u;
+
+    // True if only the record ids of the children but the last were kept.
+    bool recordIdsOnly = false;
 };
 
 struct AndSortedStats : public SpecificStats {
@@ -83,7 +83,29 @@ FTDCCompressor::addSample(const BSONObj& sample, Date_t date) {
             std::get<1>(swCompressedSamples.getValue()))};
     }
 
+    return _addDeltas();
+}
+
+StatusWith<boost::optional<std::tuple<ConstDataRange, FTDCCompressor::CompressorState, Date_t>>>
+FTDCCompressor::addSample(const std::vector<std::uint64_t>& metrics,
+                          const BSONObj& referenceDoc,
+                          Date_t date) {
+    // assign() reuses the capacity of _metrics, so steady state sampling does not allocate.
+    _metrics.assign(metrics.begin(), metrics.end());
 
+    if (_referenceDoc.isEmpty()) {
+        invariant(!referenceDoc.isEmpty());
+        _reset(referenceDoc, date);
+        return {boost::none};
+    }
+
+    invariant(_metrics.size() == _metricsCount);
+
+    return _addDeltas();
+}
+
+StatusWith<boost::optional<std::tuple<ConstDataRange, FTDCCompressor::CompressorState, Date_t>>>
+FTDCCompressor::_addDeltas() {
     // Add another sample
     for (std::size_t i = 0; i < _metrics.size(); ++i) {
         // NOTE: This touches a lot of cache lines so that compression code can be more effcient.
@@ -96,6 +96,18 @@ public:
     StatusWith<boost::optional<std::tuple<ConstDataRange, CompressorState, Date_t>>> addSample(
         const BSONObj& sample, Date_t date);
 
+    /**
+     * Add a sample whose metrics the caller has already extracted, without building a BSON
+     * document for it. Returns the same flags as the overload above.
+     *
+     * referenceDoc is only used when the sample starts a new chunk, i.e. when hasDataToFlush() is
+     * false, and may be empty otherwise. It must be a document from which
+     * FTDCBSONUtil::extractMetricsFromDocument extracts exactly metrics. The number of metrics
+     * must not change between samples.
+     */
+    StatusWith<boost::optional<std::tuple<ConstDataRange, CompressorState, Date_t>>> addSample(
+        const std::vector<std::uint64_t>& metrics, const BSONObj& referenceDoc, Date_t date);
+
     /**
      * Returns the number of enqueued samples.
      *
@@ -150,6 +162,12 @@ private:
      */
     void _reset(const BSONObj& referenceDoc, Date_t date);
 
+    /**
+     * Delta encode the metrics in _metrics against the previous sample.
+     */
+    StatusWith<boost::optional<std::tuple<ConstDataRange, CompressorState, Date_t>>>
+    _addDeltas();
+
 private:
     // Block Compressor
     BlockCompressor _compressor;
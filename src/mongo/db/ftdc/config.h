@@ -47,7 +47,8 @@ struct FTDCConfig {
           maxFileSizeBytes(kMaxFileSizeBytesDefault),
           period(kPeriodMillisDefault),
           maxSamplesPerArchiveMetricChunk(kMaxSamplesPerArchiveMetricChunkDefault),
-          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault) {}
+          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault),
+          highFrequencyPeriod(kHighFrequencyPeriodMillisDefault) {}
 
     /**
      * True if FTDC is collecting data. False otherwise
@@ -84,9 +85,16 @@ struct FTDCConfig {
      */
     std::uint32_t maxSamplesPerInterimMetricChunk;
 
+    /**
+     * Period at which to sample the high frequency counters. Zero disables high frequency
+     * sampling.
+     */
+    Milliseconds highFrequencyPeriod;
+
     static const bool kEnabledDefault = true;
 
     static const std::int64_t kPeriodMillisDefault;
+    static const std::int64_t kHighFrequencyPeriodMillisDefault = 0;
     static const std::uint64_t kMaxDirectorySizeBytesDefault = 200 * 1024 * 1024;
     static const std::uint64_t kMaxFileSizeBytesDefault = 10 * 1024 * 1024;
 
@@ -44,11 +44,20 @@
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
 
+namespace {
+
+bool isHighFrequencySamplingEnabled(const FTDCConfig& config) {
+    return config.enabled && config.highFrequencyPeriod > Milliseconds(0);
+}
+
+}  // namespace
+
 Status FTDCController::setEnabled(bool enabled) {
     stdx::lock_guard<Latch> lock(_mutex);
 
@@ -60,6 +69,7 @@ Status FTDCController::setEnabled(bool enabled) {
 
     _configTemp.enabled = enabled;
     _condvar.notify_one();
+    _highFrequencyCondvar.notify_one();
 
     return Status::OK();
 }
@@ -70,6 +80,13 @@ void FTDCController::setPeriod(Milliseconds millis) {
     _condvar.notify_one();
 }
 
+void FTDCController::setHighFrequencyPeriod(Milliseconds millis) {
+    stdx::lock_guard<Latch> lock(_mutex);
+    _configTemp.highFrequencyPeriod = millis;
+    startHighFrequencyThreadIfNeeded(lock);
+    _highFrequencyCondvar.notify_one();
+}
+
 void FTDCController::setMaxDirectorySizeBytes(std::uint64_t size) {
     stdx::lock_guard<Latch> lock(_mutex);
     _configTemp.maxDirectorySizeBytes = size;
@@ -129,6 +146,14 @@ void FTDCController::addOnRotateCollector(std::unique_ptr<FTDCCollectorInterface
     }
 }
 
+void FTDCController::addHighFrequencyCounter(StringData name,
+                                             const AtomicWord<long long>* counter) {
+    stdx::lock_guard<Latch> lock(_mutex);
+    invariant(_state == State::kNotStarted);
+
+    _highFrequencySampler.addCounter(name, counter);
+}
+
 BSONObj FTDCController::getMostRecentPeriodicDocument() {
     {
         stdx::lock_guard<Latch> lock(_mutex);
@@ -149,9 +174,22 @@ void FTDCController::start() {
 
         invariant(_state == State::kNotStarted);
         _state = State::kStarted;
+
+        startHighFrequencyThreadIfNeeded(lock);
     }
 }
 
+void FTDCController::startHighFrequencyThreadIfNeeded(WithLock) {
+    // The thread is only started once there is a period to sample at, and never once a stop was
+    // requested, so that the collection thread can join it after it stops.
+    if (_state != State::kStarted || _highFrequencyThread.joinable() ||
+        _highFrequencySampler.empty() || _configTemp.highFrequencyPeriod <= Milliseconds(0)) {
+        return;
+    }
+
+    _highFrequencyThread = stdx::thread([this] { doHighFrequencyLoop(); });
+}
+
 void FTDCController::stop() {
     LOGV2(20626, "Shutting down full-time diagnostic data capture");
 
@@ -170,8 +208,9 @@ void FTDCController::stop() {
         _configTemp.enabled = false;
         _state = State::kStopRequested;
 
-        // Wake up the thread if sleeping so that it will check if we are done
+        // Wake up the threads if sleeping so that they will check if we are done
         _condvar.notify_one();
+        _highFrequencyCondvar.notify_one();
     }
 
     _thread.join();
@@ -258,8 +297,119 @@ void FTDCController::doLoop() noexcept {
                 stdx::lock_guard<Latch> lock(_mutex);
                 _mostRecentPeriodicDocument = std::get<0>(collectSample);
             }
+
+            // High frequency chunks are appended as they complete, so they are not in _id order
+            // relative to the periodic chunk in progress, which is written once it is full.
+            uassertStatusOK(writeHighFrequencyChunks(client));
+        }
+    }
+
+    // Write the high frequency samples taken before shutdown
+    if (_highFrequencyThread.joinable()) {
+        _highFrequencyThread.join();
+
+        auto swChunk = _highFrequencySampler.flush();
+        Status s = swChunk.getStatus();
+        if (s.isOK() && _mgr) {
+            if (swChunk.getValue()) {
+                _pendingHighFrequencyChunks.push_back(std::move(swChunk.getValue().get()));
+            }
+
+            s = writeHighFrequencyChunks(client);
+        }
+
+        if (!s.isOK()) {
+            LOGV2(5121518,
+                  "Failed to write high frequency full-time diagnostic data capture samples",
+                  "error"_attr = s);
         }
     }
 }
 
+void FTDCController::doHighFrequencyLoop() noexcept {
+    // Note: All exceptions thrown in this loop are considered process fatal, as in doLoop.
+    Client::initThread("ftdcHighFrequency");
+    auto clockSource = getGlobalServiceContext()->getPreciseClockSource();
+
+    // Update config
+    {
+        stdx::lock_guard<Latch> lock(_mutex);
+        _highFrequencyConfig = _configTemp;
+    }
+
+    while (true) {
+        {
+            stdx::unique_lock<Latch> lock(_mutex);
+            MONGO_IDLE_THREAD_BLOCK;
+
+            // The stop may have been requested before this thread first waited
+            if (_state == State::kStopRequested) {
+                break;
+            }
+
+            // Sleep until the next period, or until sampling is enabled again if disabled
+            auto status = stdx::cv_status::no_timeout;
+            if (isHighFrequencySamplingEnabled(_highFrequencyConfig)) {
+                auto next_time = FTDCUtil::roundTime(clockSource->now(),
+                                                     _highFrequencyConfig.highFrequencyPeriod);
+                status = _highFrequencyCondvar.wait_until(lock, next_time.toSystemTimePoint());
+            } else {
+                _highFrequencyCondvar.wait(lock, [&] {
+                    return _state == State::kStopRequested ||
+                        isHighFrequencySamplingEnabled(_configTemp);
+                });
+            }
+
+            // Are we done running?
+            if (_state == State::kStopRequested) {
+                break;
+            }
+
+            _highFrequencyConfig = _configTemp;
+
+            // Hand the samples taken before sampling was disabled to the collection thread
+            if (!isHighFrequencySamplingEnabled(_highFrequencyConfig)) {
+                auto swChunk = _highFrequencySampler.flush();
+                uassertStatusOK(swChunk.getStatus());
+
+                if (swChunk.getValue()) {
+                    _pendingHighFrequencyChunks.push_back(std::move(swChunk.getValue().get()));
+                }
+                continue;
+            }
+
+            // if we were signalled, then we have a config update only
+            if (status == stdx::cv_status::no_timeout) {
+                continue;
+            }
+        }
+
+        // Sampling does not allocate, except for the reference document and completed chunks
+        auto swChunk = _highFrequencySampler.sample(clockSource->now());
+        uassertStatusOK(swChunk.getStatus());
+
+        if (swChunk.getValue()) {
+            stdx::lock_guard<Latch> lock(_mutex);
+            _pendingHighFrequencyChunks.push_back(std::move(swChunk.getValue().get()));
+        }
+    }
+}
+
+Status FTDCController::writeHighFrequencyChunks(Client* client) {
+    std::vector<BSONObj> chunks;
+    {
+        stdx::lock_guard<Latch> lock(_mutex);
+        std::swap(chunks, _pendingHighFrequencyChunks);
+    }
+
+    for (auto&& chunk : chunks) {
+        Status s = _mgr->writeMetricChunkAndRotateIfNeeded(client, chunk);
+        if (!s.isOK()) {
+            return s;
+        }
+    }
+
+    return Status::OK();
+}
+
 }  // namespace mongo
@@ -32,14 +32,17 @@
 #include <boost/filesystem/path.hpp>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/file_manager.h"
+#include "mongo/db/ftdc/high_frequency_sampler.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/with_lock.h"
 
 namespace mongo {
 
@@ -57,7 +60,10 @@ class FTDCController {
 
 public:
     FTDCController(const boost::filesystem::path path, FTDCConfig config)
-        : _path(path), _config(std::move(config)), _configTemp(_config) {}
+        : _path(path),
+          _config(std::move(config)),
+          _configTemp(_config),
+          _highFrequencyConfig(_config) {}
 
     ~FTDCController() = default;
 
@@ -75,6 +81,11 @@ public:
      */
     void setPeriod(Milliseconds millis);
 
+    /**
+     * Set the period for high frequency counter sampling. Zero disables it.
+     */
+    void setHighFrequencyPeriod(Milliseconds millis);
+
     /**
      * Set the maximum directory size in bytes.
      */
@@ -118,10 +129,18 @@ public:
      */
     void addOnRotateCollector(std::unique_ptr<FTDCCollectorInterface> collector);
 
+    /**
+     * Add a counter to sample on the high frequency period. i.e., opcounters.insert
+     *
+     * The counter must outlive the controller. See FTDCHighFrequencySampler.
+     */
+    void addHighFrequencyCounter(StringData name, const AtomicWord<long long>* counter);
+
     /**
      * Start the controller.
      *
-     * Spawns a new thread.
+     * Spawns a new thread, and a second one to sample the high frequency counters if any were
+     * added.
      */
     void start();
 
@@ -148,6 +167,22 @@ private:
      */
     void doLoop() noexcept;
 
+    /**
+     * Sample the high frequency counters on the background high frequency thread.
+     */
+    void doHighFrequencyLoop() noexcept;
+
+    /**
+     * Start the high frequency thread if the controller runs, there are counters to sample, and
+     * sampling has a period.
+     */
+    void startHighFrequencyThreadIfNeeded(WithLock);
+
+    /**
+     * Write the chunks of high frequency samples completed so far to disk.
+     */
+    Status writeHighFrequencyChunks(Client* client);
+
 private:
     /**
      * Private enum to track state.
@@ -186,9 +221,11 @@ private:
     // Directory to store files
     boost::filesystem::path _path;
 
-    // Mutex to protect the condvar, configuration changes, and most recent periodic document.
+    // Mutex to protect the condvars, configuration changes, most recent periodic document, and
+    // pending high frequency chunks.
     Mutex _mutex = MONGO_MAKE_LATCH("FTDCController::_mutex");
     stdx::condition_variable _condvar;
+    stdx::condition_variable _highFrequencyCondvar;
 
     // Config settings that are used by controller, file manager, and all other classes.
     // Copied from _configTemp periodically to get a consistent snapshot.
@@ -210,8 +247,22 @@ private:
     // File manager that manages file rotation, and logging
     std::unique_ptr<FTDCFileManager> _mgr;
 
+    // Config settings that are used by the high frequency sampler.
+    // Copied from _configTemp by the high frequency thread, which is the only one to read it.
+    FTDCConfig _highFrequencyConfig;
+
+    // Sampler for the high frequency counters, only used by the high frequency thread
+    FTDCHighFrequencySampler _highFrequencySampler{&_highFrequencyConfig};
+
+    // Chunks of high frequency samples waiting to be written by the collection thread
+    std::vector<BSONObj> _pendingHighFrequencyChunks;
+
     // Background collection and writing thread
     stdx::thread _thread;
+
+    // Background high frequency sampling thread, started once sampling has a period, and joined by
+    // the collection thread on shutdown
+    stdx::thread _highFrequencyThread;
 };
 
 }  // namespace mongo
@@ -43,11 +43,15 @@
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/constants.h"
 #include "mongo/db/ftdc/controller.h"
+#include "mongo/db/ftdc/file_reader.h"
 #include "mongo/db/ftdc/ftdc_test.h"
+#include "mongo/db/ftdc/util.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/system_clock_source.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -283,4 +287,273 @@ TEST_F(FTDCControllerTest, TestStartAsDisabled) {
     ValidateDocumentList(alog, allDocs, FTDCValidationMode::kStrict);
 }
 
+namespace {
+
+/**
+ * Read the high frequency samples from the archive file in dir, returning each sample with the _id
+ * of its chunk. Stops at the first incomplete document unless strict is set, so that the file can
+ * be read while the controller is still writing it.
+ */
+std::vector<std::pair<Date_t, BSONObj>> readHighFrequencySamples(const boost::filesystem::path& dir,
+                                                                 bool strict) {
+    std::vector<std::pair<Date_t, BSONObj>> samples;
+
+    std::vector<boost::filesystem::path> files;
+    for (auto&& file : scanDirectory(dir)) {
+        if (file != FTDCUtil::getInterimFile(dir) && file != FTDCUtil::getInterimTempFile(dir)) {
+            files.push_back(file);
+        }
+    }
+    if (files.empty()) {
+        return samples;
+    }
+    ASSERT_EQUALS(files.size(), 1UL);
+
+    FTDCFileReader reader;
+    ASSERT_OK(reader.open(files[0]));
+
+    auto sw = reader.hasNext();
+    while (sw.isOK() && sw.getValue()) {
+        auto next = reader.next();
+        const BSONObj& doc = std::get<1>(next);
+        if (std::get<0>(next) == FTDCBSONUtil::FTDCType::kMetricChunk &&
+            doc.hasField("highFrequencyCounters")) {
+            samples.emplace_back(std::get<2>(next), doc.getOwned());
+        }
+        sw = reader.hasNext();
+    }
+
+    if (strict) {
+        ASSERT_OK(sw);
+    }
+
+    return samples;
+}
+
+/**
+ * Wait until the archive file in dir contains at least count high frequency samples.
+ */
+void waitForHighFrequencySamples(const boost::filesystem::path& dir, size_t count) {
+    auto deadline = Date_t::now() + Seconds(30);
+    while (readHighFrequencySamples(dir, false).size() < count) {
+        ASSERT_LESS_THAN(Date_t::now(), deadline);
+        sleepmillis(10);
+    }
+}
+
+/**
+ * Assert that the samples are in a single chunk which is not full, i.e. that the chunk was written
+ * by a flush.
+ */
+void assertFlushedChunk(const std::vector<std::pair<Date_t, BSONObj>>& samples) {
+    ASSERT_GREATER_THAN_OR_EQUALS(samples.size(), 1UL);
+    ASSERT_LESS_THAN(samples.size(),
+                     static_cast<size_t>(FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault));
+    for (const auto& sample : samples) {
+        ASSERT_EQ(sample.first, samples[0].first);
+    }
+}
+
+}  // namespace
+
+// The high frequency thread sleeps until the next period of the precise clock source, which would
+// never advance if it was mocked, so these tests run on the system clock.
+class FTDCControllerHighFrequencyTest : public FTDCControllerTest {
+public:
+    FTDCControllerHighFrequencyTest() {
+        getServiceContext()->setPreciseClockSource(std::make_unique<SystemClockSource>());
+    }
+
+    FTDCConfig makeConfig() {
+        FTDCConfig config;
+        config.enabled = true;
+        config.period = Milliseconds(1);
+        config.highFrequencyPeriod = Milliseconds(10);
+        config.maxFileSizeBytes = FTDCConfig::kMaxFileSizeBytesDefault;
+        config.maxDirectorySizeBytes = FTDCConfig::kMaxDirectorySizeBytesDefault;
+        return config;
+    }
+};
+
+// Test we can start and stop the controller with high frequency counters in quick succession
+// whether high frequency sampling is enabled or not, and whether FTDC is enabled or not
+TEST_F(FTDCControllerHighFrequencyTest, TestStartStop) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path dir(tempdir.path());
+
+    createDirectoryClean(dir);
+
+    AtomicWord<long long> counter;
+
+    for (auto enabled : {true, false}) {
+        for (auto period : {Milliseconds(0), Milliseconds(10)}) {
+            FTDCConfig config = makeConfig();
+            config.enabled = enabled;
+            config.highFrequencyPeriod = period;
+
+            FTDCController c(dir, config);
+
+            // The collector must collect before it is destroyed, so only add it when enabled
+            FTDCMetricsCollectorMock2* c1Ptr = nullptr;
+            if (enabled) {
+                auto c1 = std::make_unique<FTDCMetricsCollectorMock2>();
+                c1Ptr = c1.get();
+                c1Ptr->setSignalOnCount(1);
+                c.addPeriodicCollector(std::move(c1));
+            }
+
+            c.addHighFrequencyCounter("counter", &counter);
+
+            c.start();
+
+            if (c1Ptr) {
+                c1Ptr->wait();
+            }
+
+            c.stop();
+        }
+    }
+}
+
+// Test the high frequency thread hands the chunks it fills to the collection thread, which writes
+// them while running
+TEST_F(FTDCControllerHighFrequencyTest, TestFullChunks) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path dir(tempdir.path());
+
+    createDirectoryClean(dir);
+
+    FTDCConfig config = makeConfig();
+    config.maxSamplesPerArchiveMetricChunk = 3;
+
+    FTDCController c(dir, config);
+
+    c.addPeriodicCollector(std::make_unique<FTDCMetricsCollectorMock2>());
+
+    AtomicWord<long long> counter{42};
+    c.addHighFrequencyCounter("counter", &counter);
+
+    c.start();
+
+    // Wait for two full chunks to be written
+    waitForHighFrequencySamples(dir, 6);
+
+    c.stop();
+
+    auto samples = readHighFrequencySamples(dir, true);
+    ASSERT_GREATER_THAN_OR_EQUALS(samples.size(), 6UL);
+
+    // Each chunk holds 3 samples taken in order, except the one flushed on shutdown
+    size_t chunkSamples = 0;
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const auto& sample = samples[i].second;
+        ASSERT_EQ(sample["highFrequencyCounters"]["counter"].numberLong(), 42);
+
+        if (i > 0) {
+            ASSERT_GREATER_THAN(sample["start"].Date(), samples[i - 1].second["start"].Date());
+
+            if (samples[i].first != samples[i - 1].first) {
+                ASSERT_EQ(chunkSamples, 3UL);
+                chunkSamples = 0;
+            }
+        }
+        ++chunkSamples;
+    }
+    ASSERT_LESS_THAN_OR_EQUALS(chunkSamples, 3UL);
+}
+
+// Test the samples taken before shutdown are written although they do not fill a chunk
+TEST_F(FTDCControllerHighFrequencyTest, TestFlushOnStop) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path dir(tempdir.path());
+
+    createDirectoryClean(dir);
+
+    FTDCController c(dir, makeConfig());
+
+    auto c1 = std::make_unique<FTDCMetricsCollectorMock2>();
+    auto c1Ptr = c1.get();
+    c1Ptr->setSignalOnCount(100);
+    c.addPeriodicCollector(std::move(c1));
+
+    AtomicWord<long long> counter;
+    c.addHighFrequencyCounter("counter", &counter);
+
+    c.start();
+
+    // Wait for 100 samples to have occured, spanning several high frequency periods
+    c1Ptr->wait();
+
+    c.stop();
+
+    assertFlushedChunk(readHighFrequencySamples(dir, true));
+}
+
+// Test the samples taken before high frequency sampling is disabled are written while the
+// controller runs, and that no more samples are taken while it is disabled
+TEST_F(FTDCControllerHighFrequencyTest, TestFlushOnDisable) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path dir(tempdir.path());
+
+    createDirectoryClean(dir);
+
+    FTDCController c(dir, makeConfig());
+
+    auto c1 = std::make_unique<FTDCMetricsCollectorMock2>();
+    auto c1Ptr = c1.get();
+    c1Ptr->setSignalOnCount(100);
+    c.addPeriodicCollector(std::move(c1));
+
+    AtomicWord<long long> counter;
+    c.addHighFrequencyCounter("counter", &counter);
+
+    c.start();
+
+    // Wait for 100 samples to have occured, spanning several high frequency periods
+    c1Ptr->wait();
+
+    c.setHighFrequencyPeriod(Milliseconds(0));
+
+    waitForHighFrequencySamples(dir, 1);
+    auto samples = readHighFrequencySamples(dir, false);
+    assertFlushedChunk(samples);
+
+    // Wait for 100 more samples
+    c1Ptr->setSignalOnCount(200);
+    c1Ptr->wait();
+
+    c.stop();
+
+    ASSERT_EQUALS(readHighFrequencySamples(dir, true).size(), samples.size());
+}
+
+// Test the high frequency thread is started once sampling is given a period after the controller
+// started without one
+TEST_F(FTDCControllerHighFrequencyTest, TestEnableAfterStart) {
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path dir(tempdir.path());
+
+    createDirectoryClean(dir);
+
+    FTDCConfig config = makeConfig();
+    config.highFrequencyPeriod = Milliseconds(0);
+    config.maxSamplesPerArchiveMetricChunk = 3;
+
+    FTDCController c(dir, config);
+
+    c.addPeriodicCollector(std::make_unique<FTDCMetricsCollectorMock2>());
+
+    AtomicWord<long long> counter;
+    c.addHighFrequencyCounter("counter", &counter);
+
+    c.start();
+
+    c.setHighFrequencyPeriod(Milliseconds(10));
+
+    // Wait for a full chunk to be written
+    waitForHighFrequencySamples(dir, 3);
+
+    c.stop();
+}
+
 }  // namespace mongo
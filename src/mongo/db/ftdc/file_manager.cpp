@@ -339,6 +339,20 @@ Status FTDCFileManager::writeSampleAndRotateIfNeeded(Client* client,
     return Status::OK();
 }
 
+Status FTDCFileManager::writeMetricChunkAndRotateIfNeeded(Client* client, const BSONObj& chunk) {
+    Status s = _writer.writeMetricChunk(chunk);
+
+    if (!s.isOK()) {
+        return s;
+    }
+
+    if (_writer.getSize() > _config->maxFileSizeBytes) {
+        return rotate(client);
+    }
+
+    return Status::OK();
+}
+
 Status FTDCFileManager::close() {
     return _writer.close();
 }
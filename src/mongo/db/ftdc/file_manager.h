@@ -85,6 +85,13 @@ public:
      */
     Status writeSampleAndRotateIfNeeded(Client* client, const BSONObj& sample, Date_t date);
 
+    /**
+     * Writes a metric chunk compressed by the caller to disk via FTDCFileWriter.
+     *
+     * Rotates files as needed.
+     */
+    Status writeMetricChunkAndRotateIfNeeded(Client* client, const BSONObj& chunk);
+
     /**
      * Closes the current file manager down.
      */
@@ -176,6 +176,10 @@ Status FTDCFileWriter::writeSample(const BSONObj& sample, Date_t date) {
     return Status::OK();
 }
 
+Status FTDCFileWriter::writeMetricChunk(const BSONObj& chunk) {
+    return writeArchiveFileBuffer({chunk.objdata(), static_cast<size_t>(chunk.objsize())});
+}
+
 Status FTDCFileWriter::flush(const boost::optional<ConstDataRange>& range, Date_t date) {
     if (!range.is_initialized()) {
         if (_compressor.hasDataToFlush()) {
@@ -81,6 +81,13 @@ public:
      */
     Status writeSample(const BSONObj& sample, Date_t date);
 
+    /**
+     * Write a metric chunk document compressed by the caller to the archive log.
+     *
+     * The chunk is independent of the samples buffered by writeSample.
+     */
+    Status writeMetricChunk(const BSONObj& chunk);
+
     /**
      * Close all the files and shutdown cleanly by zeroing the beginning of the interim file.
      */
@@ -46,6 +46,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/mirror_maestro.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/counters.h"
 #include "mongo/util/synchronized_value.h"
 
 namespace mongo {
@@ -68,6 +69,11 @@ FTDCController* getGlobalFTDCController() {
  */
 synchronized_value<boost::filesystem::path> ftdcDirectoryPathParameter;
 
+/**
+ * Shortest allowed period for high frequency sampling, i.e. 100Hz.
+ */
+constexpr std::int32_t kMinHighFrequencyPeriodMillis = 10;
+
 }  // namespace
 
 FTDCStartupParams ftdcStartupParams;
@@ -116,6 +122,24 @@ Status onUpdateFTDCPeriod(const std::int32_t potentialNewValue) {
     return Status::OK();
 }
 
+Status onUpdateFTDCHighFrequencyPeriod(const std::int32_t potentialNewValue) {
+    // Sampling faster than 100Hz costs more than the stalls it could show are worth.
+    if (potentialNewValue != 0 && potentialNewValue < kMinHighFrequencyPeriodMillis) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream()
+                          << "diagnosticDataCollectionHighFrequencyPeriodMillis must be 0 or "
+                             "greater than or equal to '"
+                          << kMinHighFrequencyPeriodMillis << "'.");
+    }
+
+    auto controller = getGlobalFTDCController();
+    if (controller) {
+        controller->setHighFrequencyPeriod(Milliseconds(potentialNewValue));
+    }
+
+    return Status::OK();
+}
+
 Status onUpdateFTDCDirectorySize(const std::int32_t potentialNewValue) {
     if (potentialNewValue < ftdcStartupParams.maxFileSizeMB.load()) {
         return Status(
@@ -249,6 +273,7 @@ void startFTDC(boost::filesystem::path& path,
                RegisterCollectorsFunction registerCollectors) {
     FTDCConfig config;
     config.period = Milliseconds(ftdcStartupParams.periodMillis.load());
+    config.highFrequencyPeriod = Milliseconds(ftdcStartupParams.highFrequencyPeriodMillis.load());
     // Only enable FTDC if our caller says to enable FTDC, MongoS may not have a valid path to write
     // files to so update the diagnosticDataCollectionEnabled set parameter to reflect that.
     ftdcStartupParams.enabled.store(startupMode == FTDCStartMode::kStart &&
@@ -276,6 +301,18 @@ void startFTDC(boost::filesystem::path& path,
     // Install System Metric Collector as a periodic collector
     installSystemMetricsCollector(controller.get());
 
+    // Install high frequency counters
+    // These are sampled on the high frequency period in FTDCConfig, which is disabled by default.
+    controller->addHighFrequencyCounter("opcounters.insert", globalOpCounters.getInsert());
+    controller->addHighFrequencyCounter("opcounters.query", globalOpCounters.getQuery());
+    controller->addHighFrequencyCounter("opcounters.update", globalOpCounters.getUpdate());
+    controller->addHighFrequencyCounter("opcounters.delete", globalOpCounters.getDelete());
+    controller->addHighFrequencyCounter("opcounters.getmore", globalOpCounters.getGetMore());
+    controller->addHighFrequencyCounter("opcounters.command", globalOpCounters.getCommand());
+    controller->addHighFrequencyCounter("network.bytesIn", networkCounter.getLogicalBytesIn());
+    controller->addHighFrequencyCounter("network.bytesOut", networkCounter.getLogicalBytesOut());
+    controller->addHighFrequencyCounter("network.numRequests", networkCounter.getRequests());
+
     // Install file rotation collectors
     // These are collected on each file rotation.
 
@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/high_frequency_sampler.h"
+
+#include <algorithm>
+
+#include "mongo/db/ftdc/constants.h"
+#include "mongo/db/ftdc/util.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+constexpr auto kHighFrequencyCountersField = "highFrequencyCounters"_sd;
+
+}  // namespace
+
+void FTDCHighFrequencySampler::addCounter(StringData name, const AtomicWord<long long>* counter) {
+    invariant(!_compressor.hasDataToFlush());
+    invariant(std::find(_names.begin(), _names.end(), name) == _names.end());
+
+    _names.push_back(name.toString());
+    _counters.push_back(counter);
+    _metrics.reserve(_counters.size() + 1);
+}
+
+StatusWith<boost::optional<BSONObj>> FTDCHighFrequencySampler::sample(Date_t date) {
+    _metrics.clear();
+    _metrics.push_back(date.toMillisSinceEpoch());
+    for (auto counter : _counters) {
+        _metrics.push_back(counter->loadRelaxed());
+    }
+
+    // Only the first sample of a chunk needs a reference document.
+    BSONObj referenceDoc;
+    if (!_compressor.hasDataToFlush()) {
+        referenceDoc = _makeReferenceDocument();
+    }
+
+    auto swResult = _compressor.addSample(_metrics, referenceDoc, date);
+    if (!swResult.isOK()) {
+        return swResult.getStatus();
+    }
+
+    if (!swResult.getValue()) {
+        return {boost::none};
+    }
+
+    return {FTDCBSONUtil::createBSONMetricChunkDocument(std::get<0>(swResult.getValue().get()),
+                                                        std::get<2>(swResult.getValue().get()))};
+}
+
+StatusWith<boost::optional<BSONObj>> FTDCHighFrequencySampler::flush() {
+    if (!_compressor.hasDataToFlush()) {
+        return {boost::none};
+    }
+
+    auto swBuf = _compressor.getCompressedSamples();
+    if (!swBuf.isOK()) {
+        return swBuf.getStatus();
+    }
+
+    BSONObj chunk = FTDCBSONUtil::createBSONMetricChunkDocument(std::get<0>(swBuf.getValue()),
+                                                                std::get<1>(swBuf.getValue()));
+    _compressor.reset();
+
+    return {std::move(chunk)};
+}
+
+BSONObj FTDCHighFrequencySampler::_makeReferenceDocument() const {
+    BSONObjBuilder builder;
+    builder.appendDate(kFTDCCollectStartField,
+                       Date_t::fromMillisSinceEpoch(static_cast<long long>(_metrics[0])));
+
+    BSONObjBuilder countersBuilder(builder.subobjStart(kHighFrequencyCountersField));
+    for (std::size_t i = 0; i < _names.size(); ++i) {
+        countersBuilder.append(_names[i], static_cast<long long>(_metrics[i + 1]));
+    }
+    countersBuilder.done();
+
+    return builder.obj();
+}
+
+}  // namespace mongo
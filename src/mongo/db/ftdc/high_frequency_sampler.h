@@ -0,0 +1,121 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/ftdc/compressor.h"
+#include "mongo/db/ftdc/config.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * Samples a fixed set of counters at a high frequency, i.e. 10-100Hz, so that FTDC can capture
+ * stalls shorter than the regular collection period.
+ *
+ * Counters are registered as pointers to the atomics their owners already update, so sampling a
+ * counter is a single relaxed load. Unlike the periodic collectors, a sample does not build a
+ * BSON document or allocate memory: the values are read into a preallocated vector which the
+ * compressor delta encodes directly. A BSON reference document is only built once per chunk.
+ *
+ * The samples are stored as ordinary metric chunks whose reference document has the schema:
+ * {
+ *    "start" : Date_t,               <- Time at which the sample was taken
+ *    "highFrequencyCounters" : {
+ *       "name" : NumberLong,         <- name is from addCounter()
+ *       ...
+ *    }
+ * }
+ *
+ * Not Thread-Safe. Locking is owner's responsibility.
+ */
+class FTDCHighFrequencySampler {
+    FTDCHighFrequencySampler(const FTDCHighFrequencySampler&) = delete;
+    FTDCHighFrequencySampler& operator=(const FTDCHighFrequencySampler&) = delete;
+
+public:
+    explicit FTDCHighFrequencySampler(const FTDCConfig* config) : _compressor(config) {}
+
+    /**
+     * Register a counter to sample. Must be called before the first call to sample(). The counter
+     * must outlive this sampler.
+     */
+    void addCounter(StringData name, const AtomicWord<long long>* counter);
+
+    /**
+     * Returns true if no counters have been registered.
+     */
+    bool empty() const {
+        return _counters.empty();
+    }
+
+    /**
+     * Read all counters and add them to the current chunk as a sample taken at date.
+     *
+     * Returns a metric chunk document, see FTDCBSONUtil::createBSONMetricChunkDocument, when this
+     * sample fills the current chunk, and boost::none otherwise.
+     */
+    StatusWith<boost::optional<BSONObj>> sample(Date_t date);
+
+    /**
+     * Returns a metric chunk document containing the samples which have not been returned by
+     * sample() yet, or boost::none if there are none, and starts a new chunk.
+     */
+    StatusWith<boost::optional<BSONObj>> flush();
+
+private:
+    /**
+     * Build a reference document with the schema above for the metrics in _metrics.
+     */
+    BSONObj _makeReferenceDocument() const;
+
+private:
+    // Names of the registered counters, in the same order as _counters
+    std::vector<std::string> _names;
+
+    // Registered counters
+    std::vector<const AtomicWord<long long>*> _counters;
+
+    // Buffer to hold the current sample: the sample date followed by one value per counter
+    std::vector<std::uint64_t> _metrics;
+
+    // Compressor for the current chunk
+    FTDCCompressor _compressor;
+};
+
+}  // namespace mongo
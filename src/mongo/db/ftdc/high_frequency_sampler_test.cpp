@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/config.h"
+#include "mongo/db/ftdc/decompressor.h"
+#include "mongo/db/ftdc/ftdc_test.h"
+#include "mongo/db/ftdc/high_frequency_sampler.h"
+#include "mongo/db/ftdc/util.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+
+class FTDCHighFrequencySamplerTest : public FTDCTest {};
+
+namespace {
+
+std::vector<BSONObj> decompressChunk(const BSONObj& chunk) {
+    FTDCDecompressor decompressor;
+    auto swDocs = FTDCBSONUtil::getMetricsFromMetricDoc(chunk, &decompressor);
+    ASSERT_OK(swDocs.getStatus());
+    return swDocs.getValue();
+}
+
+void assertSample(const BSONObj& doc, Date_t date, long long a, long long b) {
+    ASSERT_EQ(doc["start"].Date(), date);
+    ASSERT_EQ(doc["highFrequencyCounters"]["a"].numberLong(), a);
+    ASSERT_EQ(doc["highFrequencyCounters"]["b"].numberLong(), b);
+}
+
+}  // namespace
+
+// Samples are returned as a metric chunk once the chunk is full
+TEST_F(FTDCHighFrequencySamplerTest, TestFullChunk) {
+    FTDCConfig config;
+    config.maxSamplesPerArchiveMetricChunk = 5;
+    FTDCHighFrequencySampler sampler(&config);
+
+    AtomicWord<long long> a;
+    AtomicWord<long long> b;
+    sampler.addCounter("a", &a);
+    sampler.addCounter("b", &b);
+
+    auto dateFor = [](int i) { return Date_t::fromMillisSinceEpoch(1000 + i * 10); };
+
+    for (int i = 0; i < 4; ++i) {
+        a.store(i);
+        b.store(-10 * i);
+        auto swChunk = sampler.sample(dateFor(i));
+        ASSERT_OK(swChunk.getStatus());
+        ASSERT_FALSE(swChunk.getValue());
+    }
+
+    a.store(4);
+    b.store(-40);
+    auto swChunk = sampler.sample(dateFor(4));
+    ASSERT_OK(swChunk.getStatus());
+    ASSERT_TRUE(swChunk.getValue());
+
+    auto chunk = swChunk.getValue().get();
+    ASSERT_EQ(FTDCBSONUtil::getBSONDocumentId(chunk).getValue(), dateFor(0));
+
+    auto docs = decompressChunk(chunk);
+    ASSERT_EQ(docs.size(), 5UL);
+    for (int i = 0; i < 5; ++i) {
+        assertSample(docs[i], dateFor(i), i, -10 * i);
+    }
+
+    // Nothing is left to flush
+    auto swFlushed = sampler.flush();
+    ASSERT_OK(swFlushed.getStatus());
+    ASSERT_FALSE(swFlushed.getValue());
+}
+
+// A partial chunk can be flushed, and sampling starts a new chunk afterwards
+TEST_F(FTDCHighFrequencySamplerTest, TestFlushPartialChunk) {
+    FTDCConfig config;
+    FTDCHighFrequencySampler sampler(&config);
+
+    AtomicWord<long long> a;
+    AtomicWord<long long> b;
+    sampler.addCounter("a", &a);
+    sampler.addCounter("b", &b);
+
+    for (int i = 0; i < 3; ++i) {
+        a.fetchAndAdd(i);
+        ASSERT_OK(sampler.sample(Date_t::fromMillisSinceEpoch(i)).getStatus());
+    }
+
+    auto swFlushed = sampler.flush();
+    ASSERT_OK(swFlushed.getStatus());
+    ASSERT_TRUE(swFlushed.getValue());
+
+    auto docs = decompressChunk(swFlushed.getValue().get());
+    ASSERT_EQ(docs.size(), 3UL);
+    assertSample(docs[0], Date_t::fromMillisSinceEpoch(0), 0, 0);
+    assertSample(docs[1], Date_t::fromMillisSinceEpoch(1), 1, 0);
+    assertSample(docs[2], Date_t::fromMillisSinceEpoch(2), 3, 0);
+
+    b.store(7);
+    ASSERT_OK(sampler.sample(Date_t::fromMillisSinceEpoch(3)).getStatus());
+
+    swFlushed = sampler.flush();
+    ASSERT_OK(swFlushed.getStatus());
+    ASSERT_TRUE(swFlushed.getValue());
+
+    docs = decompressChunk(swFlushed.getValue().get());
+    ASSERT_EQ(docs.size(), 1UL);
+    assertSample(docs[0], Date_t::fromMillisSinceEpoch(3), 3, 7);
+}
+
+}  // namespace mongo
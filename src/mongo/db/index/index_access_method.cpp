@@ -486,6 +486,12 @@ public:
                   const RecordId& loc,
                   const InsertDeleteOptions& options) final;
 
+    Status insert(OperationContext* opCtx,
+                  const BSONObj& obj,
+                  const RecordId& loc,
+                  const InsertDeleteOptions& options,
+                  const OnSkippedRecordFn& onSkippedRecord) final;
+
     const MultikeyPaths& getMultikeyPaths() const final;
 
     bool isMultikey() const final;
@@ -551,6 +557,20 @@ Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(OperationContext* opCt
                                                           const BSONObj& obj,
                                                           const RecordId& loc,
                                                           const InsertDeleteOptions& options) {
+    return insert(opCtx, obj, loc, options, [&](const RecordId& skippedLoc) {
+        auto interceptor = _indexCatalogEntry->indexBuildInterceptor();
+        if (interceptor && interceptor->getSkippedRecordTracker()) {
+            interceptor->getSkippedRecordTracker()->record(opCtx, skippedLoc);
+        }
+    });
+}
+
+Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(
+    OperationContext* opCtx,
+    const BSONObj& obj,
+    const RecordId& loc,
+    const InsertDeleteOptions& options,
+    const OnSkippedRecordFn& onSkippedRecord) {
     auto& executionCtx = StorageExecutionContext::get(opCtx);
 
     auto keys = executionCtx.keys();
@@ -569,17 +589,14 @@ Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(OperationContext* opCt
             [&](Status status, const BSONObj&, boost::optional<RecordId>) {
                 // If a key generation error was suppressed, record the document as "skipped" so the
                 // index builder can retry at a point when data is consistent.
-                auto interceptor = _indexCatalogEntry->indexBuildInterceptor();
-                if (interceptor && interceptor->getSkippedRecordTracker()) {
-                    LOGV2_DEBUG(20684,
-                                1,
-                                "Recording suppressed key generation error to retry later: "
-                                "{error} on {loc}: {obj}",
-                                "error"_attr = status,
-                                "loc"_attr = loc,
-                                "obj"_attr = redact(obj));
-                    interceptor->getSkippedRecordTracker()->record(opCtx, loc);
-                }
+                LOGV2_DEBUG(20684,
+                            1,
+                            "Recording suppressed key generation error to retry later: "
+                            "{error} on {loc}: {obj}",
+                            "error"_attr = status,
+                            "loc"_attr = loc,
+                            "obj"_attr = redact(obj));
+                onSkippedRecord(loc);
             });
     } catch (...) {
         return exceptionToStatus();
@@ -242,6 +242,19 @@ public:
                               const RecordId& loc,
                               const InsertDeleteOptions& options) = 0;
 
+        /**
+         * Like insert(), but calls 'onSkippedRecord' with 'loc' if a key generation error for
+         * 'obj' was suppressed, instead of recording 'loc' with the index build's skipped record
+         * tracker. This does no writes to the storage engine, so it may be called on an
+         * OperationContext which holds none of the index build's locks.
+         */
+        using OnSkippedRecordFn = std::function<void(const RecordId&)>;
+        virtual Status insert(OperationContext* opCtx,
+                              const BSONObj& obj,
+                              const RecordId& loc,
+                              const InsertDeleteOptions& options,
+                              const OnSkippedRecordFn& onSkippedRecord) = 0;
+
         virtual const MultikeyPaths& getMultikeyPaths() const = 0;
 
         virtual bool isMultikey() const = 0;
@@ -358,6 +358,7 @@ MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
         lv2Config.fileOpenMode = serverGlobalParams.logAppend
             ? logv2::LogDomainGlobal::ConfigurationOptions::OpenMode::kAppend
             : logv2::LogDomainGlobal::ConfigurationOptions::OpenMode::kTruncate;
+        lv2Config.fileAsyncOptions = serverGlobalParams.logAsyncOptions;
 
         if (serverGlobalParams.logAppend && exists) {
             writeServerRestartedAfterLogConfig = true;
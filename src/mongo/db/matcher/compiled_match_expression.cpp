@@ -0,0 +1,316 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+#include "mongo/db/field_ref.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_path.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+void flattenConjunction(const MatchExpression* expr, std::vector<const MatchExpression*>* out) {
+    if (expr->matchType() != MatchExpression::AND) {
+        out->push_back(expr);
+        return;
+    }
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        flattenConjunction(expr->getChild(i), out);
+    }
+}
+
+bool isComparison(MatchExpression::MatchType matchType) {
+    switch (matchType) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+template <typename T>
+int compareValues(T lhs, T rhs) {
+    return lhs < rhs ? -1 : (lhs == rhs ? 0 : 1);
+}
+
+// Compares string values the way BSONElement::compareElements() does without a collator.
+int compareStrings(const BSONElement& lhs, const BSONElement& rhs) {
+    const int lhsSize = lhs.valuestrsize();
+    const int rhsSize = rhs.valuestrsize();
+    const int res = std::memcmp(lhs.valuestr(), rhs.valuestr(), std::min(lhsSize, rhsSize));
+    return res ? res : lhsSize - rhsSize;
+}
+
+bool applyMatchType(MatchExpression::MatchType matchType, int cmp) {
+    switch (matchType) {
+        case MatchExpression::LT:
+            return cmp < 0;
+        case MatchExpression::LTE:
+            return cmp <= 0;
+        case MatchExpression::EQ:
+            return cmp == 0;
+        case MatchExpression::GT:
+            return cmp > 0;
+        case MatchExpression::GTE:
+            return cmp >= 0;
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+}  // namespace
+
+std::unique_ptr<CompiledMatchExpression> CompiledMatchExpression::compile(
+    const MatchExpression* expr) {
+    std::unique_ptr<CompiledMatchExpression> compiled(new CompiledMatchExpression());
+
+    std::vector<const MatchExpression*> conjuncts;
+    flattenConjunction(expr, &conjuncts);
+    for (auto&& conjunct : conjuncts) {
+        auto pathExpr = dynamic_cast<const PathMatchExpression*>(conjunct);
+        if (pathExpr && compiled->_addLeaf(pathExpr)) {
+            continue;
+        }
+        compiled->_interpreted.push_back(conjunct);
+    }
+
+    if (compiled->_leaves.empty()) {
+        return nullptr;
+    }
+    return compiled;
+}
+
+bool CompiledMatchExpression::_addLeaf(const PathMatchExpression* expr) {
+    if (_leaves.size() == kMaxLeaves || expr->path().empty()) {
+        return false;
+    }
+
+    const size_t index = _leaves.size();
+    Leaf leaf{expr};
+    if (isComparison(expr->matchType())) {
+        auto comparison = static_cast<const ComparisonMatchExpressionBase*>(expr);
+        leaf.rhs = comparison->getData();
+        switch (leaf.rhs.type()) {
+            case NumberInt:
+                leaf.comparator = Comparator::kNumberInt;
+                break;
+            case NumberLong:
+                leaf.comparator = Comparator::kNumberLong;
+                break;
+            case NumberDouble:
+                // NaN compares equal to NaN only, which compareElements() special cases.
+                if (!std::isnan(leaf.rhs._numberDouble())) {
+                    leaf.comparator = Comparator::kNumberDouble;
+                }
+                break;
+            case String:
+                if (!comparison->getCollator()) {
+                    leaf.comparator = Comparator::kString;
+                }
+                break;
+            case jstOID:
+                leaf.comparator = Comparator::kObjectId;
+                break;
+            default:
+                break;
+        }
+    }
+    _leaves.push_back(leaf);
+
+    // Every node has at least one leaf in its subtree, so no node can have more than kMaxLeaves
+    // children.
+    FieldRef path(expr->path());
+    Node* node = &_root;
+    node->subtreeLeaves.push_back(index);
+    for (size_t i = 0; i < path.numParts(); ++i) {
+        const auto part = path.getPart(i);
+        auto it = std::find_if(node->children.begin(),
+                               node->children.end(),
+                               [&](const Node& child) { return child.fieldName == part; });
+        if (it == node->children.end()) {
+            node->children.emplace_back();
+            node->children.back().fieldName = part.toString();
+            it = std::prev(node->children.end());
+        }
+        node = &*it;
+        node->subtreeLeaves.push_back(index);
+    }
+    node->leaves.push_back(index);
+
+    if (!expr->matchesSingleElement(BSONElement())) {
+        _mustBeReached |= uint64_t{1} << index;
+    }
+    return true;
+}
+
+bool CompiledMatchExpression::matches(const BSONObj& doc) const {
+    uint64_t evaluated = 0;
+    if (!_matchObject(doc, _root, doc, &evaluated)) {
+        return false;
+    }
+
+    // The leaves the walk did not reach are on paths missing from the document.
+    if (_mustBeReached & ~evaluated) {
+        return false;
+    }
+
+    for (auto&& expr : _interpreted) {
+        if (!expr->matchesBSON(doc)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CompiledMatchExpression::_matchObject(const BSONObj& obj,
+                                           const Node& node,
+                                           const BSONObj& doc,
+                                           uint64_t* evaluated) const {
+    // Like path resolution in the interpreted matcher, only the first field with a given name is
+    // considered.
+    uint64_t seen = 0;
+    size_t remaining = node.children.size();
+    for (auto&& elem : obj) {
+        const auto fieldName = elem.fieldNameStringData();
+        for (size_t i = 0; i < node.children.size(); ++i) {
+            const uint64_t bit = uint64_t{1} << i;
+            if ((seen & bit) || node.children[i].fieldName != fieldName) {
+                continue;
+            }
+            seen |= bit;
+            --remaining;
+            if (!_matchElement(elem, node.children[i], doc, evaluated)) {
+                return false;
+            }
+            break;
+        }
+        if (remaining == 0) {
+            break;
+        }
+    }
+    return true;
+}
+
+bool CompiledMatchExpression::_matchElement(const BSONElement& elem,
+                                            const Node& node,
+                                            const BSONObj& doc,
+                                            uint64_t* evaluated) const {
+    if (elem.type() == Array) {
+        // Arrays anywhere along the path are traversed by the interpreted matcher.
+        for (auto index : node.subtreeLeaves) {
+            *evaluated |= uint64_t{1} << index;
+            if (!_leaves[index].expr->matchesBSON(doc)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    for (auto index : node.leaves) {
+        *evaluated |= uint64_t{1} << index;
+        if (!_matchLeaf(_leaves[index], elem)) {
+            return false;
+        }
+    }
+
+    // The paths continuing through a value that is not an object are missing from the document,
+    // so their leaves are left for matches() to handle.
+    if (!node.children.empty() && elem.type() == Object) {
+        return _matchObject(elem.embeddedObject(), node, doc, evaluated);
+    }
+    return true;
+}
+
+bool CompiledMatchExpression::_matchLeaf(const Leaf& leaf, const BSONElement& elem) const {
+    const auto matchType = leaf.expr->matchType();
+    switch (leaf.comparator) {
+        case Comparator::kGeneric:
+            break;
+        case Comparator::kNumberInt:
+            if (elem.type() == NumberInt) {
+                return applyMatchType(matchType,
+                                      compareValues(elem._numberInt(), leaf.rhs._numberInt()));
+            }
+            if (elem.type() == NumberLong) {
+                return applyMatchType(
+                    matchType,
+                    compareValues<long long>(elem._numberLong(), leaf.rhs._numberInt()));
+            }
+            break;
+        case Comparator::kNumberLong:
+            if (elem.type() == NumberLong) {
+                return applyMatchType(matchType,
+                                      compareValues(elem._numberLong(), leaf.rhs._numberLong()));
+            }
+            if (elem.type() == NumberInt) {
+                return applyMatchType(
+                    matchType,
+                    compareValues<long long>(elem._numberInt(), leaf.rhs._numberLong()));
+            }
+            break;
+        case Comparator::kNumberDouble:
+            if (elem.type() == NumberDouble && !std::isnan(elem._numberDouble())) {
+                return applyMatchType(
+                    matchType, compareValues(elem._numberDouble(), leaf.rhs._numberDouble()));
+            }
+            if (elem.type() == NumberInt) {
+                // Every int is exactly representable as a double.
+                return applyMatchType(
+                    matchType, compareValues<double>(elem._numberInt(), leaf.rhs._numberDouble()));
+            }
+            break;
+        case Comparator::kString:
+            if (elem.type() == String) {
+                return applyMatchType(matchType, compareStrings(elem, leaf.rhs));
+            }
+            break;
+        case Comparator::kObjectId:
+            if (elem.type() == jstOID) {
+                return applyMatchType(
+                    matchType, std::memcmp(elem.value(), leaf.rhs.value(), OID::kOIDSize));
+            }
+            break;
+    }
+    return leaf.expr->matchesSingleElement(elem);
+}
+
+}  // namespace mongo
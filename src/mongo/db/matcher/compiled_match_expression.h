@@ -0,0 +1,133 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression.h"
+
+namespace mongo {
+
+class PathMatchExpression;
+
+/**
+ * A form of a MatchExpression that evaluates its leaves in a single pass over a BSON document.
+ *
+ * Interpreting a MatchExpression walks the expression tree and resolves the path of every leaf
+ * from the root of the document. The compiled form merges the paths of the leaves of a top-level
+ * $and into a trie of field names and walks the document once, evaluating each leaf on the element
+ * at the end of its path as soon as the walk reaches it. Comparisons against numbers, strings and
+ * ObjectIds compare values of the same type directly.
+ *
+ * Paths that run into an array are evaluated by the leaf's interpreted matcher, which implements
+ * implicit array traversal. Children of the $and that are not path leaves, such as $or or $expr,
+ * are evaluated by their interpreted matcher after the walk.
+ *
+ * The compiled form refers to the MatchExpression it was compiled from, which must outlive it and
+ * must not be modified after compilation.
+ */
+class CompiledMatchExpression {
+public:
+    // The maximum number of leaves evaluated by the trie walk. Any further leaves are interpreted.
+    static constexpr size_t kMaxLeaves = 64;
+
+    /**
+     * Compiles 'expr'. Returns nullptr if none of its leaves can be evaluated by the trie walk, in
+     * which case interpreting 'expr' is as fast.
+     */
+    static std::unique_ptr<CompiledMatchExpression> compile(const MatchExpression* expr);
+
+    /**
+     * Returns true if 'doc' matches the expression. Equivalent to calling matchesBSON() on the
+     * MatchExpression it was compiled from.
+     */
+    bool matches(const BSONObj& doc) const;
+
+private:
+    // How a leaf compares the element at the end of its path to its operand.
+    enum class Comparator {
+        // Calls matchesSingleElement() on the leaf.
+        kGeneric,
+        // $eq, $lt, $lte, $gt and $gte against an operand of the given type, which compare values
+        // of the same type directly.
+        kNumberInt,
+        kNumberLong,
+        kNumberDouble,
+        kString,
+        kObjectId,
+    };
+
+    struct Leaf {
+        const PathMatchExpression* expr;
+        Comparator comparator = Comparator::kGeneric;
+        BSONElement rhs;
+    };
+
+    // A node of the trie of leaf paths. The names of the nodes from the root down to a node make
+    // up the path of the leaves that end at it.
+    struct Node {
+        std::string fieldName;
+        std::vector<size_t> leaves;
+        std::vector<Node> children;
+
+        // The leaves ending at this node or below it.
+        std::vector<size_t> subtreeLeaves;
+    };
+
+    CompiledMatchExpression() = default;
+
+    bool _addLeaf(const PathMatchExpression* expr);
+
+    bool _matchObject(const BSONObj& obj,
+                      const Node& node,
+                      const BSONObj& doc,
+                      uint64_t* evaluated) const;
+    bool _matchElement(const BSONElement& elem,
+                       const Node& node,
+                       const BSONObj& doc,
+                       uint64_t* evaluated) const;
+    bool _matchLeaf(const Leaf& leaf, const BSONElement& elem) const;
+
+    std::vector<Leaf> _leaves;
+    Node _root;
+
+    // The leaves that do not match a document where their path is missing. A leaf the trie walk
+    // does not reach is evaluated against a missing element, so a document where any of these
+    // leaves is not reached does not match.
+    uint64_t _mustBeReached = 0;
+
+    // Children of the $and that are interpreted.
+    std::vector<const MatchExpression*> _interpreted;
+};
+
+}  // namespace mongo
@@ -0,0 +1,149 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include <limits>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+
+const double kNaN = std::numeric_limits<double>::quiet_NaN();
+const OID kOid = OID("5f1b2c3d4e5f60718293a4b5");
+
+std::unique_ptr<MatchExpression> parse(const BSONObj& filter) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto expr = MatchExpressionParser::parse(filter, expCtx);
+    ASSERT_OK(expr.getStatus());
+    return std::move(expr.getValue());
+}
+
+std::vector<BSONObj> documents() {
+    return {BSONObj(),
+            BSON("a" << 1),
+            BSON("a" << 1.0),
+            BSON("a" << 1LL),
+            BSON("a" << 2),
+            BSON("a" << 2.5),
+            BSON("a" << kNaN),
+            BSON("a"
+                 << "x"),
+            BSON("a"
+                 << "xy"),
+            BSON("a" << BSONNULL),
+            BSON("a" << BSONUndefined),
+            BSON("a" << kOid),
+            BSON("a" << 5 << "a" << 1),
+            BSON("b" << 1),
+            BSON("c" << 1 << "a" << 1 << "b"
+                     << "x"),
+            fromjson("{a: [1, 2]}"),
+            fromjson("{a: [[1], 2]}"),
+            fromjson("{a: {b: 1}}"),
+            fromjson("{a: {b: 2.5}, b: 'x'}"),
+            fromjson("{a: {b: [1, 3]}}"),
+            fromjson("{a: [{b: 1}, {b: 2}]}"),
+            fromjson("{a: {b: null}}"),
+            fromjson("{a: {c: 1}}"),
+            fromjson("{a: {'0': 1}}"),
+            fromjson("{a: {b: {c: 1}}}")};
+}
+
+void assertCompiledMatchesLikeInterpreted(const BSONObj& filter) {
+    auto expr = parse(filter);
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+    ASSERT(compiled) << filter;
+    for (auto&& doc : documents()) {
+        ASSERT_EQ(compiled->matches(doc), expr->matchesBSON(doc))
+            << "filter: " << filter << " document: " << doc;
+    }
+}
+
+TEST(CompiledMatchExpressionTest, ComparisonsMatchLikeInterpreted) {
+    for (auto&& op : {"$eq", "$lt", "$lte", "$gt", "$gte"}) {
+        assertCompiledMatchesLikeInterpreted(BSON("a" << BSON(op << 1)));
+        assertCompiledMatchesLikeInterpreted(BSON("a" << BSON(op << 1LL)));
+        assertCompiledMatchesLikeInterpreted(BSON("a" << BSON(op << 2.5)));
+        assertCompiledMatchesLikeInterpreted(BSON("a" << BSON(op << kNaN)));
+        assertCompiledMatchesLikeInterpreted(BSON("a" << BSON(op << "x")));
+        assertCompiledMatchesLikeInterpreted(BSON("a" << BSON(op << kOid)));
+        assertCompiledMatchesLikeInterpreted(BSON("a" << BSON(op << BSONNULL)));
+        assertCompiledMatchesLikeInterpreted(BSON("a.b" << BSON(op << 1)));
+        assertCompiledMatchesLikeInterpreted(BSON("a.b" << BSON(op << BSONNULL)));
+    }
+}
+
+TEST(CompiledMatchExpressionTest, OtherLeavesMatchLikeInterpreted) {
+    assertCompiledMatchesLikeInterpreted(fromjson("{a: {$exists: true}}"));
+    assertCompiledMatchesLikeInterpreted(fromjson("{a: {$exists: false}}"));
+    assertCompiledMatchesLikeInterpreted(fromjson("{'a.b': {$exists: false}}"));
+    assertCompiledMatchesLikeInterpreted(fromjson("{a: {$in: [1, 'x']}}"));
+    assertCompiledMatchesLikeInterpreted(fromjson("{a: {$type: 'string'}}"));
+    assertCompiledMatchesLikeInterpreted(fromjson("{a: {$size: 2}}"));
+    assertCompiledMatchesLikeInterpreted(fromjson("{a: {$elemMatch: {$gt: 1}}}"));
+    assertCompiledMatchesLikeInterpreted(fromjson("{a: {$not: {$gt: 1}}}"));
+    assertCompiledMatchesLikeInterpreted(fromjson("{a: {b: 1}}"));
+    assertCompiledMatchesLikeInterpreted(fromjson("{'a.0': 1}"));
+}
+
+TEST(CompiledMatchExpressionTest, ConjunctionsMatchLikeInterpreted) {
+    assertCompiledMatchesLikeInterpreted(fromjson("{a: 1, b: 'x'}"));
+    assertCompiledMatchesLikeInterpreted(fromjson("{a: {$gte: 1, $lt: 3}}"));
+    assertCompiledMatchesLikeInterpreted(fromjson("{a: {$exists: true}, 'a.b': 1}"));
+    assertCompiledMatchesLikeInterpreted(fromjson("{'a.b': 1, 'a.c': 1}"));
+    assertCompiledMatchesLikeInterpreted(fromjson("{'a.b.c': 1, b: {$exists: false}}"));
+    assertCompiledMatchesLikeInterpreted(fromjson("{$and: [{a: 1}, {$and: [{c: 1}]}]}"));
+    assertCompiledMatchesLikeInterpreted(fromjson("{a: 1, $or: [{b: 'x'}, {c: 1}]}"));
+}
+
+TEST(CompiledMatchExpressionTest, ExpressionsWithoutPathLeavesAreNotCompiled) {
+    auto expr = parse(fromjson("{$or: [{a: 1}, {b: 1}]}"));
+    ASSERT_FALSE(CompiledMatchExpression::compile(expr.get()));
+}
+
+TEST(CompiledMatchExpressionTest, LeavesBeyondTheLimitAreInterpreted) {
+    BSONObjBuilder filter;
+    for (size_t i = 0; i <= CompiledMatchExpression::kMaxLeaves; ++i) {
+        filter.append(str::stream() << "f" << i, BSON("$exists" << false));
+    }
+    filter.append("a", 1);
+    assertCompiledMatchesLikeInterpreted(filter.obj());
+}
+
+}  // namespace
+}  // namespace mongo
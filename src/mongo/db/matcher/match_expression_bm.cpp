@@ -0,0 +1,133 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <boost/intrusive_ptr.hpp>
+#include <random>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/query_test_service_context.h"
+
+namespace mongo {
+namespace {
+
+constexpr size_t kNumDocuments = 1000;
+
+/**
+ * Builds order-like documents with a mix of top-level scalars, nested subdocuments and an array
+ * of subdocuments, the shape a typical application collection has.
+ */
+std::vector<BSONObj> buildDocuments() {
+    const std::vector<std::string> statuses = {"new", "paid", "shipped", "delivered", "returned"};
+    const std::vector<std::string> countries = {"DE", "FR", "US", "JP", "BR"};
+    const std::vector<std::string> cities = {"Berlin", "Paris", "Austin", "Osaka", "Recife"};
+    const std::vector<std::string> tiers = {"bronze", "silver", "gold"};
+
+    std::mt19937 gen(1234);
+    std::vector<BSONObj> docs;
+    for (size_t i = 0; i < kNumDocuments; ++i) {
+        BSONObjBuilder doc;
+        doc.append("_id", OID::gen());
+        doc.append("orderNumber", static_cast<long long>(i));
+        doc.append("createdAt", Date_t::fromMillisSinceEpoch(1600000000000LL + gen() % 100000000));
+        doc.append("status", statuses[gen() % statuses.size()]);
+        doc.append("channel", gen() % 2 ? "web" : "store");
+        doc.append("currency", "EUR");
+        {
+            BSONObjBuilder customer(doc.subobjStart("customer"));
+            customer.append("customerId", static_cast<int>(gen() % 100000));
+            customer.append("name", "Customer " + std::to_string(gen() % 100000));
+            customer.append("tier", tiers[gen() % tiers.size()]);
+            BSONObjBuilder address(customer.subobjStart("address"));
+            const auto location = gen() % countries.size();
+            address.append("street", std::to_string(gen() % 200) + " Main Street");
+            address.append("city", cities[location]);
+            address.append("country", countries[location]);
+            address.append("zip", std::to_string(10000 + gen() % 90000));
+        }
+        {
+            BSONArrayBuilder items(doc.subarrayStart("items"));
+            const auto numItems = 1 + gen() % 5;
+            for (size_t j = 0; j < numItems; ++j) {
+                items.append(BSON("sku"
+                                  << ("sku-" + std::to_string(gen() % 50)) << "quantity"
+                                  << static_cast<int>(1 + gen() % 4) << "price"
+                                  << static_cast<double>(gen() % 20000) / 100));
+            }
+        }
+        doc.append("total", static_cast<double>(gen() % 100000) / 100);
+        doc.append("priority", static_cast<int>(gen() % 5));
+        doc.append("gift", gen() % 10 == 0);
+        doc.append("notes", "Please leave the parcel at the door.");
+        docs.push_back(doc.obj());
+    }
+    return docs;
+}
+
+void BM_Match(benchmark::State& state, const char* filter, bool compile) {
+    QueryTestServiceContext testServiceContext;
+    auto opCtx = testServiceContext.makeOperationContext();
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx =
+        new ExpressionContextForTest(opCtx.get(), NamespaceString("test.bm"));
+    auto expr = uassertStatusOK(MatchExpressionParser::parse(fromjson(filter), expCtx));
+    auto compiled = compile ? CompiledMatchExpression::compile(expr.get()) : nullptr;
+    const auto docs = buildDocuments();
+
+    for (auto keepRunning : state) {
+        size_t numMatches = 0;
+        for (auto&& doc : docs) {
+            numMatches += compiled ? compiled->matches(doc) : expr->matchesBSON(doc);
+        }
+        benchmark::DoNotOptimize(numMatches);
+    }
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+#define MATCH_BENCHMARK(name, filter)                              \
+    BENCHMARK_CAPTURE(BM_Match, name##Interpreted, filter, false); \
+    BENCHMARK_CAPTURE(BM_Match, name##Compiled, filter, true)
+
+MATCH_BENCHMARK(Equality, "{status: 'shipped'}");
+MATCH_BENCHMARK(Range, "{total: {$gte: 100, $lt: 500}}");
+MATCH_BENCHMARK(DottedPaths, "{'customer.address.city': 'Berlin', 'customer.tier': 'gold'}");
+MATCH_BENCHMARK(Conjunction,
+                "{status: 'shipped', 'customer.address.country': 'DE', total: {$gt: 50}, "
+                "priority: {$lte: 3}, gift: false}");
+MATCH_BENCHMARK(Missing, "{coupon: {$exists: false}, status: {$ne: 'returned'}}");
+MATCH_BENCHMARK(ArrayPath, "{'items.sku': 'sku-17'}");
+MATCH_BENCHMARK(Disjunction, "{status: 'shipped', $or: [{priority: 1}, {total: {$gt: 900}}]}");
+
+}  // namespace
+}  // namespace mongo
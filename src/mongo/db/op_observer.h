@@ -310,6 +310,15 @@ public:
                                const NamespaceString& collectionName,
                                OptionalCollectionUUID uuid) = 0;
 
+    /**
+     * Called when every document of a collection clustered by time with a clustering time before
+     * 'removedBefore' has been removed with a single range truncate.
+     */
+    virtual void onTruncateRange(OperationContext* opCtx,
+                                 const NamespaceString& collectionName,
+                                 OptionalCollectionUUID uuid,
+                                 Date_t removedBefore) = 0;
+
     /**
      * The onUnpreparedTransactionCommit method is called on the commit of an unprepared
      * transaction, before the RecoveryUnit onCommit() is called.  It must not be called when no
@@ -932,6 +932,19 @@ void OpObserverImpl::onEmptyCapped(OperationContext* opCtx,
     }
 }
 
+void OpObserverImpl::onTruncateRange(OperationContext* opCtx,
+                                     const NamespaceString& collectionName,
+                                     OptionalCollectionUUID uuid,
+                                     Date_t removedBefore) {
+    MutableOplogEntry oplogEntry;
+    oplogEntry.setOpType(repl::OpTypeEnum::kCommand);
+    oplogEntry.setNss(collectionName.getCommandNS());
+    oplogEntry.setUuid(uuid);
+    oplogEntry.setObject(
+        BSON("truncateRange" << collectionName.coll() << "before" << removedBefore));
+    logOperation(opCtx, &oplogEntry);
+}
+
 namespace {
 // Accepts an empty BSON builder and appends the given transaction statements to an 'applyOps' array
 // field. Appends as many operations as possible until either the constructed object exceeds the
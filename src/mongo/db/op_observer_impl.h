@@ -174,6 +174,10 @@ public:
     void onEmptyCapped(OperationContext* opCtx,
                        const NamespaceString& collectionName,
                        OptionalCollectionUUID uuid);
+    void onTruncateRange(OperationContext* opCtx,
+                         const NamespaceString& collectionName,
+                         OptionalCollectionUUID uuid,
+                         Date_t removedBefore);
     void onUnpreparedTransactionCommit(OperationContext* opCtx,
                                        std::vector<repl::ReplOperation>* statements,
                                        size_t numberOfPreImagesToWrite) final;
@@ -152,6 +152,10 @@ public:
     void onEmptyCapped(OperationContext* opCtx,
                        const NamespaceString& collectionName,
                        OptionalCollectionUUID uuid) override {}
+    void onTruncateRange(OperationContext* opCtx,
+                         const NamespaceString& collectionName,
+                         OptionalCollectionUUID uuid,
+                         Date_t removedBefore) override {}
     void onUnpreparedTransactionCommit(OperationContext* opCtx,
                                        std::vector<repl::ReplOperation>* statements,
                                        size_t numberOfPreImagesToWrite) override {}
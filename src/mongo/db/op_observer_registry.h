@@ -300,6 +300,15 @@ public:
             o->onEmptyCapped(opCtx, collectionName, uuid);
     }
 
+    void onTruncateRange(OperationContext* const opCtx,
+                         const NamespaceString& collectionName,
+                         OptionalCollectionUUID uuid,
+                         Date_t removedBefore) {
+        ReservedTimes times{opCtx};
+        for (auto& o : _observers)
+            o->onTruncateRange(opCtx, collectionName, uuid, removedBefore);
+    }
+
     void onUnpreparedTransactionCommit(OperationContext* opCtx,
                                        std::vector<repl::ReplOperation>* statements,
                                        size_t numberOfPreImagesToWrite) override {
@@ -0,0 +1,238 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/change_stream_rewrite_helpers.h"
+
+#include <set>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/pipeline/document_source_change_stream.h"
+
+namespace mongo {
+namespace change_stream_rewrite {
+namespace {
+
+using DSCS = DocumentSourceChangeStream;
+
+/**
+ * Returns true if 'expr' can only match a document in which its path exists. A predicate that may
+ * match a missing field cannot be moved onto an oplog field, since the oplog field may exist when
+ * the corresponding field of the change event does not.
+ */
+bool requiresPathToExist(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE: {
+            const auto& rhs = static_cast<const ComparisonMatchExpressionBase*>(expr)->getData();
+            switch (rhs.type()) {
+                case BSONType::jstNULL:
+                case BSONType::Undefined:
+                case BSONType::MinKey:
+                case BSONType::MaxKey:
+                    return false;
+                default:
+                    return true;
+            }
+        }
+        case MatchExpression::MATCH_IN:
+            return !static_cast<const InMatchExpression*>(expr)->hasNull();
+        case MatchExpression::REGEX:
+        case MatchExpression::EXISTS:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Appends 'expr', a predicate on a path starting with 'eventField', applied to the same path under
+ * 'oplogField' instead.
+ */
+void appendMovedPredicate(BSONObjBuilder* bob,
+                          const MatchExpression* expr,
+                          StringData eventField,
+                          StringData oplogField) {
+    auto subPath = expr->path().substr(eventField.size());
+    bob->append(oplogField.toString() + subPath,
+                static_cast<const PathMatchExpression*>(expr)->getSerializedRightHandSide());
+}
+
+boost::optional<BSONObj> rewriteOperationType(const MatchExpression* expr) {
+    std::vector<BSONElement> values;
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+            values.push_back(static_cast<const EqualityMatchExpression*>(expr)->getData());
+            break;
+        case MatchExpression::MATCH_IN: {
+            auto inExpr = static_cast<const InMatchExpression*>(expr);
+            if (!inExpr->getRegexes().empty()) {
+                return boost::none;
+            }
+            values = inExpr->getEqualities();
+            break;
+        }
+        default:
+            return boost::none;
+    }
+
+    // Any other operation type, or a value that is not a string, never matches the event of an
+    // insert, update or delete.
+    std::set<StringData> opTypes;
+    for (const auto& value : values) {
+        if (value.type() != BSONType::String) {
+            continue;
+        }
+        auto opType = value.valueStringData();
+        if (opType == DSCS::kInsertOpType) {
+            opTypes.insert("i"_sd);
+        } else if (opType == DSCS::kUpdateOpType || opType == DSCS::kReplaceOpType) {
+            opTypes.insert("u"_sd);
+        } else if (opType == DSCS::kDeleteOpType) {
+            opTypes.insert("d"_sd);
+        }
+    }
+    if (opTypes.empty()) {
+        return BSON("$alwaysFalse" << 1);
+    }
+
+    BSONArrayBuilder opTypesArr;
+    for (auto opType : opTypes) {
+        opTypesArr.append(opType);
+    }
+    return BSON("op" << BSON("$in" << opTypesArr.arr()));
+}
+
+/**
+ * Rewrites a leaf predicate on a change event field into a filter on the oplog entries of inserts,
+ * updates and deletes.
+ */
+boost::optional<BSONObj> rewriteLeaf(const MatchExpression* expr) {
+    auto path = expr->path();
+    if (path == DSCS::kOperationTypeField) {
+        return rewriteOperationType(expr);
+    }
+
+    auto isSubPathOf = [&](StringData field) {
+        return path.size() > field.size() && path.startsWith(field) && path[field.size()] == '.';
+    };
+    if (!requiresPathToExist(expr)) {
+        return boost::none;
+    }
+
+    // The document key of an insert or a delete comes from the 'o' field of the oplog entry, and
+    // that of an update or a replacement from the 'o2' field.
+    if (isSubPathOf(DSCS::kDocumentKeyField)) {
+        BSONObjBuilder insertOrDelete;
+        insertOrDelete.append("op", BSON("$in" << BSON_ARRAY("i"
+                                                             << "d")));
+        appendMovedPredicate(&insertOrDelete, expr, DSCS::kDocumentKeyField, "o");
+        BSONObjBuilder update;
+        update.append("op", "u");
+        appendMovedPredicate(&update, expr, DSCS::kDocumentKeyField, "o2");
+        return BSON("$or" << BSON_ARRAY(insertOrDelete.obj() << update.obj()));
+    }
+
+    // The full document of an insert is its 'o' field. An update may carry a full document looked
+    // up after the fact, so it cannot be filtered here. A delete has none.
+    if (isSubPathOf(DSCS::kFullDocumentField)) {
+        BSONObjBuilder insert;
+        insert.append("op", "i");
+        appendMovedPredicate(&insert, expr, DSCS::kFullDocumentField, "o");
+        return BSON("$or" << BSON_ARRAY(insert.obj() << BSON("op"
+                                                             << "u")));
+    }
+
+    // Only the event of an update has an update description.
+    if (path == DSCS::kUpdateDescriptionField || isSubPathOf(DSCS::kUpdateDescriptionField)) {
+        return BSON("op"
+                    << "u");
+    }
+    return boost::none;
+}
+
+boost::optional<BSONObj> rewriteForCrudOps(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::AND: {
+            // Each child that can be rewritten narrows the filter.
+            BSONArrayBuilder children;
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                if (auto child = rewriteForCrudOps(expr->getChild(i))) {
+                    children.append(*child);
+                }
+            }
+            if (children.arrSize() == 0) {
+                return boost::none;
+            }
+            return BSON("$and" << children.arr());
+        }
+        case MatchExpression::OR: {
+            // An entry may match through any child, so all of them must be rewritten.
+            BSONArrayBuilder children;
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                auto child = rewriteForCrudOps(expr->getChild(i));
+                if (!child) {
+                    return boost::none;
+                }
+                children.append(*child);
+            }
+            return BSON("$or" << children.arr());
+        }
+        default:
+            break;
+    }
+
+    if (expr->getCategory() != MatchExpression::MatchCategory::kLeaf) {
+        return boost::none;
+    }
+    return rewriteLeaf(expr);
+}
+
+}  // namespace
+
+boost::optional<BSONObj> rewriteFilterForOplog(const MatchExpression* userFilter) {
+    auto crudFilter = rewriteForCrudOps(userFilter);
+    if (!crudFilter) {
+        return boost::none;
+    }
+
+    // Commands, including the 'applyOps' of transactions, and no-op entries pass through.
+    return BSON("$or" << BSON_ARRAY(BSON("op" << BSON("$nin" << BSON_ARRAY("i"
+                                                                           << "u"
+                                                                           << "d")))
+                                    << *crudFilter));
+}
+
+}  // namespace change_stream_rewrite
+}  // namespace mongo
@@ -0,0 +1,55 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression.h"
+
+namespace mongo {
+namespace change_stream_rewrite {
+
+/**
+ * Rewrites 'userFilter', a filter on the change events a change stream produces, into a filter on
+ * the oplog entries the events are generated from. Every oplog entry whose change event may match
+ * 'userFilter' matches the rewritten filter, which may also match entries whose events do not.
+ *
+ * Only predicates on 'operationType', 'documentKey', 'fullDocument' and 'updateDescription' narrow
+ * the rewritten filter, and only for the entries of inserts, updates and deletes. All other oplog
+ * entries match it. Returns boost::none if no part of 'userFilter' can be rewritten.
+ *
+ * The rewritten filter compares strings with the simple collation, so it is only valid for a
+ * 'userFilter' that does too.
+ */
+boost::optional<BSONObj> rewriteFilterForOplog(const MatchExpression* userFilter);
+
+}  // namespace change_stream_rewrite
+}  // namespace mongo
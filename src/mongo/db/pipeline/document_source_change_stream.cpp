@@ -102,8 +102,21 @@ static constexpr StringData kOplogMatchExplainName = "$_internalOplogMatch"_sd;
 }  // namespace
 
 intrusive_ptr<DocumentSourceOplogMatch> DocumentSourceOplogMatch::create(
-    BSONObj filter, const intrusive_ptr<ExpressionContext>& expCtx) {
-    return new DocumentSourceOplogMatch(std::move(filter), expCtx);
+    BSONObj filter, Timestamp startFrom, const intrusive_ptr<ExpressionContext>& expCtx) {
+    return new DocumentSourceOplogMatch(std::move(filter), startFrom, expCtx);
+}
+
+void DocumentSourceOplogMatch::setUserFilterPushdown(
+    const boost::optional<BSONObj>& userFilterPushdown) {
+    // Append to the clauses of the base filter, which keeps the bound on 'ts' first.
+    BSONArrayBuilder clauses;
+    for (auto&& clause : _baseFilter["$and"].Obj()) {
+        clauses.append(clause);
+    }
+    if (userFilterPushdown) {
+        clauses.append(BSON("$or" << BSON_ARRAY(BSON("ts" << _startFrom) << *userFilterPushdown)));
+    }
+    rebuild(BSON("$and" << clauses.arr()));
 }
 
 const char* DocumentSourceOplogMatch::getSourceName() const {
@@ -424,6 +437,7 @@ list<intrusive_ptr<DocumentSource>> buildPipeline(const intrusive_ptr<Expression
     // upon the fact that it is always the first stage in the pipeline.
     stages.push_back(DocumentSourceOplogMatch::create(
         DocumentSourceChangeStream::buildMatchFilter(expCtx, *startFrom, showMigrationEvents),
+        *startFrom,
         expCtx));
 
     // If we haven't already populated the initial PBRT, then we are starting from a specific
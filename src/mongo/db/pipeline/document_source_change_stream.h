@@ -217,17 +217,36 @@ private:
  */
 class DocumentSourceOplogMatch final : public DocumentSourceMatch {
 public:
-    DocumentSourceOplogMatch(const DocumentSourceOplogMatch& other) : DocumentSourceMatch(other) {}
+    DocumentSourceOplogMatch(const DocumentSourceOplogMatch& other)
+        : DocumentSourceMatch(other),
+          _baseFilter(other._baseFilter),
+          _startFrom(other._startFrom) {}
 
     virtual boost::intrusive_ptr<DocumentSourceMatch> clone() const {
         return make_intrusive<std::decay_t<decltype(*this)>>(*this);
     }
 
+    /**
+     * Creates the stage with 'filter', built by DocumentSourceChangeStream::buildMatchFilter()
+     * for a change stream starting at 'startFrom'.
+     */
     static boost::intrusive_ptr<DocumentSourceOplogMatch> create(
-        BSONObj filter, const boost::intrusive_ptr<ExpressionContext>& expCtx);
+        BSONObj filter, Timestamp startFrom, const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
     const char* getSourceName() const final;
 
+    Timestamp getStartFrom() const {
+        return _startFrom;
+    }
+
+    /**
+     * Narrows the filter to the oplog entries matching 'userFilterPushdown' as well, a filter
+     * rewritten from the user's $match stages following the change stream stages. Replaces the
+     * pushdown of any earlier call. The entry at 'startFrom' is always let through, so that a
+     * resumed change stream can still find the event in its resume token.
+     */
+    void setUserFilterPushdown(const boost::optional<BSONObj>& userFilterPushdown);
+
     GetNextResult doGetNext() final {
         // We should never execute this stage directly. We expect this stage to be absorbed into the
         // cursor feeding the pipeline, and executing this stage may result in the use of the wrong
@@ -241,7 +260,16 @@ public:
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain) const final;
 
 private:
-    using DocumentSourceMatch::DocumentSourceMatch;
+    DocumentSourceOplogMatch(BSONObj filter,
+                             Timestamp startFrom,
+                             const boost::intrusive_ptr<ExpressionContext>& expCtx)
+        : DocumentSourceMatch(filter, expCtx),
+          _baseFilter(filter.getOwned()),
+          _startFrom(startFrom) {}
+
+    // The filter built by DocumentSourceChangeStream::buildMatchFilter(), without any pushdown.
+    BSONObj _baseFilter;
+    Timestamp _startFrom;
 };
 
 }  // namespace mongo
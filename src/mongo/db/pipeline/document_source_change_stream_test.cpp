@@ -41,7 +41,9 @@
 #include "mongo/db/exec/document_value/document_value_test_util.h"
 #include "mongo/db/exec/document_value/value.h"
 #include "mongo/db/exec/document_value/value_comparator.h"
+#include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/change_stream_rewrite_helpers.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 #include "mongo/db/pipeline/document_source_change_stream_transform.h"
@@ -2683,5 +2685,100 @@ TEST_F(ChangeStreamStageDBTest, StartAfterSucceedsEvenIfResumeTokenDoesNotContai
         BSON("$changeStream" << BSON("startAfter" << resumeToken)));
 }
 
+/**
+ * Returns the filter on change events 'userFilter' rewritten into a filter on oplog entries.
+ */
+std::unique_ptr<MatchExpression> rewriteForOplog(const intrusive_ptr<ExpressionContext>& expCtx,
+                                                 const BSONObj& userFilter) {
+    auto userExpr = uassertStatusOK(MatchExpressionParser::parse(userFilter, expCtx));
+    auto rewritten = change_stream_rewrite::rewriteFilterForOplog(userExpr.get());
+    if (!rewritten) {
+        return nullptr;
+    }
+    return uassertStatusOK(MatchExpressionParser::parse(rewritten->getOwned(), expCtx));
+}
+
+TEST_F(ChangeStreamStageTest, RewrittenOperationTypeFilterOnlyPassesMatchingCrudEntries) {
+    auto expr =
+        rewriteForOplog(getExpCtx(), fromjson("{operationType: {$in: ['insert', 'drop']}}"));
+    ASSERT(expr);
+
+    auto insert = makeOplogEntry(OpTypeEnum::kInsert, nss, BSON("_id" << 1));
+    auto update = makeOplogEntry(
+        OpTypeEnum::kUpdate, nss, BSON("$set" << BSON("x" << 1)), testUuid(), {}, BSON("_id" << 1));
+    auto remove = makeOplogEntry(OpTypeEnum::kDelete, nss, BSON("_id" << 1));
+    auto drop = createCommand(BSON("drop" << nss.coll()), testUuid());
+    ASSERT_TRUE(expr->matchesBSON(insert.toBSON()));
+    ASSERT_FALSE(expr->matchesBSON(update.toBSON()));
+    ASSERT_FALSE(expr->matchesBSON(remove.toBSON()));
+    ASSERT_TRUE(expr->matchesBSON(drop.toBSON()));
+}
+
+TEST_F(ChangeStreamStageTest, RewrittenDocumentKeyFilterUsesTheFieldHoldingTheDocumentKey) {
+    auto expr = rewriteForOplog(getExpCtx(), fromjson("{'documentKey._id': 2}"));
+    ASSERT(expr);
+
+    auto insertMatching = makeOplogEntry(OpTypeEnum::kInsert, nss, BSON("_id" << 2));
+    auto insertOther = makeOplogEntry(OpTypeEnum::kInsert, nss, BSON("_id" << 3));
+    auto updateMatching = makeOplogEntry(
+        OpTypeEnum::kUpdate, nss, BSON("$set" << BSON("x" << 1)), testUuid(), {}, BSON("_id" << 2));
+    auto deleteOther = makeOplogEntry(OpTypeEnum::kDelete, nss, BSON("_id" << 3));
+    ASSERT_TRUE(expr->matchesBSON(insertMatching.toBSON()));
+    ASSERT_FALSE(expr->matchesBSON(insertOther.toBSON()));
+    ASSERT_TRUE(expr->matchesBSON(updateMatching.toBSON()));
+    ASSERT_FALSE(expr->matchesBSON(deleteOther.toBSON()));
+}
+
+TEST_F(ChangeStreamStageTest, RewrittenFullDocumentFilterPassesUpdatesAndDropsDeletes) {
+    auto expr = rewriteForOplog(getExpCtx(), fromjson("{operationType: {$ne: 'drop'}, "
+                                                      "'fullDocument.x': {$gt: 1}}"));
+    ASSERT(expr);
+
+    auto insertMatching = makeOplogEntry(OpTypeEnum::kInsert, nss, BSON("_id" << 1 << "x" << 2));
+    auto insertOther = makeOplogEntry(OpTypeEnum::kInsert, nss, BSON("_id" << 1 << "x" << 0));
+    auto update = makeOplogEntry(
+        OpTypeEnum::kUpdate, nss, BSON("$set" << BSON("x" << 0)), testUuid(), {}, BSON("_id" << 1));
+    auto remove = makeOplogEntry(OpTypeEnum::kDelete, nss, BSON("_id" << 1));
+    ASSERT_TRUE(expr->matchesBSON(insertMatching.toBSON()));
+    ASSERT_FALSE(expr->matchesBSON(insertOther.toBSON()));
+    ASSERT_TRUE(expr->matchesBSON(update.toBSON()));
+    ASSERT_FALSE(expr->matchesBSON(remove.toBSON()));
+}
+
+TEST_F(ChangeStreamStageTest, FiltersThatMayMatchMissingFieldsAreNotRewritten) {
+    ASSERT_FALSE(rewriteForOplog(getExpCtx(), fromjson("{'fullDocument.x': null}")));
+    ASSERT_FALSE(rewriteForOplog(getExpCtx(), fromjson("{'documentKey.x': {$exists: false}}")));
+    ASSERT_FALSE(rewriteForOplog(getExpCtx(),
+                                 fromjson("{$or: [{operationType: 'insert'}, {'ns.coll': 'a'}]}")));
+}
+
+TEST_F(ChangeStreamStageTest, TransformPushesFollowingUserMatchIntoOplogMatch) {
+    auto stages = DSChangeStream::createFromBson(
+        BSON(DSChangeStream::kStageName << BSON("startAtOperationTime" << kDefaultTs))
+            .firstElement(),
+        getExpCtx());
+    stages.push_back(
+        DocumentSourceMatch::create(fromjson("{operationType: 'delete'}"), getExpCtx()));
+    Pipeline::SourceContainer container(stages.begin(), stages.end());
+
+    auto oplogMatch = dynamic_cast<DocumentSourceOplogMatch*>(container.front().get());
+    ASSERT(oplogMatch);
+    auto transformIt = std::next(container.begin());
+    (*transformIt)->optimizeAt(transformIt, &container);
+
+    auto expr = uassertStatusOK(MatchExpressionParser::parse(oplogMatch->getQuery(), getExpCtx()));
+    const repl::OpTime laterOpTime(Timestamp(kDefaultTs.getSecs() + 1, 1), 1);
+    auto insert = makeOplogEntry(
+        OpTypeEnum::kInsert, nss, BSON("_id" << 1), testUuid(), {}, boost::none, laterOpTime);
+    auto remove = makeOplogEntry(
+        OpTypeEnum::kDelete, nss, BSON("_id" << 1), testUuid(), {}, boost::none, laterOpTime);
+    ASSERT_FALSE(expr->matchesBSON(insert.toBSON()));
+    ASSERT_TRUE(expr->matchesBSON(remove.toBSON()));
+
+    // The entry at the start of the change stream is let through for the resume token check.
+    auto insertAtStart = makeOplogEntry(OpTypeEnum::kInsert, nss, BSON("_id" << 1));
+    ASSERT_TRUE(expr->matchesBSON(insertAtStart.toBSON()));
+}
+
 }  // namespace
 }  // namespace mongo
@@ -38,6 +38,7 @@
 #include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/commands/feature_compatibility_version_documentation.h"
 #include "mongo/db/pipeline/change_stream_constants.h"
+#include "mongo/db/pipeline/change_stream_rewrite_helpers.h"
 #include "mongo/db/pipeline/change_stream_document_diff_parser.h"
 #include "mongo/db/pipeline/document_path_support.h"
 #include "mongo/db/pipeline/document_source.h"
@@ -425,6 +426,46 @@ DocumentSource::GetModPathsReturn DocumentSourceChangeStreamTransform::getModifi
     return {DocumentSource::GetModPathsReturn::Type::kAllPaths, std::set<string>{}, {}};
 }
 
+Pipeline::SourceContainer::iterator DocumentSourceChangeStreamTransform::doOptimizeAt(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    invariant(*itr == this);
+
+    // The oplog $match compares with the simple collation, so a filter with any other collation
+    // cannot be moved into it.
+    auto oplogMatch = itr == container->begin()
+        ? nullptr
+        : dynamic_cast<DocumentSourceOplogMatch*>(std::prev(itr)->get());
+    if (!oplogMatch || pExpCtx->getCollator()) {
+        return std::next(itr);
+    }
+
+    // Skip the remaining change stream stages, which only add fields derived from the oplog entry
+    // or close the cursor, to the user's $match stages.
+    auto userStage = std::next(itr);
+    while (userStage != container->end() && (*userStage)->constraints().isChangeStreamStage()) {
+        ++userStage;
+    }
+
+    BSONArrayBuilder pushdown;
+    for (; userStage != container->end(); ++userStage) {
+        auto userMatch = dynamic_cast<DocumentSourceMatch*>(userStage->get());
+        if (!userMatch) {
+            break;
+        }
+        if (auto rewritten =
+                change_stream_rewrite::rewriteFilterForOplog(userMatch->getMatchExpression())) {
+            pushdown.append(*rewritten);
+        }
+    }
+
+    // Recompute the pushdown on every pass, since the user's stages may have changed since the
+    // last one.
+    oplogMatch->setUserFilterPushdown(pushdown.arrSize() == 0
+                                          ? boost::optional<BSONObj>()
+                                          : BSON("$and" << pushdown.arr()));
+    return std::next(itr);
+}
+
 DocumentSource::GetNextResult DocumentSourceChangeStreamTransform::doGetNext() {
     uassert(50988,
             "Illegal attempt to execute an internal change stream stage on mongos. A $changeStream "
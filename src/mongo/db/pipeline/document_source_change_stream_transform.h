@@ -52,6 +52,14 @@ public:
     DepsTracker::State getDependencies(DepsTracker* deps) const final;
     DocumentSource::GetModPathsReturn getModifiedPaths() const final;
 
+    /**
+     * Rewrites the user's $match stages that follow the change stream stages into a filter on
+     * oplog fields, and narrows the preceding oplog $match with it, so that oplog entries whose
+     * events cannot match are dropped before they are transformed or looked up.
+     */
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain) const;
     StageConstraints constraints(Pipeline::SplitState pipeState) const final;
 
@@ -164,6 +164,10 @@ int DocumentSourceGroup::freeMemory() {
 }
 
 DocumentSource::GetNextResult DocumentSourceGroup::doGetNext() {
+    if (_streaming) {
+        return getNextStreaming();
+    }
+
     if (!_initialized) {
         const auto initializationResult = initialize();
         if (initializationResult.isPaused()) {
@@ -241,6 +245,94 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
     return out;
 }
 
+DocumentSource::GetNextResult DocumentSourceGroup::getNextStreaming() {
+    // The input is ordered by the group key, so the current group is complete as soon as a
+    // document with a different key arrives. That document starts the next group.
+    auto input = pSource->getNext();
+    for (; input.isAdvanced(); input = pSource->getNext()) {
+        auto rootDocument = input.releaseDocument();
+        Value id = computeId(rootDocument);
+
+        boost::optional<Document> completedGroup;
+        if (_streamingGroupInProgress &&
+            pExpCtx->getValueComparator().evaluate(_currentId != id)) {
+            completedGroup = makeDocument(_currentId, _currentAccumulators, pExpCtx->needsMerge);
+            _streamingGroupInProgress = false;
+        }
+
+        if (!_streamingGroupInProgress) {
+            startStreamingGroup(std::move(id));
+        }
+
+        for (size_t i = 0; i < _accumulatedFields.size(); i++) {
+            _currentAccumulators[i]->process(
+                _accumulatedFields[i]
+                    .expr.argument->evaluate(rootDocument, &pExpCtx->variables)
+                    .getOwned(),
+                _doingMerge);
+        }
+        checkStreamingGroupMemoryUsage();
+
+        if (completedGroup) {
+            return std::move(*completedGroup);
+        }
+    }
+
+    if (input.isEOF() && _streamingGroupInProgress) {
+        _streamingGroupInProgress = false;
+        return makeDocument(_currentId, _currentAccumulators, pExpCtx->needsMerge);
+    }
+
+    // Propagate EOF or a pause.
+    return input;
+}
+
+void DocumentSourceGroup::checkStreamingGroupMemoryUsage() {
+    auto computeMemoryUsage = [&] {
+        size_t memoryUsageBytes = _currentId.getApproximateSize();
+        for (auto&& accumulator : _currentAccumulators) {
+            memoryUsageBytes += accumulator->memUsageForSorter();
+        }
+        return memoryUsageBytes;
+    };
+
+    _memoryTracker.memoryUsageBytes = computeMemoryUsage();
+    if (_memoryTracker.allowDiskUse ||
+        _memoryTracker.memoryUsageBytes <= _memoryTracker.maxMemoryUsageBytes) {
+        return;
+    }
+
+    for (auto&& accumulator : _currentAccumulators) {
+        accumulator->reduceMemoryConsumptionIfAble();
+    }
+    _memoryTracker.memoryUsageBytes = computeMemoryUsage();
+    uassert(ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed,
+            "Exceeded memory limit for $group, but didn't allow external sort."
+            " Pass allowDiskUse:true to opt in.",
+            _memoryTracker.memoryUsageBytes <= _memoryTracker.maxMemoryUsageBytes);
+}
+
+void DocumentSourceGroup::startStreamingGroup(Value id) {
+    if (_currentAccumulators.empty()) {
+        _currentAccumulators.reserve(_accumulatedFields.size());
+        for (auto&& accumulatedField : _accumulatedFields) {
+            _currentAccumulators.push_back(accumulatedField.makeAccumulator());
+        }
+    }
+
+    _currentId = std::move(id);
+    _streamingGroupInProgress = true;
+
+    Value expandedId = expandId(_currentId);
+    Document idDoc =
+        expandedId.getType() == BSONType::Object ? expandedId.getDocument() : Document();
+    for (size_t i = 0; i < _accumulatedFields.size(); ++i) {
+        _currentAccumulators[i]->reset();
+        _currentAccumulators[i]->startNewGroup(
+            _accumulatedFields[i].expr.initializer->evaluate(idDoc, &pExpCtx->variables));
+    }
+}
+
 void DocumentSourceGroup::doDispose() {
     // Free our resources.
     _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
@@ -298,6 +390,10 @@ Value DocumentSourceGroup::serialize(boost::optional<ExplainOptions::Verbosity>
         insides["$doingMerge"] = Value(true);
     }
 
+    if (explain && _streaming) {
+        insides["$streaming"] = Value(true);
+    }
+
     return Value(DOC(getSourceName() << insides.freeze()));
 }
 
@@ -349,6 +445,20 @@ StringMap<boost::intrusive_ptr<Expression>> DocumentSourceGroup::getIdFields() c
     }
 }
 
+std::vector<std::string> DocumentSourceGroup::getGroupKeyFieldPaths() const {
+    std::vector<std::string> paths;
+    for (auto&& idExpression : _idExpressions) {
+        auto fieldPathExpr = dynamic_cast<ExpressionFieldPath*>(idExpression.get());
+        if (!fieldPathExpr || !fieldPathExpr->isRootFieldPath() ||
+            fieldPathExpr->getFieldPath().getPathLength() == 1) {
+            // Not a field path, or the entire document ($$ROOT or $$CURRENT).
+            return {};
+        }
+        paths.push_back(fieldPathExpr->getFieldPath().tail().fullPath());
+    }
+    return paths;
+}
+
 const std::vector<AccumulationStatement>& DocumentSourceGroup::getAccumulatedFields() const {
     return _accumulatedFields;
 }
@@ -557,8 +667,11 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
         dassert(numAccumulators == group.size());
 
         for (size_t i = 0; i < numAccumulators; i++) {
+            // Accumulators may keep the value, which must not pin the arena of its batch.
             group[i]->process(
-                _accumulatedFields[i].expr.argument->evaluate(rootDocument, &pExpCtx->variables),
+                _accumulatedFields[i]
+                    .expr.argument->evaluate(rootDocument, &pExpCtx->variables)
+                    .getOwned(),
                 _doingMerge);
 
             _memoryTracker.memoryUsageBytes += group[i]->memUsageForSorter();
@@ -674,7 +787,7 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
 Value DocumentSourceGroup::computeId(const Document& root) {
     // If only one expression, return result directly
     if (_idExpressions.size() == 1) {
-        Value retValue = _idExpressions[0]->evaluate(root, &pExpCtx->variables);
+        Value retValue = _idExpressions[0]->evaluate(root, &pExpCtx->variables).getOwned();
         return retValue.missing() ? Value(BSONNULL) : std::move(retValue);
     }
 
@@ -682,7 +795,7 @@ Value DocumentSourceGroup::computeId(const Document& root) {
     vector<Value> vals;
     vals.reserve(_idExpressions.size());
     for (size_t i = 0; i < _idExpressions.size(); i++) {
-        vals.push_back(_idExpressions[i]->evaluate(root, &pExpCtx->variables));
+        vals.push_back(_idExpressions[i]->evaluate(root, &pExpCtx->variables).getOwned());
     }
     return Value(std::move(vals));
 }
@@ -156,6 +156,26 @@ public:
         _doingMerge = doingMerge;
     }
 
+    /**
+     * Tells this stage that its input arrives ordered by the group key, as it does when it reads
+     * an index in key order. Documents with equal group keys are then adjacent, so each group is
+     * output as soon as the group key changes instead of after hashing the entire input.
+     */
+    void setStreaming(bool streaming) {
+        _streaming = streaming;
+    }
+
+    bool isStreaming() const {
+        return _streaming;
+    }
+
+    /**
+     * Returns the paths this stage groups by if every component of the group key is a field path
+     * of the input document (e.g. {_id: "$a"} or {_id: {x: "$a", y: "$b.c"}}), or an empty vector
+     * otherwise.
+     */
+    std::vector<std::string> getGroupKeyFieldPaths() const;
+
     /**
      * Returns true if this $group stage used disk during execution and false otherwise.
      */
@@ -209,6 +229,20 @@ private:
      */
     GetNextResult getNextSpilled();
     GetNextResult getNextStandard();
+    GetNextResult getNextStreaming();
+
+    /**
+     * Prepares '_currentAccumulators' to accumulate the group with key 'id' in streaming mode.
+     */
+    void startStreamingGroup(Value id);
+
+    /**
+     * Charges the group in progress in streaming mode to '_memoryTracker'. Since that group is the
+     * only one in memory and cannot be spilled, throws if it exceeds the memory limit even after
+     * its accumulators reduce their memory consumption, unless disk use is allowed. In that case
+     * the group is kept in memory, as the blocking path does when it merges a spilled group.
+     */
+    void checkStreamingGroupMemoryUsage();
 
     /**
      * Before returning anything, this source must prepare itself. In a streaming $group,
@@ -238,7 +272,8 @@ private:
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
     /**
-     * Computes the internal representation of the group key.
+     * Computes the internal representation of the group key. The key is owned (see
+     * Value::getOwned()), since it is kept for as long as its group.
      */
     Value computeId(const Document& root);
 
@@ -269,6 +304,13 @@ private:
 
     bool _initialized;
 
+    // True if the input is ordered by the group key. See setStreaming().
+    bool _streaming = false;
+
+    // In streaming mode, true while '_currentId' and '_currentAccumulators' hold a group which has
+    // not been output yet.
+    bool _streamingGroupInProgress = false;
+
     Value _currentId;
     Accumulators _currentAccumulators;
 
@@ -244,6 +244,95 @@ TEST_F(DocumentSourceGroupTest, ShouldNotReportDottedGroupKeyAsARename) {
     ASSERT_EQ(modifiedPathsRet.renames.size(), 0UL);
 }
 
+TEST_F(DocumentSourceGroupTest, StreamingGroupOutputsEachGroupWhenTheKeyChanges) {
+    auto expCtx = getExpCtx();
+    auto&& parser = AccumulationStatement::getParser("$sum", boost::none);
+    auto accumulatorArg = BSON("" << 1);
+    auto accExpr = parser(expCtx.get(), accumulatorArg.firstElement(), expCtx->variablesParseState);
+    AccumulationStatement countStatement{"count", accExpr};
+    auto group = DocumentSourceGroup::create(
+        expCtx,
+        ExpressionFieldPath::parse(expCtx.get(), "$x", expCtx->variablesParseState),
+        {countStatement});
+    group->setStreaming(true);
+    auto mock =
+        DocumentSourceMock::createForTest({Document{{"x", 1}},
+                                           Document{{"x", 1}},
+                                           DocumentSource::GetNextResult::makePauseExecution(),
+                                           Document{{"x", 2}},
+                                           Document{{"x", 3}},
+                                           Document{{"x", 3}}},
+                                          expCtx);
+    group->setSource(mock.get());
+
+    // The first group cannot be output until a document with a different key arrives, so the
+    // pause is propagated first.
+    ASSERT_TRUE(group->getNext().isPaused());
+
+    auto result = group->getNext();
+    ASSERT_TRUE(result.isAdvanced());
+    ASSERT_DOCUMENT_EQ(result.releaseDocument(), (Document{{"_id", 1}, {"count", 2}}));
+
+    result = group->getNext();
+    ASSERT_TRUE(result.isAdvanced());
+    ASSERT_DOCUMENT_EQ(result.releaseDocument(), (Document{{"_id", 2}, {"count", 1}}));
+
+    // The last group is output at EOF.
+    result = group->getNext();
+    ASSERT_TRUE(result.isAdvanced());
+    ASSERT_DOCUMENT_EQ(result.releaseDocument(), (Document{{"_id", 3}, {"count", 2}}));
+    ASSERT_TRUE(group->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceGroupTest, StreamingGroupErrorsIfOneGroupExceedsTheMemoryLimit) {
+    auto expCtx = getExpCtx();
+    const size_t maxMemoryUsageBytes = 1000;
+    expCtx->inMongos = true;  // Disallow external sort.
+
+    auto&& parser = AccumulationStatement::getParser("$push", boost::none);
+    auto accumulatorArg = BSON(""
+                               << "$largeStr");
+    auto accExpr = parser(expCtx.get(), accumulatorArg.firstElement(), expCtx->variablesParseState);
+    AccumulationStatement pushStatement{"spaceHog", accExpr};
+    auto group = DocumentSourceGroup::create(
+        expCtx,
+        ExpressionFieldPath::parse(expCtx.get(), "$x", expCtx->variablesParseState),
+        {pushStatement},
+        maxMemoryUsageBytes);
+    group->setStreaming(true);
+
+    // Only the group in progress is charged, so groups that fit on their own are output even
+    // though together they exceed the limit.
+    string largeStr(maxMemoryUsageBytes * 2 / 3, 'x');
+    auto mock = DocumentSourceMock::createForTest({Document{{"x", 0}, {"largeStr", largeStr}},
+                                                   Document{{"x", 1}, {"largeStr", largeStr}},
+                                                   Document{{"x", 2}, {"largeStr", largeStr}},
+                                                   Document{{"x", 2}, {"largeStr", largeStr}}},
+                                                  expCtx);
+    group->setSource(mock.get());
+
+    ASSERT_TRUE(group->getNext().isAdvanced());
+    ASSERT_TRUE(group->getNext().isAdvanced());
+    ASSERT_THROWS_CODE(
+        group->getNext(), AssertionException, ErrorCodes::QueryExceededMemoryLimitNoDiskUseAllowed);
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldReportGroupKeyFieldPaths) {
+    auto expCtx = getExpCtx();
+    VariablesParseState vps = expCtx->variablesParseState;
+    auto x = ExpressionFieldPath::parse(expCtx.get(), "$x", vps);
+    auto yDotZ = ExpressionFieldPath::parse(expCtx.get(), "$y.z", vps);
+    auto group = DocumentSourceGroup::create(
+        expCtx, ExpressionObject::create(expCtx.get(), {{"x", x}, {"y", yDotZ}}), {});
+    ASSERT(group->getGroupKeyFieldPaths() == (std::vector<std::string>{"x", "y.z"}));
+
+    auto root = ExpressionFieldPath::parse(expCtx.get(), "$$ROOT", vps);
+    ASSERT(DocumentSourceGroup::create(expCtx, root, {})->getGroupKeyFieldPaths().empty());
+
+    auto constant = ExpressionConstant::create(expCtx.get(), Value(1));
+    ASSERT(DocumentSourceGroup::create(expCtx, constant, {})->getGroupKeyFieldPaths().empty());
+}
+
 BSONObj toBson(const intrusive_ptr<DocumentSource>& source) {
     vector<Value> arr;
     source->serializeToArray(arr);
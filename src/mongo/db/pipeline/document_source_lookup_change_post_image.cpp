@@ -32,6 +32,9 @@
 #include "mongo/db/pipeline/document_source_lookup_change_post_image.h"
 
 #include "mongo/bson/simple_bsonelement_comparator.h"
+#include "mongo/db/query/find_common.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -52,19 +55,82 @@ Value assertFieldHasType(const Document& fullDoc, StringData fieldName, BSONType
 }  // namespace
 
 DocumentSource::GetNextResult DocumentSourceLookupChangePostImage::doGetNext() {
-    auto input = pSource->getNext();
-    if (!input.isAdvanced()) {
-        return input;
+    if (_outputQueue.empty()) {
+        lookUpNextBatch();
     }
-    auto opTypeVal = assertFieldHasType(
-        input.getDocument(), DocumentSourceChangeStream::kOperationTypeField, BSONType::String);
-    if (opTypeVal.getString() != DocumentSourceChangeStream::kUpdateOpType) {
-        return input;
+    auto next = std::move(_outputQueue.front());
+    _outputQueue.pop_front();
+    return next;
+}
+
+void DocumentSourceLookupChangePostImage::lookUpNextBatch() {
+    const auto maxBatchSize =
+        static_cast<size_t>(internalChangeStreamPostImageLookupBatchSize.load());
+
+    // Once the batch holds an update event, the stages before us should return the events which
+    // are already available rather than wait for more to arrive. Tailable sources do not wait for
+    // inserts once the awaitData deadline has passed, so we move it into the past until we return.
+    auto& awaitData = awaitDataState(pExpCtx->opCtx);
+    const auto waitForInsertsDeadline = awaitData.waitForInsertsDeadline;
+    ON_BLOCK_EXIT([&] { awaitData.waitForInsertsDeadline = waitForInsertsDeadline; });
+
+    std::vector<Document> updateOps;
+    std::vector<Document> documentKeys;
+    boost::optional<NamespaceString> nss;
+    boost::optional<UUID> uuid;
+    Timestamp clusterTime;
+    while (updateOps.size() < maxBatchSize) {
+        auto input = _pendingInput ? std::move(*_pendingInput) : pSource->getNext();
+        _pendingInput = boost::none;
+
+        const bool isUpdate = input.isAdvanced() &&
+            assertFieldHasType(input.getDocument(),
+                               DocumentSourceChangeStream::kOperationTypeField,
+                               BSONType::String)
+                    .getString() == DocumentSourceChangeStream::kUpdateOpType;
+        if (!isUpdate) {
+            if (updateOps.empty()) {
+                _outputQueue.push_back(std::move(input));
+                return;
+            }
+            _pendingInput = std::move(input);
+            break;
+        }
+
+        // Make sure we have a well-formed input.
+        auto updateNss = assertValidNamespace(input.getDocument());
+        auto documentKey = assertFieldHasType(input.getDocument(),
+                                              DocumentSourceChangeStream::kDocumentKeyField,
+                                              BSONType::Object)
+                               .getDocument();
+
+        // Extract the UUID from resume token and do change stream lookups by UUID.
+        auto resumeToken = ResumeToken::parse(
+            input.getDocument()[DocumentSourceChangeStream::kIdField].getDocument());
+        invariant(resumeToken.getData().uuid);
+
+        // Only events on the same collection can be looked up together.
+        if (!updateOps.empty() && (updateNss != *nss || *resumeToken.getData().uuid != *uuid)) {
+            _pendingInput = std::move(input);
+            break;
+        }
+        nss = std::move(updateNss);
+        uuid = *resumeToken.getData().uuid;
+        clusterTime = resumeToken.getData().clusterTime;
+        documentKeys.push_back(std::move(documentKey));
+        updateOps.push_back(input.releaseDocument());
+        awaitData.waitForInsertsDeadline = Date_t();
     }
 
-    MutableDocument output(input.releaseDocument());
-    output[kFullDocumentFieldName] = lookupPostImage(output.peek());
-    return output.freeze();
+    auto lookedUpDocs = lookUpDocuments(*nss, *uuid, documentKeys, clusterTime);
+    for (size_t i = 0; i < updateOps.size(); ++i) {
+        // Check whether the lookup returned a document. Even if the lookup itself succeeded, it may
+        // not have found one if the document was deleted in the time since the update op.
+        MutableDocument output(std::move(updateOps[i]));
+        output[kFullDocumentFieldName] =
+            (lookedUpDocs[i] ? Value(*lookedUpDocs[i]) : Value(BSONNULL));
+        _outputQueue.push_back(output.freeze());
+    }
 }
 
 NamespaceString DocumentSourceLookupChangePostImage::assertValidNamespace(
@@ -88,41 +154,30 @@ NamespaceString DocumentSourceLookupChangePostImage::assertValidNamespace(
     return nss;
 }
 
-Value DocumentSourceLookupChangePostImage::lookupPostImage(const Document& updateOp) const {
-    // Make sure we have a well-formed input.
-    auto nss = assertValidNamespace(updateOp);
-
-    auto documentKey = assertFieldHasType(updateOp,
-                                          DocumentSourceChangeStream::kDocumentKeyField,
-                                          BSONType::Object)
-                           .getDocument();
-
-    // Extract the UUID from resume token and do change stream lookups by UUID.
-    auto resumeToken =
-        ResumeToken::parse(updateOp[DocumentSourceChangeStream::kIdField].getDocument());
-
+std::vector<boost::optional<Document>> DocumentSourceLookupChangePostImage::lookUpDocuments(
+    const NamespaceString& nss,
+    UUID uuid,
+    const std::vector<Document>& documentKeys,
+    Timestamp clusterTime) const {
     const auto readConcern = pExpCtx->inMongos
         ? boost::optional<BSONObj>(BSON("level"
                                         << "majority"
-                                        << "afterClusterTime" << resumeToken.getData().clusterTime))
+                                        << "afterClusterTime" << clusterTime))
         : boost::none;
 
-
     // Update lookup queries sent from mongoS to shards are allowed to use speculative majority
     // reads.
     const auto allowSpeculativeMajorityRead = pExpCtx->inMongos;
-    invariant(resumeToken.getData().uuid);
-    auto lookedUpDoc =
-        pExpCtx->mongoProcessInterface->lookupSingleDocument(pExpCtx,
-                                                             nss,
-                                                             *resumeToken.getData().uuid,
-                                                             documentKey,
-                                                             readConcern,
-                                                             allowSpeculativeMajorityRead);
-
-    // Check whether the lookup returned any documents. Even if the lookup itself succeeded, it may
-    // not have returned any results if the document was deleted in the time since the update op.
-    return (lookedUpDoc ? Value(*lookedUpDoc) : Value(BSONNULL));
+    if (documentKeys.size() == 1) {
+        return {pExpCtx->mongoProcessInterface->lookupSingleDocument(pExpCtx,
+                                                                     nss,
+                                                                     uuid,
+                                                                     documentKeys.front(),
+                                                                     readConcern,
+                                                                     allowSpeculativeMajorityRead)};
+    }
+    return pExpCtx->mongoProcessInterface->lookupDocuments(
+        pExpCtx, nss, uuid, documentKeys, readConcern, allowSpeculativeMajorityRead);
 }
 
 }  // namespace mongo
@@ -29,6 +29,9 @@
 
 #pragma once
 
+#include <deque>
+#include <vector>
+
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 
@@ -37,6 +40,9 @@ namespace mongo {
 /**
  * Part of the change stream API machinery used to look up the post-image of a document. Uses the
  * "documentKey" field of the input to look up the new version of the document.
+ *
+ * Consecutive update events on the same collection which are already available are looked up
+ * together with a single query, up to 'internalChangeStreamPostImageLookupBatchSize' of them.
  */
 class DocumentSourceLookupChangePostImage final : public DocumentSource {
 public:
@@ -115,10 +121,22 @@ private:
     GetNextResult doGetNext() final;
 
     /**
-     * Uses the "documentKey" field from 'updateOp' to look up the current version of the document.
-     * Returns Value(BSONNULL) if the document couldn't be found.
+     * Pulls the next batch of consecutive update events on one collection from the source, looks
+     * up their full documents, and appends them to '_outputQueue'. If the next input is not an
+     * update event, appends it to '_outputQueue' unchanged instead.
      */
-    Value lookupPostImage(const Document& updateOp) const;
+    void lookUpNextBatch();
+
+    /**
+     * Looks up the current version of the documents with the keys 'documentKeys' in the collection
+     * 'nss' with the UUID 'uuid'. 'clusterTime' is the time of the latest of the update events. The
+     * result is parallel to 'documentKeys', with boost::none for documents which couldn't be found.
+     */
+    std::vector<boost::optional<Document>> lookUpDocuments(
+        const NamespaceString& nss,
+        UUID uuid,
+        const std::vector<Document>& documentKeys,
+        Timestamp clusterTime) const;
 
     /**
      * Throws a AssertionException if the namespace found in 'inputDoc' doesn't match the one on the
@@ -126,6 +144,13 @@ private:
      * function verifies that the only the database names match.
      */
     NamespaceString assertValidNamespace(const Document& inputDoc) const;
+
+    // Results which are ready to be returned, in order.
+    std::deque<GetNextResult> _outputQueue;
+
+    // An input which was pulled from the source but could not join the batch being looked up. It
+    // is processed first by the next call to lookUpNextBatch().
+    boost::optional<GetNextResult> _pendingInput;
 };
 
 }  // namespace mongo
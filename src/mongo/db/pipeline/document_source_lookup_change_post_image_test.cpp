@@ -334,5 +334,58 @@ TEST_F(DocumentSourceLookupChangePostImageTest, ShouldPropagatePauses) {
     ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceLookupChangePostImageTest, ShouldLookUpConsecutiveUpdatesTogether) {
+    auto expCtx = getExpCtx();
+
+    // Set up the lookup change post image stage.
+    auto lookupChangeStage = DocumentSourceLookupChangePostImage::create(expCtx);
+
+    // Mock its input with a run of updates, one of them to a document which no longer exists,
+    // followed by an insert and another update.
+    const Document ns{{"db", expCtx->ns.db()}, {"coll", expCtx->ns.coll()}};
+    auto makeEvent = [&](int id, StringData opType) {
+        return Document{{"_id", makeResumeToken(id)},
+                        {"documentKey", Document{{"_id", id}}},
+                        {"operationType", opType},
+                        {"ns", ns}};
+    };
+    auto mockLocalSource = DocumentSourceMock::createForTest({makeEvent(0, "update"_sd),
+                                                              makeEvent(1, "update"_sd),
+                                                              makeEvent(2, "update"_sd),
+                                                              makeEvent(0, "update"_sd),
+                                                              makeEvent(3, "insert"_sd),
+                                                              makeEvent(1, "update"_sd)},
+                                                             expCtx);
+
+    lookupChangeStage->setSource(mockLocalSource.get());
+
+    // Mock out the foreign collection.
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document{{"_id", 0}, {"x", 0}},
+                                                             Document{{"_id", 1}, {"x", 1}},
+                                                             Document{{"_id", 3}, {"x", 3}}};
+    getExpCtx()->mongoProcessInterface =
+        std::make_unique<MockMongoInterface>(std::move(mockForeignContents));
+
+    // Each update is returned in order with the current version of its document, or null if there
+    // is none. The insert is returned unchanged.
+    auto assertNextFullDocument = [&](int id, StringData opType, Value fullDocument) {
+        auto next = lookupChangeStage->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        auto expected = MutableDocument(makeEvent(id, opType));
+        if (!fullDocument.missing()) {
+            expected.addField("fullDocument", fullDocument);
+        }
+        ASSERT_DOCUMENT_EQ(next.releaseDocument(), expected.freeze());
+    };
+    assertNextFullDocument(0, "update"_sd, Value(Document{{"_id", 0}, {"x", 0}}));
+    assertNextFullDocument(1, "update"_sd, Value(Document{{"_id", 1}, {"x", 1}}));
+    assertNextFullDocument(2, "update"_sd, Value(BSONNULL));
+    assertNextFullDocument(0, "update"_sd, Value(Document{{"_id", 0}, {"x", 0}}));
+    assertNextFullDocument(3, "insert"_sd, Value());
+    assertNextFullDocument(1, "update"_sd, Value(Document{{"_id", 1}, {"x", 1}}));
+
+    ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_query_shape_stats.h"
+
+#include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/db/stats/query_shape_stats.h"
+#include "mongo/util/hex.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+REGISTER_DOCUMENT_SOURCE(queryShapeStats,
+                         DocumentSourceQueryShapeStats::LiteParsed::parse,
+                         DocumentSourceQueryShapeStats::createFromBson);
+
+const char* DocumentSourceQueryShapeStats::getSourceName() const {
+    return kStageName.rawData();
+}
+
+namespace {
+static constexpr StringData kClearStats = "clearStats"_sd;
+static constexpr StringData kNamespace = "ns"_sd;
+static constexpr StringData kQueryHash = "queryHash"_sd;
+}  // namespace
+
+DocumentSource::GetNextResult DocumentSourceQueryShapeStats::doGetNext() {
+    if (_shapeStats.empty()) {
+        auto shapeMetrics = [&]() {
+            if (_clearStats) {
+                return QueryShapeStats::get(pExpCtx->opCtx).getAndClearMetrics();
+            }
+            return QueryShapeStats::get(pExpCtx->opCtx).getMetrics();
+        }();
+        for (auto& [key, metrics] : shapeMetrics) {
+            BSONObjBuilder builder;
+            builder.append(kNamespace, key.nss.ns());
+            // Reported in the same format as the slow query log and $planCacheStats.
+            builder.append(kQueryHash, zeroPaddedHex(key.queryHash));
+            metrics.toBson(&builder);
+            _shapeStats.push_back(builder.obj());
+        }
+
+        _shapeStatsIter = _shapeStats.begin();
+    }
+
+    if (_shapeStatsIter != _shapeStats.end()) {
+        auto doc = Document(std::move(*_shapeStatsIter));
+        _shapeStatsIter++;
+        return doc;
+    }
+
+    return GetNextResult::makeEOF();
+}
+
+intrusive_ptr<DocumentSource> DocumentSourceQueryShapeStats::createFromBson(
+    BSONElement elem, const intrusive_ptr<ExpressionContext>& pExpCtx) {
+    if (!QueryShapeStats::isEnabled()) {
+        uasserted(ErrorCodes::CommandNotSupported,
+                  "The collectQueryShapeStats server parameter is not set");
+    }
+
+    return new DocumentSourceQueryShapeStats(pExpCtx, parseClearStats(elem));
+}
+
+bool DocumentSourceQueryShapeStats::parseClearStats(const BSONElement& elem) {
+    uassert(ErrorCodes::BadValue,
+            "The $queryShapeStats stage specification must be an object",
+            elem.type() == Object);
+
+    auto stageObj = elem.Obj();
+    bool clearStats = false;
+    if (auto clearElem = stageObj.getField(kClearStats); !clearElem.eoo()) {
+        clearStats = clearElem.trueValue();
+    } else if (!stageObj.isEmpty()) {
+        uasserted(
+            ErrorCodes::BadValue,
+            "The $queryShapeStats stage specification must be empty or contain valid options");
+    }
+    return clearStats;
+}
+
+Value DocumentSourceQueryShapeStats::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    // The option is kept so that shards and explain see the same stage as was requested.
+    return Value(DOC(getSourceName() << (_clearStats ? DOC(kClearStats << true) : Document())));
+}
+}  // namespace mongo
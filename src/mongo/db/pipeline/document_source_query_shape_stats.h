@@ -0,0 +1,118 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/db/pipeline/document_source.h"
+
+namespace mongo {
+
+/**
+ * Provides a document source interface to retrieve the metrics accumulated by query shape.
+ */
+class DocumentSourceQueryShapeStats : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$queryShapeStats"_sd;
+
+    class LiteParsed final : public LiteParsedDocumentSource {
+    public:
+        static std::unique_ptr<LiteParsed> parse(const NamespaceString& nss,
+                                                 const BSONElement& spec) {
+            return std::make_unique<LiteParsed>(spec.fieldName(), parseClearStats(spec));
+        }
+
+        LiteParsed(std::string parseTimeName, bool clearStats)
+            : LiteParsedDocumentSource(std::move(parseTimeName)), _clearStats(clearStats) {}
+
+        PrivilegeVector requiredPrivileges(bool isMongos,
+                                           bool bypassDocumentValidation) const final {
+            // Clearing the statistics discards them for every other user.
+            if (_clearStats) {
+                return {Privilege(ResourcePattern::forClusterResource(),
+                                  {ActionType::serverStatus, ActionType::clearQueryShapeStats})};
+            }
+            return {Privilege(ResourcePattern::forClusterResource(), ActionType::serverStatus)};
+        }
+
+        stdx::unordered_set<NamespaceString> getInvolvedNamespaces() const final {
+            return {};
+        }
+
+        bool isInitialSource() const final {
+            return true;
+        }
+
+    private:
+        const bool _clearStats;
+    };
+
+    DocumentSourceQueryShapeStats(const boost::intrusive_ptr<ExpressionContext>& pExpCtx,
+                                  bool clearStats)
+        : DocumentSource(kStageName, pExpCtx), _clearStats(clearStats) {}
+
+    const char* getSourceName() const final;
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kStreaming,
+                                     PositionRequirement::kFirst,
+                                     HostTypeRequirement::kAnyShard,
+                                     DiskUseRequirement::kNoDiskUse,
+                                     FacetRequirement::kNotAllowed,
+                                     TransactionRequirement::kNotAllowed,
+                                     LookupRequirement::kAllowed,
+                                     UnionRequirement::kAllowed);
+
+        constraints.isIndependentOfAnyCollection = true;
+        constraints.requiresInputDocSource = false;
+        return constraints;
+    }
+
+    boost::optional<DistributedPlanLogic> distributedPlanLogic() final {
+        return boost::none;
+    }
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    static boost::intrusive_ptr<DocumentSource> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
+
+    /**
+     * Parses the stage specification, returning whether it asks to clear the statistics.
+     */
+    static bool parseClearStats(const BSONElement& elem);
+
+private:
+    GetNextResult doGetNext() final;
+
+    std::vector<BSONObj> _shapeStats;
+    std::vector<BSONObj>::const_iterator _shapeStatsIter;
+    bool _clearStats = false;
+};
+
+}  // namespace mongo
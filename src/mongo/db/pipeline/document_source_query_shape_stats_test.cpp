@@ -0,0 +1,112 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/json.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_source_query_shape_stats.h"
+#include "mongo/db/stats/query_shape_stats_gen.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class DocumentSourceQueryShapeStatsTest : public AggregationContextFixture {
+protected:
+    void setUp() override {
+        AggregationContextFixture::setUp();
+        _originalCollectQueryShapeStats = gCollectQueryShapeStats.load();
+        gCollectQueryShapeStats.store(true);
+    }
+
+    void tearDown() override {
+        gCollectQueryShapeStats.store(_originalCollectQueryShapeStats);
+        AggregationContextFixture::tearDown();
+    }
+
+    void assertRoundTrips(const BSONObj& specObj, const BSONObj& expected) {
+        auto stage =
+            DocumentSourceQueryShapeStats::createFromBson(specObj.firstElement(), getExpCtx());
+        for (auto explain : {boost::optional<ExplainOptions::Verbosity>(),
+                             boost::optional<ExplainOptions::Verbosity>(
+                                 ExplainOptions::Verbosity::kQueryPlanner)}) {
+            std::vector<Value> serialized;
+            stage->serializeToArray(serialized, explain);
+            ASSERT_EQ(1u, serialized.size());
+            ASSERT_BSONOBJ_EQ(expected, serialized[0].getDocument().toBson());
+        }
+    }
+
+private:
+    bool _originalCollectQueryShapeStats = false;
+};
+
+TEST_F(DocumentSourceQueryShapeStatsTest, ShouldFailToParseIfDisabled) {
+    gCollectQueryShapeStats.store(false);
+    const auto specObj = fromjson("{$queryShapeStats: {}}");
+    ASSERT_THROWS_CODE(
+        DocumentSourceQueryShapeStats::createFromBson(specObj.firstElement(), getExpCtx()),
+        AssertionException,
+        ErrorCodes::CommandNotSupported);
+}
+
+TEST_F(DocumentSourceQueryShapeStatsTest, ShouldFailToParseIfSpecIsNotObject) {
+    const auto specObj = fromjson("{$queryShapeStats: 1}");
+    ASSERT_THROWS_CODE(
+        DocumentSourceQueryShapeStats::createFromBson(specObj.firstElement(), getExpCtx()),
+        AssertionException,
+        ErrorCodes::BadValue);
+}
+
+TEST_F(DocumentSourceQueryShapeStatsTest, ShouldFailToParseUnknownOption) {
+    const auto specObj = fromjson("{$queryShapeStats: {unknownOption: 1}}");
+    ASSERT_THROWS_CODE(
+        DocumentSourceQueryShapeStats::createFromBson(specObj.firstElement(), getExpCtx()),
+        AssertionException,
+        ErrorCodes::BadValue);
+}
+
+TEST_F(DocumentSourceQueryShapeStatsTest, SerializesEmptySpec) {
+    const auto specObj = fromjson("{$queryShapeStats: {}}");
+    assertRoundTrips(specObj, specObj);
+}
+
+TEST_F(DocumentSourceQueryShapeStatsTest, SerializesClearStats) {
+    const auto specObj = fromjson("{$queryShapeStats: {clearStats: true}}");
+    assertRoundTrips(specObj, specObj);
+}
+
+TEST_F(DocumentSourceQueryShapeStatsTest, SerializesClearStatsFalseAsEmptySpec) {
+    assertRoundTrips(fromjson("{$queryShapeStats: {clearStats: false}}"),
+                     fromjson("{$queryShapeStats: {}}"));
+}
+
+}  // namespace
+}  // namespace mongo
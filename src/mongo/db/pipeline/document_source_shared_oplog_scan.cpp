@@ -0,0 +1,172 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_shared_oplog_scan.h"
+
+#include "mongo/db/curop.h"
+#include "mongo/db/pipeline/document_source_change_stream.h"
+#include "mongo/db/query/find_common.h"
+#include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/repl/speculative_majority_read_info.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+boost::intrusive_ptr<DocumentSourceSharedOplogScan> DocumentSourceSharedOplogScan::createIfEligible(
+    const DocumentSourceOplogMatch& oplogMatch,
+    const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    if (!internalChangeStreamUseSharedOplogReader.load() || expCtx->explain ||
+        expCtx->tailableMode != TailableModeEnum::kTailableAndAwaitData) {
+        return nullptr;
+    }
+
+    // A speculative majority read must establish its own read timestamp from the oplog it scans.
+    if (repl::SpeculativeMajorityReadInfo::get(expCtx->opCtx).isSpeculativeRead()) {
+        return nullptr;
+    }
+
+    auto reader = &SharedOplogReader::get(expCtx->opCtx->getServiceContext());
+    auto subscription =
+        reader->subscribe(expCtx->ns, oplogMatch.getStartFrom(), oplogMatch.getQuery());
+    if (!subscription) {
+        return nullptr;
+    }
+    return new DocumentSourceSharedOplogScan(expCtx, reader, std::move(subscription));
+}
+
+DocumentSourceSharedOplogScan::DocumentSourceSharedOplogScan(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    SharedOplogReader* reader,
+    std::shared_ptr<SharedOplogReader::Subscription> subscription)
+    : DocumentSource(kStageName, expCtx), _reader(reader), _subscription(std::move(subscription)) {}
+
+DocumentSourceSharedOplogScan::~DocumentSourceSharedOplogScan() {
+    if (_subscription) {
+        _reader->unsubscribe(_subscription);
+    }
+}
+
+const char* DocumentSourceSharedOplogScan::getSourceName() const {
+    return kStageName.rawData();
+}
+
+StageConstraints DocumentSourceSharedOplogScan::constraints(Pipeline::SplitState pipeState) const {
+    StageConstraints constraints(StreamType::kStreaming,
+                                 PositionRequirement::kFirst,
+                                 HostTypeRequirement::kAnyShard,
+                                 DiskUseRequirement::kNoDiskUse,
+                                 FacetRequirement::kNotAllowed,
+                                 TransactionRequirement::kNotAllowed,
+                                 LookupRequirement::kNotAllowed,
+                                 UnionRequirement::kNotAllowed,
+                                 ChangeStreamRequirement::kChangeStreamStage);
+    constraints.isIndependentOfAnyCollection = pExpCtx->ns.isCollectionlessAggregateNS();
+    constraints.requiresInputDocSource = false;
+    return constraints;
+}
+
+Value DocumentSourceSharedOplogScan::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    if (explain) {
+        return Value(Document{{kStageName, Document{}}});
+    }
+    return Value();
+}
+
+Timestamp DocumentSourceSharedOplogScan::getLatestOplogTimestamp() const {
+    return _subscription ? _subscription->getLatestOplogTimestamp() : Timestamp();
+}
+
+DocumentSource::GetNextResult DocumentSourceSharedOplogScan::doGetNext() {
+    if (!_subscription) {
+        return GetNextResult::makeEOF();
+    }
+
+    auto opCtx = pExpCtx->opCtx;
+    while (true) {
+        if (auto entry = _subscription->next()) {
+            return Document(*entry);
+        }
+
+        // Read the next batch of the oplog for all change streams, unless another change stream
+        // just did so.
+        if (!_reader->readNext(opCtx, _subscription.get(), &_notifierData)) {
+            continue;
+        }
+        if (auto entry = _subscription->next()) {
+            return Document(*entry);
+        }
+
+        if (!_notifierData.notifier || !shouldWaitForInserts()) {
+            return GetNextResult::makeEOF();
+        }
+        waitForInserts();
+    }
+}
+
+void DocumentSourceSharedOplogScan::doDispose() {
+    if (_subscription) {
+        _reader->unsubscribe(_subscription);
+        _subscription.reset();
+    }
+}
+
+bool DocumentSourceSharedOplogScan::shouldWaitForInserts() const {
+    auto opCtx = pExpCtx->opCtx;
+    if (!awaitDataState(opCtx).shouldWaitForInserts || !opCtx->checkForInterruptNoAssert().isOK() ||
+        awaitDataState(opCtx).waitForInsertsDeadline <=
+            opCtx->getServiceContext()->getPreciseClockSource()->now()) {
+        return false;
+    }
+
+    // Return early to inform the client of a newer last committed opTime, as the oplog scan of a
+    // change stream would.
+    if (!clientsLastKnownCommittedOpTime(opCtx).isNull()) {
+        auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+        return clientsLastKnownCommittedOpTime(opCtx) >= replCoord->getLastCommittedOpTime();
+    }
+    return true;
+}
+
+void DocumentSourceSharedOplogScan::waitForInserts() {
+    auto opCtx = pExpCtx->opCtx;
+    auto curOp = CurOp::get(opCtx);
+    curOp->pauseTimer();
+    ON_BLOCK_EXIT([curOp] { curOp->resumeTimer(); });
+
+    _notifierData.notifier->waitUntil(_notifierData.lastEOFVersion,
+                                      awaitDataState(opCtx).waitForInsertsDeadline);
+    opCtx->checkForInterrupt();
+}
+
+}  // namespace mongo
@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/shared_oplog_reader.h"
+#include "mongo/db/query/plan_insert_listener.h"
+
+namespace mongo {
+
+class DocumentSourceOplogMatch;
+
+/**
+ * Takes the place of the oplog scan of a change stream, producing the oplog entries the shared
+ * oplog reader hands to this change stream instead.
+ */
+class DocumentSourceSharedOplogScan final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$_internalSharedOplogScan"_sd;
+
+    /**
+     * Subscribes the change stream that 'oplogMatch' is the first stage of to the shared oplog
+     * reader. Returns nullptr if the shared reader is disabled, cannot serve this change stream, or
+     * has already read past the point where the change stream starts.
+     */
+    static boost::intrusive_ptr<DocumentSourceSharedOplogScan> createIfEligible(
+        const DocumentSourceOplogMatch& oplogMatch,
+        const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    const char* getSourceName() const final;
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final;
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    boost::optional<DistributedPlanLogic> distributedPlanLogic() final {
+        return boost::none;
+    }
+
+    /**
+     * Returns the latest oplog timestamp this change stream has observed, for the high water mark
+     * of the change stream.
+     */
+    Timestamp getLatestOplogTimestamp() const;
+
+private:
+    DocumentSourceSharedOplogScan(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                  SharedOplogReader* reader,
+                                  std::shared_ptr<SharedOplogReader::Subscription> subscription);
+
+    ~DocumentSourceSharedOplogScan();
+
+    GetNextResult doGetNext() final;
+
+    void doDispose() final;
+
+    /**
+     * Returns true if a tailable, awaitData getMore should wait for more oplog entries rather than
+     * returning EOF.
+     */
+    bool shouldWaitForInserts() const;
+
+    void waitForInserts();
+
+    SharedOplogReader* const _reader;
+
+    // Reset once the stage is disposed of.
+    std::shared_ptr<SharedOplogReader::Subscription> _subscription;
+
+    // The oplog's insert notifier and its version as of the last read that found no entries for
+    // this change stream.
+    insert_listener::CappedInsertNotifierData _notifierData;
+};
+
+}  // namespace mongo
@@ -38,6 +38,7 @@
 #include "mongo/db/pipeline/document_source_limit.h"
 #include "mongo/db/pipeline/document_source_skip.h"
 #include "mongo/db/pipeline/expression.h"
+#include "mongo/db/query/query_knobs_gen.h"
 
 namespace mongo {
 
@@ -64,6 +65,19 @@ DocumentSource::GetNextResult DocumentSourceSingleDocumentTransformation::doGetN
         return input;
     }
 
+    const int arenaBatchSizeBytes = internalDocumentSourceArenaBatchSizeBytes.load();
+    if (arenaBatchSizeBytes == 0) {
+        _arena.reset();
+        return _parsedTransform->applyTransformation(input.releaseDocument());
+    }
+
+    // Build the output document in the arena of the current batch, starting a new batch once the
+    // arena is full. Documents from earlier batches keep their arena alive until they are released.
+    if (!_arena || _arena->bytesAllocated() >= static_cast<size_t>(arenaBatchSizeBytes)) {
+        _arena = make_intrusive<DocumentArena>(arenaBatchSizeBytes);
+    }
+    DocumentArena::Scope arenaScope(_arena.get());
+
     // Apply and return the document with added fields.
     return _parsedTransform->applyTransformation(input.releaseDocument());
 }
@@ -79,6 +93,7 @@ void DocumentSourceSingleDocumentTransformation::doDispose() {
         _cachedStageOptions = _parsedTransform->serializeTransformation(pExpCtx->explain);
         _parsedTransform.reset();
     }
+    _arena.reset();
 }
 
 Value DocumentSourceSingleDocumentTransformation::serialize(
@@ -31,6 +31,7 @@
 
 #include <type_traits>
 
+#include "mongo/db/exec/document_value/document_arena.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/transformer_interface.h"
 
@@ -114,6 +115,10 @@ private:
     // Cached stage options in case this DocumentSource is disposed before serialized (e.g. explain
     // with a sort which will auto-dispose of the pipeline).
     Document _cachedStageOptions;
+
+    // Arena for the current batch of output documents, if internalDocumentSourceArenaBatchSizeBytes
+    // enables arena allocation.
+    boost::intrusive_ptr<DocumentArena> _arena;
 };
 
 }  // namespace mongo
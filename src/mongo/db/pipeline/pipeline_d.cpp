@@ -49,6 +49,7 @@
 #include "mongo/db/exec/trial_stage.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/ops/write_ops_exec.h"
@@ -62,6 +63,7 @@
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_sample.h"
 #include "mongo/db/pipeline/document_source_sample_from_random_cursor.h"
+#include "mongo/db/pipeline/document_source_shared_oplog_scan.h"
 #include "mongo/db/pipeline/document_source_single_document_transformation.h"
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/pipeline.h"
@@ -71,6 +73,7 @@
 #include "mongo/db/query/plan_executor_factory.h"
 #include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/sort_pattern.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/service_context.h"
@@ -325,6 +328,19 @@ PipelineD::buildInnerQueryExecutor(const CollectionPtr& collection,
     // We will be modifying the source vector as we go.
     Pipeline::SourceContainer& sources = pipeline->_sources;
 
+    // A change stream may receive its oplog entries from the oplog reader shared by all change
+    // streams, rather than scanning the oplog itself.
+    if (!sources.empty()) {
+        if (auto oplogMatch = dynamic_cast<DocumentSourceOplogMatch*>(sources.front().get())) {
+            if (auto sharedScan =
+                    DocumentSourceSharedOplogScan::createIfEligible(*oplogMatch, expCtx)) {
+                pipeline->popFront();
+                pipeline->addInitialSource(std::move(sharedScan));
+                return {};
+            }
+        }
+    }
+
     if (!sources.empty() && !sources.front()->constraints().requiresInputDocSource) {
         return {};
     }
@@ -505,6 +521,71 @@ auto buildProjectionForPushdown(const DepsTracker& deps, Pipeline* pipeline) {
     // happen. This covers cases 2 and 3.
     return deps.toProjectionWithoutMetadata();
 }
+
+/**
+ * Returns a sort pattern under which an index scan delivers the input of 'groupStage' grouped by
+ * its key, or boost::none if there is no such scan that can also provide every field in 'deps'.
+ *
+ * This requires a btree index whose leading fields are exactly the group key paths and whose key
+ * fields cover 'deps'. The index must not be multikey, so that each document has a single index
+ * key and that key holds the document's group key, and it must not be sparse or partial, so that
+ * every document has an index key.
+ */
+boost::optional<BSONObj> getSortForStreamingGroup(const intrusive_ptr<ExpressionContext>& expCtx,
+                                                  const CollectionPtr& collection,
+                                                  const DocumentSourceGroup& groupStage,
+                                                  const DepsTracker& deps) {
+    if (!collection || groupStage.doingMerge() || deps.needWholeDocument ||
+        deps.metadataDeps().any()) {
+        return boost::none;
+    }
+
+    auto groupPaths = groupStage.getGroupKeyFieldPaths();
+    if (groupPaths.empty()) {
+        return boost::none;
+    }
+    const std::set<std::string> groupPathSet(groupPaths.begin(), groupPaths.end());
+    if (groupPathSet.size() != groupPaths.size()) {
+        return boost::none;
+    }
+
+    auto ii = collection->getIndexCatalog()->getIndexIterator(expCtx->opCtx, false);
+    while (ii->more()) {
+        const IndexCatalogEntry* ice = ii->next();
+        const IndexDescriptor* desc = ice->descriptor();
+        if (desc->hidden() || desc->getIndexType() != IndexType::INDEX_BTREE ||
+            desc->isSparse() || desc->isPartial() || ice->isMultikey() ||
+            !CollatorInterface::collatorsMatch(ice->getCollator(), expCtx->getCollator())) {
+            continue;
+        }
+
+        BSONObjBuilder sortBuilder;
+        std::set<std::string> keyFields;
+        bool prefixIsGroupKey = true;
+        for (auto&& keyElem : desc->keyPattern()) {
+            const std::string keyField = keyElem.fieldName();
+            if (keyFields.size() < groupPathSet.size()) {
+                if (!groupPathSet.count(keyField)) {
+                    prefixIsGroupKey = false;
+                    break;
+                }
+                sortBuilder.append(keyField, keyElem.number() < 0 ? -1 : 1);
+            }
+            keyFields.insert(keyField);
+        }
+        if (!prefixIsGroupKey || keyFields.size() < groupPathSet.size()) {
+            continue;
+        }
+
+        const bool coversDeps = std::all_of(deps.fields.begin(),
+                                            deps.fields.end(),
+                                            [&](auto&& field) { return keyFields.count(field); });
+        if (coversDeps) {
+            return sortBuilder.obj();
+        }
+    }
+    return boost::none;
+}
 }  // namespace
 
 std::pair<PipelineD::AttachExecutorCallback, std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>>
@@ -774,6 +855,39 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
         }
     }
 
+    // If the pipeline begins with a $group whose key is a prefix of an index which covers the
+    // pipeline's dependencies, request the order of that index without allowing a blocking sort.
+    // Documents with equal group keys then arrive together, and the $group can output each group
+    // as soon as it is complete without ever fetching from the collection.
+    auto groupStage = dynamic_cast<DocumentSourceGroup*>(pipeline->peekFront());
+    if (groupStage && !sortStage && !skipThenLimit.getSkip() && !skipThenLimit.getLimit() &&
+        internalQueryEnableStreamingGroupOnIndexScan.load()) {
+        if (auto streamingSortObj =
+                getSortForStreamingGroup(expCtx, collection, *groupStage, deps)) {
+            auto swExecutorStreaming =
+                attemptToGetExecutor(expCtx,
+                                     collection,
+                                     nss,
+                                     queryObj,
+                                     projObj,
+                                     deps.metadataDeps(),
+                                     *streamingSortObj,
+                                     skipThenLimit,
+                                     boost::none, /* groupIdForDistinctScan */
+                                     aggRequest,
+                                     plannerOpts | QueryPlannerParams::NO_BLOCKING_SORT,
+                                     matcherFeatures);
+            if (swExecutorStreaming.isOK()) {
+                groupStage->setStreaming(true);
+                return swExecutorStreaming;
+            } else if (swExecutorStreaming != ErrorCodes::NoQueryExecutionPlans) {
+                return swExecutorStreaming.getStatus().withContext(
+                    "Failed to determine whether query system can provide an index scan ordered "
+                    "by the $group key");
+            }
+        }
+    }
+
     return attemptToGetExecutor(expCtx,
                                 collection,
                                 nss,
@@ -793,6 +907,10 @@ Timestamp PipelineD::getLatestOplogTimestamp(const Pipeline* pipeline) {
             dynamic_cast<DocumentSourceCursor*>(pipeline->_sources.front().get())) {
         return docSourceCursor->getLatestOplogTimestamp();
     }
+    if (auto sharedScan =
+            dynamic_cast<DocumentSourceSharedOplogScan*>(pipeline->_sources.front().get())) {
+        return sharedScan->getLatestOplogTimestamp();
+    }
     return Timestamp();
 }
 }  // namespace mongo
@@ -143,6 +143,21 @@ bool supportsUniqueKey(const boost::intrusive_ptr<ExpressionContext>& expCtx,
             CollatorInterface::collatorsMatch(index->getCollator(), expCtx->getCollator()));
 }
 
+// Sets the speculative read timestamp appropriately after we do a document lookup locally. We set
+// the speculative read timestamp based on the timestamp used by the transaction.
+void setSpeculativeReadTimestampAfterLookup(OperationContext* opCtx) {
+    repl::SpeculativeMajorityReadInfo& speculativeMajorityReadInfo =
+        repl::SpeculativeMajorityReadInfo::get(opCtx);
+    if (speculativeMajorityReadInfo.isSpeculativeRead()) {
+        // Speculative majority reads are required to use the 'kNoOverlap' read source.
+        invariant(opCtx->recoveryUnit()->getTimestampReadSource() ==
+                  RecoveryUnit::ReadSource::kNoOverlap);
+        boost::optional<Timestamp> readTs = opCtx->recoveryUnit()->getPointInTimeReadTimestamp();
+        invariant(readTs);
+        speculativeMajorityReadInfo.setSpeculativeReadTimestampForward(*readTs);
+    }
+}
+
 }  // namespace
 
 std::unique_ptr<TransactionHistoryIteratorBase>
@@ -356,21 +371,43 @@ boost::optional<Document> CommonMongodProcessInterface::lookupSingleDocument(
                                 << ", " << next->toString() << "]");
     }
 
-    // Set the speculative read timestamp appropriately after we do a document lookup locally. We
-    // set the speculative read timestamp based on the timestamp used by the transaction.
-    repl::SpeculativeMajorityReadInfo& speculativeMajorityReadInfo =
-        repl::SpeculativeMajorityReadInfo::get(expCtx->opCtx);
-    if (speculativeMajorityReadInfo.isSpeculativeRead()) {
-        // Speculative majority reads are required to use the 'kNoOverlap' read source.
-        invariant(expCtx->opCtx->recoveryUnit()->getTimestampReadSource() ==
-                  RecoveryUnit::ReadSource::kNoOverlap);
-        boost::optional<Timestamp> readTs =
-            expCtx->opCtx->recoveryUnit()->getPointInTimeReadTimestamp();
-        invariant(readTs);
-        speculativeMajorityReadInfo.setSpeculativeReadTimestampForward(*readTs);
+    setSpeculativeReadTimestampAfterLookup(expCtx->opCtx);
+    return lookedUpDocument;
+}
+
+std::vector<boost::optional<Document>> CommonMongodProcessInterface::lookupDocuments(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const std::vector<Document>& documentKeys,
+    boost::optional<BSONObj> readConcern,
+    bool allowSpeculativeMajorityRead) {
+    invariant(!readConcern);
+    invariant(!allowSpeculativeMajorityRead);
+
+    // Look up all of the documents with a single local query, as lookupSingleDocument() does for
+    // one document.
+    std::unique_ptr<Pipeline, PipelineDeleter> pipeline;
+    try {
+        auto foreignExpCtx = expCtx->copyWith(
+            nss,
+            collectionUUID,
+            _getCollectionDefaultCollator(expCtx->opCtx, nss.db(), collectionUUID));
+        MakePipelineOptions opts;
+        opts.allowTargetingShards = false;
+        pipeline = Pipeline::makePipeline(
+            {BSON("$match" << _buildDocumentKeysFilter(documentKeys))}, foreignExpCtx, opts);
+    } catch (const ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
+        return std::vector<boost::optional<Document>>(documentKeys.size());
     }
 
-    return lookedUpDocument;
+    std::vector<Document> lookedUpDocuments;
+    while (auto next = pipeline->getNext()) {
+        lookedUpDocuments.push_back(std::move(*next));
+    }
+
+    setSpeculativeReadTimestampAfterLookup(expCtx->opCtx);
+    return _matchDocumentsToKeys(documentKeys, std::move(lookedUpDocuments));
 }
 
 BackupCursorState CommonMongodProcessInterface::openBackupCursor(
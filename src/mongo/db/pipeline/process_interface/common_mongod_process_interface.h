@@ -87,6 +87,13 @@ public:
         const Document& documentKey,
         boost::optional<BSONObj> readConcern,
         bool allowSpeculativeMajorityRead = false) final;
+    std::vector<boost::optional<Document>> lookupDocuments(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const NamespaceString& nss,
+        UUID collectionUUID,
+        const std::vector<Document>& documentKeys,
+        boost::optional<BSONObj> readConcern,
+        bool allowSpeculativeMajorityRead = false) final;
     std::vector<GenericCursor> getIdleCursors(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                                               CurrentOpUserMode userMode) const final;
     BackupCursorState openBackupCursor(OperationContext* opCtx,
@@ -31,7 +31,11 @@
 
 #include "mongo/db/pipeline/process_interface/mongo_process_interface.h"
 
+#include <algorithm>
+
 #include "mongo/base/shim.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/exec/document_value/value_comparator.h"
 
 namespace mongo {
 
@@ -40,4 +44,96 @@ std::shared_ptr<MongoProcessInterface> MongoProcessInterface::create(OperationCo
     return w(opCtx);
 }
 
+std::vector<boost::optional<Document>> MongoProcessInterface::lookupDocuments(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const std::vector<Document>& documentKeys,
+    boost::optional<BSONObj> readConcern,
+    bool allowSpeculativeMajorityRead) {
+    std::vector<boost::optional<Document>> lookedUpDocuments;
+    lookedUpDocuments.reserve(documentKeys.size());
+    for (auto&& documentKey : documentKeys) {
+        lookedUpDocuments.push_back(lookupSingleDocument(
+            expCtx, nss, collectionUUID, documentKey, readConcern, allowSpeculativeMajorityRead));
+    }
+    return lookedUpDocuments;
+}
+
+BSONObj MongoProcessInterface::_buildDocumentKeysFilter(const std::vector<Document>& documentKeys) {
+    invariant(!documentKeys.empty());
+    const bool idOnly =
+        std::all_of(documentKeys.begin(), documentKeys.end(), [](const Document& documentKey) {
+            auto it = documentKey.fieldIterator();
+            return it.more() && it.next().first == "_id"_sd && !it.more();
+        });
+
+    BSONObjBuilder filterBuilder;
+    if (idOnly) {
+        BSONObjBuilder idBuilder(filterBuilder.subobjStart("_id"));
+        BSONArrayBuilder inBuilder(idBuilder.subarrayStart("$in"));
+        for (auto&& documentKey : documentKeys) {
+            documentKey["_id"].addToBsonArray(&inBuilder);
+        }
+    } else {
+        BSONArrayBuilder orBuilder(filterBuilder.subarrayStart("$or"));
+        for (auto&& documentKey : documentKeys) {
+            orBuilder.append(documentKey.toBson());
+        }
+    }
+    return filterBuilder.obj();
+}
+
+std::vector<boost::optional<Document>> MongoProcessInterface::_matchDocumentsToKeys(
+    const std::vector<Document>& documentKeys, std::vector<Document> documents) {
+    // The document keys of one collection normally all have the same fields, but they may not if
+    // its shard key was refined while the keys were being collected. We index the keys separately
+    // for each distinct list of fields. The same key may appear more than once.
+    using KeyIndex = ValueUnorderedMap<std::vector<size_t>>;
+    std::vector<std::pair<std::vector<std::string>, KeyIndex>> keyIndexes;
+    for (size_t i = 0; i < documentKeys.size(); ++i) {
+        std::vector<std::string> fieldNames;
+        for (auto it = documentKeys[i].fieldIterator(); it.more();) {
+            fieldNames.push_back(it.next().first.toString());
+        }
+        auto keyIndex = std::find_if(keyIndexes.begin(),
+                                     keyIndexes.end(),
+                                     [&](const auto& entry) { return entry.first == fieldNames; });
+        if (keyIndex == keyIndexes.end()) {
+            keyIndexes.emplace_back(
+                std::move(fieldNames),
+                ValueComparator::kInstance.makeUnorderedValueMap<std::vector<size_t>>());
+            keyIndex = std::prev(keyIndexes.end());
+        }
+        keyIndex->second[Value(documentKeys[i])].push_back(i);
+    }
+
+    std::vector<boost::optional<Document>> lookedUpDocuments(documentKeys.size());
+    for (auto&& document : documents) {
+        for (auto&& [fieldNames, keyIndex] : keyIndexes) {
+            // Extract the document's key in the same form as the document keys: dotted shard key
+            // fields are top-level fields of the document key, and a missing field matches null.
+            MutableDocument documentKey;
+            for (auto&& fieldName : fieldNames) {
+                auto value = document.getNestedField(FieldPath(fieldName));
+                documentKey.addField(fieldName, value.missing() ? Value(BSONNULL) : value);
+            }
+            auto matchingKeys = keyIndex.find(Value(documentKey.freeze()));
+            if (matchingKeys == keyIndex.end()) {
+                continue;
+            }
+            for (auto i : matchingKeys->second) {
+                uassert(ErrorCodes::ChangeStreamFatalError,
+                        str::stream() << "found more than one document with document key "
+                                      << documentKeys[i].toString() << " ["
+                                      << lookedUpDocuments[i]->toString() << ", "
+                                      << document.toString() << "]",
+                        !lookedUpDocuments[i]);
+                lookedUpDocuments[i] = document;
+            }
+        }
+    }
+    return lookedUpDocuments;
+}
+
 }  // namespace mongo
@@ -358,6 +358,22 @@ public:
         boost::optional<BSONObj> readConcern,
         bool allowSpeculativeMajorityRead = false) = 0;
 
+    /**
+     * Batched version of lookupSingleDocument(). Returns a vector parallel to 'documentKeys' which
+     * holds, for each document key, the matching document or boost::none if there was none.
+     * Implementations look up all of the documents with a single query per host, so that they are
+     * all read from the same snapshot. Throws if more than one document matches any of the keys.
+     *
+     * The default implementation looks up each document key in turn with lookupSingleDocument().
+     */
+    virtual std::vector<boost::optional<Document>> lookupDocuments(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const NamespaceString& nss,
+        UUID collectionUUID,
+        const std::vector<Document>& documentKeys,
+        boost::optional<BSONObj> readConcern,
+        bool allowSpeculativeMajorityRead = false);
+
     /**
      * Returns a vector of all idle (non-pinned) local cursors.
      */
@@ -446,6 +462,22 @@ public:
                                            const NamespaceString& outputNs) const = 0;
 
     std::shared_ptr<executor::TaskExecutor> taskExecutor;
+
+protected:
+    /**
+     * Returns a filter which matches the documents with any of the document keys in
+     * 'documentKeys'. This is an $in on _id when the keys consist only of an _id, and an $or of the
+     * keys otherwise.
+     */
+    static BSONObj _buildDocumentKeysFilter(const std::vector<Document>& documentKeys);
+
+    /**
+     * Assigns each of 'documents', the result of a query using _buildDocumentKeysFilter(), to the
+     * entry of 'documentKeys' which matches it, and returns the resulting vector parallel to
+     * 'documentKeys'. Throws if more than one document matches the same key.
+     */
+    static std::vector<boost::optional<Document>> _matchDocumentsToKeys(
+        const std::vector<Document>& documentKeys, std::vector<Document> documents);
 };
 
 }  // namespace mongo
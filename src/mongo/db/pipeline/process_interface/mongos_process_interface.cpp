@@ -96,6 +96,83 @@ bool supportsUniqueKey(const boost::intrusive_ptr<ExpressionContext>& expCtx,
         CollatorInterface::collatorsMatch(collation.get(), expCtx->getCollator());
 }
 
+/**
+ * Dispatches a find command with the filter 'filterObj' to the shards which own the documents it
+ * matches, and returns the cursors it established. Throws NamespaceNotFound if the collection no
+ * longer exists with the UUID 'collectionUUID'.
+ */
+std::vector<RemoteCursor> establishLookupCursors(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const BSONObj& filterObj,
+    const boost::optional<BSONObj>& readConcern,
+    bool allowSpeculativeMajorityRead,
+    boost::optional<long long> batchSize) {
+    auto foreignExpCtx = expCtx->copyWith(nss, collectionUUID);
+
+    // Create the find command to be dispatched to the shard(s) in order to return the post-image.
+    BSONObjBuilder cmdBuilder;
+    bool findCmdIsByUuid(foreignExpCtx->uuid);
+    if (findCmdIsByUuid) {
+        foreignExpCtx->uuid->appendToBuilder(&cmdBuilder, "find");
+    } else {
+        cmdBuilder.append("find", nss.coll());
+    }
+    cmdBuilder.append("filter", filterObj);
+    if (batchSize) {
+        cmdBuilder.append("batchSize", *batchSize);
+    }
+    if (readConcern) {
+        cmdBuilder.append(repl::ReadConcernArgs::kReadConcernFieldName, *readConcern);
+    }
+    if (allowSpeculativeMajorityRead) {
+        cmdBuilder.append("allowSpeculativeMajorityRead", true);
+    }
+
+    auto findCmd = cmdBuilder.obj();
+    auto catalogCache = Grid::get(expCtx->opCtx)->catalogCache();
+    return sharded_agg_helpers::shardVersionRetry(
+        expCtx->opCtx,
+        catalogCache,
+        foreignExpCtx->ns,
+        str::stream() << "Looking up document matching " << redact(filterObj),
+        [&]() -> std::vector<RemoteCursor> {
+            // Verify that the collection exists, with the correct UUID.
+            auto cm = uassertStatusOK(getCollectionRoutingInfo(foreignExpCtx));
+
+            // Finalize the 'find' command object based on the routing table information.
+            if (findCmdIsByUuid && cm.isSharded()) {
+                // Find by UUID and shard versioning do not work together (SERVER-31946).  In the
+                // sharded case we've already checked the UUID, so find by namespace is safe.  In
+                // the unlikely case that the collection has been deleted and a new collection with
+                // the same name created through a different mongos or the collection had its shard
+                // key refined, the shard version will be detected as stale, as shard versions
+                // contain an 'epoch' field unique to the collection.
+                findCmd = findCmd.addField(BSON("find" << nss.coll()).firstElement());
+                findCmdIsByUuid = false;
+            }
+
+            // Build the versioned requests to be dispatched to the shards. Typically, only a
+            // single shard will be targeted here; however, in certain cases where only the _id is
+            // present, we may need to scatter-gather the query to all shards in order to find the
+            // document. A filter built from several document keys targets each shard which owns
+            // any of them once.
+            auto requests = getVersionedRequestsForTargetedShards(
+                expCtx->opCtx, nss, cm, findCmd, filterObj, CollationSpec::kSimpleSpec);
+
+            // Dispatch the requests. The 'establishCursors' method conveniently prepares the
+            // result into a vector of cursor responses for us.
+            return establishCursors(
+                expCtx->opCtx,
+                Grid::get(expCtx->opCtx)->getExecutorPool()->getArbitraryExecutor(),
+                nss,
+                ReadPreferenceSetting::get(expCtx->opCtx),
+                std::move(requests),
+                false);
+        });
+}
+
 }  // namespace
 
 std::unique_ptr<Pipeline, PipelineDeleter> MongosProcessInterface::attachCursorSourceToPipeline(
@@ -123,66 +200,14 @@ boost::optional<Document> MongosProcessInterface::lookupSingleDocument(
     const Document& filter,
     boost::optional<BSONObj> readConcern,
     bool allowSpeculativeMajorityRead) {
-    auto foreignExpCtx = expCtx->copyWith(nss, collectionUUID);
-
-    // Create the find command to be dispatched to the shard(s) in order to return the post-image.
-    auto filterObj = filter.toBson();
-    BSONObjBuilder cmdBuilder;
-    bool findCmdIsByUuid(foreignExpCtx->uuid);
-    if (findCmdIsByUuid) {
-        foreignExpCtx->uuid->appendToBuilder(&cmdBuilder, "find");
-    } else {
-        cmdBuilder.append("find", nss.coll());
-    }
-    cmdBuilder.append("filter", filterObj);
-    if (readConcern) {
-        cmdBuilder.append(repl::ReadConcernArgs::kReadConcernFieldName, *readConcern);
-    }
-    if (allowSpeculativeMajorityRead) {
-        cmdBuilder.append("allowSpeculativeMajorityRead", true);
-    }
-
     try {
-        auto findCmd = cmdBuilder.obj();
-        auto catalogCache = Grid::get(expCtx->opCtx)->catalogCache();
-        auto shardResults = sharded_agg_helpers::shardVersionRetry(
-            expCtx->opCtx,
-            catalogCache,
-            foreignExpCtx->ns,
-            str::stream() << "Looking up document matching " << redact(filter.toBson()),
-            [&]() -> std::vector<RemoteCursor> {
-                // Verify that the collection exists, with the correct UUID.
-                auto cm = uassertStatusOK(getCollectionRoutingInfo(foreignExpCtx));
-
-                // Finalize the 'find' command object based on the routing table information.
-                if (findCmdIsByUuid && cm.isSharded()) {
-                    // Find by UUID and shard versioning do not work together (SERVER-31946).  In
-                    // the sharded case we've already checked the UUID, so find by namespace is
-                    // safe.  In the unlikely case that the collection has been deleted and a new
-                    // collection with the same name created through a different mongos or the
-                    // collection had its shard key refined, the shard version will be detected as
-                    // stale, as shard versions contain an 'epoch' field unique to the collection.
-                    findCmd = findCmd.addField(BSON("find" << nss.coll()).firstElement());
-                    findCmdIsByUuid = false;
-                }
-
-                // Build the versioned requests to be dispatched to the shards. Typically, only a
-                // single shard will be targeted here; however, in certain cases where only the _id
-                // is present, we may need to scatter-gather the query to all shards in order to
-                // find the document.
-                auto requests = getVersionedRequestsForTargetedShards(
-                    expCtx->opCtx, nss, cm, findCmd, filterObj, CollationSpec::kSimpleSpec);
-
-                // Dispatch the requests. The 'establishCursors' method conveniently prepares the
-                // result into a vector of cursor responses for us.
-                return establishCursors(
-                    expCtx->opCtx,
-                    Grid::get(expCtx->opCtx)->getExecutorPool()->getArbitraryExecutor(),
-                    nss,
-                    ReadPreferenceSetting::get(expCtx->opCtx),
-                    std::move(requests),
-                    false);
-            });
+        auto shardResults = establishLookupCursors(expCtx,
+                                                   nss,
+                                                   collectionUUID,
+                                                   filter.toBson(),
+                                                   readConcern,
+                                                   allowSpeculativeMajorityRead,
+                                                   boost::none);
 
         // Iterate all shard results and build a single composite batch. We also enforce the
         // requirement that only a single document should have been returned from across the
@@ -213,6 +238,75 @@ boost::optional<Document> MongosProcessInterface::lookupSingleDocument(
     }
 }
 
+std::vector<boost::optional<Document>> MongosProcessInterface::lookupDocuments(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const std::vector<Document>& documentKeys,
+    boost::optional<BSONObj> readConcern,
+    bool allowSpeculativeMajorityRead) {
+    std::vector<RemoteCursor> shardResults;
+    try {
+        // At most one document matches each key, so a batch size of one more than the number of
+        // keys lets each shard exhaust its cursor in the first batch, unless the documents exceed
+        // the maximum size of a batch.
+        shardResults = establishLookupCursors(expCtx,
+                                              nss,
+                                              collectionUUID,
+                                              _buildDocumentKeysFilter(documentKeys),
+                                              readConcern,
+                                              allowSpeculativeMajorityRead,
+                                              static_cast<long long>(documentKeys.size() + 1));
+    } catch (const ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
+        return std::vector<boost::optional<Document>>(documentKeys.size());
+    }
+
+    const bool allExhausted =
+        std::all_of(shardResults.begin(), shardResults.end(), [](const auto& shardResult) {
+            return shardResult.getCursorResponse().getCursorId() == 0;
+        });
+    if (!allExhausted) {
+        // The documents did not fit in a single batch. Rather than iterate the cursors, we kill
+        // them and look up each half of the keys, so that each lookup is a single round trip.
+        auto executor = Grid::get(expCtx->opCtx)->getExecutorPool()->getArbitraryExecutor();
+        for (auto&& shardResult : shardResults) {
+            if (shardResult.getCursorResponse().getCursorId() != 0) {
+                killRemoteCursor(expCtx->opCtx, executor.get(), std::move(shardResult), nss);
+            }
+        }
+        uassert(ErrorCodes::ChangeStreamFatalError,
+                str::stream() << "Shard cursor was unexpectedly open after lookup of "
+                              << documentKeys.front().toString(),
+                documentKeys.size() > 1);
+
+        auto middle = documentKeys.begin() + documentKeys.size() / 2;
+        auto lookedUpDocuments = lookupDocuments(expCtx,
+                                                 nss,
+                                                 collectionUUID,
+                                                 {documentKeys.begin(), middle},
+                                                 readConcern,
+                                                 allowSpeculativeMajorityRead);
+        auto secondHalf = lookupDocuments(expCtx,
+                                          nss,
+                                          collectionUUID,
+                                          {middle, documentKeys.end()},
+                                          readConcern,
+                                          allowSpeculativeMajorityRead);
+        lookedUpDocuments.insert(lookedUpDocuments.end(),
+                                 std::make_move_iterator(secondHalf.begin()),
+                                 std::make_move_iterator(secondHalf.end()));
+        return lookedUpDocuments;
+    }
+
+    std::vector<Document> lookedUpDocuments;
+    for (auto&& shardResult : shardResults) {
+        for (auto&& obj : shardResult.getCursorResponse().getBatch()) {
+            lookedUpDocuments.emplace_back(obj);
+        }
+    }
+    return _matchDocumentsToKeys(documentKeys, std::move(lookedUpDocuments));
+}
+
 BSONObj MongosProcessInterface::_reportCurrentOpForClient(
     OperationContext* opCtx,
     Client* client,
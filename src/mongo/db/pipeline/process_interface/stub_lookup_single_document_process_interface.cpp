@@ -82,4 +82,27 @@ boost::optional<Document> StubLookupSingleDocumentProcessInterface::lookupSingle
     return lookedUpDocument;
 }
 
+std::vector<boost::optional<Document>> StubLookupSingleDocumentProcessInterface::lookupDocuments(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const std::vector<Document>& documentKeys,
+    boost::optional<BSONObj> readConcern,
+    bool allowSpeculativeMajorityRead) {
+    auto foreignExpCtx = expCtx->copyWith(nss, collectionUUID, boost::none);
+    std::unique_ptr<Pipeline, PipelineDeleter> pipeline;
+    try {
+        pipeline = Pipeline::makePipeline(
+            {BSON("$match" << _buildDocumentKeysFilter(documentKeys))}, foreignExpCtx);
+    } catch (ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
+        return std::vector<boost::optional<Document>>(documentKeys.size());
+    }
+
+    std::vector<Document> lookedUpDocuments;
+    while (auto next = pipeline->getNext()) {
+        lookedUpDocuments.push_back(std::move(*next));
+    }
+    return _matchDocumentsToKeys(documentKeys, std::move(lookedUpDocuments));
+}
+
 }  // namespace mongo
@@ -80,6 +80,14 @@ public:
         boost::optional<BSONObj> readConcern,
         bool allowSpeculativeMajorityRead);
 
+    std::vector<boost::optional<Document>> lookupDocuments(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const NamespaceString& nss,
+        UUID collectionUUID,
+        const std::vector<Document>& documentKeys,
+        boost::optional<BSONObj> readConcern,
+        bool allowSpeculativeMajorityRead) final;
+
     std::unique_ptr<ShardFilterer> getShardFilterer(
         const boost::intrusive_ptr<ExpressionContext>& expCtx) const override {
         // Try to emulate the behavior mongos and mongod would each follow.
@@ -0,0 +1,354 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/shared_oplog_reader.h"
+
+#include <algorithm>
+
+#include "mongo/db/db_raii.h"
+#include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/pipeline/document_source_change_stream.h"
+#include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/plan_executor_factory.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/repl/oplog_entry.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/service_context.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+const auto getSharedOplogReader = ServiceContext::declareDecoration<SharedOplogReader>();
+
+bool isCrudOp(StringData opType) {
+    return opType == "i"_sd || opType == "u"_sd || opType == "d"_sd;
+}
+
+void removeFrom(std::vector<SharedOplogReader::Subscription*>* list,
+                SharedOplogReader::Subscription* subscription) {
+    list->erase(std::remove(list->begin(), list->end(), subscription), list->end());
+}
+
+}  // namespace
+
+SharedOplogReader::Subscription::Subscription(SharedOplogReader* reader,
+                                              NamespaceString nss,
+                                              Timestamp startFrom,
+                                              BSONObj filterObj,
+                                              boost::intrusive_ptr<ExpressionContext> expCtx,
+                                              std::unique_ptr<MatchExpression> filter)
+    : _reader(reader),
+      _nss(std::move(nss)),
+      _startFrom(startFrom),
+      _filterObj(std::move(filterObj)),
+      _expCtx(std::move(expCtx)),
+      _filter(std::move(filter)) {}
+
+boost::optional<BSONObj> SharedOplogReader::Subscription::next() {
+    stdx::lock_guard<Latch> lk(_reader->_mutex);
+    if (!_buffer.empty()) {
+        auto entry = std::move(_buffer.front());
+        _buffer.pop_front();
+        _bufferedBytes -= entry.objsize();
+        return entry;
+    }
+    uassert(ErrorCodes::RetryChangeStream,
+            str::stream() << "Change stream on " << _nss
+                          << " fell too far behind the shared oplog reader after "
+                          << _evictedAfter.toString(),
+            !_evicted);
+    return boost::none;
+}
+
+Timestamp SharedOplogReader::Subscription::getLatestOplogTimestamp() const {
+    stdx::lock_guard<Latch> lk(_reader->_mutex);
+    if (!_buffer.empty()) {
+        return _buffer.front()[repl::OpTime::kTimestampFieldName].timestamp();
+    }
+    auto lastRead = _evicted ? _evictedAfter : _reader->_lastRead.value_or(Timestamp());
+    return lastRead >= _startFrom ? lastRead : Timestamp();
+}
+
+SharedOplogReader& SharedOplogReader::get(ServiceContext* service) {
+    return getSharedOplogReader(service);
+}
+
+std::shared_ptr<SharedOplogReader::Subscription> SharedOplogReader::subscribe(
+    const NamespaceString& nss, Timestamp startFrom, const BSONObj& filter) {
+    // The filter is evaluated on behalf of the subscription by whichever operation reads the
+    // oplog, long after the one that subscribed is gone, so it cannot refer to an OperationContext.
+    // Similar to collection validators, the special features that need one are not shared.
+    auto filterObj = filter.getOwned();
+    auto expCtx = make_intrusive<ExpressionContext>(nullptr, nullptr, nss);
+    auto swFilter = MatchExpressionParser::parse(filterObj,
+                                                 expCtx,
+                                                 ExtensionsCallbackNoop(),
+                                                 MatchExpressionParser::kBanAllSpecialFeatures);
+    if (!swFilter.isOK()) {
+        return nullptr;
+    }
+    std::shared_ptr<Subscription> subscription(new Subscription(this,
+                                                                nss,
+                                                                startFrom,
+                                                                std::move(filterObj),
+                                                                std::move(expCtx),
+                                                                std::move(swFilter.getValue())));
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_subscriptions.empty() && !_reading) {
+        _lastRead = boost::none;
+        _startFrom = startFrom;
+    } else if (_lastRead ? startFrom <= *_lastRead : startFrom < _startFrom) {
+        return nullptr;
+    }
+
+    _subscriptions.push_back(subscription);
+    _allSubscriptions.push_back(subscription.get());
+    switch (DocumentSourceChangeStream::getChangeStreamType(nss)) {
+        case DocumentSourceChangeStream::ChangeStreamType::kSingleCollection:
+            _byCollection[nss.ns()].push_back(subscription.get());
+            break;
+        case DocumentSourceChangeStream::ChangeStreamType::kSingleDatabase:
+            _byDatabase[nss.db().toString()].push_back(subscription.get());
+            break;
+        case DocumentSourceChangeStream::ChangeStreamType::kAllChangesForCluster:
+            _wholeCluster.push_back(subscription.get());
+            break;
+    }
+    return subscription;
+}
+
+void SharedOplogReader::unsubscribe(const std::shared_ptr<Subscription>& subscription) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (!subscription->_evicted) {
+        _removeFromRegistry(lk, subscription.get());
+    }
+    _subscriptions.erase(std::remove(_subscriptions.begin(), _subscriptions.end(), subscription),
+                         _subscriptions.end());
+}
+
+size_t SharedOplogReader::numSubscriptions() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _allSubscriptions.size();
+}
+
+bool SharedOplogReader::readNext(OperationContext* opCtx,
+                                 Subscription* subscription,
+                                 insert_listener::CappedInsertNotifierData* notifierData) {
+    stdx::unique_lock<Latch> lk(_mutex);
+    if (_reading) {
+        opCtx->waitForConditionOrInterrupt(_readDone, lk, [&] { return !_reading; });
+        return false;
+    }
+    if (!subscription->_buffer.empty() || subscription->_evicted) {
+        return false;
+    }
+
+    _reading = true;
+    const auto lastRead = _lastRead;
+    const auto startFrom = _startFrom;
+    lk.unlock();
+
+    ON_BLOCK_EXIT([&] {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _reading = false;
+        _readDone.notify_all();
+    });
+
+    std::vector<BSONObj> entries;
+    Timestamp latestOplogTimestamp;
+    {
+        AutoGetCollectionForRead oplog(opCtx, NamespaceString::kRsOplogNamespace);
+        uassertStatusOK(repl::ReplicationCoordinator::get(opCtx)->checkCanServeReadsFor(
+            opCtx, NamespaceString::kRsOplogNamespace, true));
+        const auto& collection = oplog.getCollection();
+        if (!collection) {
+            return true;
+        }
+
+        // Capture the notifier version before reading, so that a wait for the entries written
+        // after this read cannot miss one written while it is in progress.
+        notifierData->notifier = collection->getCappedInsertNotifier();
+        notifierData->lastEOFVersion = notifierData->notifier->getVersion();
+
+        auto expCtx = make_intrusive<ExpressionContext>(
+            opCtx, nullptr, NamespaceString::kRsOplogNamespace);
+
+        // Read the entries after the last one read, or from the start of the first subscription.
+        const auto minTs = lastRead.value_or(startFrom);
+        const auto minTsObj = BSON("" << minTs);
+        std::unique_ptr<MatchExpression> filter;
+        if (lastRead) {
+            filter = std::make_unique<GTMatchExpression>(repl::OpTime::kTimestampFieldName,
+                                                         minTsObj.firstElement());
+        } else {
+            filter = std::make_unique<GTEMatchExpression>(repl::OpTime::kTimestampFieldName,
+                                                          minTsObj.firstElement());
+        }
+
+        CollectionScanParams params;
+        params.minTs = minTs;
+        params.assertMinTsHasNotFallenOffOplog = true;
+        params.shouldTrackLatestOplogTimestamp = true;
+        params.stopApplyingFilterAfterFirstMatch = true;
+        params.shouldWaitForOplogVisibility =
+            shouldWaitForOplogVisibility(opCtx, collection, false);
+
+        auto ws = std::make_unique<WorkingSet>();
+        auto root = std::make_unique<CollectionScan>(
+            expCtx.get(), collection, params, ws.get(), filter.get());
+        auto exec = uassertStatusOK(
+            plan_executor_factory::make(expCtx,
+                                        std::move(ws),
+                                        std::move(root),
+                                        &collection,
+                                        PlanYieldPolicy::YieldPolicy::INTERRUPT_ONLY,
+                                        NamespaceString::kRsOplogNamespace));
+
+        const auto batchSize =
+            static_cast<size_t>(internalChangeStreamSharedOplogReaderBatchSize.load());
+        BSONObj entry;
+        while (entries.size() < batchSize &&
+               exec->getNext(&entry, nullptr) == PlanExecutor::ADVANCED) {
+            entries.push_back(entry.getOwned());
+        }
+        latestOplogTimestamp = exec->getLatestOplogTimestamp();
+    }
+
+    lk.lock();
+    _distribute(lk, entries);
+    if (!latestOplogTimestamp.isNull()) {
+        _lastRead = std::max(_lastRead.value_or(Timestamp()), latestOplogTimestamp);
+    }
+    lk.unlock();
+    return true;
+}
+
+std::vector<const SharedOplogReader::SubscriptionList*> SharedOplogReader::_candidatesForCrudOp(
+    WithLock, StringData ns) const {
+    std::vector<const SubscriptionList*> candidates{&_wholeCluster};
+    if (auto it = _byCollection.find(ns.toString()); it != _byCollection.end()) {
+        candidates.push_back(&it->second);
+    }
+    if (auto it = _byDatabase.find(nsToDatabase(ns)); it != _byDatabase.end()) {
+        candidates.push_back(&it->second);
+    }
+    return candidates;
+}
+
+void SharedOplogReader::_distribute(WithLock lk, const std::vector<BSONObj>& entries) {
+    const auto maxBuffered =
+        static_cast<size_t>(internalChangeStreamSharedOplogReaderMaxBufferedEvents.load());
+    const auto maxBufferedBytes =
+        static_cast<size_t>(internalChangeStreamSharedOplogReaderMaxBufferedBytes.load());
+    std::vector<Subscription*> evicted;
+
+    // The last entry distributed before the current one.
+    auto previousTs = _lastRead.value_or(Timestamp());
+
+    auto offer = [&](Subscription* subscription, const BSONObj& entry) {
+        if (subscription->_evicted || !subscription->_filter->matchesBSON(entry)) {
+            return;
+        }
+        // A single entry larger than the byte limit is still buffered on its own.
+        const size_t entryBytes = entry.objsize();
+        if (subscription->_buffer.size() >= maxBuffered ||
+            (!subscription->_buffer.empty() &&
+             subscription->_bufferedBytes + entryBytes > maxBufferedBytes)) {
+            _evict(lk, subscription, previousTs);
+            evicted.push_back(subscription);
+            return;
+        }
+        subscription->_buffer.push_back(entry);
+        subscription->_bufferedBytes += entryBytes;
+    };
+
+    for (const auto& entry : entries) {
+        const auto opType = entry[repl::OplogEntry::kOpTypeFieldName].valueStringData();
+        if (isCrudOp(opType)) {
+            // A CRUD entry can only match the change streams watching its namespace.
+            const auto ns = entry[repl::OplogEntry::kNssFieldName].valueStringData();
+            for (const auto* candidates : _candidatesForCrudOp(lk, ns)) {
+                for (auto* subscription : *candidates) {
+                    offer(subscription, entry);
+                }
+            }
+        } else {
+            // Commands, including transactions' applyOps, may concern any change stream.
+            for (auto* subscription : _allSubscriptions) {
+                offer(subscription, entry);
+            }
+        }
+
+        for (auto* subscription : evicted) {
+            _removeFromRegistry(lk, subscription);
+        }
+        evicted.clear();
+        previousTs = entry[repl::OpTime::kTimestampFieldName].timestamp();
+    }
+}
+
+void SharedOplogReader::_evict(WithLock, Subscription* subscription, Timestamp evictedAfter) {
+    LOGV2_DEBUG(5121513,
+                1,
+                "Change stream fell too far behind the shared oplog reader",
+                "namespace"_attr = subscription->_nss,
+                "evictedAfter"_attr = evictedAfter);
+    subscription->_evicted = true;
+    subscription->_evictedAfter = evictedAfter;
+}
+
+void SharedOplogReader::_removeFromRegistry(WithLock, Subscription* subscription) {
+    removeFrom(&_allSubscriptions, subscription);
+    removeFrom(&_wholeCluster, subscription);
+    if (auto it = _byCollection.find(subscription->_nss.ns()); it != _byCollection.end()) {
+        removeFrom(&it->second, subscription);
+        if (it->second.empty()) {
+            _byCollection.erase(it);
+        }
+    }
+    if (auto it = _byDatabase.find(subscription->_nss.db().toString()); it != _byDatabase.end()) {
+        removeFrom(&it->second, subscription);
+        if (it->second.empty()) {
+            _byDatabase.erase(it);
+        }
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,198 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/query/plan_insert_listener.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/with_lock.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+/**
+ * A scan of the oplog shared by the change streams on this node, so that each oplog entry is read
+ * once rather than once per change stream.
+ *
+ * A change stream subscribes with the filter that it would otherwise have pushed down into its own
+ * oplog scan. The reader keeps the subscriptions in a registry indexed by namespace. It matches
+ * each CRUD entry it reads only against the change streams on that entry's collection, database or
+ * the whole cluster, and all other entries against every change stream. Each matching entry is
+ * appended to the subscription's buffer.
+ *
+ * There is no dedicated thread. A change stream that finds its buffer empty reads the next batch of
+ * the oplog on behalf of all subscriptions, or waits for the change stream already doing so.
+ */
+class SharedOplogReader {
+    SharedOplogReader(const SharedOplogReader&) = delete;
+    SharedOplogReader& operator=(const SharedOplogReader&) = delete;
+
+public:
+    /**
+     * A change stream receiving its oplog entries from the shared reader.
+     */
+    class Subscription {
+    public:
+        /**
+         * Returns the next buffered oplog entry, or boost::none if none are buffered. Throws
+         * RetryChangeStream, which is resumable, once the buffer is drained if the subscription
+         * fell so far behind that the reader stopped buffering entries for it.
+         */
+        boost::optional<BSONObj> next();
+
+        /**
+         * Returns the timestamp of the next buffered oplog entry or, if there is none, of the last
+         * oplog entry the reader has read. Returns a null timestamp while the reader has not yet
+         * reached the point this subscription started from.
+         */
+        Timestamp getLatestOplogTimestamp() const;
+
+        Timestamp getStartFrom() const {
+            return _startFrom;
+        }
+
+    private:
+        friend class SharedOplogReader;
+
+        Subscription(SharedOplogReader* reader,
+                     NamespaceString nss,
+                     Timestamp startFrom,
+                     BSONObj filterObj,
+                     boost::intrusive_ptr<ExpressionContext> expCtx,
+                     std::unique_ptr<MatchExpression> filter);
+
+        SharedOplogReader* const _reader;
+        const NamespaceString _nss;
+        const Timestamp _startFrom;
+
+        // The parsed filter refers into '_filterObj', and may refer to '_expCtx', which has no
+        // OperationContext as the subscription outlives the operation that subscribed.
+        const BSONObj _filterObj;
+        const boost::intrusive_ptr<ExpressionContext> _expCtx;
+        const std::unique_ptr<MatchExpression> _filter;
+
+        // Guarded by the reader's mutex.
+        std::deque<BSONObj> _buffer;
+        size_t _bufferedBytes = 0;
+        bool _evicted = false;
+
+        // The last oplog entry read before the subscription was evicted. Every matching entry up
+        // to it is in '_buffer'.
+        Timestamp _evictedAfter;
+    };
+
+    SharedOplogReader() = default;
+
+    static SharedOplogReader& get(ServiceContext* service);
+
+    /**
+     * Subscribes a change stream on 'nss' that matches oplog entries with 'filter' from 'startFrom'
+     * onwards. The filter is evaluated with the simple collation.
+     *
+     * Returns nullptr if the reader has already read past 'startFrom' for other subscriptions, or
+     * if evaluating 'filter' needs an OperationContext, as with $expr or $where. The change stream
+     * must then scan the oplog itself.
+     */
+    std::shared_ptr<Subscription> subscribe(const NamespaceString& nss,
+                                            Timestamp startFrom,
+                                            const BSONObj& filter);
+
+    void unsubscribe(const std::shared_ptr<Subscription>& subscription);
+
+    /**
+     * Reads the next batch of the oplog and appends the entries to the buffers of the subscriptions
+     * they match, unless 'subscription' already has entries buffered. If another subscription is
+     * reading, waits for it to finish instead and returns false.
+     *
+     * On returning true, 'notifierData' holds the version of the oplog's insert notifier from
+     * before the read, for waiting for entries written after it.
+     */
+    bool readNext(OperationContext* opCtx,
+                  Subscription* subscription,
+                  insert_listener::CappedInsertNotifierData* notifierData);
+
+    /**
+     * Returns the number of subscriptions receiving oplog entries from the reader.
+     */
+    size_t numSubscriptions() const;
+
+private:
+    using SubscriptionList = std::vector<Subscription*>;
+
+    /**
+     * Returns the subscriptions that an oplog entry for a CRUD operation on 'ns' may match.
+     */
+    std::vector<const SubscriptionList*> _candidatesForCrudOp(WithLock, StringData ns) const;
+
+    void _distribute(WithLock, const std::vector<BSONObj>& entries);
+
+    void _removeFromRegistry(WithLock, Subscription* subscription);
+
+    /**
+     * Stops buffering entries for a subscription that fell too far behind. It has received every
+     * matching entry up to and including 'evictedAfter'.
+     */
+    void _evict(WithLock, Subscription* subscription, Timestamp evictedAfter);
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("SharedOplogReader::_mutex");
+    stdx::condition_variable _readDone;
+
+    // Whether a subscription is reading the oplog on behalf of the others.
+    bool _reading = false;
+
+    // The oplog entries up to and including '_lastRead' have been read and distributed. If not
+    // set, the next read starts at '_startFrom', inclusive.
+    boost::optional<Timestamp> _lastRead;
+    Timestamp _startFrom;
+
+    // Owns the subscriptions, including those evicted but not yet unsubscribed.
+    std::vector<std::shared_ptr<Subscription>> _subscriptions;
+
+    // The subscriptions receiving oplog entries, indexed by the namespace of their change stream.
+    SubscriptionList _allSubscriptions;
+    stdx::unordered_map<std::string, SubscriptionList> _byCollection;
+    stdx::unordered_map<std::string, SubscriptionList> _byDatabase;
+    SubscriptionList _wholeCluster;
+};
+
+}  // namespace mongo
@@ -195,7 +195,7 @@ std::unique_ptr<PlanStage> ClassicStageBuilder::build(const QuerySolutionNode* r
         }
         case STAGE_AND_HASH: {
             const AndHashNode* ahn = static_cast<const AndHashNode*>(root);
-            auto ret = std::make_unique<AndHashStage>(expCtx, _ws);
+            auto ret = std::make_unique<AndHashStage>(expCtx, _ws, ahn->recordIdsOnly);
             for (size_t i = 0; i < ahn->children.size(); ++i) {
                 auto childStage = build(ahn->children[i]);
                 ret->addChild(std::move(childStage));
@@ -0,0 +1,224 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+/**
+ * A key-value store with an approximate least recently used replacement policy (CLOCK), bounded
+ * both by a number of entries and by the total size in bytes of its entries.
+ *
+ * Unlike an exact LRU list, a lookup does not reorder anything: it only sets the entry's reference
+ * bit. On eviction a "clock hand" sweeps the entries in insertion order, clearing reference bits as
+ * it goes, and evicts the first entry it finds whose bit is already clear. Entries that were looked
+ * up since the hand last passed them therefore survive one more sweep.
+ *
+ * Caveat:
+ * This kv-store is NOT thread safe! The client to this utility is responsible for protecting
+ * concurrent access to the store if used in a threaded context.
+ */
+template <class K, class V, class KeyHasher = std::hash<K>>
+class ClockKeyValue {
+public:
+    struct Slot {
+        Slot(const K& key, std::unique_ptr<V> value, size_t sizeBytes)
+            : key(key), value(std::move(value)), sizeBytes(sizeBytes) {}
+
+        K key;
+        std::unique_ptr<V> value;
+        size_t sizeBytes;
+
+        // Set on every lookup and cleared when the clock hand passes over the slot.
+        mutable bool referenced = false;
+    };
+
+    using SlotList = std::list<Slot>;
+    using SlotListIt = typename SlotList::iterator;
+    using SlotListConstIt = typename SlotList::const_iterator;
+
+    ClockKeyValue(size_t maxEntries, size_t maxSizeBytes)
+        : _maxEntries(maxEntries), _maxSizeBytes(maxSizeBytes), _hand(_slots.end()) {}
+
+    /**
+     * Adds 'value' under 'key', replacing any value already stored for 'key'. 'sizeBytes' is the
+     * amount of the byte budget accounted to the entry.
+     *
+     * Returns the entries evicted to make room. If 'value' alone does not fit in the store it is
+     * not added, and is returned as the only evicted entry.
+     */
+    std::vector<std::unique_ptr<V>> add(const K& key, std::unique_ptr<V> value, size_t sizeBytes) {
+        std::vector<std::unique_ptr<V>> evicted;
+        if (_maxEntries == 0 || sizeBytes > _maxSizeBytes) {
+            remove(key).ignore();
+            evicted.push_back(std::move(value));
+            return evicted;
+        }
+
+        auto found = _index.find(key);
+        if (found != _index.end()) {
+            // Replace in place, keeping the slot's position relative to the clock hand.
+            auto& slot = *found->second;
+            _currentSizeBytes -= slot.sizeBytes;
+            slot.value = std::move(value);
+            slot.sizeBytes = sizeBytes;
+            slot.referenced = true;
+            _currentSizeBytes += sizeBytes;
+            _evictWhileOverBudget(found->second, &evicted);
+            return evicted;
+        }
+
+        // New slots go right behind the hand so that they are the last ones it considers.
+        auto inserted = _slots.emplace(_hand, key, std::move(value), sizeBytes);
+        _index.emplace(key, inserted);
+        _currentSizeBytes += sizeBytes;
+        _evictWhileOverBudget(inserted, &evicted);
+        return evicted;
+    }
+
+    /**
+     * Retrieves the value associated with 'key' through 'entryOut' and marks it as recently used.
+     * The kv-store retains ownership of the value.
+     */
+    Status get(const K& key, V** entryOut) const {
+        auto found = _index.find(key);
+        if (found == _index.end()) {
+            return Status(ErrorCodes::NoSuchKey, "no such key in CLOCK key-value store");
+        }
+        found->second->referenced = true;
+        *entryOut = found->second->value.get();
+        return Status::OK();
+    }
+
+    /**
+     * Removes the entry keyed by 'key'.
+     */
+    Status remove(const K& key) {
+        auto found = _index.find(key);
+        if (found == _index.end()) {
+            return Status(ErrorCodes::NoSuchKey, "no such key in CLOCK key-value store");
+        }
+        _erase(found->second);
+        return Status::OK();
+    }
+
+    /**
+     * Deletes all entries in the kv-store.
+     */
+    void clear() {
+        _index.clear();
+        _slots.clear();
+        _hand = _slots.end();
+        _currentSizeBytes = 0;
+    }
+
+    bool hasKey(const K& key) const {
+        return _index.find(key) != _index.end();
+    }
+
+    /**
+     * Returns the number of entries currently in the kv-store.
+     */
+    size_t size() const {
+        return _slots.size();
+    }
+
+    /**
+     * Returns the sum of the sizes of the entries currently in the kv-store.
+     */
+    size_t sizeBytes() const {
+        return _currentSizeBytes;
+    }
+
+    SlotListConstIt begin() const {
+        return _slots.begin();
+    }
+
+    SlotListConstIt end() const {
+        return _slots.end();
+    }
+
+private:
+    void _erase(SlotListIt slot) {
+        if (_hand == slot) {
+            ++_hand;
+        }
+        _currentSizeBytes -= slot->sizeBytes;
+        _index.erase(slot->key);
+        _slots.erase(slot);
+    }
+
+    /**
+     * Evicts entries until the store is within both of its limits, never evicting 'keep'.
+     */
+    void _evictWhileOverBudget(SlotListIt keep, std::vector<std::unique_ptr<V>>* evicted) {
+        while ((_slots.size() > _maxEntries || _currentSizeBytes > _maxSizeBytes) &&
+               _slots.size() > 1) {
+            if (_hand == _slots.end()) {
+                _hand = _slots.begin();
+            }
+
+            if (_hand == keep) {
+                ++_hand;
+                continue;
+            }
+
+            if (_hand->referenced) {
+                _hand->referenced = false;
+                ++_hand;
+                continue;
+            }
+
+            auto victim = _hand;
+            evicted->push_back(std::move(victim->value));
+            _erase(victim);
+        }
+    }
+
+    const size_t _maxEntries;
+    const size_t _maxSizeBytes;
+
+    size_t _currentSizeBytes = 0;
+
+    // Slots in insertion order. The clock hand cycles through this list.
+    SlotList _slots;
+    SlotListIt _hand;
+
+    stdx::unordered_map<K, SlotListIt, KeyHasher> _index;
+};
+
+}  // namespace mongo
@@ -0,0 +1,148 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/query/clock_key_value.h"
+
+#include <limits>
+
+#include "mongo/unittest/unittest.h"
+
+using namespace mongo;
+
+namespace {
+
+using Cache = ClockKeyValue<int, int>;
+
+constexpr size_t kUnlimitedBytes = std::numeric_limits<size_t>::max();
+
+std::unique_ptr<int> makeValue(int value) {
+    return std::make_unique<int>(value);
+}
+
+void assertInKVStore(Cache& cache, int key, int value) {
+    int* cachedValue = nullptr;
+    ASSERT_TRUE(cache.hasKey(key));
+    ASSERT_OK(cache.get(key, &cachedValue));
+    ASSERT_EQUALS(*cachedValue, value);
+}
+
+TEST(ClockKeyValueTest, BasicAddGet) {
+    Cache cache(100, kUnlimitedBytes);
+    ASSERT_TRUE(cache.add(1, makeValue(2), 1).empty());
+    assertInKVStore(cache, 1, 2);
+    ASSERT_EQUALS(cache.size(), 1U);
+    ASSERT_EQUALS(cache.sizeBytes(), 1U);
+}
+
+TEST(ClockKeyValueTest, SizeZeroCache) {
+    Cache cache(0, kUnlimitedBytes);
+    auto evicted = cache.add(1, makeValue(2), 1);
+    ASSERT_EQUALS(evicted.size(), 1U);
+    ASSERT_EQUALS(*evicted[0], 2);
+    ASSERT_FALSE(cache.hasKey(1));
+}
+
+TEST(ClockKeyValueTest, ReplaceKeepsOneEntry) {
+    Cache cache(10, kUnlimitedBytes);
+    cache.add(1, makeValue(1), 10);
+    cache.add(1, makeValue(2), 5);
+    ASSERT_EQUALS(cache.size(), 1U);
+    ASSERT_EQUALS(cache.sizeBytes(), 5U);
+    assertInKVStore(cache, 1, 2);
+}
+
+/**
+ * Fill up the kv-store, look up every entry except for one, then add another entry and make sure
+ * that the entry that was not looked up is evicted.
+ */
+TEST(ClockKeyValueTest, EvictsEntryNotRecentlyUsed) {
+    const int maxSize = 10;
+    Cache cache(maxSize, kUnlimitedBytes);
+    for (int i = 0; i < maxSize; ++i) {
+        ASSERT_TRUE(cache.add(i, makeValue(i), 1).empty());
+    }
+
+    const int evictKey = 5;
+    for (int i = 0; i < maxSize; ++i) {
+        if (i != evictKey) {
+            assertInKVStore(cache, i, i);
+        }
+    }
+
+    auto evicted = cache.add(maxSize, makeValue(maxSize), 1);
+    ASSERT_EQUALS(evicted.size(), 1U);
+    ASSERT_EQUALS(*evicted[0], evictKey);
+    ASSERT_EQUALS(cache.size(), static_cast<size_t>(maxSize));
+    ASSERT_FALSE(cache.hasKey(evictKey));
+}
+
+TEST(ClockKeyValueTest, EvictsToStayWithinByteBudget) {
+    Cache cache(100, 10);
+    cache.add(1, makeValue(1), 4);
+    cache.add(2, makeValue(2), 4);
+
+    // Needs both existing entries gone to fit.
+    auto evicted = cache.add(3, makeValue(3), 9);
+    ASSERT_EQUALS(evicted.size(), 2U);
+    ASSERT_EQUALS(cache.size(), 1U);
+    ASSERT_EQUALS(cache.sizeBytes(), 9U);
+    assertInKVStore(cache, 3, 3);
+}
+
+TEST(ClockKeyValueTest, EntryLargerThanBudgetIsNotAdded) {
+    Cache cache(100, 10);
+    cache.add(1, makeValue(1), 4);
+
+    auto evicted = cache.add(2, makeValue(2), 11);
+    ASSERT_EQUALS(evicted.size(), 1U);
+    ASSERT_EQUALS(*evicted[0], 2);
+    ASSERT_FALSE(cache.hasKey(2));
+    assertInKVStore(cache, 1, 1);
+}
+
+TEST(ClockKeyValueTest, RemoveAndClear) {
+    Cache cache(10, kUnlimitedBytes);
+    cache.add(1, makeValue(1), 1);
+    cache.add(2, makeValue(2), 1);
+
+    ASSERT_OK(cache.remove(1));
+    ASSERT_NOT_OK(cache.remove(1));
+    ASSERT_EQUALS(cache.size(), 1U);
+
+    cache.clear();
+    ASSERT_EQUALS(cache.size(), 0U);
+    ASSERT_EQUALS(cache.sizeBytes(), 0U);
+    ASSERT_FALSE(cache.hasKey(2));
+
+    // The store remains usable after being cleared.
+    cache.add(3, makeValue(3), 1);
+    assertInKVStore(cache, 3, 3);
+}
+
+}  // namespace
@@ -34,6 +34,7 @@
 #include "mongo/db/query/collection_query_info.h"
 
 #include <memory>
+#include <set>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/index_catalog.h"
@@ -49,9 +50,12 @@
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/planner_ixselect.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/service_context.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/clock_source.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -77,10 +81,72 @@ CoreIndexInfo indexInfoFromIndexCatalogEntry(const IndexCatalogEntry& ice) {
             projExec};
 }
 
+bool isStale(const CollectionStatistics& stats, long long numRecords, Date_t now) {
+    if (now - stats.getTimeOfCreation() >=
+        Seconds(internalQueryStatisticsRefreshIntervalSecs.load())) {
+        return true;
+    }
+
+    // A collection that grew or shrank a lot since the sample was taken is likely to have a
+    // different distribution of values.
+    return numRecords > 2 * stats.getNumRecords() || 2 * numRecords < stats.getNumRecords();
+}
+
+std::shared_ptr<const CollectionStatistics> sampleStatistics(OperationContext* opCtx,
+                                                             const CollectionPtr& coll,
+                                                             long long numRecords,
+                                                             Date_t now) {
+    std::set<std::string> paths;
+    std::unique_ptr<IndexCatalog::IndexIterator> ii =
+        coll->getIndexCatalog()->getIndexIterator(opCtx, false);
+    while (ii->more()) {
+        const IndexDescriptor* desc = ii->next()->descriptor();
+        if (desc->getIndexType() != IndexType::INDEX_BTREE) {
+            continue;
+        }
+        for (auto&& elt : desc->keyPattern()) {
+            paths.insert(elt.fieldName());
+        }
+    }
+    if (paths.empty()) {
+        return nullptr;
+    }
+
+    auto cursor = coll->getRecordStore()->getRandomCursor(opCtx);
+    if (!cursor) {
+        return nullptr;
+    }
+
+    // The sample is taken by the query that found the statistics missing or stale, so its cost
+    // is bounded by time as well as by the number of documents. Each step of a random cursor may
+    // have to read pages from disk.
+    CollectionStatistics::Builder builder({paths.begin(), paths.end()});
+    const long long sampleSize =
+        std::min<long long>(internalQueryStatisticsSampleSize.load(), numRecords);
+    const Milliseconds maxSampleTime{internalQueryStatisticsSampleMaxMillis.load()};
+    Timer timer;
+    long long numSampled = 0;
+    while (numSampled < sampleSize && Milliseconds(timer.millis()) < maxSampleTime) {
+        opCtx->checkForInterrupt();
+        auto record = cursor->next();
+        if (!record) {
+            break;
+        }
+        builder.addDocument(record->data.toBson());
+        ++numSampled;
+    }
+    if (numSampled == 0) {
+        return nullptr;
+    }
+    return builder.done(numRecords, now);
+}
+
 }  // namespace
 
 CollectionQueryInfo::CollectionQueryInfo()
-    : _keysComputed(false), _planCache(std::make_shared<PlanCache>()) {}
+    : _keysComputed(false),
+      _planCache(std::make_shared<PlanCache>()),
+      _statisticsCache(std::make_shared<StatisticsCache>()) {}
 
 const UpdateIndexData& CollectionQueryInfo::getIndexKeys(OperationContext* opCtx) const {
     invariant(_keysComputed);
@@ -215,6 +281,40 @@ PlanCache* CollectionQueryInfo::getPlanCache() const {
     return _planCache.get();
 }
 
+std::shared_ptr<const CollectionStatistics> CollectionQueryInfo::getCollectionStatistics(
+    OperationContext* opCtx, const CollectionPtr& coll) const {
+    auto cache = _statisticsCache;
+    const Date_t now = opCtx->getServiceContext()->getFastClockSource()->now();
+    const long long numRecords = static_cast<long long>(coll->numRecords(opCtx));
+    {
+        stdx::lock_guard<Latch> lk(cache->mutex);
+        if (cache->refreshing || (cache->stats && !isStale(*cache->stats, numRecords, now))) {
+            return cache->stats;
+        }
+        cache->refreshing = true;
+    }
+    ON_BLOCK_EXIT([&] {
+        stdx::lock_guard<Latch> lk(cache->mutex);
+        cache->refreshing = false;
+    });
+
+    auto stats = sampleStatistics(opCtx, coll, numRecords, now);
+    if (stats) {
+        LOGV2_DEBUG(5121505,
+                    1,
+                    "Computed collection statistics",
+                    "namespace"_attr = coll->ns(),
+                    "numRecords"_attr = numRecords,
+                    "numSampledDocs"_attr = stats->getNumSampledDocs());
+    }
+
+    stdx::lock_guard<Latch> lk(cache->mutex);
+    if (stats) {
+        cache->stats = stats;
+    }
+    return cache->stats;
+}
+
 void CollectionQueryInfo::updatePlanCacheIndexEntries(OperationContext* opCtx,
                                                       const CollectionPtr& coll) {
     std::vector<CoreIndexInfo> indexCores;
@@ -265,6 +365,8 @@ void CollectionQueryInfo::droppedIndex(OperationContext* opCtx,
 
 void CollectionQueryInfo::rebuildIndexData(OperationContext* opCtx, const CollectionPtr& coll) {
     _planCache = std::make_shared<PlanCache>();
+    // The set of sampled fields depends on the indexes.
+    _statisticsCache = std::make_shared<StatisticsCache>();
 
     _keysComputed = false;
     computeIndexKeys(opCtx, coll);
@@ -30,9 +30,11 @@
 #pragma once
 
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/query/collection_statistics.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/update_index_data.h"
+#include "mongo/platform/mutex.h"
 
 namespace mongo {
 
@@ -62,6 +64,20 @@ public:
      */
     PlanCache* getPlanCache() const;
 
+    /**
+     * Returns statistics about the values of the collection's indexed fields, sampling the
+     * collection to compute them if they are missing or stale. Returns nullptr if there are no
+     * statistics and they cannot be computed, either because the storage engine does not support
+     * random cursors or because another operation is already computing them.
+     *
+     * The sample is taken synchronously by the calling operation, which therefore pays up to
+     * internalQueryStatisticsSampleMaxMillis of extra latency about once per
+     * internalQueryStatisticsRefreshIntervalSecs per collection. A sample cut short by that limit
+     * is built from the documents read so far.
+     */
+    std::shared_ptr<const CollectionStatistics> getCollectionStatistics(
+        OperationContext* opCtx, const CollectionPtr& coll) const;
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
@@ -124,6 +140,19 @@ private:
 
     // A cache for query plans. Shared across cloned Collection instances.
     std::shared_ptr<PlanCache> _planCache;
+
+    struct StatisticsCache {
+        Mutex mutex = MONGO_MAKE_LATCH("CollectionQueryInfo::StatisticsCache::mutex");
+        std::shared_ptr<const CollectionStatistics> stats;
+
+        // Set while an operation samples the collection, so that concurrent operations use the
+        // previous statistics rather than sampling too.
+        bool refreshing = false;
+    };
+
+    // The latest statistics about the collection. Shared across cloned Collection instances, like
+    // the plan cache.
+    std::shared_ptr<StatisticsCache> _statisticsCache;
 };
 
 }  // namespace mongo
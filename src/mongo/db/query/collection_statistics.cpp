@@ -0,0 +1,232 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/db/bson/dotted_path_support.h"
+
+namespace mongo {
+namespace {
+int compareValues(const BSONElement& lhs, const BSONElement& rhs) {
+    return lhs.woCompare(rhs, 0);
+}
+}  // namespace
+
+FieldStatistics FieldStatistics::make(std::vector<BSONElement> values,
+                                      size_t numSampledDocs,
+                                      long long numRecords) {
+    FieldStatistics stats;
+    stats._numSampledDocs = numSampledDocs;
+    if (values.empty() || numSampledDocs == 0) {
+        return stats;
+    }
+
+    std::sort(values.begin(), values.end(), [](const BSONElement& lhs, const BSONElement& rhs) {
+        return compareValues(lhs, rhs) < 0;
+    });
+
+    // Group the sorted values into runs of equal values: (index of the first value, run length).
+    std::vector<std::pair<size_t, size_t>> runs;
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (!runs.empty() && compareValues(values[runs.back().first], values[i]) == 0) {
+            ++runs.back().second;
+        } else {
+            runs.emplace_back(i, 1);
+        }
+    }
+
+    // Estimate the number of distinct values with the GEE estimator: values seen once in the
+    // sample stand in for sqrt(N/n) distinct values each, values seen more often are assumed to
+    // have been all found.
+    const double numSampledValues = values.size();
+    const double numValues = std::max(numSampledValues,
+                                      numSampledValues * numRecords / double(numSampledDocs));
+    const double seenOnce = std::count_if(
+        runs.begin(), runs.end(), [](const auto& run) { return run.second == 1; });
+    stats._distinctValues = std::min(
+        numValues, std::sqrt(numValues / numSampledValues) * seenOnce + (runs.size() - seenOnce));
+
+    // The most common values are the longest runs of more than one value.
+    std::vector<std::pair<size_t, size_t>> commonRuns;
+    std::copy_if(runs.begin(), runs.end(), std::back_inserter(commonRuns), [](const auto& run) {
+        return run.second > 1;
+    });
+    std::sort(commonRuns.begin(), commonRuns.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.second > rhs.second;
+    });
+    if (commonRuns.size() > kMaxCommonValues) {
+        commonRuns.resize(kMaxCommonValues);
+    }
+
+    // Equi-depth histogram boundaries over all the sampled values.
+    const size_t numBuckets = std::min(kMaxBuckets, values.size());
+    std::vector<size_t> boundaryIndexes;
+    for (size_t i = 0; i <= numBuckets; ++i) {
+        boundaryIndexes.push_back(i * (values.size() - 1) / numBuckets);
+    }
+    stats._valuesPerBucket = numSampledValues / numBuckets;
+
+    // Copy the values that the statistics refer to.
+    BSONObjBuilder dataBuilder;
+    {
+        BSONArrayBuilder boundaries(dataBuilder.subarrayStart("boundaries"));
+        for (auto index : boundaryIndexes) {
+            boundaries.append(values[index]);
+        }
+    }
+    {
+        BSONArrayBuilder commonValues(dataBuilder.subarrayStart("commonValues"));
+        for (auto&& run : commonRuns) {
+            commonValues.append(values[run.first]);
+        }
+    }
+    stats._data = dataBuilder.obj();
+
+    for (auto&& boundary : stats._data["boundaries"].Obj()) {
+        stats._boundaries.push_back(boundary);
+    }
+
+    size_t numCommonValues = 0;
+    auto runIt = commonRuns.begin();
+    for (auto&& commonValue : stats._data["commonValues"].Obj()) {
+        stats._commonValues.emplace_back(commonValue, double(runIt->second) / numSampledDocs);
+        numCommonValues += runIt->second;
+        ++runIt;
+    }
+
+    stats._otherValuesFraction = (numSampledValues - numCommonValues) / numSampledDocs;
+    stats._distinctOtherValues =
+        std::max(1.0, stats._distinctValues - static_cast<double>(commonRuns.size()));
+    return stats;
+}
+
+double FieldStatistics::estimateFraction(const Interval& interval) const {
+    if (_boundaries.empty()) {
+        return 0;
+    }
+
+    BSONElement start = interval.start;
+    BSONElement end = interval.end;
+    bool startInclusive = interval.startInclusive;
+    bool endInclusive = interval.endInclusive;
+    if (compareValues(start, end) > 0) {
+        // Intervals of descending index fields run backwards.
+        std::swap(start, end);
+        std::swap(startInclusive, endInclusive);
+    }
+
+    if (interval.isPoint()) {
+        for (auto&& [value, fraction] : _commonValues) {
+            if (compareValues(value, start) == 0) {
+                return fraction;
+            }
+        }
+
+        // A value the sample did not find at all is assumed to be at most as common as a value
+        // found once.
+        const double fraction = _otherValuesFraction / _distinctOtherValues;
+        if (compareValues(start, _boundaries.front()) < 0 ||
+            compareValues(start, _boundaries.back()) > 0) {
+            return std::min(fraction, 1.0 / _numSampledDocs);
+        }
+        return fraction;
+    }
+
+    // Count the buckets that are entirely within the interval in full and the ones that overlap
+    // it in half.
+    double buckets = 0;
+    for (size_t i = 0; i + 1 < _boundaries.size(); ++i) {
+        const auto& low = _boundaries[i];
+        const auto& high = _boundaries[i + 1];
+
+        const int highVsStart = compareValues(high, start);
+        const int lowVsEnd = compareValues(low, end);
+        if (highVsStart < 0 || (highVsStart == 0 && !startInclusive) || lowVsEnd > 0 ||
+            (lowVsEnd == 0 && !endInclusive)) {
+            continue;
+        }
+
+        if (compareValues(start, low) <= 0 && compareValues(high, end) <= 0) {
+            buckets += 1;
+        } else {
+            buckets += 0.5;
+        }
+    }
+    return buckets * _valuesPerBucket / _numSampledDocs;
+}
+
+CollectionStatistics::Builder::Builder(std::vector<std::string> paths)
+    : _paths(std::move(paths)), _values(_paths.size()) {}
+
+void CollectionStatistics::Builder::addDocument(const BSONObj& doc) {
+    ++_numSampledDocs;
+    for (size_t i = 0; i < _paths.size(); ++i) {
+        BSONElementSet elements;
+        dotted_path_support::extractAllElementsAlongPath(doc, _paths[i], elements);
+        if (elements.empty()) {
+            // Missing fields are indexed as null.
+            _values[i].appendNull();
+            continue;
+        }
+        for (auto&& element : elements) {
+            _values[i].append(element);
+        }
+    }
+}
+
+std::shared_ptr<const CollectionStatistics> CollectionStatistics::Builder::done(
+    long long numRecords, Date_t now) {
+    auto stats = std::make_shared<CollectionStatistics>();
+    stats->_numRecords = numRecords;
+    stats->_numSampledDocs = _numSampledDocs;
+    stats->_timeOfCreation = now;
+
+    for (size_t i = 0; i < _paths.size(); ++i) {
+        const auto sampled = _values[i].arr();
+        std::vector<BSONElement> values;
+        for (auto&& value : sampled) {
+            values.push_back(value);
+        }
+        stats->_fields[_paths[i]] =
+            FieldStatistics::make(std::move(values), _numSampledDocs, numRecords);
+    }
+    return stats;
+}
+
+const FieldStatistics* CollectionStatistics::getFieldStatistics(StringData path) const {
+    auto it = _fields.find(path);
+    return it == _fields.end() ? nullptr : &it->second;
+}
+
+}  // namespace mongo
@@ -0,0 +1,148 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/query/interval.h"
+#include "mongo/util/string_map.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * Statistics about the values of a single field, computed from a sample of a collection's
+ * documents. Documents where the field is missing count as having a null value, as they do in an
+ * index.
+ *
+ * The statistics consist of an equi-depth histogram over all sampled values, the most common
+ * values with their frequencies, and an estimate of the number of distinct values in the whole
+ * collection.
+ */
+class FieldStatistics {
+public:
+    static constexpr size_t kMaxBuckets = 64;
+    static constexpr size_t kMaxCommonValues = 8;
+
+    /**
+     * Computes the statistics for 'values', the values of the field in 'numSampledDocs' sampled
+     * documents out of a collection of 'numRecords' documents. The statistics keep copies of the
+     * values they need, so 'values' only has to stay valid for the duration of the call.
+     */
+    static FieldStatistics make(std::vector<BSONElement> values,
+                                size_t numSampledDocs,
+                                long long numRecords);
+
+    /**
+     * Returns the estimated fraction of the collection's documents with a value in 'interval'.
+     * Can exceed 1 for array fields.
+     */
+    double estimateFraction(const Interval& interval) const;
+
+    /**
+     * Returns the estimated number of distinct values of the field in the collection.
+     */
+    double getDistinctValues() const {
+        return _distinctValues;
+    }
+
+private:
+    // Owns the histogram boundaries and the common values.
+    BSONObj _data;
+
+    // Boundaries of the equi-depth histogram: bucket 'i' holds the values between boundaries 'i'
+    // and 'i + 1', and every bucket holds '_valuesPerBucket' values on average.
+    std::vector<BSONElement> _boundaries;
+    double _valuesPerBucket = 0;
+
+    // The most common values, and the fraction of the documents holding each of them.
+    std::vector<std::pair<BSONElement, double>> _commonValues;
+
+    // The fraction of documents holding a value other than a common one, and an estimate of how
+    // many distinct such values there are.
+    double _otherValuesFraction = 0;
+    double _distinctOtherValues = 0;
+
+    double _distinctValues = 0;
+    size_t _numSampledDocs = 0;
+};
+
+/**
+ * A point-in-time set of statistics about a collection, used by the cost model to estimate the
+ * cost of query plans.
+ */
+class CollectionStatistics {
+public:
+    /**
+     * Accumulates sampled documents and computes statistics over the values of 'paths'.
+     */
+    class Builder {
+    public:
+        explicit Builder(std::vector<std::string> paths);
+
+        void addDocument(const BSONObj& doc);
+
+        std::shared_ptr<const CollectionStatistics> done(long long numRecords, Date_t now);
+
+    private:
+        std::vector<std::string> _paths;
+        std::vector<BSONArrayBuilder> _values;
+        size_t _numSampledDocs = 0;
+    };
+
+    /**
+     * Returns the statistics of 'path', or nullptr if it was not sampled.
+     */
+    const FieldStatistics* getFieldStatistics(StringData path) const;
+
+    long long getNumRecords() const {
+        return _numRecords;
+    }
+
+    size_t getNumSampledDocs() const {
+        return _numSampledDocs;
+    }
+
+    Date_t getTimeOfCreation() const {
+        return _timeOfCreation;
+    }
+
+private:
+    long long _numRecords = 0;
+    size_t _numSampledDocs = 0;
+    Date_t _timeOfCreation;
+
+    StringMap<FieldStatistics> _fields;
+};
+
+}  // namespace mongo
@@ -0,0 +1,163 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/cost_model.h"
+
+#include <algorithm>
+
+namespace mongo {
+namespace cost_model {
+namespace {
+boost::optional<CostEstimate> estimateIndexScan(const CollectionStatistics& stats,
+                                                const IndexScanNode& node) {
+    // Keys in indexes with a collation or on special index types do not compare like the sampled
+    // values, and simple range bounds carry no per-field intervals.
+    if (node.index.type != INDEX_BTREE || node.index.collator || node.bounds.isSimpleRange) {
+        return boost::none;
+    }
+
+    double fraction = 1.0;
+    for (auto&& oil : node.bounds.fields) {
+        if (oil.isMinToMax() || (oil.intervals.size() == 1 && oil.intervals[0].isMaxToMin())) {
+            continue;
+        }
+
+        auto fieldStats = stats.getFieldStatistics(oil.name);
+        if (!fieldStats) {
+            return boost::none;
+        }
+
+        double fieldFraction = 0;
+        for (auto&& interval : oil.intervals) {
+            fieldFraction += fieldStats->estimateFraction(interval);
+        }
+        fraction *= fieldFraction;
+    }
+
+    CostEstimate estimate;
+    estimate.numOutput = stats.getNumRecords() * fraction;
+    estimate.cost = estimate.numOutput * kReadCost;
+    return estimate;
+}
+}  // namespace
+
+boost::optional<CostEstimate> estimate(const CollectionStatistics& stats,
+                                       const QuerySolutionNode* root) {
+    switch (root->getType()) {
+        case STAGE_IXSCAN:
+            return estimateIndexScan(stats, *static_cast<const IndexScanNode*>(root));
+        case STAGE_COLLSCAN: {
+            CostEstimate estimate;
+            estimate.numOutput = stats.getNumRecords();
+            estimate.cost = estimate.numOutput * kReadCost;
+            return estimate;
+        }
+        default:
+            break;
+    }
+
+    // The estimate for any other stage is built from the estimates of its children. Leaf stages
+    // the statistics know nothing about make the whole estimate unknown.
+    if (root->children.empty()) {
+        return boost::none;
+    }
+
+    std::vector<CostEstimate> childEstimates;
+    for (auto&& child : root->children) {
+        auto childEstimate = estimate(stats, child);
+        if (!childEstimate) {
+            return boost::none;
+        }
+        childEstimates.push_back(*childEstimate);
+    }
+
+    CostEstimate result;
+    for (auto&& childEstimate : childEstimates) {
+        result.cost += childEstimate.cost;
+        result.numOutput += childEstimate.numOutput;
+    }
+
+    switch (root->getType()) {
+        case STAGE_FETCH:
+            result.cost += result.numOutput * kFetchCost;
+            break;
+        case STAGE_AND_HASH:
+        case STAGE_AND_SORTED:
+            // An intersection returns at most as many results as its most selective child.
+            result.numOutput = std::min_element(childEstimates.begin(),
+                                                childEstimates.end(),
+                                                [](const auto& lhs, const auto& rhs) {
+                                                    return lhs.numOutput < rhs.numOutput;
+                                                })
+                                   ->numOutput;
+            break;
+        default:
+            break;
+    }
+    return result;
+}
+
+size_t pruneCandidates(const CollectionStatistics& stats,
+                       double maxCostRatio,
+                       std::vector<std::unique_ptr<QuerySolution>>* solutions) {
+    std::vector<double> costs;
+    for (auto&& solution : *solutions) {
+        auto solutionEstimate = estimate(stats, solution->root());
+        if (!solutionEstimate) {
+            return 0;
+        }
+        costs.push_back(solutionEstimate->cost);
+    }
+
+    if (costs.empty()) {
+        return 0;
+    }
+
+    // Differences below what a single sampled document stands for are within the error of the
+    // estimates, so the cheapest cost is never taken to be lower than that.
+    const double resolution = kReadCost * stats.getNumRecords() /
+        std::max(stats.getNumSampledDocs(), static_cast<size_t>(1));
+    const double maxCost =
+        std::max(*std::min_element(costs.begin(), costs.end()), resolution) * maxCostRatio;
+    std::vector<std::unique_ptr<QuerySolution>> kept;
+    for (size_t i = 0; i < solutions->size(); ++i) {
+        if (costs[i] <= maxCost) {
+            kept.push_back(std::move((*solutions)[i]));
+        }
+    }
+
+    const size_t numPruned = solutions->size() - kept.size();
+    *solutions = std::move(kept);
+    return numPruned;
+}
+
+}  // namespace cost_model
+}  // namespace mongo
@@ -0,0 +1,74 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/query/collection_statistics.h"
+#include "mongo/db/query/query_solution.h"
+
+namespace mongo {
+namespace cost_model {
+
+/**
+ * The estimated cost of executing a query solution tree, in units of the work needed to read one
+ * index key, and the estimated number of results it produces.
+ */
+struct CostEstimate {
+    double cost = 0;
+    double numOutput = 0;
+};
+
+// The cost of reading an index key or a document in a collection scan, and of fetching the
+// document an index key points to.
+constexpr double kReadCost = 1.0;
+constexpr double kFetchCost = 3.0;
+
+/**
+ * Estimates the cost of the solution tree rooted at 'root' from the collection statistics 'stats'.
+ * Returns boost::none if the tree contains a stage or index bounds the statistics can say nothing
+ * about.
+ */
+boost::optional<CostEstimate> estimate(const CollectionStatistics& stats,
+                                       const QuerySolutionNode* root);
+
+/**
+ * Removes from 'solutions' the candidates whose estimated cost is more than 'maxCostRatio' times
+ * the estimated cost of the cheapest one. Leaves 'solutions' untouched if the cost of any of the
+ * candidates cannot be estimated. Returns the number of removed candidates.
+ */
+size_t pruneCandidates(const CollectionStatistics& stats,
+                       double maxCostRatio,
+                       std::vector<std::unique_ptr<QuerySolution>>* solutions);
+
+}  // namespace cost_model
+}  // namespace mongo
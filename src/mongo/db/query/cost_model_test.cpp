@@ -0,0 +1,178 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/cost_model.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/index_entry.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const long long kNumRecords = 100000;
+
+IndexEntry buildSimpleIndexEntry(const BSONObj& kp) {
+    return {kp,
+            IndexNames::nameToType(IndexNames::findPluginName(kp)),
+            false,
+            {},
+            {},
+            false,
+            false,
+            CoreIndexInfo::Identifier("test_foo"),
+            nullptr,
+            {},
+            nullptr,
+            nullptr};
+}
+
+/**
+ * Samples 1000 documents where 'a' is 0 in half of them and ranges over 1 to 500 in the others,
+ * and 'b' holds distinct values from 0 to 999.
+ */
+std::shared_ptr<const CollectionStatistics> makeStats() {
+    CollectionStatistics::Builder builder({"a", "b"});
+    for (int i = 0; i < 1000; ++i) {
+        builder.addDocument(BSON("a" << (i % 2 ? 0 : i / 2 + 1) << "b" << i));
+    }
+    return builder.done(kNumRecords, Date_t::now());
+}
+
+std::unique_ptr<QuerySolutionNode> makeIndexScan(const std::string& field,
+                                                 std::vector<Interval> intervals) {
+    auto ixscan = std::make_unique<IndexScanNode>(buildSimpleIndexEntry(BSON(field << 1)));
+    OrderedIntervalList oil(field);
+    oil.intervals = std::move(intervals);
+    ixscan->bounds.fields.push_back(std::move(oil));
+    return ixscan;
+}
+
+std::unique_ptr<QuerySolution> makeSolution(std::unique_ptr<QuerySolutionNode> root) {
+    auto solution = std::make_unique<QuerySolution>();
+    solution->setRoot(std::move(root));
+    return solution;
+}
+
+TEST(FieldStatisticsTest, CommonValueEstimateIsItsFrequency) {
+    auto stats = makeStats();
+    auto aStats = stats->getFieldStatistics("a");
+    ASSERT(aStats);
+    ASSERT_APPROX_EQUAL(
+        aStats->estimateFraction(IndexBoundsBuilder::makePointInterval(BSON("" << 0))), 0.5, 0.01);
+}
+
+TEST(FieldStatisticsTest, RareValueEstimateIsSmall) {
+    auto stats = makeStats();
+    auto aStats = stats->getFieldStatistics("a");
+    ASSERT(aStats);
+    ASSERT_LT(aStats->estimateFraction(IndexBoundsBuilder::makePointInterval(BSON("" << 7))),
+              0.01);
+    ASSERT_LTE(aStats->estimateFraction(IndexBoundsBuilder::makePointInterval(BSON("" << 9999))),
+               1.0 / stats->getNumSampledDocs());
+}
+
+TEST(FieldStatisticsTest, RangeEstimateFollowsHistogram) {
+    auto stats = makeStats();
+    auto bStats = stats->getFieldStatistics("b");
+    ASSERT(bStats);
+    const auto range = [](int start, int end) {
+        return IndexBoundsBuilder::makeRangeInterval(BSON("" << start << "" << end),
+                                                     BoundInclusion::kIncludeBothStartAndEndKeys);
+    };
+    ASSERT_APPROX_EQUAL(bStats->estimateFraction(range(0, 500)), 0.5, 0.05);
+    ASSERT_APPROX_EQUAL(bStats->estimateFraction(range(500, 0)), 0.5, 0.05);
+    ASSERT_EQ(bStats->estimateFraction(range(2000, 3000)), 0.0);
+}
+
+TEST(FieldStatisticsTest, DistinctValuesAreExtrapolatedFromValuesSeenOnce) {
+    auto stats = makeStats();
+    // Every value of 'b' was seen once, so the collection is assumed to hold many more.
+    ASSERT_GT(stats->getFieldStatistics("b")->getDistinctValues(), 1000);
+    ASSERT_LTE(stats->getFieldStatistics("b")->getDistinctValues(), kNumRecords);
+}
+
+TEST(CollectionStatisticsTest, MissingFieldsCountAsNull) {
+    CollectionStatistics::Builder builder({"a"});
+    for (int i = 0; i < 10; ++i) {
+        builder.addDocument(i < 5 ? BSON("a" << i) : BSON("b" << i));
+    }
+    auto stats = builder.done(10, Date_t::now());
+    ASSERT_FALSE(stats->getFieldStatistics("b"));
+    ASSERT_APPROX_EQUAL(stats->getFieldStatistics("a")->estimateFraction(
+                            IndexBoundsBuilder::makePointInterval(BSON("" << BSONNULL))),
+                        0.5,
+                        0.01);
+}
+
+TEST(CostModelTest, SelectiveIndexScanIsCheaperThanCollectionScan) {
+    auto stats = makeStats();
+    auto ixscan = makeIndexScan("b", {IndexBoundsBuilder::makePointInterval(BSON("" << 5))});
+    auto fetch = std::make_unique<FetchNode>();
+    fetch->children.push_back(ixscan.release());
+
+    auto ixscanEstimate = cost_model::estimate(*stats, fetch.get());
+    ASSERT(ixscanEstimate);
+    CollectionScanNode collscan;
+    auto collscanEstimate = cost_model::estimate(*stats, &collscan);
+    ASSERT(collscanEstimate);
+    ASSERT_LT(ixscanEstimate->cost * 100, collscanEstimate->cost);
+}
+
+TEST(CostModelTest, PruneDropsMuchMoreExpensiveCandidates) {
+    auto stats = makeStats();
+    std::vector<std::unique_ptr<QuerySolution>> solutions;
+    solutions.push_back(
+        makeSolution(makeIndexScan("b", {IndexBoundsBuilder::makePointInterval(BSON("" << 5))})));
+    solutions.push_back(makeSolution(std::make_unique<CollectionScanNode>()));
+
+    ASSERT_EQ(cost_model::pruneCandidates(*stats, 10.0, &solutions), 1U);
+    ASSERT_EQ(solutions.size(), 1U);
+    ASSERT_EQ(solutions[0]->root()->getType(), STAGE_IXSCAN);
+}
+
+TEST(CostModelTest, PruneKeepsAllCandidatesWhenAnEstimateIsUnknown) {
+    auto stats = makeStats();
+    std::vector<std::unique_ptr<QuerySolution>> solutions;
+    solutions.push_back(
+        makeSolution(makeIndexScan("b", {IndexBoundsBuilder::makePointInterval(BSON("" << 5))})));
+    solutions.push_back(makeSolution(std::make_unique<CollectionScanNode>()));
+    // There are no statistics about 'c'.
+    solutions.push_back(
+        makeSolution(makeIndexScan("c", {IndexBoundsBuilder::makePointInterval(BSON("" << 5))})));
+
+    ASSERT_EQ(cost_model::pruneCandidates(*stats, 10.0, &solutions), 0U);
+    ASSERT_EQ(solutions.size(), 3U);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -67,6 +67,7 @@
 #include "mongo/db/query/canonical_query_encoder.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/collection_query_info.h"
+#include "mongo/db/query/cost_model.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/internal_plans.h"
@@ -325,6 +326,10 @@ void fillOutPlannerParams(OperationContext* opCtx,
         plannerParams->options |= QueryPlannerParams::GENERATE_COVERED_IXSCANS;
     }
 
+    if (internalQueryPlannerGenerateSkipScans.load()) {
+        plannerParams->options |= QueryPlannerParams::GENERATE_SKIP_SCANS;
+    }
+
     plannerParams->options |= QueryPlannerParams::SPLIT_LIMITED_SORT;
 
     if (shouldWaitForOplogVisibility(
@@ -584,9 +589,11 @@ public:
                 canonical_query_encoder::computeHash(planCacheKey.toString());
 
             // Try to look up a cached solution for the query.
-            if (auto cs = CollectionQueryInfo::get(_collection)
-                              .getPlanCache()
-                              ->getCacheEntryIfActive(planCacheKey)) {
+            if (auto cs = (plannerParams.options & QueryPlannerParams::NO_BLOCKING_SORT)
+                    ? nullptr
+                    : CollectionQueryInfo::get(_collection)
+                          .getPlanCache()
+                          ->getCacheEntryIfActive(planCacheKey)) {
                 // We have a CachedSolution.  Have the planner turn it into a QuerySolution.
                 auto statusWithQs = QueryPlanner::planFromCache(*_cq, plannerParams, *cs);
 
@@ -608,6 +615,7 @@ public:
 
 
         if (internalQueryPlanOrChildrenIndependently.load() &&
+            !(plannerParams.options & QueryPlannerParams::NO_BLOCKING_SORT) &&
             SubplanStage::canUseSubplanning(*_cq)) {
             LOGV2_DEBUG(20924,
                         2,
@@ -644,6 +652,10 @@ public:
             }
         }
 
+        if (solutions.size() > 1 && internalQueryPlannerEnableCostBasedPruning.load()) {
+            pruneCandidates(&solutions);
+        }
+
         if (1 == solutions.size()) {
             auto result = makeResult();
             // Only one possible plan. Run it. Build the stages from the solution.
@@ -663,6 +675,36 @@ public:
     }
 
 protected:
+    /**
+     * Drops the candidate 'solutions' that the cost model estimates to be much more expensive than
+     * the cheapest one, so that the multi-planner does not have to run them. Queries with a sort or
+     * a limit are left alone: a plan that provides the sort or stops early can be much cheaper than
+     * the cost of reading all the data it could read.
+     */
+    void pruneCandidates(std::vector<std::unique_ptr<QuerySolution>>* solutions) const {
+        const auto& qr = _cq->getQueryRequest();
+        if (!qr.getSort().isEmpty() || qr.getLimit() || qr.getNToReturn()) {
+            return;
+        }
+
+        auto stats =
+            CollectionQueryInfo::get(_collection).getCollectionStatistics(_opCtx, _collection);
+        if (!stats) {
+            return;
+        }
+
+        const auto numPruned = cost_model::pruneCandidates(
+            *stats, internalQueryPlannerCostPruningRatio.load(), solutions);
+        if (numPruned > 0) {
+            LOGV2_DEBUG(5121506,
+                        2,
+                        "Pruned candidate plans by estimated cost",
+                        "query"_attr = redact(_cq->toStringShort()),
+                        "numPruned"_attr = numPruned,
+                        "numRemaining"_attr = solutions->size());
+        }
+    }
+
     /**
      * Creates a result instance to be returned to the caller holding the result of the
      * prepare() call.
@@ -216,8 +216,13 @@ std::unique_ptr<PlanCacheEntry> PlanCacheEntry::create(
     std::vector<std::unique_ptr<const SolutionCacheData>> solutionCacheData(solutions.size());
     for (size_t i = 0; i < solutions.size(); ++i) {
         invariant(solutions[i]->cacheData.get());
-        solutionCacheData[i] =
-            std::unique_ptr<const SolutionCacheData>(solutions[i]->cacheData->clone());
+        std::unique_ptr<SolutionCacheData> cacheData(solutions[i]->cacheData->clone());
+
+        // Only the winning solution is ever used to answer queries from the cache.
+        if (i == 0 && cacheData->solnType == SolutionCacheData::USE_INDEX_TAGS_SOLN) {
+            cacheData->parameterizedSolution = ParameterizedSolution::make(query, *solutions[0]);
+        }
+        solutionCacheData[i] = std::move(cacheData);
     }
 
     // Strip projections on $-prefixed fields, as these are added by internal callers of the
@@ -385,6 +390,162 @@ std::string PlanCacheIndexTree::toString(int indents) const {
     return result.str();
 }
 
+//
+// ParameterizedSolution
+//
+
+namespace {
+bool isParameterizableComparison(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+        case MatchExpression::MATCH_IN:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Returns the index scan at the bottom of 'node' if the plan is an unfiltered index scan, possibly
+ * under an unfiltered fetch and a shard filter, and nullptr otherwise.
+ */
+const IndexScanNode* getParameterizableIndexScan(const QuerySolutionNode* node) {
+    while (node) {
+        if (node->filter) {
+            return nullptr;
+        }
+
+        switch (node->getType()) {
+            case STAGE_IXSCAN:
+                return static_cast<const IndexScanNode*>(node);
+            case STAGE_FETCH:
+            case STAGE_SHARDING_FILTER:
+                if (node->children.size() != 1) {
+                    return nullptr;
+                }
+                node = node->children[0];
+                break;
+            default:
+                return nullptr;
+        }
+    }
+    return nullptr;
+}
+
+uint64_t estimateSolutionNodeSizeInBytes(const QuerySolutionNode* node) {
+    uint64_t size = 0;
+    switch (node->getType()) {
+        case STAGE_IXSCAN: {
+            const auto ixscan = static_cast<const IndexScanNode*>(node);
+            size += sizeof(IndexScanNode) + ixscan->index.estimateObjectSizeInBytes() -
+                sizeof(ixscan->index);
+            for (auto&& oil : ixscan->bounds.fields) {
+                size += oil.name.capacity();
+                for (auto&& interval : oil.intervals) {
+                    size += sizeof(interval) + interval._intervalData.objsize();
+                }
+            }
+            break;
+        }
+        case STAGE_FETCH:
+            size += sizeof(FetchNode);
+            break;
+        default:
+            size += sizeof(ShardingFilterNode);
+            break;
+    }
+
+    for (auto&& child : node->children) {
+        size += estimateSolutionNodeSizeInBytes(child);
+    }
+    return size;
+}
+}  // namespace
+
+ParameterizedSolution::~ParameterizedSolution() = default;
+
+std::unique_ptr<ParameterizedSolution> ParameterizedSolution::make(const CanonicalQuery& query,
+                                                                   const QuerySolution& soln) {
+    if (!internalQueryCacheReuseParameterizedSolutions.load() || !isParameterizableQuery(query)) {
+        return nullptr;
+    }
+
+    std::vector<const MatchExpression*> comparisons;
+    if (!collectParameters(query.root(), &comparisons)) {
+        return nullptr;
+    }
+
+    const auto ixscan = getParameterizableIndexScan(soln.root());
+    if (!ixscan || ixscan->addKeyMetadata) {
+        return nullptr;
+    }
+
+    // With no filters left in the plan, every comparison was turned into exact bounds on the index.
+    // Rebuilding those bounds for other literals is only that simple for plain btree indexes.
+    const auto& index = ixscan->index;
+    if (index.type != INDEX_BTREE || index.multikey || index.sparse || index.filterExpr ||
+        !CollatorInterface::collatorsMatch(query.getCollator(), index.collator)) {
+        return nullptr;
+    }
+
+    auto parameterized = std::make_unique<ParameterizedSolution>();
+    for (auto&& comparison : comparisons) {
+        if (!index.keyPattern.hasField(comparison->path())) {
+            return nullptr;
+        }
+        parameterized->parameters.push_back(
+            {comparison->matchType(), comparison->path().toString()});
+    }
+    parameterized->root.reset(soln.root()->clone());
+    return parameterized;
+}
+
+bool ParameterizedSolution::isParameterizableQuery(const CanonicalQuery& query) {
+    const auto& qr = query.getQueryRequest();
+    return !query.getProj() && qr.getSort().isEmpty() && !qr.getSkip() && !qr.getLimit() &&
+        !qr.getNToReturn() && qr.getMin().isEmpty() && qr.getMax().isEmpty() &&
+        !qr.returnKey() && !qr.showRecordId() && !qr.isTailable();
+}
+
+bool ParameterizedSolution::collectParameters(const MatchExpression* root,
+                                              std::vector<const MatchExpression*>* out) {
+    if (root->matchType() != MatchExpression::AND) {
+        if (!isParameterizableComparison(root)) {
+            return false;
+        }
+        out->push_back(root);
+        return true;
+    }
+
+    for (size_t i = 0; i < root->numChildren(); ++i) {
+        const auto child = root->getChild(i);
+        if (!isParameterizableComparison(child)) {
+            return false;
+        }
+        out->push_back(child);
+    }
+    return !out->empty();
+}
+
+ParameterizedSolution* ParameterizedSolution::clone() const {
+    auto other = new ParameterizedSolution();
+    other->parameters = parameters;
+    other->root.reset(root->clone());
+    return other;
+}
+
+uint64_t ParameterizedSolution::estimateObjectSizeInBytes() const {
+    return container_size_helper::estimateObjectSizeInBytes(
+               parameters,
+               [](const auto& parameter) { return parameter.path.capacity(); },
+               true) +
+        estimateSolutionNodeSizeInBytes(root.get()) + sizeof(*this);
+}
+
 //
 // SolutionCacheData
 //
@@ -399,6 +560,9 @@ SolutionCacheData* SolutionCacheData::clone() const {
     other->solnType = this->solnType;
     other->wholeIXSolnDir = this->wholeIXSolnDir;
     other->indexFilterApplied = this->indexFilterApplied;
+    if (this->parameterizedSolution) {
+        other->parameterizedSolution.reset(this->parameterizedSolution->clone());
+    }
     return other;
 }
 
@@ -415,6 +579,10 @@ std::string SolutionCacheData::toString() const {
             verify(this->tree.get());
             return str::stream() << "(index-tagged expression tree: "
                                  << "tree=" << this->tree->toString() << ")";
+        case SKIP_SCAN_SOLN:
+            verify(this->tree.get());
+            return str::stream() << "(skip scan solution: "
+                                 << "tree=" << this->tree->toString() << ")";
     }
     MONGO_UNREACHABLE;
 }
@@ -423,12 +591,38 @@ std::string SolutionCacheData::toString() const {
 // PlanCache
 //
 
-PlanCache::PlanCache() : PlanCache(internalQueryCacheSize.load()) {}
+namespace {
+// Caches are only partitioned while every partition still gets a useful share of the entry budget,
+// so that small caches keep close to least recently used eviction.
+constexpr size_t kMaxPartitions = 16;
+constexpr size_t kMinEntriesPerPartition = 64;
+}  // namespace
+
+PlanCache::PlanCache()
+    : PlanCache(internalQueryCacheSize.load(),
+                static_cast<size_t>(internalQueryCacheMaxSizeBytesPerCollection.load())) {}
+
+PlanCache::PlanCache(size_t size, size_t maxSizeBytes) {
+    const size_t numPartitions =
+        std::max<size_t>(1, std::min(kMaxPartitions, size / kMinEntriesPerPartition));
 
-PlanCache::PlanCache(size_t size) : _cache(size) {}
+    // Round the per-partition entry budget up so that the partitions can hold 'size' entries in
+    // total.
+    const size_t entriesPerPartition = (size + numPartitions - 1) / numPartitions;
+    const size_t bytesPerPartition = maxSizeBytes / numPartitions;
+
+    _partitions.reserve(numPartitions);
+    for (size_t i = 0; i < numPartitions; ++i) {
+        _partitions.push_back(std::make_unique<Partition>(entriesPerPartition, bytesPerPartition));
+    }
+}
 
 PlanCache::~PlanCache() {}
 
+PlanCache::Partition& PlanCache::_getPartition(const PlanCacheKey& key) const {
+    return *_partitions[PlanCacheKeyHasher{}(key) % _partitions.size()];
+}
+
 std::unique_ptr<CachedSolution> PlanCache::getCacheEntryIfActive(const PlanCacheKey& key) const {
 
     PlanCache::GetResult res = get(key);
@@ -577,7 +771,8 @@ Status PlanCache::set(const CanonicalQuery& query,
                                  }},
         why->stats);
     const auto key = computeKey(query);
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
+    auto& partition = _getPartition(key);
+    stdx::lock_guard<Latch> cacheLock(partition.mutex);
     bool isNewEntryActive = false;
     uint32_t queryHash;
     uint32_t planCacheKey;
@@ -588,7 +783,7 @@ Status PlanCache::set(const CanonicalQuery& query,
         queryHash = canonical_query_encoder::computeHash(key.getStableKeyStringData());
     } else {
         PlanCacheEntry* oldEntry = nullptr;
-        Status cacheStatus = _cache.get(key, &oldEntry);
+        Status cacheStatus = partition.cache.get(key, &oldEntry);
         invariant(cacheStatus.isOK() || cacheStatus == ErrorCodes::NoSuchKey);
         if (oldEntry) {
             queryHash = oldEntry->queryHash;
@@ -615,9 +810,10 @@ Status PlanCache::set(const CanonicalQuery& query,
     auto newEntry(PlanCacheEntry::create(
         solns, std::move(why), query, queryHash, planCacheKey, now, isNewEntryActive, newWorks));
 
-    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(key, newEntry.release());
+    const auto newEntrySize = newEntry->estimatedEntrySizeBytes();
+    auto evictedEntries = partition.cache.add(key, std::move(newEntry), newEntrySize);
 
-    if (nullptr != evictedEntry.get()) {
+    for (auto&& evictedEntry : evictedEntries) {
         LOGV2_DEBUG(20942,
                     1,
                     "Plan cache maximum size exceeded - removed least recently used entry",
@@ -635,9 +831,10 @@ void PlanCache::deactivate(const CanonicalQuery& query) {
     }
 
     PlanCacheKey key = computeKey(query);
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
+    auto& partition = _getPartition(key);
+    stdx::lock_guard<Latch> cacheLock(partition.mutex);
     PlanCacheEntry* entry = nullptr;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = partition.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         invariant(cacheStatus == ErrorCodes::NoSuchKey);
         return;
@@ -652,9 +849,10 @@ PlanCache::GetResult PlanCache::get(const CanonicalQuery& query) const {
 }
 
 PlanCache::GetResult PlanCache::get(const PlanCacheKey& key) const {
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
+    auto& partition = _getPartition(key);
+    stdx::lock_guard<Latch> cacheLock(partition.mutex);
     PlanCacheEntry* entry = nullptr;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = partition.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         invariant(cacheStatus == ErrorCodes::NoSuchKey);
         return {CacheEntryState::kNotPresent, nullptr};
@@ -667,13 +865,17 @@ PlanCache::GetResult PlanCache::get(const PlanCacheKey& key) const {
 }
 
 Status PlanCache::remove(const CanonicalQuery& canonicalQuery) {
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
-    return _cache.remove(computeKey(canonicalQuery));
+    const auto key = computeKey(canonicalQuery);
+    auto& partition = _getPartition(key);
+    stdx::lock_guard<Latch> cacheLock(partition.mutex);
+    return partition.cache.remove(key);
 }
 
 void PlanCache::clear() {
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
-    _cache.clear();
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<Latch> cacheLock(partition->mutex);
+        partition->cache.clear();
+    }
 }
 
 PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
@@ -687,9 +889,10 @@ PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
 StatusWith<std::unique_ptr<PlanCacheEntry>> PlanCache::getEntry(const CanonicalQuery& query) const {
     PlanCacheKey key = computeKey(query);
 
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
+    auto& partition = _getPartition(key);
+    stdx::lock_guard<Latch> cacheLock(partition.mutex);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = partition.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
@@ -699,20 +902,25 @@ StatusWith<std::unique_ptr<PlanCacheEntry>> PlanCache::getEntry(const CanonicalQ
 }
 
 std::vector<std::unique_ptr<PlanCacheEntry>> PlanCache::getAllEntries() const {
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
     std::vector<std::unique_ptr<PlanCacheEntry>> entries;
 
-    for (auto&& cacheEntry : _cache) {
-        auto entry = cacheEntry.second;
-        entries.push_back(std::unique_ptr<PlanCacheEntry>(entry->clone()));
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<Latch> cacheLock(partition->mutex);
+        for (auto&& slot : partition->cache) {
+            entries.push_back(slot.value->clone());
+        }
     }
 
     return entries;
 }
 
 size_t PlanCache::size() const {
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
-    return _cache.size();
+    size_t total = 0;
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<Latch> cacheLock(partition->mutex);
+        total += partition->cache.size();
+    }
+    return total;
 }
 
 void PlanCache::notifyOfIndexUpdates(const std::vector<CoreIndexInfo>& indexCores) {
@@ -723,13 +931,14 @@ std::vector<BSONObj> PlanCache::getMatchingStats(
     const std::function<BSONObj(const PlanCacheEntry&)>& serializationFunc,
     const std::function<bool(const BSONObj&)>& filterFunc) const {
     std::vector<BSONObj> results;
-    stdx::lock_guard<Latch> cacheLock(_cacheMutex);
 
-    for (auto&& cacheEntry : _cache) {
-        const auto entry = cacheEntry.second;
-        auto serializedEntry = serializationFunc(*entry);
-        if (filterFunc(serializedEntry)) {
-            results.push_back(serializedEntry);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<Latch> cacheLock(partition->mutex);
+        for (auto&& slot : partition->cache) {
+            auto serializedEntry = serializationFunc(*slot.value);
+            if (filterFunc(serializedEntry)) {
+                results.push_back(serializedEntry);
+            }
         }
     }
 
@@ -30,12 +30,13 @@
 #pragma once
 
 #include <boost/optional/optional.hpp>
+#include <limits>
 #include <set>
 
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/clock_key_value.h"
 #include "mongo/db/query/index_tag.h"
-#include "mongo/db/query/lru_key_value.h"
 #include "mongo/db/query/plan_cache_indexability.h"
 #include "mongo/db/query/query_planner_params.h"
 #include "mongo/platform/atomic_word.h"
@@ -212,6 +213,59 @@ struct PlanCacheIndexTree {
     std::vector<OrPushdown> orPushdowns;
 };
 
+/**
+ * A copy of a cached winning plan that can be reused as-is for any query of the same shape, by
+ * rebuilding its index bounds from the literals in that query. This lets repeated point and range
+ * queries skip tagging, index selection and access planning entirely.
+ *
+ * Only plans consisting of a single, unfiltered index scan (optionally fetched and shard filtered)
+ * are parameterized, for queries that are a conjunction of simple comparisons on indexed fields and
+ * have no projection, sort, skip or limit.
+ */
+struct ParameterizedSolution {
+    /**
+     * A parameter marker: the kind and field of one comparison in the canonical match expression.
+     * Queries with the same shape have the same parameters in the same order, only their literals
+     * differ.
+     */
+    struct Parameter {
+        MatchExpression::MatchType matchType;
+        std::string path;
+    };
+
+    ParameterizedSolution() = default;
+    ~ParameterizedSolution();
+
+    /**
+     * Returns a parameterized copy of 'soln', the winning plan for 'query', or nullptr if its
+     * bounds cannot be rebuilt from the literals of another query alone.
+     */
+    static std::unique_ptr<ParameterizedSolution> make(const CanonicalQuery& query,
+                                                       const QuerySolution& soln);
+
+    /**
+     * Returns true if nothing but the filter of 'query' affects the shape of its plan.
+     */
+    static bool isParameterizableQuery(const CanonicalQuery& query);
+
+    /**
+     * Appends the comparisons of 'root' to 'out' in canonical order. Returns false if 'root' is not
+     * a single comparison or a conjunction of comparisons.
+     */
+    static bool collectParameters(const MatchExpression* root,
+                                  std::vector<const MatchExpression*>* out);
+
+    // Make a deep copy.
+    ParameterizedSolution* clone() const;
+
+    uint64_t estimateObjectSizeInBytes() const;
+
+    std::vector<Parameter> parameters;
+
+    // The winning plan. The bounds of its index scan are those of the query it was cached for.
+    std::unique_ptr<QuerySolutionNode> root;
+};
+
 /**
  * Data stored inside a QuerySolution which can subsequently be
  * used to create a cache entry. When this data is retrieved
@@ -232,7 +286,9 @@ struct SolutionCacheData {
     std::string toString() const;
 
     uint64_t estimateObjectSizeInBytes() const {
-        return (tree ? tree->estimateObjectSizeInBytes() : 0) + sizeof(*this);
+        return (tree ? tree->estimateObjectSizeInBytes() : 0) +
+            (parameterizedSolution ? parameterizedSolution->estimateObjectSizeInBytes() : 0) +
+            sizeof(*this);
     }
 
     // Owned here. If 'wholeIXSoln' is false, then 'tree'
@@ -252,7 +308,11 @@ struct SolutionCacheData {
 
         // Build the solution by using 'tree'
         // to tag the match expression.
-        USE_INDEX_TAGS_SOLN
+        USE_INDEX_TAGS_SOLN,
+
+        // The cached plan is a skip scan over
+        // the index stored in 'tree'.
+        SKIP_SCAN_SOLN
     } solnType;
 
     // The direction of the index scan used as
@@ -262,6 +322,10 @@ struct SolutionCacheData {
 
     // True if index filter was applied.
     bool indexFilterApplied;
+
+    // Set for the winning solution of a cache entry if it can be reused for other queries of the
+    // same shape by rebinding its parameters. May be null.
+    std::unique_ptr<ParameterizedSolution> parameterizedSolution;
 };
 
 class PlanCacheEntry;
@@ -380,6 +444,14 @@ public:
      */
     inline static Counter64 planCacheTotalSizeEstimateBytes;
 
+    /**
+     * Returns the estimated deep size of this entry, which is what the entry is charged against
+     * the plan cache's memory budget.
+     */
+    uint64_t estimatedEntrySizeBytes() const {
+        return _entireObjectSize;
+    }
+
 private:
     /**
      * All arguments constructor.
@@ -411,6 +483,16 @@ private:
  * Caches the best solution to a query.  Aside from the (CanonicalQuery -> QuerySolution)
  * mapping, the cache contains information on why that mapping was made and statistics on the
  * cache entry's actual performance on subsequent runs.
+ *
+ * The entries are spread over a number of partitions by the hash of their PlanCacheKey, each with
+ * its own latch, so that queries of different shapes do not contend with each other. Within a
+ * partition entries are evicted in approximately least recently used order (CLOCK), which lets
+ * lookups avoid reordering anything. Each partition gets an equal share of the cache's entry and
+ * memory budgets.
+ *
+ * Eviction order differs from exact LRU: any entry looked up since the clock hand last passed it
+ * is spared once, however long ago that lookup was, and the victim is the first entry after the
+ * hand that has not been looked up since. See ClockKeyValue.
  */
 class PlanCache {
 private:
@@ -457,7 +539,11 @@ public:
      */
     PlanCache();
 
-    PlanCache(size_t size);
+    /**
+     * Creates a cache holding at most 'size' entries whose estimated sizes add up to at most
+     * 'maxSizeBytes'.
+     */
+    PlanCache(size_t size, size_t maxSizeBytes = std::numeric_limits<size_t>::max());
 
     ~PlanCache();
 
@@ -582,10 +668,17 @@ private:
                                    size_t newWorks,
                                    double growthCoefficient);
 
-    LRUKeyValue<PlanCacheKey, PlanCacheEntry, PlanCacheKeyHasher> _cache;
+    struct Partition {
+        Partition(size_t maxEntries, size_t maxSizeBytes) : cache(maxEntries, maxSizeBytes) {}
+
+        // Protects 'cache'.
+        mutable Mutex mutex = MONGO_MAKE_LATCH("PlanCache::Partition::mutex");
+        ClockKeyValue<PlanCacheKey, PlanCacheEntry, PlanCacheKeyHasher> cache;
+    };
+
+    Partition& _getPartition(const PlanCacheKey& key) const;
 
-    // Protects _cache.
-    mutable Mutex _cacheMutex = MONGO_MAKE_LATCH("PlanCache::_cacheMutex");
+    std::vector<std::unique_ptr<Partition>> _partitions;
 
     // Holds computed information about the collection's indexes.  Used for generating plan
     // cache keys.
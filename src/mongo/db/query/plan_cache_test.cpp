@@ -538,8 +538,8 @@ TEST(PlanCacheTest, InactiveEntriesDisabled) {
 }
 
 
-TEST(PlanCacheTest, PlanCacheLRUPolicyRemovesInactiveEntries) {
-    // Use a tiny cache size.
+TEST(PlanCacheTest, PlanCacheClockPolicyRemovesInactiveEntries) {
+    // Use a tiny cache size, which also keeps all the entries in a single partition.
     const size_t kCacheSize = 2;
     PlanCache planCache(kCacheSize);
     QueryTestServiceContext serviceContext;
@@ -548,28 +548,72 @@ TEST(PlanCacheTest, PlanCacheLRUPolicyRemovesInactiveEntries) {
     ASSERT_EQ(planCache.get(*cqA).state, PlanCache::CacheEntryState::kNotPresent);
     addCacheEntryForShape(*cqA.get(), &planCache);
 
-    // After add, the planCache should have an inactive entry.
+    // After add, the planCache should have an inactive entry. The lookup also sets the reference
+    // bit of the {a: 1} entry.
     ASSERT_EQ(planCache.get(*cqA).state, PlanCache::CacheEntryState::kPresentInactive);
 
-    // Add a cache entry for another shape.
+    // Add a cache entry for another shape, without looking it up. Its reference bit stays clear.
+    // Note that under CLOCK a lookup of {b: 1} here would protect it just as much as the lookup of
+    // {a: 1} above, regardless of which of the two was more recent.
     unique_ptr<CanonicalQuery> cqB(canonicalize("{b: 1}"));
     ASSERT_EQ(planCache.get(*cqB).state, PlanCache::CacheEntryState::kNotPresent);
     addCacheEntryForShape(*cqB.get(), &planCache);
-    ASSERT_EQ(planCache.get(*cqB).state, PlanCache::CacheEntryState::kPresentInactive);
-
-    // Access the cached solution for the {a: 1} shape. Now the entry for {b: 1} will be the least
-    // recently used.
-    ASSERT_EQ(planCache.get(*cqA).state, PlanCache::CacheEntryState::kPresentInactive);
 
-    // Insert another entry. Since the cache size is 2, we expect the {b: 1} entry to be ejected.
+    // Insert another entry. Since the cache size is 2, one entry must go: the clock hand clears the
+    // bit of the {a: 1} entry and evicts the unreferenced {b: 1} entry.
     unique_ptr<CanonicalQuery> cqC(canonicalize("{c: 1}"));
     ASSERT_EQ(planCache.get(*cqC).state, PlanCache::CacheEntryState::kNotPresent);
     addCacheEntryForShape(*cqC.get(), &planCache);
-
-    // Check that {b: 1} is gone, but {a: 1} and {c: 1} both still have entries.
     ASSERT_EQ(planCache.get(*cqB).state, PlanCache::CacheEntryState::kNotPresent);
-    ASSERT_EQ(planCache.get(*cqA).state, PlanCache::CacheEntryState::kPresentInactive);
+    ASSERT_EQ(planCache.size(), 2U);
+
+    // Only look up {c: 1}. The {a: 1} entry lost its reference bit to the last sweep, so it is the
+    // one evicted to make room for {d: 1}.
     ASSERT_EQ(planCache.get(*cqC).state, PlanCache::CacheEntryState::kPresentInactive);
+    unique_ptr<CanonicalQuery> cqD(canonicalize("{d: 1}"));
+    addCacheEntryForShape(*cqD.get(), &planCache);
+
+    ASSERT_EQ(planCache.get(*cqA).state, PlanCache::CacheEntryState::kNotPresent);
+    ASSERT_EQ(planCache.get(*cqC).state, PlanCache::CacheEntryState::kPresentInactive);
+    ASSERT_EQ(planCache.get(*cqD).state, PlanCache::CacheEntryState::kPresentInactive);
+}
+
+TEST(PlanCacheTest, PlanCacheMemoryBudgetIsEnforced) {
+    QueryTestServiceContext serviceContext;
+    unique_ptr<CanonicalQuery> cqA(canonicalize("{a: 1}"));
+
+    // An entry that does not fit in the memory budget is never cached.
+    PlanCache tinyCache(5000, 1);
+    addCacheEntryForShape(*cqA.get(), &tinyCache);
+    ASSERT_EQ(tinyCache.size(), 0U);
+    ASSERT_EQ(tinyCache.get(*cqA).state, PlanCache::CacheEntryState::kNotPresent);
+
+    PlanCache planCache;
+    addCacheEntryForShape(*cqA.get(), &planCache);
+    auto entry = unittest::assertGet(planCache.getEntry(*cqA));
+    ASSERT_GT(entry->estimatedEntrySizeBytes(), 1U);
+}
+
+TEST(PlanCacheTest, PartitionedPlanCacheHoldsAllShapes) {
+    QueryTestServiceContext serviceContext;
+    PlanCache planCache(5000);
+
+    // Enough shapes that they are spread over several partitions.
+    const std::vector<std::string> fields = {"a", "b", "c", "d", "e", "f", "g", "h"};
+    std::vector<unique_ptr<CanonicalQuery>> queries;
+    for (auto&& field : fields) {
+        queries.push_back(canonicalize(BSON(field << 1)));
+        addCacheEntryForShape(*queries.back(), &planCache);
+    }
+
+    ASSERT_EQ(planCache.size(), fields.size());
+    ASSERT_EQ(planCache.getAllEntries().size(), fields.size());
+    for (auto&& cq : queries) {
+        ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentInactive);
+    }
+
+    planCache.clear();
+    ASSERT_EQ(planCache.size(), 0U);
 }
 
 TEST(PlanCacheTest, PlanCacheRemoveDeletesInactiveEntries) {
@@ -1145,6 +1189,31 @@ protected:
         return std::move(statusWithQs.getValue());
     }
 
+    /**
+     * Caches 'soln', the winning plan for 'cachedQuery', and plans 'query' from that cache entry.
+     * Sets 'isParameterized' to whether the entry holds a parameterized solution.
+     */
+    std::unique_ptr<QuerySolution> planQueryFromParameterizedCache(const BSONObj& cachedQuery,
+                                                                   const BSONObj& query,
+                                                                   const QuerySolution& soln,
+                                                                   bool* isParameterized) const {
+        QueryTestServiceContext serviceContext;
+        unique_ptr<CanonicalQuery> cachedCq(canonicalize(cachedQuery));
+        unique_ptr<CanonicalQuery> cq(canonicalize(query));
+
+        // Unlike planQueryFromCache(), cache the whole solution so that it can be parameterized.
+        std::vector<QuerySolution*> solutions = {const_cast<QuerySolution*>(&soln)};
+        uint32_t queryHash = canonical_query_encoder::computeHash(ck.stringData());
+        auto entry = PlanCacheEntry::create(
+            solutions, createDecision(1U), *cachedCq, queryHash, queryHash, Date_t(), false, 0);
+        *isParameterized = static_cast<bool>(entry->plannerData[0]->parameterizedSolution);
+        CachedSolution cachedSoln(ck, *entry);
+
+        auto statusWithQs = QueryPlanner::planFromCache(*cq, params, cachedSoln);
+        ASSERT_OK(statusWithQs.getStatus());
+        return std::move(statusWithQs.getValue());
+    }
+
     /**
      * @param solnJson -- a json representation of a query solution.
      *
@@ -1254,6 +1323,62 @@ TEST_F(CachePlanSelectionTest, EqualityIndexScanWithTrailingFields) {
         BSON("x" << 5), "{fetch: {filter: null, node: {ixscan: {pattern: {x: 1, y: 1}}}}}");
 }
 
+//
+// Parameterized solutions
+//
+
+TEST_F(CachePlanSelectionTest, ParameterizedSolutionIsReboundToNewLiterals) {
+    addIndex(BSON("x" << 1 << "y" << 1), "x_1_y_1");
+    const auto cachedQuery = fromjson("{x: 5, y: {$gt: 1, $lt: 10}}");
+    runQuery(cachedQuery);
+
+    auto bestSoln = firstMatchingSolution(
+        "{fetch: {filter: null, node: {ixscan: {pattern: {x: 1, y: 1}}}}}");
+    bool isParameterized = false;
+    auto planSoln = planQueryFromParameterizedCache(
+        cachedQuery, fromjson("{x: 7, y: {$gt: 2, $lt: 3}}"), *bestSoln, &isParameterized);
+
+    ASSERT_TRUE(isParameterized);
+    assertSolutionMatches(planSoln.get(),
+                          "{fetch: {filter: null, node: {ixscan: {pattern: {x: 1, y: 1}, "
+                          "bounds: {x: [[7, 7, true, true]], y: [[2, 3, false, false]]}}}}}");
+}
+
+TEST_F(CachePlanSelectionTest, ParameterizedSolutionFallsBackForInexactLiterals) {
+    addIndex(BSON("x" << 1), "x_1");
+    const auto cachedQuery = BSON("x" << 5);
+    runQuery(cachedQuery);
+
+    // Equality to null needs a filter on top of the index scan, so the parameterized solution
+    // cannot be used and the plan is rebuilt from the cached index assignments instead.
+    auto bestSoln =
+        firstMatchingSolution("{fetch: {filter: null, node: {ixscan: {pattern: {x: 1}}}}}");
+    bool isParameterized = false;
+    auto planSoln = planQueryFromParameterizedCache(
+        cachedQuery, fromjson("{x: null}"), *bestSoln, &isParameterized);
+
+    ASSERT_TRUE(isParameterized);
+    assertSolutionMatches(planSoln.get(),
+                          "{fetch: {filter: {x: null}, node: {ixscan: {pattern: {x: 1}}}}}");
+}
+
+TEST_F(CachePlanSelectionTest, MultikeyIndexScanIsNotParameterized) {
+    addIndex(BSON("x" << 1), "x_1", true);
+    const auto cachedQuery = BSON("x" << 5);
+    runQuery(cachedQuery);
+
+    auto bestSoln =
+        firstMatchingSolution("{fetch: {filter: null, node: {ixscan: {pattern: {x: 1}}}}}");
+    bool isParameterized = true;
+    auto planSoln = planQueryFromParameterizedCache(
+        cachedQuery, BSON("x" << 6), *bestSoln, &isParameterized);
+
+    ASSERT_FALSE(isParameterized);
+    assertSolutionMatches(planSoln.get(),
+                          "{fetch: {filter: null, node: {ixscan: {pattern: {x: 1}, "
+                          "bounds: {x: [[6, 6, true, true]]}}}}}");
+}
+
 //
 // Geo
 //
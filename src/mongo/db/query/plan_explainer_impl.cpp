@@ -251,6 +251,7 @@ void statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("memUsage", spec->memUsage);
             bob->appendNumber("memLimit", spec->memLimit);
+            bob->appendBool("recordIdsOnly", spec->recordIdsOnly);
 
             for (size_t i = 0; i < spec->mapAfterChild.size(); ++i) {
                 bob->appendNumber(std::string(str::stream() << "mapAfterChild_" << i),
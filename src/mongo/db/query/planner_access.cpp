@@ -43,6 +43,7 @@
 #include "mongo/db/matcher/expression_array.h"
 #include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/matcher/expression_text.h"
+#include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/index_tag.h"
 #include "mongo/db/query/indexability.h"
@@ -1376,6 +1377,88 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::scanWholeIndex(
     return solnRoot;
 }
 
+std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::makeSkipScan(
+    const IndexEntry& index, const CanonicalQuery& query, const QueryPlannerParams& params) {
+    // Every document must have exactly one key in the index, and the bounds must be built in the
+    // query's collation.
+    if (index.type != INDEX_BTREE || index.multikey || index.sparse || index.filterExpr ||
+        index.keyPattern.nFields() < 2 ||
+        !CollatorInterface::collatorsMatch(index.collator, query.getCollator())) {
+        return nullptr;
+    }
+
+    std::vector<const MatchExpression*> predicates;
+    if (MatchExpression::AND == query.root()->matchType()) {
+        for (size_t i = 0; i < query.root()->numChildren(); ++i) {
+            predicates.push_back(query.root()->getChild(i));
+        }
+    } else {
+        predicates.push_back(query.root());
+    }
+
+    auto canBoundSkipScan = [](const MatchExpression* expr) {
+        switch (expr->matchType()) {
+            case MatchExpression::EQ:
+            case MatchExpression::LT:
+            case MatchExpression::LTE:
+            case MatchExpression::GT:
+            case MatchExpression::GTE:
+            case MatchExpression::MATCH_IN:
+                return true;
+            default:
+                return false;
+        }
+    };
+
+    unique_ptr<IndexScanNode> isn = std::make_unique<IndexScanNode>(index);
+    isn->addKeyMetadata = query.metadataDeps()[DocumentMetadataFields::kIndexKey];
+    isn->queryCollator = query.getCollator();
+    isn->bounds.fields.resize(index.keyPattern.nFields());
+
+    // Give the leading fields all-values bounds, up to the first field with a predicate that can
+    // be turned into bounds. The remaining fields also get all-values bounds.
+    bool foundSkipField = false;
+    size_t fieldNo = 0;
+    for (auto&& keyElt : index.keyPattern) {
+        OrderedIntervalList* oil = &isn->bounds.fields[fieldNo];
+        bool translated = false;
+        if (fieldNo > 0 && !foundSkipField) {
+            for (auto&& predicate : predicates) {
+                if (!canBoundSkipScan(predicate) ||
+                    predicate->path() != keyElt.fieldNameStringData()) {
+                    continue;
+                }
+
+                IndexBoundsBuilder::BoundsTightness tightness;
+                if (translated) {
+                    IndexBoundsBuilder::translateAndIntersect(
+                        predicate, keyElt, index, oil, &tightness);
+                } else {
+                    IndexBoundsBuilder::translate(predicate, keyElt, index, oil, &tightness);
+                    translated = true;
+                }
+            }
+            foundSkipField = translated;
+        }
+        if (!translated) {
+            IndexBoundsBuilder::allValuesForField(keyElt, oil);
+        }
+        ++fieldNo;
+    }
+
+    if (!foundSkipField) {
+        return nullptr;
+    }
+    IndexBoundsBuilder::alignBounds(&isn->bounds, index.keyPattern);
+
+    // The bounds may be looser than the predicates they were built from, and predicates on other
+    // fields are not reflected in them at all, so the full filter is applied to each document.
+    unique_ptr<FetchNode> fetch = std::make_unique<FetchNode>();
+    fetch->filter = query.root()->shallowClone();
+    fetch->children.push_back(isn.release());
+    return fetch;
+}
+
 void QueryPlannerAccess::addFilterToSolutionNode(QuerySolutionNode* node,
                                                  MatchExpression* match,
                                                  MatchExpression::MatchType type) {
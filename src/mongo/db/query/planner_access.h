@@ -110,6 +110,17 @@ public:
                                                              const QueryPlannerParams& params,
                                                              int direction = 1);
 
+    /**
+     * Return a plan that answers 'query' with a skip scan over 'index', or nullptr if 'index' is
+     * not eligible. The plan scans all values of the index's leading fields, but has the bounds of
+     * the query's predicates on the first later field that has any. For each distinct value of
+     * the leading fields, the index bounds checker then seeks directly to those bounds and past
+     * the rest of the keys with that value, so 'query' needs no predicate on the leading field.
+     */
+    static std::unique_ptr<QuerySolutionNode> makeSkipScan(const IndexEntry& index,
+                                                           const CanonicalQuery& query,
+                                                           const QueryPlannerParams& params);
+
     /**
      * Return a plan that scans the provided index from [startKey to endKey).
      */
@@ -80,6 +80,21 @@ bool isFetchNodeWithIndexScanChild(const QuerySolutionNode* node) {
             STAGE_IXSCAN == node->children[0]->getType());
 }
 
+/**
+ * Walks the tree 'root' and marks each AND_HASH node that is the child of a FETCH node so that it
+ * only keeps the record ids of its children's results. The FETCH reads every field from the
+ * document, so the index key data of all children but the one that is output is not needed.
+ */
+void markRecordIdOnlyIntersections(QuerySolutionNode* root) {
+    if (STAGE_FETCH == root->getType() && root->children.size() == 1 &&
+        STAGE_AND_HASH == root->children[0]->getType()) {
+        static_cast<AndHashNode*>(root->children[0])->recordIdsOnly = true;
+    }
+    for (auto&& child : root->children) {
+        markRecordIdOnlyIntersections(child);
+    }
+}
+
 /**
  * Walks the tree 'root' and outputs all nodes that can be considered for explosion for sort.
  * Outputs FETCH nodes with an IXSCAN node as a child as well as singular IXSCAN leaves without a
@@ -805,6 +820,10 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
     }
 
     // If we're here, we need to add a sort stage.
+    if (params.options & QueryPlannerParams::NO_BLOCKING_SORT) {
+        delete solnRoot;
+        return nullptr;
+    }
 
     if (!solnRoot->fetched()) {
         const bool sortIsCovered =
@@ -1029,6 +1048,10 @@ std::unique_ptr<QuerySolution> QueryPlannerAnalysis::analyzeDataAccess(
 
     solnRoot = tryPushdownProjectBeneathSort(std::move(solnRoot));
 
+    if (!query.metadataDeps()[DocumentMetadataFields::kIndexKey]) {
+        markRecordIdOnlyIntersections(solnRoot.get());
+    }
+
     soln->setRoot(std::move(solnRoot));
     return soln;
 }
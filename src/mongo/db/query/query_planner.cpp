@@ -33,6 +33,7 @@
 
 #include "mongo/db/query/query_planner.h"
 
+#include <algorithm>
 #include <boost/optional.hpp>
 #include <vector>
 
@@ -47,6 +48,7 @@
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/collation/collation_index_key.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_enumerator.h"
 #include "mongo/db/query/planner_access.h"
@@ -97,6 +99,99 @@ Status tagOrChildAccordingToCache(PlanCacheIndexTree* compositeCacheData,
 
     return Status::OK();
 }
+
+/**
+ * Rebuilds the solution cached as 'parameterized' for 'query' by recomputing the bounds of its
+ * index scan from the literals in 'query'. Returns nullptr if 'query' cannot be answered this way,
+ * in which case the caller should plan from the cached index assignments instead.
+ */
+std::unique_ptr<QuerySolution> buildFromParameterizedSolution(
+    const CanonicalQuery& query,
+    const QueryPlannerParams& params,
+    const ParameterizedSolution& parameterized) {
+    if (!ParameterizedSolution::isParameterizableQuery(query)) {
+        return nullptr;
+    }
+
+    // Bind the comparisons in 'query' to the parameter markers of the cached solution. The plan
+    // cache key guarantees the shapes match, but we check anyway since it is cheap.
+    std::vector<const MatchExpression*> comparisons;
+    if (!ParameterizedSolution::collectParameters(query.root(), &comparisons) ||
+        comparisons.size() != parameterized.parameters.size()) {
+        return nullptr;
+    }
+    for (size_t i = 0; i < comparisons.size(); ++i) {
+        if (comparisons[i]->matchType() != parameterized.parameters[i].matchType ||
+            comparisons[i]->path() != parameterized.parameters[i].path) {
+            return nullptr;
+        }
+    }
+
+    std::unique_ptr<QuerySolutionNode> root(parameterized.root->clone());
+    QuerySolutionNode* node = root.get();
+    bool hasShardFilter = false;
+    while (node->getType() != STAGE_IXSCAN) {
+        hasShardFilter = hasShardFilter || node->getType() == STAGE_SHARDING_FILTER;
+        node = node->children[0];
+    }
+    const bool wantsShardFilter = params.options & QueryPlannerParams::INCLUDE_SHARD_FILTER;
+    if (hasShardFilter != wantsShardFilter) {
+        return nullptr;
+    }
+
+    // Use the current description of the index, which must still be one the cached plan is valid
+    // for.
+    auto ixscan = static_cast<IndexScanNode*>(node);
+    auto index = std::find_if(params.indices.begin(), params.indices.end(), [&](auto&& entry) {
+        return entry.identifier == ixscan->index.identifier;
+    });
+    if (index == params.indices.end() || index->multikey ||
+        !CollatorInterface::collatorsMatch(query.getCollator(), index->collator)) {
+        return nullptr;
+    }
+
+    IndexBounds bounds;
+    for (auto&& keyElt : index->keyPattern) {
+        OrderedIntervalList oil(keyElt.fieldName());
+        bool hasBounds = false;
+        for (auto&& comparison : comparisons) {
+            if (comparison->path() != keyElt.fieldNameStringData()) {
+                continue;
+            }
+
+            IndexBoundsBuilder::BoundsTightness tightness;
+            if (hasBounds) {
+                IndexBoundsBuilder::translateAndIntersect(
+                    comparison, keyElt, *index, &oil, &tightness);
+            } else {
+                IndexBoundsBuilder::translate(comparison, keyElt, *index, &oil, &tightness);
+                hasBounds = true;
+            }
+
+            // Some literals (null, arrays, regexes in an $in...) need a filter on top of the scan,
+            // which the cached plan does not have.
+            if (tightness != IndexBoundsBuilder::EXACT) {
+                return nullptr;
+            }
+        }
+
+        if (!hasBounds) {
+            IndexBoundsBuilder::allValuesForField(keyElt, &oil);
+        }
+        bounds.fields.push_back(std::move(oil));
+    }
+    IndexBoundsBuilder::alignBounds(&bounds, index->keyPattern, ixscan->direction);
+
+    ixscan->index = *index;
+    ixscan->bounds = std::move(bounds);
+    ixscan->queryCollator = query.getCollator();
+    root->computeProperties();
+
+    auto soln = std::make_unique<QuerySolution>();
+    soln->setRoot(std::move(root));
+    soln->indexFilterApplied = params.indexFiltersApplied;
+    return soln;
+}
 }  // namespace
 
 using std::numeric_limits;
@@ -179,6 +274,12 @@ string optionString(size_t options) {
             case QueryPlannerParams::ENUMERATE_OR_CHILDREN_LOCKSTEP:
                 ss << "ENUMERATE_OR_CHILDREN_LOCKSTEP ";
                 break;
+            case QueryPlannerParams::NO_BLOCKING_SORT:
+                ss << "NO_BLOCKING_SORT ";
+                break;
+            case QueryPlannerParams::GENERATE_SKIP_SCANS:
+                ss << "GENERATE_SKIP_SCANS ";
+                break;
             case QueryPlannerParams::DEFAULT:
                 MONGO_UNREACHABLE;
                 break;
@@ -325,6 +426,17 @@ std::unique_ptr<QuerySolution> buildCollscanSoln(const CanonicalQuery& query,
     return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
 }
 
+std::unique_ptr<QuerySolution> buildSkipScanSoln(const IndexEntry& index,
+                                                 const CanonicalQuery& query,
+                                                 const QueryPlannerParams& params) {
+    std::unique_ptr<QuerySolutionNode> solnRoot(
+        QueryPlannerAccess::makeSkipScan(index, query, params));
+    if (!solnRoot) {
+        return nullptr;
+    }
+    return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
+}
+
 std::unique_ptr<QuerySolution> buildWholeIXSoln(const IndexEntry& index,
                                                 const CanonicalQuery& query,
                                                 const QueryPlannerParams& params,
@@ -493,6 +605,18 @@ StatusWith<std::unique_ptr<QuerySolution>> QueryPlanner::planFromCache(
     // Look up winning solution in cached solution's array.
     const SolutionCacheData& winnerCacheData = *cachedSoln.plannerData[0];
 
+    if (winnerCacheData.parameterizedSolution &&
+        internalQueryCacheReuseParameterizedSolutions.load()) {
+        if (auto soln = buildFromParameterizedSolution(
+                query, params, *winnerCacheData.parameterizedSolution)) {
+            LOGV2_DEBUG(5121504,
+                        5,
+                        "Planner: solution rebound from parameterized cached solution",
+                        "solution"_attr = redact(soln->toString()));
+            return {std::move(soln)};
+        }
+    }
+
     if (SolutionCacheData::WHOLE_IXSCAN_SOLN == winnerCacheData.solnType) {
         // The solution can be constructed by a scan over the entire index.
         auto soln = buildWholeIXSoln(
@@ -503,6 +627,14 @@ StatusWith<std::unique_ptr<QuerySolution>> QueryPlanner::planFromCache(
         } else {
             return {std::move(soln)};
         }
+    } else if (SolutionCacheData::SKIP_SCAN_SOLN == winnerCacheData.solnType) {
+        auto soln = buildSkipScanSoln(*winnerCacheData.tree->entry, query, params);
+        if (!soln) {
+            return Status(ErrorCodes::NoQueryExecutionPlans,
+                          "plan cache error: soln that uses index skip scan");
+        } else {
+            return {std::move(soln)};
+        }
     } else if (SolutionCacheData::COLLSCAN_SOLN == winnerCacheData.solnType) {
         // The cached solution is a collection scan. We don't cache collscans
         // with tailable==true, hence the false below.
@@ -1062,6 +1194,7 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
             }
 
             QueryPlannerParams paramsForCoveredIxScan;
+            paramsForCoveredIxScan.options = params.options & QueryPlannerParams::NO_BLOCKING_SORT;
             auto soln = buildWholeIXSoln(index, query, paramsForCoveredIxScan);
             if (soln && !soln->root()->fetched()) {
                 LOGV2_DEBUG(
@@ -1081,8 +1214,38 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
         }
     }
 
-    // The caller can explicitly ask for a collscan.
-    bool collscanRequested = (params.options & QueryPlannerParams::INCLUDE_COLLSCAN);
+    // If no index could be used, a compound index may still be able to answer the query by
+    // skipping over the distinct values of its leading field.
+    bool generatedSkipScan = false;
+    if (params.options & QueryPlannerParams::GENERATE_SKIP_SCANS && out.size() == 0 &&
+        hintedIndex.isEmpty() && !isTailable) {
+        for (auto&& index : fullIndexList) {
+            auto soln = buildSkipScanSoln(index, query, params);
+            if (!soln) {
+                continue;
+            }
+            LOGV2_DEBUG(5121507,
+                        5,
+                        "Planner: outputting soln that skip scans index",
+                        "index"_attr = index.identifier);
+            PlanCacheIndexTree* indexTree = new PlanCacheIndexTree();
+            indexTree->setIndexEntry(index);
+
+            SolutionCacheData* scd = new SolutionCacheData();
+            scd->tree.reset(indexTree);
+            scd->solnType = SolutionCacheData::SKIP_SCAN_SOLN;
+            soln->cacheData.reset(scd);
+
+            out.push_back(std::move(soln));
+            generatedSkipScan = true;
+        }
+    }
+
+    // The caller can explicitly ask for a collscan. A skip scan seeks once for every distinct
+    // value of the index's leading field, so it also competes with a collscan, which wins when
+    // there are many such values.
+    bool collscanRequested = (params.options & QueryPlannerParams::INCLUDE_COLLSCAN) ||
+        (generatedSkipScan && canTableScan);
 
     // No indexed plans?  We must provide a collscan if possible or else we can't run the query.
     bool collScanRequired = 0 == out.size();
@@ -417,6 +417,72 @@ TEST_F(QueryPlannerTest, NoSplitLimitedSortAsCommandBatchSize) {
         "node: {ixscan: {pattern: {a: 1}}}}}}}");
 }
 
+TEST_F(QueryPlannerTest, NoBlockingSortDiscardsSolutionsWithSortStage) {
+    params.options = QueryPlannerParams::NO_BLOCKING_SORT;
+    addIndex(BSON("a" << 1));
+    addIndex(BSON("b" << 1));
+
+    runQuerySortProj(fromjson("{a: {$gt: 0}}"), fromjson("{b: 1}"), BSONObj());
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: {a: {$gt: 0}}, node: {ixscan: {filter: null, pattern: {b: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, NoBlockingSortUsesCoveredIndexScanForSort) {
+    params.options = QueryPlannerParams::NO_BLOCKING_SORT;
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    runQuerySortProj(BSONObj(), fromjson("{a: -1}"), fromjson("{_id: 0, a: 1, b: 1}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1, b: 1}, node: {ixscan: "
+        "{filter: null, pattern: {a: 1, b: 1}, dir: -1}}}}");
+}
+
+TEST_F(QueryPlannerTest, NoBlockingSortFailsWithoutIndexProvidingSort) {
+    params.options = QueryPlannerParams::NO_BLOCKING_SORT;
+    addIndex(BSON("a" << 1));
+
+    runInvalidQuerySortProj(fromjson("{a: 1}"), fromjson("{b: 1}"), BSONObj());
+}
+
+TEST_F(QueryPlannerTest, SkipScanUsesCompoundIndexWithoutPredicateOnLeadingField) {
+    params.options = QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << -1));
+
+    runQuery(fromjson("{b: {$gte: 3, $lt: 7}, c: 1}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: {b: {$gte: 3, $lt: 7}, c: 1}, node: {ixscan: {pattern: {a: 1, b: -1}, "
+        "bounds: {a: [['MinKey','MaxKey',true,true]], b: [[7,3,false,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotGeneratedWhenAnIndexCanBeUsedDirectly) {
+    params.options = QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    addIndex(BSON("b" << 1));
+
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{fetch: {filter: null, node: {ixscan: {pattern: {b: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotGeneratedForMultikeyOrSparseIndex) {
+    params.options = QueryPlannerParams::GENERATE_SKIP_SCANS;
+    addIndex(BSON("a" << 1 << "b" << 1), true /* multikey */);
+    addIndex(BSON("c" << 1 << "b" << 1), false /* multikey */, true /* sparse */);
+
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
 
 //
 // Test shard filter query planning
@@ -118,6 +118,17 @@ struct QueryPlannerParams {
         // is thought to be helpful in general, but particularly in cases where all children of the
         // $or use the same fields and have the same indexes available, as in this example.
         ENUMERATE_OR_CHILDREN_LOCKSTEP = 1 << 12,
+
+        // Only output solutions in which the requested sort is provided by the order of an index
+        // scan. Solutions that would need a blocking SORT stage are discarded, and if there are
+        // none left the planner fails with NoQueryExecutionPlans. Cached plans are not consulted,
+        // since they may have been planned without this restriction.
+        NO_BLOCKING_SORT = 1 << 13,
+
+        // Set this to generate skip scans over compound indexes for queries which have predicates
+        // on a non-leading field of the index but none that the planner could otherwise answer
+        // with an index.
+        GENERATE_SKIP_SCANS = 1 << 14,
     };
 
     // See Options enum above.
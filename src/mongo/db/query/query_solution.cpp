@@ -248,6 +248,10 @@ void AndHashNode::appendToString(str::stream* ss, int indent) const {
         addIndent(ss, indent + 1);
         *ss << " filter = " << filter->debugString() << '\n';
     }
+    if (recordIdsOnly) {
+        addIndent(ss, indent + 1);
+        *ss << "recordIdsOnly\n";
+    }
     addCommon(ss, indent);
     for (size_t i = 0; i < children.size(); ++i) {
         addIndent(ss, indent + 1);
@@ -279,6 +283,7 @@ FieldAvailability AndHashNode::getFieldAvailability(const string& field) const {
 QuerySolutionNode* AndHashNode::clone() const {
     AndHashNode* copy = new AndHashNode();
     cloneBaseData(copy);
+    copy->recordIdsOnly = this->recordIdsOnly;
     return copy;
 }
 
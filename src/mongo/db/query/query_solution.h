@@ -502,6 +502,10 @@ struct AndHashNode : public QuerySolutionNode {
     }
 
     QuerySolutionNode* clone() const;
+
+    // True if the results of the intersection are fetched, so that only the record ids of the
+    // children other than the last need to be kept.
+    bool recordIdsOnly = false;
 };
 
 struct AndSortedNode : public QuerySolutionNodeWithSortSet {
@@ -57,6 +57,7 @@
 #include "mongo/db/catalog/import_collection_oplog_entry_gen.h"
 #include "mongo/db/catalog/multi_index_block.h"
 #include "mongo/db/catalog/rename_collection.h"
+#include "mongo/db/catalog/truncate_clustered_range.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/feature_compatibility_version_parser.h"
@@ -957,6 +958,25 @@ const StringMap<ApplyOpMetadata> kOpsMap = {
               extractNsFromUUIDorNs(opCtx, entry.getNss(), entry.getUuid(), entry.getObject()));
       },
       {ErrorCodes::NamespaceNotFound}}},
+    {"truncateRange",
+     {[](OperationContext* opCtx, const OplogEntry& entry, OplogApplication::Mode mode) -> Status {
+          // If we are validating features as primary, only allow the entries at FCV 4.9 or newer,
+          // which is when collections clustered by time can be created.
+          if (serverGlobalParams.validateFeaturesAsPrimary.load()) {
+              uassert(5121520,
+                      "truncateRange oplog entries may not be used in FCV below 4.9",
+                      serverGlobalParams.featureCompatibility.isVersionInitialized() &&
+                          serverGlobalParams.featureCompatibility.isGreaterThanOrEqualTo(
+                              ServerGlobalParams::FeatureCompatibility::Version::kVersion49));
+          }
+
+          const auto& cmd = entry.getObject();
+          return truncateClusteredRangeForApplyOps(
+              opCtx,
+              extractNsFromUUIDorNs(opCtx, entry.getNss(), entry.getUuid(), cmd),
+              cmd["before"].Date());
+      },
+      {ErrorCodes::NamespaceNotFound}}},
     {"commitTransaction",
      {[](OperationContext* opCtx, const OplogEntry& entry, OplogApplication::Mode mode) -> Status {
          return applyCommitTransaction(opCtx, entry, mode);
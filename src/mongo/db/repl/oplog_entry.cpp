@@ -61,6 +61,8 @@ OplogEntry::CommandType parseCommandType(const BSONObj& objectField) {
         return OplogEntry::CommandType::kDropDatabase;
     } else if (commandString == "emptycapped") {
         return OplogEntry::CommandType::kEmptyCapped;
+    } else if (commandString == "truncateRange") {
+        return OplogEntry::CommandType::kTruncateRange;
     } else if (commandString == "createIndexes") {
         return OplogEntry::CommandType::kCreateIndexes;
     } else if (commandString == "startIndexBuild") {
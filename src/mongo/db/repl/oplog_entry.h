@@ -271,6 +271,7 @@ public:
         kApplyOps,
         kDropDatabase,
         kEmptyCapped,
+        kTruncateRange,
         kCreateIndexes,
         kStartIndexBuild,
         kCommitIndexBuild,
@@ -323,6 +323,29 @@ Status storeBaseOptions(const moe::Environment& params) {
         }
     }
 
+    if (params.count("systemLog.async") && params["systemLog.async"].as<bool>()) {
+        serverGlobalParams.logAsyncOptions.enabled = true;
+    }
+
+    if (params.count("systemLog.asyncBufferSize")) {
+        serverGlobalParams.logAsyncOptions.bufferSize =
+            params["systemLog.asyncBufferSize"].as<int>();
+    }
+
+    if (params.count("systemLog.asyncOverflowPolicy")) {
+        std::string overflowPolicy = params["systemLog.asyncOverflowPolicy"].as<string>();
+        if (overflowPolicy == "block") {
+            serverGlobalParams.logAsyncOptions.overflowPolicy =
+                logv2::AsyncLogOptions::OverflowPolicy::kBlock;
+        } else if (overflowPolicy == "drop") {
+            serverGlobalParams.logAsyncOptions.overflowPolicy =
+                logv2::AsyncLogOptions::OverflowPolicy::kDrop;
+        } else {
+            return Status(ErrorCodes::BadValue,
+                          "unsupported value for asyncOverflowPolicy " + overflowPolicy);
+        }
+    }
+
     if (params.count("systemLog.destination")) {
         std::string systemLogDestination = params["systemLog.destination"].as<std::string>();
         if (systemLogDestination == "file") {
@@ -80,6 +80,7 @@
 #include "mongo/db/session_catalog_mongod.h"
 #include "mongo/db/stats/api_version_metrics.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/stats/query_shape_stats.h"
 #include "mongo/db/stats/resource_consumption_metrics.h"
 #include "mongo/db/stats/server_read_concern_metrics.h"
 #include "mongo/db/stats/top.h"
@@ -1384,7 +1385,11 @@ DbResponse receivedCommands(OperationContext* opCtx,
     Command* c = nullptr;
     [&] {
         try {  // Parse.
-            request = rpc::opMsgRequestFromAnyProtocol(message);
+            // The message outlives the request, so document sequences (the documents of a bulk
+            // write) can stay views into it all the way down to the storage layer. Anything that
+            // retains a document past the command, such as a transaction's oplog entries, already
+            // takes its own copy.
+            request = rpc::opMsgRequestFromAnyProtocolWithUnownedSequences(message);
         } catch (const DBException& ex) {
             // If this error needs to fail the connection, propagate it out.
             if (ErrorCodes::isConnectionFatalMessageParseError(ex.code()))
@@ -1872,6 +1877,9 @@ void HandleRequest::startOperation() {
 
         // We should not be holding any locks at this point
         invariant(!opCtx->lockState()->isLocked());
+
+        // Operations run through DBDirectClient share the CPU timer of the calling operation.
+        QueryShapeStats::onOperationStart(opCtx);
     }
     {
         stdx::lock_guard<Client> lk(client());
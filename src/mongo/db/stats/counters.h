@@ -185,6 +185,17 @@ public:
 
     void append(BSONObjBuilder& b);
 
+    // These are sampled by FTDC at a high frequency
+    const AtomicWord<long long>* getLogicalBytesIn() const {
+        return &_together.logicalBytesIn;
+    }
+    const AtomicWord<long long>* getLogicalBytesOut() const {
+        return &_logicalBytesOut;
+    }
+    const AtomicWord<long long>* getRequests() const {
+        return &_together.requests;
+    }
+
 private:
     CacheAligned<AtomicWord<long long>> _physicalBytesIn{0};
     CacheAligned<AtomicWord<long long>> _physicalBytesOut{0};
@@ -0,0 +1,119 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_shape_stats.h"
+
+#include "mongo/db/operation_cpu_timer.h"
+#include "mongo/db/stats/query_shape_stats_gen.h"
+
+namespace mongo {
+namespace {
+const ServiceContext::Decoration<QueryShapeStats> getGlobalQueryShapeStats =
+    ServiceContext::declareDecoration<QueryShapeStats>();
+
+// Whether onOperationStart started the operation's CPU timer.
+const OperationContext::Decoration<bool> isMeasuringCPUTime =
+    OperationContext::declareDecoration<bool>();
+
+static const char kExecCount[] = "execCount";
+static const char kCpuNanos[] = "cpuNanos";
+static const char kDocsExamined[] = "docsExamined";
+static const char kKeysExamined[] = "keysExamined";
+static const char kDocBytesRead[] = "docBytesRead";
+}  // namespace
+
+QueryShapeStats::QueryShapeStats() : _metrics(gQueryShapeStatsMaxEntries) {}
+
+QueryShapeStats& QueryShapeStats::get(ServiceContext* svcCtx) {
+    return getGlobalQueryShapeStats(svcCtx);
+}
+
+QueryShapeStats& QueryShapeStats::get(OperationContext* opCtx) {
+    return getGlobalQueryShapeStats(opCtx->getServiceContext());
+}
+
+bool QueryShapeStats::isEnabled() {
+    return gCollectQueryShapeStats.load();
+}
+
+void QueryShapeStats::onOperationStart(OperationContext* opCtx) {
+    if (!isEnabled()) {
+        return;
+    }
+
+    invariant(!isMeasuringCPUTime(opCtx));
+    if (auto timer = OperationCPUTimer::get(opCtx)) {
+        timer->start();
+        isMeasuringCPUTime(opCtx) = true;
+    }
+}
+
+boost::optional<Nanoseconds> QueryShapeStats::getOperationCPUTime(OperationContext* opCtx) {
+    if (!isMeasuringCPUTime(opCtx)) {
+        return boost::none;
+    }
+
+    return OperationCPUTimer::get(opCtx)->getElapsed();
+}
+
+void QueryShapeStats::Metrics::toBson(BSONObjBuilder* builder) const {
+    builder->appendNumber(kExecCount, execCount);
+    builder->appendNumber(kCpuNanos, cpuNanos);
+    builder->appendNumber(kDocsExamined, docsExamined);
+    builder->appendNumber(kKeysExamined, keysExamined);
+    builder->appendNumber(kDocBytesRead, docBytesRead);
+}
+
+void QueryShapeStats::add(const NamespaceString& nss,
+                          std::uint32_t queryHash,
+                          const Metrics& metrics) {
+    Key key{nss, queryHash};
+    stdx::unique_lock<Mutex> lk(_mutex);
+    if (auto it = _metrics.find(key); it != _metrics.end()) {
+        it->second += metrics;
+        return;
+    }
+    _metrics.add(key, metrics);
+}
+
+QueryShapeStats::ShapeMetrics QueryShapeStats::getMetrics() const {
+    stdx::unique_lock<Mutex> lk(_mutex);
+    return ShapeMetrics(_metrics.cbegin(), _metrics.cend());
+}
+
+QueryShapeStats::ShapeMetrics QueryShapeStats::getAndClearMetrics() {
+    stdx::unique_lock<Mutex> lk(_mutex);
+    ShapeMetrics shapeMetrics(_metrics.cbegin(), _metrics.cend());
+    _metrics.clear();
+    return shapeMetrics;
+}
+
+}  // namespace mongo
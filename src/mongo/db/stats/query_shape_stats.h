@@ -0,0 +1,151 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/lru_cache.h"
+
+namespace mongo {
+
+/**
+ * QueryShapeStats accumulates the cost of operations by query shape, so that expensive shapes can
+ * be found without the overhead of the profiler. A shape is identified by its namespace and its
+ * queryHash, the hash of the canonical_query_encoder stable key which the slow query log, the
+ * profiler and $planCacheStats also report.
+ *
+ * The number of shapes is bounded by queryShapeStatsMaxEntries. Once the store is full, recording
+ * a new shape evicts the least recently executed one.
+ */
+class QueryShapeStats {
+public:
+    QueryShapeStats();
+
+    static QueryShapeStats& get(OperationContext* opCtx);
+    static QueryShapeStats& get(ServiceContext* svcCtx);
+
+    /**
+     * Returns true if operations should be recorded by query shape.
+     */
+    static bool isEnabled();
+
+    /**
+     * Starts measuring the CPU time of a top-level operation if the store is enabled. Must be
+     * called at most once per operation, on the thread running it.
+     */
+    static void onOperationStart(OperationContext* opCtx);
+
+    /**
+     * Returns the CPU time consumed by the operation so far, or boost::none if it is not measured.
+     */
+    static boost::optional<Nanoseconds> getOperationCPUTime(OperationContext* opCtx);
+
+    /**
+     * Metrics maintains the accumulated cost of a query shape.
+     */
+    struct Metrics {
+        void add(const Metrics& other) {
+            execCount += other.execCount;
+            cpuNanos += other.cpuNanos;
+            docsExamined += other.docsExamined;
+            keysExamined += other.keysExamined;
+            docBytesRead += other.docBytesRead;
+        }
+
+        Metrics& operator+=(const Metrics& other) {
+            add(other);
+            return *this;
+        }
+
+        /**
+         * Reports all metrics on a BSONObjBuilder.
+         */
+        void toBson(BSONObjBuilder* builder) const;
+
+        // Number of times the query was executed. getMores of the query's cursor add their cost,
+        // but do not count as executions.
+        long long execCount = 0;
+        // Amount of CPU time consumed in nanoseconds, where the platform can measure it
+        long long cpuNanos = 0;
+        // Number of documents examined
+        long long docsExamined = 0;
+        // Number of index keys examined
+        long long keysExamined = 0;
+        // Number of document bytes read from the storage engine
+        long long docBytesRead = 0;
+    };
+
+    /**
+     * Identifies a query shape.
+     */
+    struct Key {
+        bool operator==(const Key& other) const {
+            return queryHash == other.queryHash && nss == other.nss;
+        }
+
+        template <typename H>
+        friend H AbslHashValue(H h, const Key& key) {
+            return H::combine(std::move(h), key.nss, key.queryHash);
+        }
+
+        NamespaceString nss;
+        std::uint32_t queryHash;
+    };
+
+    /**
+     * Adds the metrics of an operation to those of its query shape.
+     */
+    void add(const NamespaceString& nss, std::uint32_t queryHash, const Metrics& metrics);
+
+    /**
+     * Returns a copy of the metrics of every query shape, most recently executed first.
+     */
+    using ShapeMetrics = std::vector<std::pair<Key, Metrics>>;
+    ShapeMetrics getMetrics() const;
+
+    /**
+     * Returns the metrics of every query shape like getMetrics and then clears the store.
+     */
+    ShapeMetrics getAndClearMetrics();
+
+private:
+    // Protects _metrics
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("QueryShapeStats::_mutex");
+    LRUCache<Key, Metrics> _metrics;
+};
+
+}  // namespace mongo
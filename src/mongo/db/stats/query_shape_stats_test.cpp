@@ -0,0 +1,124 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/operation_cpu_timer.h"
+#include "mongo/db/service_context_test_fixture.h"
+#include "mongo/db/stats/query_shape_stats.h"
+#include "mongo/db/stats/query_shape_stats_gen.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+
+class QueryShapeStatsTest : public ServiceContextTest {
+public:
+    void setUp() {
+        _opCtx = makeOperationContext();
+        gCollectQueryShapeStats.store(true);
+    }
+
+    void tearDown() {
+        gCollectQueryShapeStats.store(false);
+        gQueryShapeStatsMaxEntries = 1000;
+    }
+
+    static QueryShapeStats::Metrics makeMetrics(long long execCount, long long docsExamined) {
+        QueryShapeStats::Metrics metrics;
+        metrics.execCount = execCount;
+        metrics.docsExamined = docsExamined;
+        return metrics;
+    }
+
+protected:
+    const NamespaceString _nss1{"db.coll1"};
+    const NamespaceString _nss2{"db.coll2"};
+    ServiceContext::UniqueOperationContext _opCtx;
+};
+
+TEST_F(QueryShapeStatsTest, Add) {
+    auto& queryShapeStats = QueryShapeStats::get(getServiceContext());
+
+    queryShapeStats.add(_nss1, 1, makeMetrics(1, 10));
+    queryShapeStats.add(_nss1, 2, makeMetrics(1, 20));
+    queryShapeStats.add(_nss2, 1, makeMetrics(1, 30));
+    queryShapeStats.add(_nss1, 1, makeMetrics(0, 5));
+
+    // Shapes are keyed by namespace and queryHash, and returned most recently executed first.
+    auto shapeMetrics = queryShapeStats.getMetrics();
+    ASSERT_EQ(shapeMetrics.size(), 3U);
+    ASSERT_EQ(shapeMetrics[0].first.nss, _nss1);
+    ASSERT_EQ(shapeMetrics[0].first.queryHash, 1U);
+    ASSERT_EQ(shapeMetrics[0].second.execCount, 1);
+    ASSERT_EQ(shapeMetrics[0].second.docsExamined, 15);
+    ASSERT_EQ(shapeMetrics[1].first.nss, _nss2);
+    ASSERT_EQ(shapeMetrics[1].second.docsExamined, 30);
+    ASSERT_EQ(shapeMetrics[2].first.queryHash, 2U);
+    ASSERT_EQ(shapeMetrics[2].second.docsExamined, 20);
+
+    shapeMetrics = queryShapeStats.getAndClearMetrics();
+    ASSERT_EQ(shapeMetrics.size(), 3U);
+    ASSERT_EQ(queryShapeStats.getMetrics().size(), 0U);
+}
+
+TEST_F(QueryShapeStatsTest, EvictLeastRecentlyExecuted) {
+    gQueryShapeStatsMaxEntries = 2;
+    QueryShapeStats queryShapeStats;
+
+    queryShapeStats.add(_nss1, 1, makeMetrics(1, 10));
+    queryShapeStats.add(_nss1, 2, makeMetrics(1, 20));
+    queryShapeStats.add(_nss1, 1, makeMetrics(1, 10));
+    queryShapeStats.add(_nss1, 3, makeMetrics(1, 30));
+
+    auto shapeMetrics = queryShapeStats.getMetrics();
+    ASSERT_EQ(shapeMetrics.size(), 2U);
+    ASSERT_EQ(shapeMetrics[0].first.queryHash, 3U);
+    ASSERT_EQ(shapeMetrics[1].first.queryHash, 1U);
+    ASSERT_EQ(shapeMetrics[1].second.execCount, 2);
+}
+
+TEST_F(QueryShapeStatsTest, OperationCPUTime) {
+    gCollectQueryShapeStats.store(false);
+    QueryShapeStats::onOperationStart(_opCtx.get());
+    ASSERT_FALSE(QueryShapeStats::getOperationCPUTime(_opCtx.get()));
+
+    _opCtx.reset();
+    auto opCtx = makeOperationContext();
+    gCollectQueryShapeStats.store(true);
+    QueryShapeStats::onOperationStart(opCtx.get());
+
+    // The CPU time is only measured where the platform supports it.
+    auto cpuTime = QueryShapeStats::getOperationCPUTime(opCtx.get());
+    ASSERT_EQ(bool(cpuTime), OperationCPUTimer::get(opCtx.get()) != nullptr);
+    if (cpuTime) {
+        ASSERT_GTE(*cpuTime, Nanoseconds(0));
+    }
+}
+
+}  // namespace mongo
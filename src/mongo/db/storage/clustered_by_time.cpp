@@ -0,0 +1,85 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/clustered_by_time.h"
+
+#include "mongo/bson/bson_validate.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/util/debug_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace clustered_by_time {
+
+namespace {
+// The largest millisecond value whose RecordIds all stay below the reserved RecordId range.
+const long long kMaxMillis = (RecordId::minReserved().repr() >> kTiebreakBits) - 1;
+}  // namespace
+
+StatusWith<RecordId> makeRecordId(Date_t time, int64_t tiebreak) {
+    const long long millis = time.toMillisSinceEpoch();
+    if (millis <= 0)
+        return {ErrorCodes::BadValue, "clustering time must be after the epoch"};
+    if (millis > kMaxMillis)
+        return {ErrorCodes::BadValue, "clustering time too high"};
+
+    return RecordId((millis << kTiebreakBits) | (tiebreak & kTiebreakMask));
+}
+
+RecordId minRecordId(Date_t time) {
+    const long long millis = time.toMillisSinceEpoch();
+    if (millis <= 0)
+        return RecordId::min();
+    if (millis > kMaxMillis)
+        return RecordId::minReserved();
+    return RecordId(millis << kTiebreakBits);
+}
+
+Date_t timeOf(const RecordId& id) {
+    return Date_t::fromMillisSinceEpoch(id.repr() >> kTiebreakBits);
+}
+
+StatusWith<Date_t> extractTime(StringData field, const char* data, int len) {
+    if (kDebugBuild)
+        invariant(validateBSON(data, len).isOK());
+
+    const BSONObj obj(data);
+    const BSONElement elem = obj[field];
+    if (elem.eoo())
+        return {ErrorCodes::BadValue, str::stream() << "no " << field << " field"};
+    if (elem.type() != Date)
+        return {ErrorCodes::BadValue, str::stream() << field << " must be a Date"};
+
+    return elem.date();
+}
+
+}  // namespace clustered_by_time
+}  // namespace mongo
@@ -0,0 +1,78 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/record_id.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * Helpers for collections created with the 'clusteredByTime' option. The records of such a
+ * collection are keyed by the Date value of a document field instead of by an insertion counter,
+ * in the same way the oplog keys its records by 'ts' (see 'oplog_hack.h'). Records are therefore
+ * ordered by time and every record older than a given time lives in one contiguous range at the
+ * start of the collection, which the storage engine can remove in a single truncate.
+ *
+ * A RecordId holds the milliseconds since the epoch in its upper 43 bits and a tiebreak in the
+ * lower 20 bits, so that up to 2^20 documents can share the same millisecond.
+ */
+namespace clustered_by_time {
+
+constexpr int kTiebreakBits = 20;
+constexpr int64_t kTiebreakMask = (1LL << kTiebreakBits) - 1;
+
+/**
+ * Returns the RecordId for a document whose time field holds 'time', disambiguated by the low
+ * bits of 'tiebreak'. Fails for times at or before the epoch and for times too large to fit.
+ */
+StatusWith<RecordId> makeRecordId(Date_t time, int64_t tiebreak);
+
+/**
+ * Returns the smallest RecordId that any document with a time of 'time' or later can have. All
+ * documents older than 'time' sort before it.
+ */
+RecordId minRecordId(Date_t time);
+
+/**
+ * Returns the time that 'id' was derived from.
+ */
+Date_t timeOf(const RecordId& id);
+
+/**
+ * Returns the Date stored in the 'field' of the BSON document 'data' of length 'len'. Fails if the
+ * field is missing or is not a Date.
+ */
+StatusWith<Date_t> extractTime(StringData field, const char* data, int len);
+
+}  // namespace clustered_by_time
+}  // namespace mongo
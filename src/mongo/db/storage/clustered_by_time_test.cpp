@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/storage/clustered_by_time.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(ClusteredByTimeTest, RecordIdsSortByTimeThenTiebreak) {
+    const auto t1 = Date_t::fromMillisSinceEpoch(1000);
+    const auto t2 = Date_t::fromMillisSinceEpoch(1001);
+
+    auto a = unittest::assertGet(clustered_by_time::makeRecordId(t1, 0));
+    auto b = unittest::assertGet(clustered_by_time::makeRecordId(t1, 7));
+    auto c = unittest::assertGet(clustered_by_time::makeRecordId(t2, 0));
+    ASSERT_LT(a, b);
+    ASSERT_LT(b, c);
+
+    ASSERT_EQ(t1, clustered_by_time::timeOf(a));
+    ASSERT_EQ(t1, clustered_by_time::timeOf(b));
+    ASSERT_EQ(t2, clustered_by_time::timeOf(c));
+}
+
+TEST(ClusteredByTimeTest, TiebreakWrapsWithinTheSameMillisecond) {
+    const auto t = Date_t::fromMillisSinceEpoch(1000);
+    auto last = unittest::assertGet(
+        clustered_by_time::makeRecordId(t, clustered_by_time::kTiebreakMask));
+    auto wrapped = unittest::assertGet(
+        clustered_by_time::makeRecordId(t, clustered_by_time::kTiebreakMask + 1));
+    ASSERT_EQ(t, clustered_by_time::timeOf(last));
+    ASSERT_EQ(t, clustered_by_time::timeOf(wrapped));
+}
+
+TEST(ClusteredByTimeTest, MinRecordIdSeparatesOlderDocuments) {
+    const auto t = Date_t::fromMillisSinceEpoch(5000);
+    auto older = unittest::assertGet(clustered_by_time::makeRecordId(
+        t - Milliseconds(1), clustered_by_time::kTiebreakMask));
+    auto first = unittest::assertGet(clustered_by_time::makeRecordId(t, 0));
+
+    ASSERT_LT(older, clustered_by_time::minRecordId(t));
+    ASSERT_EQ(first, clustered_by_time::minRecordId(t));
+    ASSERT_EQ(RecordId::min(), clustered_by_time::minRecordId(Date_t()));
+}
+
+TEST(ClusteredByTimeTest, RejectsTimesOutOfRange) {
+    ASSERT_EQ(ErrorCodes::BadValue,
+              clustered_by_time::makeRecordId(Date_t(), 0).getStatus().code());
+    ASSERT_EQ(ErrorCodes::BadValue,
+              clustered_by_time::makeRecordId(Date_t::max(), 0).getStatus().code());
+}
+
+TEST(ClusteredByTimeTest, ExtractTime) {
+    const auto t = Date_t::fromMillisSinceEpoch(1234);
+    BSONObj doc = BSON("_id" << 1 << "at" << t);
+    ASSERT_EQ(t,
+              unittest::assertGet(
+                  clustered_by_time::extractTime("at", doc.objdata(), doc.objsize())));
+
+    ASSERT_EQ(ErrorCodes::BadValue,
+              clustered_by_time::extractTime("missing", doc.objdata(), doc.objsize())
+                  .getStatus()
+                  .code());
+
+    BSONObj notADate = BSON("at" << 1234);
+    ASSERT_EQ(ErrorCodes::BadValue,
+              clustered_by_time::extractTime("at", notADate.objdata(), notADate.objsize())
+                  .getStatus()
+                  .code());
+}
+
+}  // namespace
+}  // namespace mongo
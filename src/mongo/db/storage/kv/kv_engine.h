@@ -447,6 +447,13 @@ public:
         return false;
     }
 
+    /**
+     * See `StorageEngine::supportsClusteredByTime`
+     */
+    virtual bool supportsClusteredByTime() const {
+        return false;
+    }
+
     /**
      * Methods to access the storage engine's timestamps.
      */
@@ -538,6 +538,19 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    /**
+     * Removes, in a single storage engine operation, every record with a RecordId less than 'end'.
+     * The caller has already visited those records and passes their number and total size.
+     * This should only be called if StorageEngine::supportsClusteredByTime() is true, on the
+     * RecordStore of a collection clustered by time.
+     */
+    virtual void truncateRange(OperationContext* opCtx,
+                               const RecordId& end,
+                               long long numRecords,
+                               long long dataSize) {
+        MONGO_UNREACHABLE;
+    }
+
     /**
      * If supported, this method returns the timestamp value for the latest storage engine committed
      * oplog document. Note that this method will not include uncommitted writes on the input
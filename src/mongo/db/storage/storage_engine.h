@@ -447,6 +447,12 @@ public:
      */
     virtual bool supportsOplogStones() const = 0;
 
+    /**
+     * Returns true if the storage engine can store a collection's records keyed by a time field of
+     * the document and remove whole time ranges of them at once. See 'clustered_by_time.h'.
+     */
+    virtual bool supportsClusteredByTime() const = 0;
+
     virtual bool supportsResumableIndexBuilds() const = 0;
 
     /**
@@ -984,6 +984,10 @@ bool StorageEngineImpl::supportsOplogStones() const {
     return _engine->supportsOplogStones();
 }
 
+bool StorageEngineImpl::supportsClusteredByTime() const {
+    return _engine->supportsClusteredByTime();
+}
+
 bool StorageEngineImpl::supportsResumableIndexBuilds() const {
     return enableResumableIndexBuilds && supportsReadConcernMajority() && !isEphemeral() &&
         serverGlobalParams.featureCompatibility.isVersionInitialized() &&
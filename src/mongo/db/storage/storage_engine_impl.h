@@ -161,6 +161,8 @@ public:
 
     bool supportsOplogStones() const final;
 
+    bool supportsClusteredByTime() const final;
+
     bool supportsResumableIndexBuilds() const final;
 
     bool supportsPendingDrops() const final;
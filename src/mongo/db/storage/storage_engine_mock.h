@@ -121,6 +121,9 @@ public:
     bool supportsOplogStones() const final {
         return false;
     }
+    bool supportsClusteredByTime() const final {
+        return false;
+    }
     bool supportsResumableIndexBuilds() const final {
         return false;
     }
@@ -1437,6 +1437,7 @@ std::unique_ptr<RecordStore> WiredTigerKVEngine::getGroupedRecordStore(
     params.cappedMaxDocs = -1;
     if (options.capped && options.cappedMaxDocs)
         params.cappedMaxDocs = options.cappedMaxDocs;
+    params.clusteredByTimeField = options.clusteredByTime;
 
     std::unique_ptr<WiredTigerRecordStore> ret;
     if (prefix == KVPrefix::kNotPrefixed) {
@@ -2281,6 +2282,10 @@ bool WiredTigerKVEngine::supportsOplogStones() const {
     return true;
 }
 
+bool WiredTigerKVEngine::supportsClusteredByTime() const {
+    return true;
+}
+
 void WiredTigerKVEngine::startOplogManager(OperationContext* opCtx,
                                            WiredTigerRecordStore* oplogRecordStore) {
     stdx::lock_guard<Latch> lock(_oplogManagerMutex);
@@ -290,6 +290,8 @@ public:
 
     bool supportsOplogStones() const final override;
 
+    bool supportsClusteredByTime() const final override;
+
     bool supportsReadConcernMajority() const final;
 
     // wiredtiger specific
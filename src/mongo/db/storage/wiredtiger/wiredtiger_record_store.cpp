@@ -43,6 +43,7 @@
 #include "mongo/base/checked_cast.h"
 #include "mongo/base/static_assert.h"
 #include "mongo/bson/util/builder.h"
+#include "mongo/db/bytes_read_tracker.h"
 #include "mongo/db/catalog/validate_results.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -53,6 +54,7 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_recovery.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/clustered_by_time.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/wiredtiger/oplog_stone_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_cursor_helpers.h"
@@ -668,6 +670,7 @@ public:
 
         WT_ITEM value;
         invariantWTOK(_cursor->get_value(_cursor, &value));
+        BytesReadTracker::get(_opCtx).incrementDocBytesRead(value.size);
 
         return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
     }
@@ -813,6 +816,7 @@ WiredTigerRecordStore::WiredTigerRecordStore(WiredTigerKVEngine* kvEngine,
                     getGlobalReplSettings().usingReplSets() ||
                         repl::ReplSettings::shouldRecoverFromOplogAsStandalone())),
       _isOplog(NamespaceString::oplog(params.ns)),
+      _clusteredByTimeField(params.clusteredByTimeField),
       _cappedMaxSize(params.cappedMaxSize),
       _cappedMaxSizeSlack(std::min(params.cappedMaxSize / 10, int64_t(16 * 1024 * 1024))),
       _cappedMaxDocs(params.cappedMaxDocs),
@@ -1467,11 +1471,18 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
             if (!status.isOK())
                 return status.getStatus();
             record.id = status.getValue();
+        } else if (!_clusteredByTimeField.empty()) {
+            StatusWith<RecordId> status = _nextClusteredId(opCtx, c, record);
+            if (!status.isOK())
+                return status.getStatus();
+            record.id = status.getValue();
         } else {
             record.id = _nextId(opCtx);
         }
-        dassert(record.id > highestIdRecord.id);
-        highestIdRecord = record;
+        // The RecordIds of records clustered by time follow their times, not the insert order.
+        dassert(!_clusteredByTimeField.empty() || record.id > highestIdRecord.id);
+        if (record.id > highestIdRecord.id)
+            highestIdRecord = record;
     }
 
     for (size_t i = 0; i < nRecords; i++) {
@@ -1723,6 +1734,48 @@ Status WiredTigerRecordStore::truncate(OperationContext* opCtx) {
     return Status::OK();
 }
 
+void WiredTigerRecordStore::truncateRange(OperationContext* opCtx,
+                                          const RecordId& end,
+                                          long long numRecords,
+                                          long long dataSize) {
+    invariant(!_clusteredByTimeField.empty());
+
+    WiredTigerCursor startWrap(_uri, _tableId, true, opCtx);
+    WT_CURSOR* start = startWrap.get();
+    setKey(start, RecordId::min());
+    int cmp = 0;
+    int ret =
+        wiredTigerPrepareConflictRetry(opCtx, [&] { return start->search_near(start, &cmp); });
+    if (ret == 0 && cmp < 0) {
+        ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return start->next(start); });
+    }
+    // Nothing to truncate if the collection is empty or starts at or after 'end'.
+    if (ret == WT_NOTFOUND) {
+        return;
+    }
+    invariantWTOK(ret);
+    if (getKey(start) >= end) {
+        return;
+    }
+
+    // Position the stop cursor on the last record before 'end'. Such a record exists because the
+    // start cursor is on one.
+    WiredTigerCursor stopWrap(_uri, _tableId, true, opCtx);
+    WT_CURSOR* stop = stopWrap.get();
+    setKey(stop, end);
+    ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return stop->search_near(stop, &cmp); });
+    invariantWTOK(ret);
+    if (cmp >= 0) {
+        ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return stop->prev(stop); });
+        invariantWTOK(ret);
+    }
+
+    WT_SESSION* session = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
+    invariantWTOK(WT_OP_CHECK(session->truncate(session, nullptr, start, stop, nullptr)));
+    _changeNumRecords(opCtx, -numRecords);
+    _increaseDataSize(opCtx, -dataSize);
+}
+
 Status WiredTigerRecordStore::compact(OperationContext* opCtx) {
     dassert(opCtx->lockState()->isWriteLocked());
 
@@ -1921,6 +1974,34 @@ RecordId WiredTigerRecordStore::_nextId(OperationContext* opCtx) {
     return out;
 }
 
+StatusWith<RecordId> WiredTigerRecordStore::_nextClusteredId(OperationContext* opCtx,
+                                                             WT_CURSOR* cursor,
+                                                             const Record& record) {
+    auto swTime = clustered_by_time::extractTime(
+        _clusteredByTimeField, record.data.data(), record.data.size());
+    if (!swTime.isOK())
+        return swTime.getStatus();
+
+    // Most inserts get a free RecordId on the first attempt. A RecordId that is taken by a record
+    // this snapshot cannot see surfaces as a write conflict on insert, and the retry draws a new
+    // tiebreak.
+    for (int64_t attempt = 0; attempt <= clustered_by_time::kTiebreakMask; ++attempt) {
+        auto swId = clustered_by_time::makeRecordId(swTime.getValue(),
+                                                    _clusteredTiebreak.fetchAndAdd(1));
+        if (!swId.isOK())
+            return swId.getStatus();
+
+        setKey(cursor, swId.getValue());
+        int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return cursor->search(cursor); });
+        if (ret == WT_NOTFOUND)
+            return swId;
+        invariantWTOK(ret);
+    }
+
+    return Status(ErrorCodes::BadValue,
+                  str::stream() << "too many documents with the same " << _clusteredByTimeField);
+}
+
 WiredTigerRecoveryUnit* WiredTigerRecordStore::_getRecoveryUnit(OperationContext* opCtx) {
     return checked_cast<WiredTigerRecoveryUnit*>(opCtx->recoveryUnit());
 }
@@ -2195,6 +2276,7 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
 
     WT_ITEM value;
     invariantWTOK(c->get_value(c, &value));
+    BytesReadTracker::get(_opCtx).incrementDocBytesRead(value.size);
 
     _lastReturnedId = id;
     return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
@@ -2226,6 +2308,7 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordI
 
     WT_ITEM value;
     invariantWTOK(c->get_value(c, &value));
+    BytesReadTracker::get(_opCtx).incrementDocBytesRead(value.size);
 
     _lastReturnedId = id;
     _eof = false;
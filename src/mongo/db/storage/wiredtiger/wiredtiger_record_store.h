@@ -114,6 +114,8 @@ public:
         WiredTigerSizeStorer* sizeStorer;
         bool isReadOnly;
         bool tracksSizeAdjustments;
+        // The Date field that keys the records, if the collection is clustered by time.
+        std::string clusteredByTimeField;
     };
 
     WiredTigerRecordStore(WiredTigerKVEngine* kvEngine, OperationContext* opCtx, Params params);
@@ -172,6 +174,11 @@ public:
 
     virtual Status truncate(OperationContext* opCtx);
 
+    void truncateRange(OperationContext* opCtx,
+                       const RecordId& end,
+                       long long numRecords,
+                       long long dataSize) override;
+
     virtual bool compactSupported() const {
         return !_isEphemeral;
     }
@@ -298,6 +305,15 @@ private:
                           size_t nRecords);
 
     RecordId _nextId(OperationContext* opCtx);
+
+    /**
+     * Returns an unused RecordId for 'record' in a collection clustered by time, derived from the
+     * Date in its clustering field. 'cursor' is used to check that the RecordId is free.
+     */
+    StatusWith<RecordId> _nextClusteredId(OperationContext* opCtx,
+                                          WT_CURSOR* cursor,
+                                          const Record& record);
+
     bool cappedAndNeedDelete() const;
     RecordData _getData(const WiredTigerCursor& cursor) const;
 
@@ -361,6 +377,10 @@ private:
     const bool _isLogged;
     // True if the namespace of this record store starts with "local.oplog.", and false otherwise.
     const bool _isOplog;
+    // The Date field that keys the records, or empty if the collection is not clustered by time.
+    const std::string _clusteredByTimeField;
+    // Disambiguates the RecordIds of records with the same clustering time.
+    AtomicWord<int64_t> _clusteredTiebreak{0};
     int64_t _cappedMaxSize;
     const int64_t _cappedMaxSizeSlack;  // when to start applying backpressure
     const int64_t _cappedMaxDocs;
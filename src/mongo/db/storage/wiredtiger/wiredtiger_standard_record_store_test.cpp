@@ -44,6 +44,7 @@
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/clustered_by_time.h"
 #include "mongo/db/storage/kv/kv_engine_test_harness.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/db/storage/record_store_test_harness.h"
@@ -96,6 +97,11 @@ public:
     }
 
     virtual std::unique_ptr<RecordStore> newNonCappedRecordStore(const std::string& ns) {
+        return newNonCappedRecordStore(ns, CollectionOptions());
+    }
+
+    std::unique_ptr<RecordStore> newNonCappedRecordStore(const std::string& ns,
+                                                         const CollectionOptions& options) {
         WiredTigerRecoveryUnit* ru =
             checked_cast<WiredTigerRecoveryUnit*>(_engine.newRecoveryUnit());
         OperationContextNoop opCtx(ru);
@@ -103,7 +109,7 @@ public:
 
         const bool prefixed = false;
         StatusWith<std::string> result = WiredTigerRecordStore::generateCreateString(
-            kWiredTigerEngineName, ns, CollectionOptions(), "", prefixed);
+            kWiredTigerEngineName, ns, options, "", prefixed);
         ASSERT_TRUE(result.isOK());
         std::string config = result.getValue();
 
@@ -125,6 +131,7 @@ public:
         params.cappedCallback = nullptr;
         params.sizeStorer = nullptr;
         params.tracksSizeAdjustments = true;
+        params.clusteredByTimeField = options.clusteredByTime;
 
         auto ret = std::make_unique<StandardWiredTigerRecordStore>(&_engine, &opCtx, params);
         ret->postConstructorInit(&opCtx);
@@ -202,6 +209,88 @@ MONGO_INITIALIZER(RegisterRecordStoreHarnessFactory)(InitializerContext* const)
     return Status::OK();
 }
 
+TEST(WiredTigerRecordStoreTest, ClusteredByTimeTruncateRange) {
+    WiredTigerHarnessHelper harnessHelper;
+    CollectionOptions options;
+    options.clusteredByTime = "t";
+    unique_ptr<RecordStore> rs(harnessHelper.newNonCappedRecordStore("a.b", options));
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+
+    auto timeOfDoc = [](int i) { return Date_t::fromMillisSinceEpoch(i * 1000); };
+    auto readIds = [&] {
+        std::vector<RecordId> ids;
+        auto cursor = rs->getCursor(opCtx.get());
+        while (auto record = cursor->next()) {
+            ids.push_back(record->id);
+        }
+        return ids;
+    };
+
+    // Insert the documents out of time order, each at its own timestamp. The records are ordered
+    // by time regardless.
+    const int numDocs = 5;
+    long long docSize = 0;
+    int nextTimestamp = 1;
+    for (int i : {3, 1, 5, 2, 4}) {
+        BSONObj doc = BSON("_id" << i << "t" << timeOfDoc(i));
+        docSize = doc.objsize();
+        WriteUnitOfWork wuow(opCtx.get());
+        ASSERT_OK(opCtx->recoveryUnit()->setTimestamp(Timestamp(nextTimestamp++, 1)));
+        auto id = unittest::assertGet(
+            rs->insertRecord(opCtx.get(), doc.objdata(), doc.objsize(), Timestamp()));
+        ASSERT_EQ(timeOfDoc(i), clustered_by_time::timeOf(id));
+        wuow.commit();
+    }
+    const auto idsBeforeTruncate = readIds();
+    ASSERT_EQ(static_cast<size_t>(numDocs), idsBeforeTruncate.size());
+    for (int i = 0; i < numDocs; ++i) {
+        ASSERT_EQ(timeOfDoc(i + 1), clustered_by_time::timeOf(idsBeforeTruncate[i]));
+    }
+
+    // A document without a Date in the time field cannot be clustered.
+    {
+        BSONObj doc = BSON("_id" << 0 << "t" << 1);
+        WriteUnitOfWork wuow(opCtx.get());
+        ASSERT_NOT_OK(
+            rs->insertRecord(opCtx.get(), doc.objdata(), doc.objsize(), Timestamp()).getStatus());
+    }
+
+    // Nothing is older than the first document.
+    const Timestamp truncateTimestamp(nextTimestamp++, 1);
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        ASSERT_OK(opCtx->recoveryUnit()->setTimestamp(truncateTimestamp));
+        rs->truncateRange(opCtx.get(), clustered_by_time::minRecordId(timeOfDoc(1)), 0, 0);
+        wuow.commit();
+    }
+    ASSERT_EQ(numDocs, rs->numRecords(opCtx.get()));
+
+    // Remove the two oldest documents.
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        ASSERT_OK(opCtx->recoveryUnit()->setTimestamp(truncateTimestamp));
+        rs->truncateRange(
+            opCtx.get(), clustered_by_time::minRecordId(timeOfDoc(3)), 2, 2 * docSize);
+        wuow.commit();
+    }
+    ASSERT_EQ(numDocs - 2, rs->numRecords(opCtx.get()));
+    ASSERT_EQ((numDocs - 2) * docSize, rs->dataSize(opCtx.get()));
+    ASSERT(std::vector<RecordId>(idsBeforeTruncate.begin() + 2, idsBeforeTruncate.end()) ==
+           readIds());
+
+    // Reads at a timestamp before the truncate still see the removed records.
+    opCtx->recoveryUnit()->abandonSnapshot();
+    opCtx->recoveryUnit()->setTimestampReadSource(RecoveryUnit::ReadSource::kProvided,
+                                                  Timestamp(truncateTimestamp.getSecs() - 1, 1));
+    ASSERT(idsBeforeTruncate == readIds());
+
+    // The second insert was the document with the oldest time.
+    opCtx->recoveryUnit()->abandonSnapshot();
+    opCtx->recoveryUnit()->setTimestampReadSource(RecoveryUnit::ReadSource::kProvided,
+                                                  Timestamp(2, 1));
+    ASSERT(std::vector<RecordId>({idsBeforeTruncate[0], idsBeforeTruncate[2]}) == readIds());
+}
+
 TEST(WiredTigerRecordStoreTest, StorageSizeStatisticsDisabled) {
     WiredTigerHarnessHelper harnessHelper("statistics=(none)");
     unique_ptr<RecordStore> rs(harnessHelper.newNonCappedRecordStore("a.b"));
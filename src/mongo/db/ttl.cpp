@@ -33,14 +33,19 @@
 
 #include "mongo/db/ttl.h"
 
+#include <map>
+#include <set>
+
 #include "mongo/base/counter.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_name.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog/truncate_clustered_range.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands/fsync_locked.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
@@ -50,13 +55,17 @@
 #include "mongo/db/ops/insert.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/clustered_by_time.h"
 #include "mongo/db/storage/durable_catalog.h"
 #include "mongo/db/ttl_collection_cache.h"
 #include "mongo/db/ttl_gen.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -72,10 +81,106 @@ MONGO_FAIL_POINT_DEFINE(hangTTLMonitorWithLock);
 
 Counter64 ttlPasses;
 Counter64 ttlDeletedDocuments;
+Counter64 ttlTruncatedRanges;
 
 ServerStatusMetricField<Counter64> ttlPassesDisplay("ttl.passes", &ttlPasses);
 ServerStatusMetricField<Counter64> ttlDeletedDocumentsDisplay("ttl.deletedDocuments",
                                                               &ttlDeletedDocuments);
+ServerStatusMetricField<Counter64> ttlTruncatedRangesDisplay("ttl.truncatedRanges",
+                                                             &ttlTruncatedRanges);
+
+namespace {
+
+/**
+ * Statistics about the deletions by each TTL index, reported in the "ttl" serverStatus section.
+ */
+class TTLIndexStats {
+public:
+    /**
+     * Records the outcome of deleting the expired documents of an index. 'lag' is how long the
+     * oldest expired document had been expired when the deletion started.
+     */
+    void record(const NamespaceString& nss,
+                StringData indexName,
+                long long numDeleted,
+                Milliseconds duration,
+                Milliseconds lag) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        auto& entry = _entries[{nss.ns(), indexName.toString()}];
+        entry.deletedDocuments += numDeleted;
+        entry.lastPassDeletedDocuments = numDeleted;
+        entry.lastPassDuration = duration;
+        entry.lag = lag;
+        entry.lastPassEnd = Date_t::now();
+    }
+
+    /**
+     * Discards the statistics of the indexes that are no longer TTL indexes.
+     */
+    void retain(const std::vector<std::pair<NamespaceString, BSONObj>>& ttlIndexes) {
+        std::set<std::pair<std::string, std::string>> keep;
+        for (auto&& [nss, spec] : ttlIndexes) {
+            keep.emplace(nss.ns(), spec["name"].str());
+        }
+
+        stdx::lock_guard<Latch> lk(_mutex);
+        for (auto it = _entries.begin(); it != _entries.end();) {
+            it = keep.count(it->first) ? std::next(it) : _entries.erase(it);
+        }
+    }
+
+    BSONObj toBSON() const {
+        BSONObjBuilder builder;
+        BSONArrayBuilder indexes(builder.subarrayStart("indexes"));
+        stdx::lock_guard<Latch> lk(_mutex);
+        for (auto&& [key, entry] : _entries) {
+            BSONObjBuilder index(indexes.subobjStart());
+            index.append("ns", key.first);
+            index.append("name", key.second);
+            index.append("deletedDocuments", entry.deletedDocuments);
+            index.append("lagMillis", durationCount<Milliseconds>(entry.lag));
+            BSONObjBuilder lastPass(index.subobjStart("lastPass"));
+            lastPass.append("deletedDocuments", entry.lastPassDeletedDocuments);
+            lastPass.append("durationMillis", durationCount<Milliseconds>(entry.lastPassDuration));
+            lastPass.append("end", entry.lastPassEnd);
+        }
+        indexes.done();
+        return builder.obj();
+    }
+
+private:
+    struct Entry {
+        long long deletedDocuments = 0;
+        long long lastPassDeletedDocuments = 0;
+        Milliseconds lastPassDuration{0};
+        Milliseconds lag{0};
+        Date_t lastPassEnd;
+    };
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("TTLIndexStats::_mutex");
+
+    // Keyed by namespace and index name.
+    std::map<std::pair<std::string, std::string>, Entry> _entries;
+};
+
+TTLIndexStats ttlIndexStats;
+
+class TTLServerStatusSection : public ServerStatusSection {
+public:
+    TTLServerStatusSection() : ServerStatusSection("ttl") {}
+
+    bool includeByDefault() const override {
+        // The section grows with the number of TTL indexes.
+        return false;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        return ttlIndexStats.toBSON();
+    }
+} ttlServerStatusSection;
+
+}  // namespace
 
 class TTLMonitor : public BackgroundJob {
 public:
@@ -238,9 +343,148 @@ private:
             ttlIndexes.push_back(std::make_pair(*nss, spec.getOwned()));
         }
 
+        ttlIndexStats.retain(ttlIndexes);
+
+        const int numThreads = ttlMonitorThreads.load();
+        if (numThreads > 1 && ttlIndexes.size() > 1) {
+            doTTLForCollectionsInParallel(ttlIndexes, numThreads);
+        } else {
+            doTTLForIndexes(&opCtx, ttlIndexes);
+        }
+
+        doTTLForClusteredCollections(&opCtx, ttlCollectionCache);
+    }
+
+    /**
+     * Removes the expired documents of every collection clustered by time that has an
+     * 'expireAfterSeconds' option, skipping over the collections that fail.
+     */
+    void doTTLForClusteredCollections(OperationContext* opCtx,
+                                      TTLCollectionCache& ttlCollectionCache) {
+        // Nodes of an older featureCompatibilityVersion may not understand the 'truncateRange'
+        // oplog entries.
+        if (!serverGlobalParams.featureCompatibility.isVersionInitialized() ||
+            !serverGlobalParams.featureCompatibility.isGreaterThanOrEqualTo(
+                ServerGlobalParams::FeatureCompatibility::Version::kVersion49)) {
+            return;
+        }
+
+        for (const auto& uuid : ttlCollectionCache.getClusteredCollections()) {
+            const CollectionCatalog& collectionCatalog = CollectionCatalog::get(opCtx);
+            if (collectionCatalog.isCollectionAwaitingVisibility(uuid)) {
+                continue;
+            }
+
+            auto nss = collectionCatalog.lookupNSSByUUID(opCtx, uuid);
+            if (!nss) {
+                ttlCollectionCache.deregisterClusteredCollection(uuid);
+                continue;
+            }
+
+            try {
+                doTTLForClusteredCollection(opCtx, *nss, uuid);
+            } catch (const ExceptionForCat<ErrorCategory::Interruption>&) {
+                LOGV2_WARNING(5121510,
+                              "TTLMonitor was interrupted, waiting before doing another pass",
+                              "wait"_attr = Milliseconds(Seconds(ttlMonitorSleepSecs.load())));
+                return;
+            } catch (const DBException& dbex) {
+                LOGV2_ERROR(5121511,
+                            "Error processing collection clustered by time",
+                            logAttrs(*nss),
+                            "error"_attr = dbex);
+                continue;
+            }
+        }
+    }
+
+    /**
+     * Removes the expired documents of a collection clustered by time with range truncates. Each
+     * truncate takes the collection lock in exclusive mode and removes about
+     * 'ttlMonitorTruncateBatchSize' documents, so that writers are not blocked for long.
+     */
+    void doTTLForClusteredCollection(OperationContext* opCtx,
+                                     const NamespaceString& collectionNSS,
+                                     const UUID& uuid) {
+        if (collectionNSS.isDropPendingNamespace() ||
+            collectionNSS.isTemporaryReshardingCollection() ||
+            !userAllowedWriteNS(collectionNSS).isOK()) {
+            return;
+        }
+
+        // Read the expiry and the oldest clustering time without blocking writers.
+        Date_t expirationTime;
+        Milliseconds lag{0};
+        {
+            AutoGetCollection collection(opCtx, collectionNSS, MODE_IS);
+            if (!collection || collection->uuid() != uuid) {
+                return;
+            }
+
+            auto options = DurableCatalog::get(opCtx)->getCollectionOptions(
+                opCtx, collection->getCatalogId());
+            if (!options.expireAfterSeconds) {
+                TTLCollectionCache::get(opCtx->getServiceContext())
+                    .deregisterClusteredCollection(uuid);
+                return;
+            }
+            expirationTime = Date_t::now() - Seconds(*options.expireAfterSeconds);
+
+            auto cursor = collection->getCursor(opCtx);
+            auto oldest = cursor->next();
+            if (!oldest || clustered_by_time::timeOf(oldest->id) >= expirationTime) {
+                return;
+            }
+            lag = expirationTime - clustered_by_time::timeOf(oldest->id);
+        }
+
+        Timer timer;
+        long long numDeleted = 0;
+        while (true) {
+            opCtx->checkForInterrupt();
+
+            auto result = writeConflictRetry(opCtx, "ttlTruncateRange", collectionNSS.ns(), [&] {
+                AutoGetCollection collection(opCtx, collectionNSS, MODE_X);
+                if (!collection || collection->uuid() != uuid ||
+                    !repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx,
+                                                                                  collectionNSS)) {
+                    return TruncateClusteredRangeResult();
+                }
+                return truncateClusteredRange(opCtx,
+                                              collection.getCollection(),
+                                              expirationTime,
+                                              ttlMonitorTruncateBatchSize.load());
+            });
+            if (result.numRemoved == 0) {
+                break;
+            }
+
+            numDeleted += result.numRemoved;
+            ttlDeletedDocuments.increment(result.numRemoved);
+            ttlTruncatedRanges.increment();
+            if (result.removedBefore >= expirationTime) {
+                break;
+            }
+        }
+
+        LOGV2_DEBUG(5121512,
+                    1,
+                    "Truncated expired documents of a collection clustered by time",
+                    logAttrs(collectionNSS),
+                    "numDeleted"_attr = numDeleted,
+                    "lag"_attr = lag,
+                    "duration"_attr = Milliseconds(timer.millis()));
+    }
+
+    /**
+     * Performs doTTLForIndex() on each of 'ttlIndexes', in order, skipping over the indexes that
+     * fail. Stops if interrupted.
+     */
+    void doTTLForIndexes(OperationContext* opCtx,
+                         const std::vector<std::pair<NamespaceString, BSONObj>>& ttlIndexes) {
         for (const auto& it : ttlIndexes) {
             try {
-                doTTLForIndex(&opCtx, it.first, it.second);
+                doTTLForIndex(opCtx, it.first, it.second);
             } catch (const ExceptionForCat<ErrorCategory::Interruption>&) {
                 LOGV2_WARNING(22537,
                               "TTLMonitor was interrupted, waiting {ttlMonitorSleepSecs_load} "
@@ -260,6 +504,48 @@ private:
         }
     }
 
+    /**
+     * Deletes the expired documents of different collections on up to 'numThreads' threads. The
+     * TTL indexes of one collection are processed in order on a single thread, so that their
+     * deletions do not conflict with each other.
+     */
+    void doTTLForCollectionsInParallel(
+        const std::vector<std::pair<NamespaceString, BSONObj>>& ttlIndexes, int numThreads) {
+        std::map<NamespaceString, std::vector<std::pair<NamespaceString, BSONObj>>>
+            ttlIndexesByCollection;
+        for (const auto& it : ttlIndexes) {
+            ttlIndexesByCollection[it.first].push_back(it);
+        }
+
+        ThreadPool::Options options;
+        options.poolName = "TTLMonitor";
+        options.minThreads = 0;
+        options.maxThreads = numThreads;
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+            AuthorizationSession::get(cc())->grantInternalAuthorization(&cc());
+
+            stdx::lock_guard<Client> lk(cc());
+            cc().setSystemOperationKillableByStepdown(lk);
+        };
+        ThreadPool pool(options);
+        pool.startup();
+
+        for (const auto& [nss, collectionTTLIndexes] : ttlIndexesByCollection) {
+            pool.schedule([this, &collectionTTLIndexes = collectionTTLIndexes](Status status) {
+                if (!status.isOK()) {
+                    return;
+                }
+                auto opCtx = cc().makeOperationContext();
+                doTTLForIndexes(opCtx.get(), collectionTTLIndexes);
+            });
+        }
+
+        // Runs the tasks that were scheduled before returning.
+        pool.shutdown();
+        pool.join();
+    }
+
     /**
      * Removes documents from the collection using the specified TTL index after a sufficient amount
      * of time has passed according to its expiry specification.
@@ -355,6 +641,31 @@ private:
             ? InternalPlanner::Direction::FORWARD
             : InternalPlanner::Direction::BACKWARD;
 
+        // Seek to the oldest expired key first. Most passes find nothing expired in most indexes,
+        // and the seek lets them skip planning the delete, which costs more than the seek. Where
+        // there are expired documents, the delete's index scan starts on the same, now cached,
+        // page, and the key tells how far behind the deletions are.
+        Milliseconds lag{0};
+        {
+            auto oldestExpiredExec =
+                InternalPlanner::indexScan(opCtx,
+                                           &collection.getCollection(),
+                                           desc,
+                                           startKey,
+                                           endKey,
+                                           BoundInclusion::kIncludeBothStartAndEndKeys,
+                                           PlanYieldPolicy::YieldPolicy::NO_YIELD,
+                                           direction);
+            BSONObj oldestExpiredKey;
+            if (oldestExpiredExec->getNext(&oldestExpiredKey, nullptr) != PlanExecutor::ADVANCED) {
+                ttlIndexStats.record(collectionNSS, desc->indexName(), 0, Milliseconds(0), lag);
+                return;
+            }
+            if (oldestExpiredKey.firstElement().type() == BSONType::Date) {
+                lag = expirationTime - oldestExpiredKey.firstElement().date();
+            }
+        }
+
         // We need to pass into the DeleteStageParams (below) a CanonicalQuery with a BSONObj that
         // queries for the expired documents correctly so that we do not delete documents that are
         // not actually expired when our snapshot changes during deletion.
@@ -370,6 +681,7 @@ private:
         params->isMulti = true;
         params->canonicalQuery = canonicalQuery.getValue().get();
 
+        Timer timer;
         auto exec =
             InternalPlanner::deleteWithIndexScan(opCtx,
                                                  &collection.getCollection(),
@@ -384,6 +696,8 @@ private:
         try {
             const auto numDeleted = exec->executeDelete();
             ttlDeletedDocuments.increment(numDeleted);
+            ttlIndexStats.record(
+                collectionNSS, desc->indexName(), numDeleted, Milliseconds(timer.millis()), lag);
             LOGV2_DEBUG(22536, 1, "deleted: {numDeleted}", "numDeleted"_attr = numDeleted);
         } catch (const ExceptionFor<ErrorCodes::QueryPlanKilled>&) {
             // It is expected that a collection drop can kill a query plan while the TTL monitor is
@@ -74,4 +74,24 @@ std::vector<std::pair<UUID, std::string>> TTLCollectionCache::getTTLInfos() {
     stdx::lock_guard<Latch> lock(_ttlInfosLock);
     return _ttlInfos;
 }
+
+void TTLCollectionCache::registerClusteredCollection(const UUID& uuid) {
+    stdx::lock_guard<Latch> lock(_ttlInfosLock);
+    if (std::find(_clusteredCollections.begin(), _clusteredCollections.end(), uuid) ==
+        _clusteredCollections.end()) {
+        _clusteredCollections.push_back(uuid);
+    }
+}
+
+void TTLCollectionCache::deregisterClusteredCollection(const UUID& uuid) {
+    stdx::lock_guard<Latch> lock(_ttlInfosLock);
+    _clusteredCollections.erase(
+        std::remove(_clusteredCollections.begin(), _clusteredCollections.end(), uuid),
+        _clusteredCollections.end());
+}
+
+std::vector<UUID> TTLCollectionCache::getClusteredCollections() {
+    stdx::lock_guard<Latch> lock(_ttlInfosLock);
+    return _clusteredCollections;
+}
 };  // namespace mongo
@@ -51,8 +51,15 @@ public:
     void deregisterTTLInfo(const std::pair<UUID, std::string>& ttlInfo);
     std::vector<std::pair<UUID, std::string>> getTTLInfos();
 
+    // Collections clustered by time with an 'expireAfterSeconds' option, which expire documents
+    // without a TTL index. Registering a collection twice has no effect.
+    void registerClusteredCollection(const UUID& uuid);
+    void deregisterClusteredCollection(const UUID& uuid);
+    std::vector<UUID> getClusteredCollections();
+
 private:
     Mutex _ttlInfosLock = MONGO_MAKE_LATCH("TTLCollectionCache::_ttlInfosLock");
     std::vector<std::pair<UUID, std::string>> _ttlInfos;  // <CollectionUUID, IndexName>
+    std::vector<UUID> _clusteredCollections;
 };
 }  // namespace mongo
@@ -583,6 +583,58 @@ public:
     }
 };
 
+// The same AND as above, but keeping only the record ids of the children's results. The buffered
+// data then stays far below the limit, and the stage outputs the intersection.
+class QueryStageAndHashThreeLeafMiddleChildLargeKeysRecordIdsOnly : public QueryStageAndBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        CollectionPtr coll = ctx.getCollection();
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, nss());
+            wuow.commit();
+        }
+
+        std::string big(512, 'a');
+        for (int i = 0; i < 50; ++i) {
+            insert(BSON("foo" << i << "bar" << i << "baz" << i << "big" << big));
+        }
+
+        addIndex(BSON("foo" << 1));
+        addIndex(BSON("bar" << 1 << "big" << 1));
+        addIndex(BSON("baz" << 1));
+
+        WorkingSet ws;
+        auto ah = std::make_unique<AndHashStage>(_expCtx.get(), &ws, true /* recordIdsOnly */);
+
+        // Foo <= 20
+        auto params = makeIndexScanParams(&_opCtx, getIndex(BSON("foo" << 1), coll));
+        params.bounds.startKey = BSON("" << 20);
+        params.direction = -1;
+        ah->addChild(std::make_unique<IndexScan>(_expCtx.get(), coll, params, &ws, nullptr));
+
+        // Bar >= 10
+        params = makeIndexScanParams(&_opCtx, getIndex(BSON("bar" << 1 << "big" << 1), coll));
+        params.bounds.startKey = BSON("" << 10 << "" << big);
+        ah->addChild(std::make_unique<IndexScan>(_expCtx.get(), coll, params, &ws, nullptr));
+
+        // 5 <= baz <= 15
+        params = makeIndexScanParams(&_opCtx, getIndex(BSON("baz" << 1), coll));
+        params.bounds.startKey = BSON("" << 5);
+        params.bounds.endKey = BSON("" << 15);
+        ah->addChild(std::make_unique<IndexScan>(_expCtx.get(), coll, params, &ws, nullptr));
+
+        // foo == bar == baz, and foo<=20, bar>=10, 5<=baz<=15, so our values are:
+        // foo == 10, 11, 12, 13, 14, 15.
+        ASSERT_EQUALS(6, countResults(ah.get()));
+
+        // Only the record ids for 10 <= foo == bar <= 20 remained buffered.
+        ASSERT_LTE(ah->getMemUsage(), 11 * sizeof(RecordId) + 8);
+    }
+};
+
 // An AND with an index scan that returns nothing.
 class QueryStageAndHashWithNothing : public QueryStageAndBase {
 public:
@@ -1332,6 +1384,7 @@ public:
         add<QueryStageAndHashTwoLeafLastChildLargeKeys>();
         add<QueryStageAndHashThreeLeaf>();
         add<QueryStageAndHashThreeLeafMiddleChildLargeKeys>();
+        add<QueryStageAndHashThreeLeafMiddleChildLargeKeysRecordIdsOnly>();
         add<QueryStageAndHashWithNothing>();
         add<QueryStageAndHashProducesNothing>();
         add<QueryStageAndHashDeleteLookaheadDuringYield>();
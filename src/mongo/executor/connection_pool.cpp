@@ -51,7 +51,7 @@
 using namespace fmt::literals;
 
 // One interesting implementation note herein concerns how setup() and
-// refresh() are invoked outside of the global lock, but setTimeout is not.
+// refresh() are invoked outside of the specific pool's lock, but setTimeout is not.
 // This implementation detail simplifies mocks, allowing them to return
 // synchronously sometimes, whereas having timeouts fire instantly adds little
 // value. In practice, dumping the locks is always safe (because we restrict
@@ -241,12 +241,20 @@ public:
     auto guardCallback(Callback&& cb) {
         return
             [this, cb = std::forward<Callback>(cb), anchor = shared_from_this()](auto&&... args) {
-                stdx::lock_guard lk(_parent->_mutex);
+                stdx::lock_guard lk(_mutex);
                 cb(std::forward<decltype(args)>(args)...);
                 updateState();
             };
     }
 
+    /**
+     * Acquires the lock guarding this pool's state. Every member function below other than
+     * host() and fassertSSLModeIs() must be called with this lock held.
+     */
+    stdx::unique_lock<Latch> lock() const {
+        return stdx::unique_lock<Latch>(_mutex);
+    }
+
     SpecificPool(std::shared_ptr<ConnectionPool> parent,
                  const HostAndPort& hostAndPort,
                  transport::ConnectSSLMode sslMode);
@@ -268,11 +276,17 @@ public:
     void updateState();
 
     /**
-     * Gets a connection from the specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Gets a connection from the specific pool.
      */
     Future<ConnectionHandle> getConnection(Milliseconds timeout);
 
+    /**
+     * Applies the parts of a HostGroupState returned by updateController() which concern pools
+     * other than this one. This must be called without holding this pool's lock, since it may
+     * need to acquire the locks of the other pools in the group.
+     */
+    void updateHostGroup(const HostGroupState& hostGroup);
+
     /**
      * Triggers the shutdown procedure. This function sets isShutdown to true
      * and calls processFailure below with the status provided. This immediately removes this pool
@@ -320,6 +334,20 @@ public:
      */
     size_t requestsPending() const;
 
+    /**
+     * Returns the distribution of time that requests spent waiting for a connection.
+     */
+    const ConnectionWaitTimeHistogram& acquisitionWaitTimes() const {
+        return _acquisitionWaitTimes;
+    }
+
+    /**
+     * Returns true if this pool has been shut down and removed from its ConnectionPool.
+     */
+    bool isShutdown() const {
+        return _health.isShutdown;
+    }
+
     /**
      * Returns the HostAndPort for this pool.
      */
@@ -352,10 +380,14 @@ private:
     using OwnedConnection = std::shared_ptr<ConnectionInterface>;
     using OwnershipPool = stdx::unordered_map<ConnectionInterface*, OwnedConnection>;
     using LRUOwnershipPool = LRUCache<OwnershipPool::key_type, OwnershipPool::mapped_type>;
-    using Request = std::pair<Date_t, Promise<ConnectionHandle>>;
+    struct Request {
+        Date_t expiration;
+        Date_t requestedAt;
+        Promise<ConnectionHandle> promise;
+    };
     struct RequestComparator {
         bool operator()(const Request& a, const Request& b) {
-            return a.first > b.first;
+            return a.expiration > b.expiration;
         }
     };
 
@@ -390,8 +422,9 @@ private:
     // Update the event timer for this host pool
     void updateEventTimer();
 
-    // Update the controller and potentially change the controls
-    void updateController();
+    // Update the controller and potentially change the controls. Returns the group state so that
+    // the caller can apply it to the other pools in the group once this pool's lock is released.
+    HostGroupState updateController();
 
 private:
     const std::shared_ptr<ConnectionPool> _parent;
@@ -401,6 +434,11 @@ private:
 
     const PoolId _id;
 
+    // Guards all of the mutable state below. Pools for different hosts never hold each other's
+    // locks at the same time.
+    mutable Mutex _mutex = MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(1),
+                                            "ExecutorConnectionPool::SpecificPool::_mutex");
+
     LRUOwnershipPool _readyPool;
     OwnershipPool _processingPool;
     OwnershipPool _droppedProcessingPool;
@@ -426,6 +464,8 @@ private:
 
     size_t _created = 0;
 
+    ConnectionWaitTimeHistogram _acquisitionWaitTimes;
+
     transport::Session::TagMask _tags = transport::Session::kPending;
 
     HostHealth _health;
@@ -442,6 +482,7 @@ auto ConnectionPool::SpecificPool::make(std::shared_ptr<ConnectionPool> parent,
     controller.addHost(pool->_id, hostAndPort);
 
     // Set our timers and health
+    stdx::lock_guard lk(pool->_mutex);
     pool->updateEventTimer();
     pool->updateHealth();
     return pool;
@@ -476,40 +517,83 @@ ConnectionPool::~ConnectionPool() {
     shutdown();
 }
 
+std::vector<std::shared_ptr<ConnectionPool::SpecificPool>> ConnectionPool::_getPools() const {
+    stdx::lock_guard lk(_mutex);
+
+    std::vector<std::shared_ptr<SpecificPool>> pools;
+    pools.reserve(_pools.size());
+    for (const auto& pair : _pools) {
+        pools.push_back(pair.second);
+    }
+    return pools;
+}
+
+std::shared_ptr<ConnectionPool::SpecificPool> ConnectionPool::_getOrMakePool(
+    const HostAndPort& hostAndPort, transport::ConnectSSLMode sslMode) {
+    {
+        stdx::lock_guard lk(_mutex);
+        if (auto iter = _pools.find(hostAndPort); iter != _pools.end()) {
+            return iter->second;
+        }
+    }
+
+    // Construct the pool outside of _mutex, since initializing it informs the controller and arms
+    // its event timer.
+    auto pool = SpecificPool::make(shared_from_this(), hostAndPort, sslMode);
+
+    auto existing = [&]() -> std::shared_ptr<SpecificPool> {
+        stdx::lock_guard lk(_mutex);
+        auto [iter, inserted] = _pools.emplace(hostAndPort, pool);
+        return inserted ? nullptr : iter->second;
+    }();
+
+    if (!existing) {
+        return pool;
+    }
+
+    // Another thread published a pool for this host first. Our pool has never been visible to
+    // anyone else, so retire it and use the winner.
+    {
+        auto lk = pool->lock();
+        pool->triggerShutdown(
+            Status(ErrorCodes::ConnectionPoolExpired, "Superseded by a concurrently created pool"));
+    }
+    return existing;
+}
+
 void ConnectionPool::shutdown() {
     _factory->shutdown();
 
     // Grab all current pools (under the lock)
-    auto pools = [&] {
-        stdx::lock_guard lk(_mutex);
-        return _pools;
-    }();
+    auto pools = _getPools();
 
-    for (const auto& pair : pools) {
-        stdx::lock_guard lk(_mutex);
-        pair.second->triggerShutdown(
+    for (const auto& pool : pools) {
+        auto lk = pool->lock();
+        pool->triggerShutdown(
             Status(ErrorCodes::ShutdownInProgress, "Shutting down the connection pool"));
     }
 }
 
 void ConnectionPool::dropConnections(const HostAndPort& hostAndPort) {
-    stdx::lock_guard lk(_mutex);
-
-    auto iter = _pools.find(hostAndPort);
+    auto pool = [&]() -> std::shared_ptr<SpecificPool> {
+        stdx::lock_guard lk(_mutex);
+        auto iter = _pools.find(hostAndPort);
+        return iter == _pools.end() ? nullptr : iter->second;
+    }();
 
-    if (iter == _pools.end())
+    if (!pool)
         return;
 
-    auto& pool = iter->second;
+    auto lk = pool->lock();
     pool->triggerShutdown(
         Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"));
 }
 
 void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
-    stdx::lock_guard lk(_mutex);
+    auto pools = _getPools();
 
-    for (const auto& pair : _pools) {
-        auto& pool = pair.second;
+    for (const auto& pool : pools) {
+        auto lk = pool->lock();
 
         if (pool->matchesTags(tags))
             continue;
@@ -522,14 +606,16 @@ void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
 void ConnectionPool::mutateTags(
     const HostAndPort& hostAndPort,
     const std::function<transport::Session::TagMask(transport::Session::TagMask)>& mutateFunc) {
-    stdx::lock_guard lk(_mutex);
-
-    auto iter = _pools.find(hostAndPort);
+    auto pool = [&]() -> std::shared_ptr<SpecificPool> {
+        stdx::lock_guard lk(_mutex);
+        auto iter = _pools.find(hostAndPort);
+        return iter == _pools.end() ? nullptr : iter->second;
+    }();
 
-    if (iter == _pools.end())
+    if (!pool)
         return;
 
-    auto pool = iter->second;
+    auto lk = pool->lock();
     pool->mutateTags(mutateFunc);
 }
 
@@ -548,46 +634,55 @@ void ConnectionPool::get_forTest(const HostAndPort& hostAndPort,
 SemiFuture<ConnectionPool::ConnectionHandle> ConnectionPool::get(const HostAndPort& hostAndPort,
                                                                  transport::ConnectSSLMode sslMode,
                                                                  Milliseconds timeout) {
-    stdx::lock_guard lk(_mutex);
-
-    auto& pool = _pools[hostAndPort];
-    if (!pool) {
-        pool = SpecificPool::make(shared_from_this(), hostAndPort, sslMode);
-    } else {
+    while (true) {
+        auto pool = _getOrMakePool(hostAndPort, sslMode);
+        invariant(pool);
         pool->fassertSSLModeIs(sslMode);
-    }
 
-    invariant(pool);
+        auto lk = pool->lock();
+        if (pool->isShutdown()) {
+            // The pool was delisted between looking it up and locking it, so look again.
+            continue;
+        }
 
-    auto connFuture = pool->getConnection(timeout);
-    pool->updateState();
+        auto connFuture = pool->getConnection(timeout);
+        pool->updateState();
 
-    return std::move(connFuture).semi();
+        return std::move(connFuture).semi();
+    }
 }
 
 void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
-    stdx::lock_guard lk(_mutex);
+    auto pools = _getPools();
 
-    for (const auto& kv : _pools) {
-        HostAndPort host = kv.first;
+    for (const auto& pool : pools) {
+        auto lk = pool->lock();
+        if (pool->isShutdown()) {
+            continue;
+        }
 
-        auto& pool = kv.second;
         ConnectionStatsPer hostStats{pool->inUseConnections(),
                                      pool->availableConnections(),
                                      pool->createdConnections(),
                                      pool->refreshingConnections()};
-        stats->updateStatsForHost(_name, host, hostStats);
+        hostStats.acquisitionWaitTimes = pool->acquisitionWaitTimes();
+        stats->updateStatsForHost(_name, pool->host(), hostStats);
     }
 }
 
 size_t ConnectionPool::getNumConnectionsPerHost(const HostAndPort& hostAndPort) const {
-    stdx::lock_guard lk(_mutex);
-    auto iter = _pools.find(hostAndPort);
-    if (iter != _pools.end()) {
-        return iter->second->openConnections();
+    auto pool = [&]() -> std::shared_ptr<SpecificPool> {
+        stdx::lock_guard lk(_mutex);
+        auto iter = _pools.find(hostAndPort);
+        return iter == _pools.end() ? nullptr : iter->second;
+    }();
+
+    if (!pool) {
+        return 0;
     }
 
-    return 0;
+    auto lk = pool->lock();
+    return pool->openConnections();
 }
 
 ConnectionPool::SpecificPool::SpecificPool(std::shared_ptr<ConnectionPool> parent,
@@ -596,7 +691,7 @@ ConnectionPool::SpecificPool::SpecificPool(std::shared_ptr<ConnectionPool> paren
     : _parent(std::move(parent)),
       _sslMode(sslMode),
       _hostAndPort(hostAndPort),
-      _id(_parent->_nextPoolId++),
+      _id(_parent->_nextPoolId.fetchAndAdd(1)),
       _readyPool(std::numeric_limits<size_t>::max()) {
     invariant(_parent);
     _eventTimer = _parent->_factory->makeTimer();
@@ -652,6 +747,7 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
                         "Using existing idle connection to {hostAndPort}",
                         "Using existing idle connection",
                         "hostAndPort"_attr = _hostAndPort);
+            _acquisitionWaitTimes.increment(Milliseconds(0));
             return Future<ConnectionPool::ConnectionHandle>::makeReady(std::move(conn));
         }
     }
@@ -670,7 +766,7 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
     const auto expiration = now + timeout;
     auto pf = makePromiseFuture<ConnectionHandle>();
 
-    _requests.push_back(make_pair(expiration, std::move(pf.promise)));
+    _requests.push_back(Request{expiration, now, std::move(pf.promise)});
     std::push_heap(begin(_requests), end(_requests), RequestComparator{});
 
     return std::move(pf.future);
@@ -678,7 +774,7 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
 
 auto ConnectionPool::SpecificPool::makeHandle(ConnectionInterface* connection) -> ConnectionHandle {
     auto deleter = [this, anchor = shared_from_this()](ConnectionInterface* connection) {
-        stdx::lock_guard lk(_parent->_mutex);
+        stdx::lock_guard lk(_mutex);
         returnConnection(connection);
         _lastActiveTime = _parent->_factory->now();
         updateState();
@@ -902,7 +998,13 @@ void ConnectionPool::SpecificPool::triggerShutdown(const Status& status) {
     // it could be only in the map of pools
     auto anchor = shared_from_this();
     _parent->_controller->removeHost(_id);
-    _parent->_pools.erase(_hostAndPort);
+    {
+        stdx::lock_guard lk(_parent->_mutex);
+        if (auto iter = _parent->_pools.find(_hostAndPort);
+            iter != _parent->_pools.end() && iter->second.get() == this) {
+            _parent->_pools.erase(iter);
+        }
+    }
 
     processFailure(status);
 
@@ -947,7 +1049,7 @@ void ConnectionPool::SpecificPool::processFailure(const Status& status) {
     }
 
     for (auto& request : _requests) {
-        request.second.setError(status);
+        request.promise.setError(status);
     }
 
     LOGV2_DEBUG(22573,
@@ -962,7 +1064,8 @@ void ConnectionPool::SpecificPool::processFailure(const Status& status) {
 void ConnectionPool::SpecificPool::fulfillRequests() {
     while (_requests.size()) {
         // Marking this as our newest active time
-        _lastActiveTime = _parent->_factory->now();
+        const auto now = _parent->_factory->now();
+        _lastActiveTime = now;
 
         // Caution: If this returns with a value, it's important that we not throw until we've
         // emplaced the promise (as returning a connection would attempt to take the lock and would
@@ -976,7 +1079,8 @@ void ConnectionPool::SpecificPool::fulfillRequests() {
         }
 
         // Grab the request and callback
-        auto promise = std::move(_requests.front().second);
+        auto promise = std::move(_requests.front().promise);
+        _acquisitionWaitTimes.increment(now - _requests.front().requestedAt);
         std::pop_heap(begin(_requests), end(_requests), RequestComparator{});
         _requests.pop_back();
 
@@ -1108,8 +1212,8 @@ void ConnectionPool::SpecificPool::updateEventTimer() {
     }
 
     // If a request would timeout before the next event, then it is the next event
-    if (_requests.size() && (_requests.front().first < nextEventTime)) {
-        nextEventTime = _requests.front().first;
+    if (_requests.size() && (_requests.front().expiration < nextEventTime)) {
+        nextEventTime = _requests.front().expiration;
     }
 
     // If our timer is already set to the next event, then we're done
@@ -1129,11 +1233,11 @@ void ConnectionPool::SpecificPool::updateEventTimer() {
 
         _health.isFailed = false;
 
-        while (_requests.size() && (_requests.front().first <= now)) {
+        while (_requests.size() && (_requests.front().expiration <= now)) {
             std::pop_heap(begin(_requests), end(_requests), RequestComparator{});
 
             auto& request = _requests.back();
-            request.second.setError(Status(ErrorCodes::NetworkInterfaceExceededTimeLimit,
+            request.promise.setError(Status(ErrorCodes::NetworkInterfaceExceededTimeLimit,
                                            "Couldn't get a connection within the time limit"));
             _requests.pop_back();
 
@@ -1144,9 +1248,9 @@ void ConnectionPool::SpecificPool::updateEventTimer() {
     _eventTimer->setTimeout(timeout, std::move(deferredStateUpdateFunc));
 }
 
-void ConnectionPool::SpecificPool::updateController() {
+auto ConnectionPool::SpecificPool::updateController() -> HostGroupState {
     if (_health.isShutdown) {
-        return;
+        return {};
     }
 
     auto& controller = *_parent->_controller;
@@ -1167,16 +1271,12 @@ void ConnectionPool::SpecificPool::updateController() {
                 "poolState"_attr = state);
     auto hostGroup = controller.updateHost(_id, std::move(state));
 
-    // If we can shutdown, then do so
+    // If we can shutdown, then do so. The other pools in our group are handled by
+    // updateHostGroup() once our lock is released.
     if (hostGroup.canShutdown) {
-        for (const auto& host : hostGroup.hosts) {
-            auto it = _parent->_pools.find(host);
-            if (it == _parent->_pools.end()) {
-                continue;
-            }
-
-            auto& pool = it->second;
-            if (!pool->_health.isExpired) {
+        if (std::find(hostGroup.hosts.begin(), hostGroup.hosts.end(), _hostAndPort) !=
+            hostGroup.hosts.end()) {
+            if (!_health.isExpired) {
                 // Just because a HostGroup "canShutdown" doesn't mean that a SpecificPool should
                 // shutdown. For example, it is always inappropriate to shutdown a SpecificPool with
                 // connections in use or requests outstanding unless its parent ConnectionPool is
@@ -1184,35 +1284,72 @@ void ConnectionPool::SpecificPool::updateController() {
                 LOGV2_WARNING(4293001,
                               "Controller requested shutdown but connections still in use, "
                               "connection pool will stay active.",
-                              "hostAndPort"_attr = pool->_hostAndPort);
-                continue;
+                              "hostAndPort"_attr = _hostAndPort);
+            } else {
+                // At the moment, controllers will never mark for shutdown a pool with active
+                // connections or pending requests. isExpired is never true if these invariants
+                // are false. That's not to say that it's a terrible idea, but if this happens then
+                // we should review what it means to be expired.
+                if (shouldInvariantOnPoolCorrectness()) {
+                    invariant(_checkedOutPool.empty());
+                    invariant(_requests.empty());
+                }
+
+                triggerShutdown(Status(ErrorCodes::ConnectionPoolExpired,
+                                       str::stream() << "Pool for " << _hostAndPort
+                                                     << " has expired."));
             }
+        }
+        return hostGroup;
+    }
 
-            // At the moment, controllers will never mark for shutdown a pool with active
-            // connections or pending requests. isExpired is never true if these invariants are
-            // false. That's not to say that it's a terrible idea, but if this happens then we
-            // should review what it means to be expired.
+    spawnConnections();
 
-            if (shouldInvariantOnPoolCorrectness()) {
-                invariant(pool->_checkedOutPool.empty());
-                invariant(pool->_requests.empty());
-            }
+    return hostGroup;
+}
 
-            pool->triggerShutdown(Status(ErrorCodes::ConnectionPoolExpired,
-                                         str::stream() << "Pool for " << host << " has expired."));
+void ConnectionPool::SpecificPool::updateHostGroup(const HostGroupState& hostGroup) {
+    for (const auto& host : hostGroup.hosts) {
+        if (host == _hostAndPort) {
+            continue;
         }
-        return;
-    }
 
+        if (!hostGroup.canShutdown) {
+            // Make sure all related hosts exist
+            _parent->_getOrMakePool(host, _sslMode);
+            continue;
+        }
 
-    // Make sure all related hosts exist
-    for (const auto& host : hostGroup.hosts) {
-        if (auto& pool = _parent->_pools[host]; !pool) {
-            pool = SpecificPool::make(_parent, host, _sslMode);
+        auto pool = [&]() -> std::shared_ptr<SpecificPool> {
+            stdx::lock_guard lk(_parent->_mutex);
+            auto it = _parent->_pools.find(host);
+            return it == _parent->_pools.end() ? nullptr : it->second;
+        }();
+        if (!pool) {
+            continue;
         }
-    }
 
-    spawnConnections();
+        stdx::lock_guard lk(pool->_mutex);
+        if (pool->_health.isShutdown) {
+            continue;
+        }
+
+        if (!pool->_health.isExpired) {
+            LOGV2_WARNING(4293001,
+                          "Controller requested shutdown but connections still in use, "
+                          "connection pool will stay active.",
+                          "hostAndPort"_attr = pool->_hostAndPort);
+            continue;
+        }
+
+        if (shouldInvariantOnPoolCorrectness()) {
+            invariant(pool->_checkedOutPool.empty());
+            invariant(pool->_requests.empty());
+        }
+
+        pool->triggerShutdown(Status(ErrorCodes::ConnectionPoolExpired,
+                                     str::stream() << "Pool for " << host << " has expired."));
+    }
 }
 
 // Updates our state and manages the request timer
@@ -1238,9 +1375,13 @@ void ConnectionPool::SpecificPool::updateState() {
         .getAsync([this, anchor = shared_from_this()](Status&& status) mutable {
             invariant(status);
 
-            stdx::lock_guard lk(_parent->_mutex);
-            _updateScheduled = false;
-            updateController();
+            auto hostGroup = [&] {
+                stdx::lock_guard lk(_mutex);
+                _updateScheduled = false;
+                return updateController();
+            }();
+
+            updateHostGroup(hostGroup);
         });
 }
 
@@ -35,6 +35,7 @@
 
 #include "mongo/executor/egress_tag_closer.h"
 #include "mongo/executor/egress_tag_closer_manager.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/transport/session.h"
@@ -261,10 +262,25 @@ private:
 
     std::shared_ptr<ControllerInterface> _controller;
 
-    // The global mutex for specific pool access and the generation counter
+    /**
+     * Returns the SpecificPool for the given host, creating and publishing a new one if none
+     * exists. Must be called without holding _mutex or any SpecificPool's mutex.
+     */
+    std::shared_ptr<SpecificPool> _getOrMakePool(const HostAndPort& hostAndPort,
+                                                 transport::ConnectSSLMode sslMode);
+
+    /**
+     * Returns a snapshot of the current pools so that they can be visited without holding _mutex.
+     */
+    std::vector<std::shared_ptr<SpecificPool>> _getPools() const;
+
+    AtomicWord<PoolId> _nextPoolId{0};
+
+    // The mutex protecting the set of specific pools. Each SpecificPool guards its own state with
+    // its own mutex, so that leasing and returning connections to different hosts does not
+    // contend. A SpecificPool's mutex may be held while acquiring this one, never the reverse.
     mutable Mutex _mutex =
-        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(1), "ExecutorConnectionPool::_mutex");
-    PoolId _nextPoolId = 0;
+        MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "ExecutorConnectionPool::_mutex");
     stdx::unordered_map<HostAndPort, std::shared_ptr<SpecificPool>> _pools;
 
     EgressTagCloserManager* _manager;
@@ -31,11 +31,54 @@
 
 #include "mongo/executor/connection_pool_stats.h"
 
+#include <algorithm>
+
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/bits.h"
 
 namespace mongo {
 namespace executor {
 
+void ConnectionWaitTimeHistogram::increment(Milliseconds waitTime) {
+    auto millis = static_cast<uint64_t>(std::max(waitTime.count(), Milliseconds::rep{0}));
+
+    // Bucket 0 holds waits under 1ms, bucket N holds waits in [2^(N-1), 2^N) ms.
+    size_t bucket = millis == 0 ? 0 : 64 - countLeadingZeros64(millis);
+    buckets[std::min(bucket, kMaxBuckets - 1)]++;
+
+    totalCount++;
+    totalWaitTime += Milliseconds(static_cast<Milliseconds::rep>(millis));
+}
+
+ConnectionWaitTimeHistogram& ConnectionWaitTimeHistogram::operator+=(
+    const ConnectionWaitTimeHistogram& other) {
+    for (size_t i = 0; i < kMaxBuckets; ++i) {
+        buckets[i] += other.buckets[i];
+    }
+    totalCount += other.totalCount;
+    totalWaitTime += other.totalWaitTime;
+
+    return *this;
+}
+
+void ConnectionWaitTimeHistogram::appendToBSON(mongo::BSONObjBuilder& result) const {
+    BSONObjBuilder histogramBuilder(result.subobjStart("acquisitionWaitTimes"));
+    {
+        BSONArrayBuilder arrayBuilder(histogramBuilder.subarrayStart("histogram"));
+        for (size_t i = 0; i < kMaxBuckets; ++i) {
+            if (buckets[i] == 0) {
+                continue;
+            }
+
+            BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
+            entryBuilder.append("millis", static_cast<long long>(i == 0 ? 0 : 1ULL << (i - 1)));
+            entryBuilder.append("count", static_cast<long long>(buckets[i]));
+        }
+    }
+    histogramBuilder.append("totalCount", static_cast<long long>(totalCount));
+    histogramBuilder.append("totalWaitTimeMillis", durationCount<Milliseconds>(totalWaitTime));
+}
+
 ConnectionStatsPer::ConnectionStatsPer(size_t nInUse,
                                        size_t nAvailable,
                                        size_t nCreated,
@@ -49,6 +92,7 @@ ConnectionStatsPer& ConnectionStatsPer::operator+=(const ConnectionStatsPer& oth
     available += other.available;
     created += other.created;
     refreshing += other.refreshing;
+    acquisitionWaitTimes += other.acquisitionWaitTimes;
 
     return *this;
 }
@@ -106,6 +150,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result, bool forFT
             poolInfo.appendNumber("poolAvailable", poolStats.available);
             poolInfo.appendNumber("poolCreated", poolStats.created);
             poolInfo.appendNumber("poolRefreshing", poolStats.refreshing);
+            poolStats.acquisitionWaitTimes.appendToBSON(poolInfo);
 
             for (const auto& host : poolStats.statsByHost) {
                 BSONObjBuilder hostInfo(poolInfo.subobjStart(host.first.toString()));
@@ -114,6 +159,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result, bool forFT
                 hostInfo.appendNumber("available", hostStats.available);
                 hostInfo.appendNumber("created", hostStats.created);
                 hostInfo.appendNumber("refreshing", hostStats.refreshing);
+                hostStats.acquisitionWaitTimes.appendToBSON(hostInfo);
             }
         }
     }
@@ -126,6 +172,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result, bool forFT
             hostInfo.appendNumber("available", hostStats.available);
             hostInfo.appendNumber("created", hostStats.created);
             hostInfo.appendNumber("refreshing", hostStats.refreshing);
+            hostStats.acquisitionWaitTimes.appendToBSON(hostInfo);
         }
     }
 }
@@ -29,12 +29,35 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/stdx/unordered_map.h"
+#include "mongo/util/duration.h"
 #include "mongo/util/net/hostandport.h"
 
 namespace mongo {
 namespace executor {
 
+/**
+ * Tracks how long requests for a connection waited before they were fulfilled. Buckets are powers
+ * of two in milliseconds; the final bucket collects every wait at or above its lower bound.
+ *
+ * Note: This class is not thread-safe.
+ */
+struct ConnectionWaitTimeHistogram {
+    static constexpr size_t kMaxBuckets = 16;
+
+    void increment(Milliseconds waitTime);
+
+    ConnectionWaitTimeHistogram& operator+=(const ConnectionWaitTimeHistogram& other);
+
+    void appendToBSON(mongo::BSONObjBuilder& result) const;
+
+    std::array<uint64_t, kMaxBuckets> buckets{};
+    uint64_t totalCount = 0;
+    Milliseconds totalWaitTime{0};
+};
+
 /**
  * Holds connection information for a specific pool or remote host. These objects are maintained by
  * a parent ConnectionPoolStats object and should not need to be created directly.
@@ -50,6 +73,7 @@ struct ConnectionStatsPer {
     size_t available = 0u;
     size_t created = 0u;
     size_t refreshing = 0u;
+    ConnectionWaitTimeHistogram acquisitionWaitTimes;
 };
 
 /**
@@ -41,6 +41,7 @@
 #include <fmt/ostream.h>
 
 #include "mongo/executor/connection_pool.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/stdx/future.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/scopeguard.h"
@@ -1530,6 +1531,35 @@ TEST_F(ConnectionPoolTest, ReturnAfterShutdown) {
     pool->shutdown();
 }
 
+TEST_F(ConnectionPoolTest, AcquisitionWaitTimesAreRecorded) {
+    auto pool = makePool();
+
+    auto now = Date_t::now();
+    PoolImpl::setNow(now);
+
+    // The first request has to wait for a connection to be set up
+    auto connFuture = getFromPool(HostAndPort(), transport::kGlobalSSLMode, Seconds(1));
+    PoolImpl::setNow(now + Milliseconds(10));
+    ConnectionImpl::pushSetup(Status::OK());
+    auto conn = std::move(connFuture).get();
+    doneWith(conn);
+
+    // The second request is served immediately by the now idle connection
+    auto connFuture2 = getFromPool(HostAndPort(), transport::kGlobalSSLMode, Seconds(1));
+    auto conn2 = std::move(connFuture2).get();
+    doneWith(conn2);
+
+    ConnectionPoolStats stats;
+    pool->appendConnectionStats(&stats);
+
+    const auto& histogram = stats.statsByHost[HostAndPort()].acquisitionWaitTimes;
+    ASSERT_EQ(histogram.totalCount, 2u);
+    ASSERT_EQ(histogram.totalWaitTime, Milliseconds(10));
+    ASSERT_EQ(histogram.buckets[0], 1u);
+    // 10ms falls into the [8ms, 16ms) bucket
+    ASSERT_EQ(histogram.buckets[4], 1u);
+}
+
 }  // namespace connection_pool_test_details
 }  // namespace executor
 }  // namespace mongo
@@ -0,0 +1,130 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/log/attributes/value_extraction.hpp>
+#include <boost/log/core/record_view.hpp>
+#include <boost/log/detail/locking_ptr.hpp>
+#include <boost/log/sinks/basic_sink_backend.hpp>
+#include <boost/log/sinks/frontend_requirements.hpp>
+#include <memory>
+
+#include "mongo/logv2/async_log_writer.h"
+#include "mongo/logv2/attributes.h"
+#include "mongo/logv2/log_severity.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo::logv2 {
+
+/**
+ * Backend which writes the records formatted on the logging thread to the attached backend from a
+ * dedicated thread, in batches, when asynchronous writes are enabled. Records at Error severity
+ * or above are still written on the logging thread. Otherwise it writes each record to the attached
+ * backend on the logging thread.
+ */
+template <typename Backend>
+class AsyncBackend
+    : public boost::log::sinks::basic_formatted_sink_backend<
+          char,
+          boost::log::sinks::combine_requirements<boost::log::sinks::concurrent_feeding,
+                                                  boost::log::sinks::flushing>::type> {
+public:
+    AsyncBackend(boost::shared_ptr<Backend> backend,
+                 const AsyncLogOptions& options,
+                 LogTimestampFormat timestampFormat)
+        : _backend(std::move(backend)) {
+        if (options.enabled) {
+            _writer = std::make_unique<AsyncLogWriter>(
+                options, timestampFormat, [this](const std::string& batch) {
+                    // The attached backends do not use the record, only the formatted string.
+                    stdx::lock_guard lock(_mutex);
+                    _backend->consume(boost::log::record_view(), batch);
+                });
+        }
+    }
+
+    /**
+     * Locking accessor to the attached backend
+     */
+    auto lockedBackend() {
+        return boost::log::aux::locking_ptr(_backend, _mutex);
+    }
+
+    /**
+     * Consumes formatted log for the attached backend, or buffers it for the writer thread
+     */
+    void consume(boost::log::record_view const& rec, string_type const& formatted_string) {
+        if (!_writer) {
+            stdx::lock_guard lock(_mutex);
+            _backend->consume(rec, formatted_string);
+            return;
+        }
+
+        // Write errors before returning, after everything logged before them, so that they are
+        // neither dropped when the buffer is full nor lost if the process is about to terminate.
+        auto severity = boost::log::extract<LogSeverity>(attributes::severity(), rec);
+        if (severity && severity.get() >= LogSeverity::Error()) {
+            _writer->write(formatted_string);
+            return;
+        }
+
+        _writer->push(formatted_string);
+    }
+
+    /**
+     * Writes the buffered records and flushes the attached backend if it supports flushing
+     */
+    void flush() {
+        if (_writer) {
+            _writer->drain();
+        }
+        if constexpr (boost::log::sinks::has_requirement<typename Backend::frontend_requirements,
+                                                         boost::log::sinks::flushing>::value) {
+            stdx::lock_guard lock(_mutex);
+            _backend->flush();
+        }
+    }
+
+    /**
+     * Returns the number of records dropped because the asynchronous buffer was full
+     */
+    int64_t droppedRecords() const {
+        return _writer ? _writer->droppedRecords() : 0;
+    }
+
+private:
+    boost::shared_ptr<Backend> _backend;
+    stdx::mutex _mutex;  // NOLINT
+
+    // Declared last so that it writes the records still buffered before the rest is destroyed.
+    std::unique_ptr<AsyncLogWriter> _writer;
+};
+
+}  // namespace mongo::logv2
@@ -0,0 +1,246 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/logv2/async_log_writer.h"
+
+#include <algorithm>
+#include <fmt/format.h>
+
+#include "mongo/logv2/attribute_storage.h"
+#include "mongo/logv2/json_formatter.h"
+#include "mongo/logv2/log_component.h"
+#include "mongo/logv2/log_severity.h"
+#include "mongo/logv2/log_tag.h"
+#include "mongo/logv2/log_truncation.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo::logv2 {
+namespace {
+// How long the writer thread sleeps when it has no records to write, unless it is woken sooner.
+constexpr auto kIdleWait = Milliseconds(1000);
+
+// How long a thread waiting for room in a full buffer sleeps before it tries again, unless it is
+// woken sooner by the writer thread.
+constexpr auto kRoomWait = Milliseconds(10);
+
+size_t roundUpToPowerOfTwo(size_t n) {
+    size_t powerOfTwo = 1;
+    while (powerOfTwo < n) {
+        powerOfTwo <<= 1;
+    }
+    return powerOfTwo;
+}
+}  // namespace
+
+AsyncLogWriter::AsyncLogWriter(const AsyncLogOptions& options,
+                               LogTimestampFormat timestampFormat,
+                               WriteBatchFn writeBatch)
+    : _options(options),
+      _timestampFormat(timestampFormat),
+      _writeBatch(std::move(writeBatch)),
+      _capacity(roundUpToPowerOfTwo(std::max<size_t>(options.bufferSize, 2))),
+      _slots(std::make_unique<Slot[]>(_capacity)) {
+    for (size_t i = 0; i < _capacity; ++i) {
+        _slots[i].sequence.store(i);
+    }
+    _thread = stdx::thread([this] { _run(); });
+}
+
+AsyncLogWriter::~AsyncLogWriter() {
+    {
+        stdx::lock_guard lk(_waitMutex);
+        _shutdown = true;
+        _recordsAvailable.notify_one();
+    }
+    _thread.join();
+}
+
+void AsyncLogWriter::push(StringData record) {
+    while (!_tryPush(record)) {
+        if (_options.overflowPolicy == AsyncLogOptions::OverflowPolicy::kDrop) {
+            _droppedRecords.fetchAndAdd(1);
+            return;
+        }
+
+        // Wait for the writer thread to make room. It only notifies us if it sees that we are
+        // waiting, so we wait with a timeout in case it wrote its last batch just before that.
+        _waitingForRoom.fetchAndAdd(1);
+        {
+            stdx::unique_lock lk(_waitMutex);
+            _recordsAvailable.notify_one();
+            _roomAvailable.wait_for(lk, kRoomWait.toSystemDuration());
+        }
+        _waitingForRoom.subtractAndFetch(1);
+    }
+
+    // The writer thread marks itself idle before it checks for records, so it either sees this
+    // record or we see that it is idle and wake it.
+    if (_writerIdle.load()) {
+        stdx::lock_guard lk(_waitMutex);
+        _recordsAvailable.notify_one();
+    }
+}
+
+void AsyncLogWriter::drain() {
+    // Stop at the records pushed so far, so that a steady stream of new records cannot keep us
+    // here.
+    const auto drainPosition = _pushPosition.load();
+    stdx::lock_guard lk(_consumerMutex);
+    _drainTo(lk, drainPosition);
+}
+
+void AsyncLogWriter::write(StringData record) {
+    const auto drainPosition = _pushPosition.load();
+    stdx::lock_guard lk(_consumerMutex);
+    _drainTo(lk, drainPosition);
+
+    _batch.assign(record.rawData(), record.size());
+    _writeBatch(_batch);
+}
+
+void AsyncLogWriter::_drainTo(WithLock lk, uint64_t position) {
+    while (_popPosition.load() < position && _writeNextBatch(lk)) {
+    }
+}
+
+bool AsyncLogWriter::_tryPush(StringData record) {
+    auto position = _pushPosition.load();
+    while (true) {
+        auto& slot = _slots[position & (_capacity - 1)];
+        const auto sequence = slot.sequence.load();
+        if (sequence == position) {
+            // The slot is free. Claim it, unless another thread claimed it first, in which case
+            // 'position' is updated to the current push position.
+            if (_pushPosition.compareAndSwap(&position, position + 1)) {
+                // The slot keeps the capacity of the string it held on the previous lap, so this
+                // rarely allocates.
+                slot.record.assign(record.rawData(), record.size());
+                slot.sequence.store(position + 1);
+                return true;
+            }
+        } else if (sequence < position) {
+            // The slot still holds the record pushed one lap ago, so the buffer is full.
+            return false;
+        } else {
+            position = _pushPosition.load();
+        }
+    }
+}
+
+bool AsyncLogWriter::_writeNextBatch(WithLock) {
+    _batch.clear();
+    size_t numRecords = 0;
+    auto position = _popPosition.load();
+    while (numRecords < _capacity) {
+        auto& slot = _slots[position & (_capacity - 1)];
+        if (slot.sequence.load() != position + 1) {
+            // Either there are no more records, or the next one is still being copied in.
+            break;
+        }
+        if (numRecords > 0) {
+            _batch.push_back('\n');
+        }
+        _batch.append(slot.record);
+        slot.record.clear();
+        slot.sequence.store(position + _capacity);
+        _popPosition.store(++position);
+        ++numRecords;
+    }
+
+    const auto droppedRecords = _droppedRecords.load();
+    if (droppedRecords > _reportedDroppedRecords) {
+        if (numRecords > 0) {
+            _batch.push_back('\n');
+        }
+
+        DynamicAttributes attrs;
+        attrs.add("droppedRecords", droppedRecords - _reportedDroppedRecords);
+        fmt::memory_buffer buffer;
+        JSONFormatter(nullptr, _timestampFormat)
+            .format(buffer,
+                    LogSeverity::Warning(),
+                    LogComponent::kControl,
+                    Date_t::now(),
+                    5121514,
+                    getThreadName(),
+                    "Dropped log records because the asynchronous log buffer was full",
+                    TypeErasedAttributeStorage(attrs),
+                    LogTag::kNone,
+                    LogTruncation::Disabled);
+        // Commented out log line below to get validation of the log id with the errorcodes
+        // linter
+        // LOGV2(5121514, "Dropped log records because the asynchronous log buffer was full");
+        _batch.append(buffer.data(), buffer.size());
+        _reportedDroppedRecords = droppedRecords;
+        ++numRecords;
+    }
+
+    if (numRecords == 0) {
+        return false;
+    }
+
+    // Let the threads waiting for room in the buffer carry on while we write.
+    if (_waitingForRoom.load() > 0) {
+        stdx::lock_guard lk(_waitMutex);
+        _roomAvailable.notify_all();
+    }
+
+    _writeBatch(_batch);
+    return true;
+}
+
+void AsyncLogWriter::_run() {
+    setThreadName("AsyncLogWriter");
+
+    while (true) {
+        {
+            stdx::lock_guard lk(_consumerMutex);
+            if (_writeNextBatch(lk)) {
+                continue;
+            }
+        }
+
+        stdx::unique_lock lk(_waitMutex);
+        if (_shutdown) {
+            break;
+        }
+        _writerIdle.store(true);
+        _recordsAvailable.wait_for(
+            lk, kIdleWait.toSystemDuration(), [&] { return _shutdown || _hasRecords(); });
+        _writerIdle.store(false);
+    }
+
+    stdx::lock_guard lk(_consumerMutex);
+    while (_writeNextBatch(lk)) {
+    }
+}
+
+}  // namespace mongo::logv2
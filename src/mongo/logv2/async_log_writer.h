@@ -0,0 +1,170 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "mongo/base/string_data.h"
+#include "mongo/logv2/log_format.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/with_lock.h"
+
+namespace mongo::logv2 {
+
+/**
+ * Options for writing formatted log records from a dedicated thread rather than from the thread
+ * which logged them.
+ */
+struct AsyncLogOptions {
+    // What a thread that logs a record does when the buffer is full.
+    enum class OverflowPolicy {
+        kBlock,  // Waits until the writer thread has made room.
+        kDrop,   // Drops the record, and counts it.
+    };
+
+    bool enabled{false};
+    // Maximum number of records buffered, rounded up to a power of two.
+    size_t bufferSize{16384};
+    OverflowPolicy overflowPolicy{OverflowPolicy::kBlock};
+};
+
+/**
+ * Buffers formatted log records in a bounded lock-free ring, and writes them in batches from a
+ * dedicated writer thread. Any number of threads may push records concurrently. Records are written
+ * in the order in which they were pushed, joined into batches separated by newlines, through
+ * 'writeBatch', which is only ever called by one thread at a time.
+ */
+class AsyncLogWriter {
+public:
+    using WriteBatchFn = std::function<void(const std::string&)>;
+
+    AsyncLogWriter(const AsyncLogOptions& options,
+                   LogTimestampFormat timestampFormat,
+                   WriteBatchFn writeBatch);
+
+    /**
+     * Writes the records which are still buffered, and stops the writer thread.
+     */
+    ~AsyncLogWriter();
+
+    AsyncLogWriter(const AsyncLogWriter&) = delete;
+    AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+
+    /**
+     * Buffers 'record' to be written by the writer thread. If the buffer is full, either waits for
+     * room or drops the record, according to the overflow policy.
+     */
+    void push(StringData record);
+
+    /**
+     * Writes all of the records buffered so far on the calling thread.
+     */
+    void drain();
+
+    /**
+     * Writes all of the records buffered so far, followed by 'record', on the calling thread.
+     * 'record' is never buffered, so it cannot be dropped.
+     */
+    void write(StringData record);
+
+    /**
+     * Returns the number of records dropped because the buffer was full.
+     */
+    int64_t droppedRecords() const {
+        return _droppedRecords.load();
+    }
+
+private:
+    struct Slot {
+        // Equal to the position of the next push to this slot while it is free, and to one more
+        // than the position of the record it holds while it is full.
+        AtomicWord<uint64_t> sequence;
+        std::string record;
+    };
+
+    bool _tryPush(StringData record);
+
+    /**
+     * Writes the records pushed before 'position'. The caller must hold '_consumerMutex'.
+     */
+    void _drainTo(WithLock, uint64_t position);
+
+    /**
+     * Writes up to one buffer's worth of records. Returns false if there were none. The caller must
+     * hold '_consumerMutex'.
+     */
+    bool _writeNextBatch(WithLock);
+
+    /**
+     * Returns true if any records have been pushed which have not been written yet.
+     */
+    bool _hasRecords() const {
+        return _pushPosition.load() != _popPosition.load();
+    }
+
+    void _run();
+
+    const AsyncLogOptions _options;
+    const LogTimestampFormat _timestampFormat;
+    const WriteBatchFn _writeBatch;
+
+    const size_t _capacity;
+    std::unique_ptr<Slot[]> _slots;
+    AtomicWord<uint64_t> _pushPosition{0};
+
+    // Only advanced while holding '_consumerMutex'.
+    AtomicWord<uint64_t> _popPosition{0};
+
+    // Serializes the writer thread and drain(), and protects the members below it.
+    stdx::mutex _consumerMutex;  // NOLINT
+    std::string _batch;
+    int64_t _reportedDroppedRecords{0};
+
+    AtomicWord<int64_t> _droppedRecords{0};
+
+    // Used to wake the writer thread when records are pushed while it is idle, and threads waiting
+    // for room in the buffer when it has written a batch.
+    stdx::mutex _waitMutex;  // NOLINT
+    stdx::condition_variable _recordsAvailable;
+    stdx::condition_variable _roomAvailable;
+    AtomicWord<bool> _writerIdle{false};
+    AtomicWord<int> _waitingForRoom{0};
+    bool _shutdown{false};
+
+    stdx::thread _thread;
+};
+
+}  // namespace mongo::logv2
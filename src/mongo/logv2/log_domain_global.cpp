@@ -30,6 +30,7 @@
 #include "log_domain_global.h"
 
 #include "mongo/config.h"
+#include "mongo/logv2/async_backend.h"
 #include "mongo/logv2/component_settings_filter.h"
 #include "mongo/logv2/composite_backend.h"
 #include "mongo/logv2/console.h"
@@ -66,7 +67,7 @@ struct LogDomainGlobal::Impl {
                              UserAssertSink>
         SyslogBackend;
 #endif
-    typedef CompositeBackend<FileRotateSink, RamLogSink, RamLogSink, UserAssertSink>
+    typedef CompositeBackend<AsyncBackend<FileRotateSink>, RamLogSink, RamLogSink, UserAssertSink>
         RotatableFileBackend;
 
     Impl(LogDomainGlobal& parent);
@@ -159,16 +160,19 @@ Status LogDomainGlobal::Impl::configure(LogDomainGlobal::ConfigurationOptions co
 
     if (options.fileEnabled) {
         auto backend = boost::make_shared<RotatableFileBackend>(
-            boost::make_shared<FileRotateSink>(options.timestampFormat),
+            boost::make_shared<AsyncBackend<FileRotateSink>>(
+                boost::make_shared<FileRotateSink>(options.timestampFormat),
+                options.fileAsyncOptions,
+                options.timestampFormat),
             boost::make_shared<RamLogSink>(RamLog::get("global")),
             boost::make_shared<RamLogSink>(RamLog::get("startupWarnings")),
             boost::make_shared<UserAssertSink>());
-        Status ret = backend->lockedBackend<0>()->addFile(
+        Status ret = backend->lockedBackend<0>()->lockedBackend()->addFile(
             options.filePath,
             options.fileOpenMode == ConfigurationOptions::OpenMode::kAppend ? true : false);
         if (!ret.isOK())
             return ret;
-        backend->lockedBackend<0>()->auto_flush(true);
+        backend->lockedBackend<0>()->lockedBackend()->auto_flush(true);
         backend->setFilter<2>(
             TaggedSeverityFilter(_parent, {LogTag::kStartupWarnings}, LogSeverity::Log()));
 
@@ -225,7 +229,9 @@ const LogDomainGlobal::ConfigurationOptions& LogDomainGlobal::Impl::config() con
 Status LogDomainGlobal::Impl::rotate(bool rename, StringData renameSuffix) {
     if (_rotatableFileSink) {
         auto backend = _rotatableFileSink->locked_backend()->lockedBackend<0>();
-        return backend->rotate(rename, renameSuffix);
+        // Write the records logged before the rotation to the old file.
+        backend->flush();
+        return backend->lockedBackend()->rotate(rename, renameSuffix);
     }
     return Status::OK();
 }
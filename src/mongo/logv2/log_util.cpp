@@ -35,6 +35,7 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/time_support.h"
 
+#include <boost/log/core.hpp>
 #include <string>
 #include <vector>
 
@@ -68,6 +69,10 @@ bool rotateLogs(bool renameFiles) {
     return success;
 }
 
+void flushLogs() {
+    boost::log::core::get()->flush();
+}
+
 bool shouldRedactLogs() {
     return redactionEnabled.loadRelaxed();
 }
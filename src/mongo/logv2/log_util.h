@@ -52,6 +52,12 @@ void addLogRotator(LogRotateCallback cb);
  */
 bool rotateLogs(bool renameFiles);
 
+/**
+ * Writes out the log records which are buffered to be written asynchronously, and flushes the log
+ * sinks.
+ */
+void flushLogs();
+
 /**
  * Returns true if system logs should be redacted.
  */
@@ -29,17 +29,22 @@
 
 #define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kDefault
 
+#include "mongo/logv2/async_backend.h"
 #include "mongo/logv2/component_settings_filter.h"
+#include "mongo/logv2/file_rotate_sink.h"
+#include "mongo/logv2/json_formatter.h"
 #include "mongo/logv2/log.h"
 #include "mongo/logv2/log_domain_global.h"
 #include "mongo/logv2/text_formatter.h"
 #include "mongo/platform/basic.h"
 
 #include <benchmark/benchmark.h>
+#include <boost/filesystem/operations.hpp>
 #include <boost/iostreams/device/null.hpp>
 #include <boost/iostreams/stream.hpp>
 #include <boost/log/sinks/sync_frontend.hpp>
 #include <boost/log/sinks/text_ostream_backend.hpp>
+#include <boost/log/sinks/unlocked_frontend.hpp>
 #include <boost/make_shared.hpp>
 #include <iostream>
 
@@ -97,6 +102,68 @@ private:
     bool _shouldInit;
 };
 
+// RAII style helper class which logs to a file in the temporary directory, the way the server does,
+// either on the logging thread or through the asynchronous writer. The time per iteration is the
+// latency which logging adds to the thread which logs.
+class ScopedLogV2FileBench {
+public:
+    using Backend = logv2::AsyncBackend<logv2::FileRotateSink>;
+
+    ScopedLogV2FileBench(benchmark::State& state, const logv2::AsyncLogOptions& asyncOptions)
+        : _state(state) {
+        _shouldInit = state.thread_index == 0;
+        if (_shouldInit) {
+            setupAppender(asyncOptions);
+        }
+    }
+
+    ~ScopedLogV2FileBench() {
+        if (_shouldInit) {
+            tearDownAppender();
+        }
+    }
+
+private:
+    void setupAppender(const logv2::AsyncLogOptions& asyncOptions) {
+        logv2::LogDomainGlobal::ConfigurationOptions config;
+        config.makeDisabled();
+        invariant(logv2::LogManager::global().getGlobalDomainInternal().configure(config).isOK());
+
+        _path = boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path("logv2_bm-%%%%-%%%%-%%%%.log");
+        _backend = boost::make_shared<Backend>(
+            boost::make_shared<logv2::FileRotateSink>(logv2::LogTimestampFormat::kISO8601UTC),
+            asyncOptions,
+            logv2::LogTimestampFormat::kISO8601UTC);
+        invariant(_backend->lockedBackend()->addFile(_path.string(), false).isOK());
+        _backend->lockedBackend()->auto_flush(true);
+
+        _sink = boost::make_shared<boost::log::sinks::unlocked_sink<Backend>>(_backend);
+        _sink->set_filter(
+            logv2::ComponentSettingsFilter(logv2::LogManager::global().getGlobalDomain(),
+                                           logv2::LogManager::global().getGlobalSettings()));
+        _sink->set_formatter(logv2::JSONFormatter());
+        boost::log::core::get()->add_sink(_sink);
+    }
+
+    void tearDownAppender() {
+        boost::log::core::get()->remove_sink(_sink);
+        _state.counters["dropped"] = _backend->droppedRecords();
+
+        // Destroying the backend writes out the records which are still buffered.
+        _sink.reset();
+        _backend.reset();
+        boost::filesystem::remove(_path);
+        invariant(logv2::LogManager::global().getGlobalDomainInternal().configure({}).isOK());
+    }
+
+    benchmark::State& _state;
+    boost::filesystem::path _path;
+    boost::shared_ptr<Backend> _backend;
+    boost::shared_ptr<boost::log::sinks::unlocked_sink<Backend>> _sink;
+    bool _shouldInit;
+};
+
 // "Expensive" way to create a string.
 std::string createLongString() {
     return std::string(1000, 'a') + std::string(1000, 'b') + std::string(1000, 'c') +
@@ -150,6 +217,31 @@ void BM_EnabledLogV2ManySmallArg(benchmark::State& state) {
     }
 }
 
+void BM_FileLogV2(benchmark::State& state, logv2::AsyncLogOptions asyncOptions) {
+    ScopedLogV2FileBench init(state, asyncOptions);
+
+    for (auto _ : state)
+        LOGV2(5121515, "enabled log {}", "str"_attr = "Some attribute of moderate length"_sd);
+}
+
+void BM_FileLogV2Sync(benchmark::State& state) {
+    BM_FileLogV2(state, {});
+}
+
+void BM_FileLogV2AsyncBlock(benchmark::State& state) {
+    logv2::AsyncLogOptions asyncOptions;
+    asyncOptions.enabled = true;
+    asyncOptions.overflowPolicy = logv2::AsyncLogOptions::OverflowPolicy::kBlock;
+    BM_FileLogV2(state, asyncOptions);
+}
+
+void BM_FileLogV2AsyncDrop(benchmark::State& state) {
+    logv2::AsyncLogOptions asyncOptions;
+    asyncOptions.enabled = true;
+    asyncOptions.overflowPolicy = logv2::AsyncLogOptions::OverflowPolicy::kDrop;
+    BM_FileLogV2(state, asyncOptions);
+}
+
 void ThreadCounts(benchmark::internal::Benchmark* b) {
     int tc[] = {1, 2, 4, 8};
     for (int t : tc)
@@ -161,6 +253,9 @@ BENCHMARK(BM_NoopLogV2Arg)->Apply(ThreadCounts);
 BENCHMARK(BM_EnabledLogV2)->Apply(ThreadCounts);
 BENCHMARK(BM_EnabledLogV2ExpensiveArg)->Apply(ThreadCounts);
 BENCHMARK(BM_EnabledLogV2ManySmallArg)->Apply(ThreadCounts);
+BENCHMARK(BM_FileLogV2Sync)->Apply(ThreadCounts);
+BENCHMARK(BM_FileLogV2AsyncBlock)->Apply(ThreadCounts);
+BENCHMARK(BM_FileLogV2AsyncDrop)->Apply(ThreadCounts);
 
 }  // namespace
 }  // namespace mongo
@@ -40,6 +40,7 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/json.h"
 #include "mongo/bson/oid.h"
+#include "mongo/logv2/async_backend.h"
 #include "mongo/logv2/bson_formatter.h"
 #include "mongo/logv2/component_settings_filter.h"
 #include "mongo/logv2/composite_backend.h"
@@ -1751,6 +1752,127 @@ TEST_F(LogV2Test, UserAssert) {
                              });
 }
 
+TEST_F(LogV2Test, AsyncWrites) {
+    std::vector<std::string> batches;
+    AsyncLogOptions asyncOptions;
+    asyncOptions.enabled = true;
+    asyncOptions.bufferSize = 64;
+    auto backend = boost::make_shared<AsyncBackend<LogCaptureBackend>>(
+        boost::make_shared<LogCaptureBackend>(batches),
+        asyncOptions,
+        LogTimestampFormat::kISO8601UTC);
+    auto sink = wrapInUnlockedSink(backend);
+    applyDefaultFilterToSink(sink);
+    sink->set_formatter(PlainFormatter());
+    attachSink(sink);
+
+    // Log from several threads at once, so that they fill the buffer.
+    constexpr int kNumThreads = 4;
+    constexpr int kNumPerThread = 1000;
+    std::vector<stdx::thread> threads;
+    for (int thread = 0; thread < kNumThreads; ++thread) {
+        threads.emplace_back([thread] {
+            for (int i = 0; i < kNumPerThread; ++i)
+                LOGV2(5121516, "async {thread} {i}", "thread"_attr = thread, "i"_attr = i);
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    sink->flush();
+
+    // Every record was written, in the order in which each thread logged them.
+    std::vector<int> nextPerThread(kNumThreads, 0);
+    int numRecords = 0;
+    for (auto&& batch : batches) {
+        std::istringstream batchStream(batch);
+        for (std::string line; std::getline(batchStream, line, '\n');) {
+            std::istringstream lineStream(line);
+            std::string word;
+            int thread, i;
+            lineStream >> word >> thread >> i;
+            ASSERT_EQ(word, "async");
+            ASSERT_EQ(i, nextPerThread[thread]++);
+            ++numRecords;
+        }
+    }
+    ASSERT_EQ(numRecords, kNumThreads * kNumPerThread);
+    ASSERT_EQ(backend->droppedRecords(), 0);
+}
+
+TEST_F(LogV2Test, AsyncWritesDropWhenFull) {
+    // Backend which blocks while the test holds 'gate'.
+    class GatedCaptureBackend
+        : public boost::log::sinks::
+              basic_formatted_sink_backend<char, boost::log::sinks::synchronized_feeding> {
+    public:
+        GatedCaptureBackend(std::vector<std::string>& lines, stdx::mutex& gate)
+            : _lines(lines), _gate(gate) {}
+
+        void consume(boost::log::record_view const& rec, string_type const& formatted_string) {
+            stdx::lock_guard lk(_gate);
+            _lines.push_back(formatted_string);
+        }
+
+    private:
+        std::vector<std::string>& _lines;
+        stdx::mutex& _gate;  // NOLINT
+    };
+
+    std::vector<std::string> batches;
+    stdx::mutex gate;  // NOLINT
+    AsyncLogOptions asyncOptions;
+    asyncOptions.enabled = true;
+    asyncOptions.bufferSize = 8;
+    asyncOptions.overflowPolicy = AsyncLogOptions::OverflowPolicy::kDrop;
+    auto backend = boost::make_shared<AsyncBackend<GatedCaptureBackend>>(
+        boost::make_shared<GatedCaptureBackend>(batches, gate),
+        asyncOptions,
+        LogTimestampFormat::kISO8601UTC);
+    auto sink = wrapInUnlockedSink(backend);
+    applyDefaultFilterToSink(sink);
+    sink->set_formatter(PlainFormatter());
+    attachSink(sink);
+
+    // While the writer thread is blocked, at most one batch and one buffer's worth of records fit.
+    constexpr int kNumRecords = 100;
+    stdx::thread errorThread;
+    {
+        stdx::lock_guard lk(gate);
+        for (int i = 0; i < kNumRecords; ++i)
+            LOGV2(5121517, "dropped {i}", "i"_attr = i);
+        ASSERT_GTE(backend->droppedRecords(), kNumRecords - 16);
+
+        // An error is not dropped although the buffer is full, and waits for the writer instead.
+        errorThread = stdx::thread([] { LOGV2_ERROR(5121521, "error when full"); });
+    }
+    errorThread.join();
+    sink->flush();
+
+    // The records which were not dropped were written, followed by a notice of the drops. The
+    // error was written after the records logged before it.
+    int numRecords = 0;
+    bool sawNotice = false;
+    bool sawError = false;
+    for (auto&& batch : batches) {
+        std::istringstream batchStream(batch);
+        for (std::string line; std::getline(batchStream, line, '\n');) {
+            if (line.find("Dropped log records") != std::string::npos) {
+                sawNotice = true;
+            } else if (line == "error when full") {
+                ASSERT_FALSE(sawError);
+                sawError = true;
+            } else {
+                ASSERT_FALSE(sawError);
+                ++numRecords;
+            }
+        }
+    }
+    ASSERT_TRUE(sawNotice);
+    ASSERT_TRUE(sawError);
+    ASSERT_EQ(numRecords + backend->droppedRecords(), kNumRecords);
+}
+
 class UnstructuredLoggingTest : public LogV2JsonBsonTest {};
 
 TEST_F(UnstructuredLoggingTest, NoArgs) {
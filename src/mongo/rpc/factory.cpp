@@ -82,6 +82,13 @@ OpMsgRequest opMsgRequestFromAnyProtocol(const Message& unownedMessage) {
     }
 }
 
+OpMsgRequest opMsgRequestFromAnyProtocolWithUnownedSequences(const Message& unownedMessage) {
+    if (unownedMessage.operation() == mongo::dbMsg) {
+        return OpMsgRequest::parseOwnedBody(unownedMessage);
+    }
+    return opMsgRequestFromAnyProtocol(unownedMessage);
+}
+
 std::unique_ptr<ReplyBuilderInterface> makeReplyBuilder(Protocol protocol) {
     switch (protocol) {
         case Protocol::kOpMsg:
@@ -66,6 +66,13 @@ inline Message messageFromOpMsgRequest(ProtocolSet clientProtos,
  */
 OpMsgRequest opMsgRequestFromAnyProtocol(const Message& unownedMessage);
 
+/**
+ * Like opMsgRequestFromAnyProtocol(), but OP_MSG document sequences are left as unowned views into
+ * 'unownedMessage' rather than each sharing ownership of its buffer. Only use this when
+ * 'unownedMessage' outlives the returned request and any documents taken from its sequences.
+ */
+OpMsgRequest opMsgRequestFromAnyProtocolWithUnownedSequences(const Message& unownedMessage);
+
 /**
  * Returns the appropriate concrete ReplyBuilder.
  */
@@ -118,6 +118,20 @@ struct OpMsg {
         return msg;
     }
 
+    /**
+     * Parses and returns an OpMsg whose body is owned but whose document sequences are unowned
+     * views into the message. Unlike parseOwned(), this does not take a reference on the message
+     * buffer for every document in the sequences, which matters for large bulk writes. The caller
+     * must keep 'message' alive for as long as the document sequences are in use.
+     */
+    static OpMsg parseOwnedBody(const Message& message) {
+        auto msg = parse(message);
+        if (!msg.body.isOwned()) {
+            msg.body.shareOwnershipWith(message.sharedBuffer());
+        }
+        return msg;
+    }
+
     Message serialize() const;
 
     /**
@@ -164,6 +178,10 @@ struct OpMsgRequest : public OpMsg {
         return OpMsgRequest(OpMsg::parseOwned(message));
     }
 
+    static OpMsgRequest parseOwnedBody(const Message& message) {
+        return OpMsgRequest(OpMsg::parseOwnedBody(message));
+    }
+
     static OpMsgRequest fromDBAndBody(StringData db,
                                       BSONObj body,
                                       const BSONObj& extraFields = {}) {
@@ -219,6 +219,36 @@ TEST_F(OpMsgParser, SucceedsWithBodyThenSequence) {
     ASSERT_BSONOBJ_EQ(msg.sequences[0].objs[1], fromjson("{a: 2}"));
 }
 
+TEST_F(OpMsgParser, ParseOwnedBodyLeavesSequencesUnowned) {
+    OpMsgBytes bytes{
+        kNoFlags,  //
+        kBodySection,
+        fromjson("{insert: 'coll'}"),
+
+        kDocSequenceSection,
+        Sized{
+            "documents",  //
+            fromjson("{a: 1}"),
+            fromjson("{a: 2}"),
+        },
+    };
+    auto message = bytes.done();
+    auto msg = OpMsg::parseOwnedBody(message);
+
+    ASSERT_TRUE(msg.body.isOwned());
+    ASSERT_BSONOBJ_EQ(msg.body, fromjson("{insert: 'coll'}"));
+    ASSERT_EQ(msg.sequences.size(), 1u);
+    ASSERT_EQ(msg.sequences[0].objs.size(), 2u);
+    for (auto&& obj : msg.sequences[0].objs) {
+        ASSERT_FALSE(obj.isOwned());
+        // The documents point directly into the message rather than at a copy.
+        ASSERT_GTE(obj.objdata(), message.buf());
+        ASSERT_LT(obj.objdata(), message.buf() + message.size());
+    }
+    ASSERT_BSONOBJ_EQ(msg.sequences[0].objs[0], fromjson("{a: 1}"));
+    ASSERT_BSONOBJ_EQ(msg.sequences[0].objs[1], fromjson("{a: 2}"));
+}
+
 TEST_F(OpMsgParser, SucceedsWithSequenceThenBody) {
     auto msg =
         OpMsgBytes{
@@ -383,11 +383,33 @@ StatusWith<Shard::QueryResponse> ShardRemote::_exhaustiveFindOnConfig(
         qr.asFindCommand(&findCmdBuilder);
     }
 
-    return _runExhaustiveCursorCommand(opCtx,
-                                       grid->readPreferenceWithConfigTime(readPref),
-                                       nss.db().toString(),
-                                       maxTimeMS,
-                                       findCmdBuilder.done());
+    const auto readPrefWithConfigTime = grid->readPreferenceWithConfigTime(readPref);
+    const auto findCmd = findCmdBuilder.obj();
+
+    auto runFind = [&] {
+        return _runExhaustiveCursorCommand(
+            opCtx, readPrefWithConfigTime, nss.db().toString(), maxTimeMS, findCmd);
+    };
+
+    if (!gCoalesceIdenticalConfigReads.load()) {
+        return runFind();
+    }
+
+    // The maxTimeMS differs between callers, so it is left out of the key. Everything else which
+    // determines the result, including the config time in the read concern and read preference,
+    // is part of it.
+    const auto key = [&] {
+        BSONObjBuilder keyBuilder;
+        keyBuilder.append("cmd", findCmd.removeField(QueryRequest::cmdOptionMaxTimeMS));
+        keyBuilder.append("readPref", readPrefWithConfigTime.toInnerBSON());
+        auto keyObj = keyBuilder.obj();
+        return std::string(keyObj.objdata(), keyObj.objsize());
+    }();
+
+    // A caller which joins an identical read waits no longer than its own maxTimeMS would allow.
+    const auto deadline =
+        maxTimeMS < Milliseconds::max() ? Date_t::now() + maxTimeMS : Date_t::max();
+    return _configFindSingleFlight.run(opCtx, key, deadline, runFind);
 }
 
 Status ShardRemote::createIndexOnConfig(OperationContext* opCtx,
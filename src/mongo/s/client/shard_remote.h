@@ -35,6 +35,7 @@
 
 #include "mongo/executor/task_executor.h"
 #include "mongo/platform/mutex.h"
+#include "mongo/util/single_flight.h"
 
 namespace mongo {
 
@@ -138,6 +139,14 @@ private:
      */
     std::shared_ptr<RemoteCommandTargeter> _targeter;
 
+    /**
+     * Merges identical concurrent reads against the config server, so that a burst of routers or
+     * threads asking for the same config metadata results in a single round trip. Keyed on the
+     * serialized find command and read preference, which include the config time the read must
+     * observe.
+     */
+    SingleFlight<std::string, QueryResponse> _configFindSingleFlight;
+
     /**
      * Protects _lastCommittedOpTime.
      */
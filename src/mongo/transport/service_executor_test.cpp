@@ -41,6 +41,7 @@
 #include "mongo/transport/service_executor_fixed.h"
 #include "mongo/transport/service_executor_gen.h"
 #include "mongo/transport/service_executor_synchronous.h"
+#include "mongo/transport/service_executor_thread_per_core.h"
 #include "mongo/transport/transport_layer.h"
 #include "mongo/transport/transport_layer_mock.h"
 #include "mongo/unittest/barrier.h"
@@ -49,7 +50,9 @@
 #include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/future.h"
+#include "mongo/util/interruptible.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 
 #include <asio.hpp>
 
@@ -398,5 +401,207 @@ TEST_F(ServiceExecutorFixedFixture, StartAndShutdownAreDeterministic) {
     shutdownThread.join();
 }
 
+class ServiceExecutorThreadPerCoreFixture : public unittest::Test {
+protected:
+    static constexpr size_t kNumWorkers = 2;
+
+    void setUp() override {
+        executor = std::make_unique<ServiceExecutorThreadPerCore>(nullptr, kNumWorkers);
+    }
+
+    std::unique_ptr<ServiceExecutorThreadPerCore> executor;
+};
+
+TEST_F(ServiceExecutorThreadPerCoreFixture, ScheduleFailsBeforeStartup) {
+    scheduleBasicTask(executor.get(), false);
+}
+
+TEST_F(ServiceExecutorThreadPerCoreFixture, BasicTaskRuns) {
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    scheduleBasicTask(executor.get(), true);
+}
+
+TEST_F(ServiceExecutorThreadPerCoreFixture, ScheduleFailsAfterShutdown) {
+    ASSERT_OK(executor->start());
+    ASSERT_OK(executor->shutdown(kShutdownTime));
+
+    scheduleBasicTask(executor.get(), false);
+}
+
+TEST_F(ServiceExecutorThreadPerCoreFixture, TasksScheduledFromWorkerStayOnWorker) {
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    auto pf = makePromiseFuture<std::pair<int, int>>();
+    ASSERT_OK(executor->scheduleTask(
+        [this, promise = std::move(pf.promise)]() mutable {
+            auto parent = executor->getWorkerIndexForCurrentThread();
+            ASSERT_OK(executor->scheduleTask(
+                [this, parent, promise = std::move(promise)]() mutable {
+                    promise.emplaceValue(parent, executor->getWorkerIndexForCurrentThread());
+                },
+                ServiceExecutor::kEmptyFlags));
+        },
+        ServiceExecutor::kEmptyFlags));
+
+    auto [parent, child] = pf.future.get();
+    ASSERT_GTE(parent, 0);
+    ASSERT_EQ(executor->getWorkerIndexForCurrentThread(), -1);
+
+    // The only other worker may have stolen the child task, but it must have run on a worker.
+    ASSERT_GTE(child, 0);
+    ASSERT_LT(child, static_cast<int>(kNumWorkers));
+}
+
+TEST_F(ServiceExecutorThreadPerCoreFixture, IdleWorkerStealsFromBusyWorker) {
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    // Park one worker on a task that only finishes once the task it queued behind itself has run.
+    // That queued task can only run if the other worker steals it.
+    auto stolen = std::make_shared<unittest::Barrier>(2);
+    auto done = makePromiseFuture<void>();
+    ASSERT_OK(executor->scheduleTask(
+        [this, stolen, promise = std::move(done.promise)]() mutable {
+            auto owner = executor->getWorkerIndexForCurrentThread();
+            ASSERT_OK(executor->scheduleTask(
+                [this, stolen, owner] {
+                    ASSERT_NE(executor->getWorkerIndexForCurrentThread(), owner);
+                    stolen->countDownAndWait();
+                },
+                ServiceExecutor::kEmptyFlags));
+            stolen->countDownAndWait();
+            promise.emplaceValue();
+        },
+        ServiceExecutor::kEmptyFlags));
+    done.future.get();
+
+    BSONObjBuilder bob;
+    executor->appendStats(&bob);
+    auto stats = bob.obj();
+    ASSERT_EQ(stats["executor"].str(), "threadPerCore");
+    ASSERT_EQ(stats["threadsRunning"].numberInt(), static_cast<int>(kNumWorkers));
+    ASSERT_GTE(stats["tasksStolen"].numberLong(), 1);
+}
+
+TEST_F(ServiceExecutorThreadPerCoreFixture, RecursiveTaskRunsInline) {
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    auto pf = makePromiseFuture<bool>();
+    ASSERT_OK(executor->scheduleTask(
+        [this, promise = std::move(pf.promise)]() mutable {
+            bool ranInline = false;
+            ASSERT_OK(executor->scheduleTask([&ranInline] { ranInline = true; },
+                                             ServiceExecutor::kMayRecurse));
+            promise.emplaceValue(ranInline);
+        },
+        ServiceExecutor::kEmptyFlags));
+    ASSERT_TRUE(pf.future.get());
+}
+
+TEST_F(ServiceExecutorThreadPerCoreFixture, BlockedWorkersAreHandedOff) {
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    auto mutex = MONGO_MAKE_LATCH("BlockedWorkersAreHandedOff::mutex");
+    stdx::condition_variable cv;
+    size_t numBlocked = 0;
+    size_t numFinished = 0;
+    bool released = false;
+
+    // Block every worker on an Interruptible wait, as a lock wait or an awaitData getMore would.
+    for (size_t i = 0; i < kNumWorkers; ++i) {
+        ASSERT_OK(executor->scheduleTask(
+            [&] {
+                stdx::unique_lock<Latch> lk(mutex);
+                ++numBlocked;
+                cv.notify_all();
+                Interruptible::notInterruptible()->waitForConditionOrInterrupt(
+                    cv, lk, [&] { return released; });
+                ++numFinished;
+                cv.notify_all();
+            },
+            ServiceExecutor::kEmptyFlags));
+    }
+
+    {
+        stdx::unique_lock<Latch> lk(mutex);
+        cv.wait(lk, [&] { return numBlocked == kNumWorkers; });
+    }
+
+    // The task which ends the waits can only run once a blocked worker has handed its core off.
+    ASSERT_OK(executor->scheduleTask(
+        [&] {
+            stdx::lock_guard<Latch> lk(mutex);
+            released = true;
+            cv.notify_all();
+        },
+        ServiceExecutor::kEmptyFlags));
+
+    {
+        stdx::unique_lock<Latch> lk(mutex);
+        cv.wait(lk, [&] { return numFinished == kNumWorkers; });
+    }
+
+    BSONObjBuilder bob;
+    executor->appendStats(&bob);
+    ASSERT_GTE(bob.obj()["workersHandedOff"].numberLong(), 1);
+}
+
+TEST_F(ServiceExecutorThreadPerCoreFixture, HandOffsAreCapped) {
+    const auto oldMaxHandedOff = threadPerCoreServiceExecutorMaxHandedOffThreads.load();
+    threadPerCoreServiceExecutorMaxHandedOffThreads.store(0);
+    ON_BLOCK_EXIT([&] { threadPerCoreServiceExecutorMaxHandedOffThreads.store(oldMaxHandedOff); });
+
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    auto mutex = MONGO_MAKE_LATCH("HandOffsAreCapped::mutex");
+    stdx::condition_variable cv;
+    size_t numBlocked = 0;
+    size_t numFinished = 0;
+    bool released = false;
+
+    for (size_t i = 0; i < kNumWorkers; ++i) {
+        ASSERT_OK(executor->scheduleTask(
+            [&] {
+                stdx::unique_lock<Latch> lk(mutex);
+                ++numBlocked;
+                cv.notify_all();
+                Interruptible::notInterruptible()->waitForConditionOrInterrupt(
+                    cv, lk, [&] { return released; });
+                ++numFinished;
+                cv.notify_all();
+            },
+            ServiceExecutor::kEmptyFlags));
+    }
+
+    // Block past the point at which the workers would be handed off.
+    {
+        stdx::unique_lock<Latch> lk(mutex);
+        cv.wait(lk, [&] { return numBlocked == kNumWorkers; });
+    }
+    sleepFor(Interruptible::kFastWakeTimeout * 3);
+
+    {
+        stdx::lock_guard<Latch> lk(mutex);
+        released = true;
+        cv.notify_all();
+    }
+    {
+        stdx::unique_lock<Latch> lk(mutex);
+        cv.wait(lk, [&] { return numFinished == kNumWorkers; });
+    }
+
+    BSONObjBuilder bob;
+    executor->appendStats(&bob);
+    auto stats = bob.obj();
+    ASSERT_EQ(stats["workersHandedOff"].numberLong(), 0);
+    ASSERT_EQ(stats["threadsRunning"].numberInt(), static_cast<int>(kNumWorkers));
+}
+
 }  // namespace
 }  // namespace mongo
@@ -0,0 +1,427 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kExecutor
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/service_executor_thread_per_core.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "mongo/base/init.h"
+#include "mongo/logv2/log.h"
+#include "mongo/transport/service_executor_gen.h"
+#include "mongo/transport/service_executor_utils.h"
+#include "mongo/transport/session.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/interruptible.h"
+#include "mongo/util/processinfo.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+constexpr auto kThreadsRunning = "threadsRunning"_sd;
+constexpr auto kExecutorLabel = "executor"_sd;
+constexpr auto kExecutorName = "threadPerCore"_sd;
+constexpr auto kTasksQueued = "tasksQueued"_sd;
+constexpr auto kTasksStolen = "tasksStolen"_sd;
+constexpr auto kTasksRecursed = "tasksRecursed"_sd;
+constexpr auto kWorkersHandedOff = "workersHandedOff"_sd;
+
+// How long the destructor waits for the threads which are still finishing a task after shutdown.
+constexpr auto kDestructorExitTimeout = Seconds(10);
+
+size_t getNumWorkers(size_t requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    return std::max<size_t>(1, ProcessInfo::getNumAvailableCores());
+}
+
+/**
+ * Pins the current thread to a single core. This is only a hint for locality, so failing to set
+ * the affinity is not an error.
+ */
+void pinCurrentThreadToCore(size_t workerIndex) {
+#if defined(__linux__)
+    cpu_set_t available;
+    if (sched_getaffinity(0, sizeof(available), &available) != 0) {
+        return;
+    }
+
+    // Map the worker onto the N-th core this process is allowed to run on.
+    const auto numAvailable = static_cast<size_t>(CPU_COUNT(&available));
+    if (numAvailable == 0) {
+        return;
+    }
+
+    auto target = workerIndex % numAvailable;
+    for (size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (!CPU_ISSET(cpu, &available)) {
+            continue;
+        }
+        if (target-- == 0) {
+            cpu_set_t pinned;
+            CPU_ZERO(&pinned);
+            CPU_SET(cpu, &pinned);
+            if (int err = pthread_setaffinity_np(pthread_self(), sizeof(pinned), &pinned)) {
+                LOGV2_DEBUG(5121501,
+                            3,
+                            "Unable to pin service executor worker to core",
+                            "worker"_attr = workerIndex,
+                            "core"_attr = cpu,
+                            "error"_attr = errnoWithDescription(err));
+            }
+            return;
+        }
+    }
+#endif
+}
+
+MONGO_INITIALIZER(ThreadPerCoreServiceExecutorWaitListener)(InitializerContext*) {
+    class WaitListener : public Interruptible::WaitListener {
+        void onLongSleep(const StringData&) override {
+            ServiceExecutorThreadPerCore::handOffCurrentWorker();
+        }
+
+        void onWake(const StringData&,
+                    Interruptible::WakeReason,
+                    Interruptible::WakeSpeed) override {}
+    };
+
+    Interruptible::installWaitListener<WaitListener>();
+    return Status::OK();
+}
+}  // namespace
+
+ServiceExecutorThreadPerCore::ServiceExecutorThreadPerCore(ReactorHandle networkReactor,
+                                                           size_t numWorkers)
+    : _networkReactor(std::move(networkReactor)), _numWorkers(getNumWorkers(numWorkers)) {
+    _workers.reserve(_numWorkers);
+    for (size_t i = 0; i < _numWorkers; ++i) {
+        _workers.push_back(std::make_unique<Worker>(i));
+    }
+}
+
+ServiceExecutorThreadPerCore::~ServiceExecutorThreadPerCore() {
+    invariant(!_canScheduleWork.load());
+    if (_state == State::kNotStarted)
+        return;
+
+    // Ensures we always call "shutdown" after starting the service executor
+    invariant(_state == State::kStopped);
+    if (_networkThread.joinable()) {
+        _networkThread.join();
+    }
+
+    // Worker threads are detached, and a handed off worker may still be finishing its task, for
+    // example if it is blocked on a wait which shutdown does not interrupt. Do not wait for it
+    // forever: once handed off, a thread only touches the state it shares with the executor.
+    if (!_threads->waitForExit(kDestructorExitTimeout)) {
+        LOGV2_WARNING(5121522,
+                      "Destroying the thread-per-core service executor while some of its threads "
+                      "are still running",
+                      "numRunning"_attr = _threads->numRunning.load(),
+                      "numHandedOff"_attr = _threads->numHandedOff.load());
+    }
+}
+
+bool ServiceExecutorThreadPerCore::Threads::waitForExit(Milliseconds timeout) {
+    stdx::unique_lock<Latch> lk(mutex);
+    return exited.wait_for(
+        lk, timeout.toSystemDuration(), [this] { return numRunning.load() == 0; });
+}
+
+Status ServiceExecutorThreadPerCore::start() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto oldState = std::exchange(_state, State::kRunning);
+    invariant(oldState == State::kNotStarted);
+
+    _canScheduleWork.store(true);
+    for (auto& worker : _workers) {
+        if (auto status = _startWorkerThread(worker.get()); !status.isOK()) {
+            return status;
+        }
+    }
+
+    if (_networkReactor) {
+        _networkThread = stdx::thread([reactor = _networkReactor] {
+            setThreadName("ThreadPerCoreNetwork");
+            reactor->run();
+        });
+    }
+
+    LOGV2_DEBUG(5121502,
+                3,
+                "Started thread-per-core service executor",
+                "numWorkers"_attr = _numWorkers);
+    return Status::OK();
+}
+
+Status ServiceExecutorThreadPerCore::shutdown(Milliseconds timeout) {
+    LOGV2_DEBUG(5121503, 3, "Shutting down thread-per-core service executor");
+
+    stdx::unique_lock<Latch> lk(_mutex);
+    _canScheduleWork.store(false);
+    if (std::exchange(_state, State::kStopped) == State::kNotStarted) {
+        return Status::OK();
+    }
+    _workAvailable.notify_all();
+    if (_networkReactor) {
+        _networkReactor->stop();
+    }
+    lk.unlock();
+
+    bool success = _threads->waitForExit(timeout);
+
+    if (_networkThread.joinable()) {
+        _networkThread.join();
+    }
+    return success ? Status::OK()
+                   : Status(ErrorCodes::ExceededTimeLimit,
+                            "Failed to shutdown all executor threads within the time limit");
+}
+
+Status ServiceExecutorThreadPerCore::scheduleTask(Task task, ScheduleFlags flags) {
+    if (!_canScheduleWork.load()) {
+        return Status(ErrorCodes::ShutdownInProgress, "Executor is not running");
+    }
+
+    auto localWorker = _localExecutor == this ? _localWorker : nullptr;
+    if (localWorker) {
+        if ((flags & ScheduleFlags::kMayRecurse) &&
+            _localRecursionDepth < threadPerCoreServiceExecutorRecursionLimit.loadRelaxed()) {
+            _numTasksRecursed.fetchAndAddRelaxed(1);
+            ++_localRecursionDepth;
+            task();
+            --_localRecursionDepth;
+            return Status::OK();
+        }
+
+        // Keep the task on the core that scheduled it.
+        _push(localWorker, std::move(task));
+        return Status::OK();
+    }
+
+    auto worker = _workers[_nextWorker.fetchAndAddRelaxed(1) % _numWorkers].get();
+    _push(worker, std::move(task));
+    return Status::OK();
+}
+
+void ServiceExecutorThreadPerCore::runOnDataAvailable(
+    Session* session, OutOfLineExecutor::Task onCompletionCallback) {
+    invariant(session);
+    session->waitForData().getAsync(
+        [this, callback = std::move(onCompletionCallback)](Status status) mutable {
+            if (!status.isOK()) {
+                callback(std::move(status));
+                return;
+            }
+
+            if (!_canScheduleWork.load()) {
+                callback(Status(ErrorCodes::ShutdownInProgress, "Executor is not running"));
+                return;
+            }
+
+            // Once the executor has accepted the task, it only drops it if it shuts down before
+            // running it.
+            scheduleTask([callback = std::move(callback)]() mutable { callback(Status::OK()); },
+                         ScheduleFlags::kEmptyFlags)
+                .ignore();
+        });
+}
+
+void ServiceExecutorThreadPerCore::appendStats(BSONObjBuilder* bob) const {
+    *bob << kExecutorLabel << kExecutorName << kThreadsRunning
+         << static_cast<int>(_threads->numRunning.load()) << kTasksQueued
+         << static_cast<long long>(_numQueuedTasks.load()) << kTasksStolen
+         << _numTasksStolen.load() << kTasksRecursed << _numTasksRecursed.load()
+         << kWorkersHandedOff << _numWorkersHandedOff.load();
+}
+
+int ServiceExecutorThreadPerCore::getWorkerIndexForCurrentThread() const {
+    if (_localExecutor != this || !_localWorker) {
+        return -1;
+    }
+    return static_cast<int>(_localWorker->index);
+}
+
+void ServiceExecutorThreadPerCore::handOffCurrentWorker() {
+    auto executor = _localExecutor;
+    if (!executor || !_localWorker || !executor->_canScheduleWork.load()) {
+        return;
+    }
+
+    // Bound the number of threads which blocked workers leave behind. Past it, a blocked worker
+    // keeps its core, and the other workers steal the tasks queued behind it.
+    const auto& threads = executor->_threads;
+    const auto maxHandedOff = threadPerCoreServiceExecutorMaxHandedOffThreads.loadRelaxed();
+    if (threads->numHandedOff.fetchAndAdd(1) >= static_cast<size_t>(std::max(maxHandedOff, 0))) {
+        threads->numHandedOff.subtractAndFetch(1);
+        return;
+    }
+
+    auto worker = std::exchange(_localWorker, nullptr);
+    if (auto status = executor->_startWorkerThread(worker); !status.isOK()) {
+        // Keep serving the worker rather than leave its queue without a thread.
+        threads->numHandedOff.subtractAndFetch(1);
+        _localWorker = worker;
+        return;
+    }
+
+    executor->_numWorkersHandedOff.fetchAndAddRelaxed(1);
+    LOGV2_DEBUG(5121519,
+                3,
+                "Handed off a blocked thread-per-core service executor worker",
+                "worker"_attr = worker->index);
+}
+
+Status ServiceExecutorThreadPerCore::_startWorkerThread(Worker* worker) {
+    _threads->numRunning.addAndFetch(1);
+    auto status = launchServiceWorkerThread([this, worker, threads = _threads] {
+        const bool handedOff = _runWorker(worker);
+
+        // Only touch the shared state from here on, as the executor may be gone.
+        stdx::lock_guard<Latch> lk(threads->mutex);
+        if (handedOff) {
+            threads->numHandedOff.subtractAndFetch(1);
+        }
+        if (threads->numRunning.subtractAndFetch(1) == 0) {
+            threads->exited.notify_all();
+        }
+    });
+    if (!status.isOK()) {
+        _threads->numRunning.subtractAndFetch(1);
+    }
+    return status;
+}
+
+void ServiceExecutorThreadPerCore::_push(Worker* worker, Task task) {
+    _numQueuedTasks.fetchAndAdd(1);
+    {
+        stdx::lock_guard<Latch> lk(worker->mutex);
+        worker->tasks.push_back(std::move(task));
+    }
+
+    // The sleeping count is raised before a worker re-checks the queued count under _mutex, so
+    // either that worker sees this task or we see it sleeping.
+    if (_numSleepingWorkers.load() > 0) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _workAvailable.notify_one();
+    }
+}
+
+boost::optional<ServiceExecutor::Task> ServiceExecutorThreadPerCore::_getNextTask(Worker* worker) {
+    auto tryPop = [&](Worker* victim, bool fromFront) -> boost::optional<Task> {
+        stdx::lock_guard<Latch> lk(victim->mutex);
+        if (victim->tasks.empty()) {
+            return boost::none;
+        }
+
+        Task task;
+        if (fromFront) {
+            task = std::move(victim->tasks.front());
+            victim->tasks.pop_front();
+        } else {
+            task = std::move(victim->tasks.back());
+            victim->tasks.pop_back();
+        }
+        _numQueuedTasks.fetchAndSubtract(1);
+        return std::move(task);
+    };
+
+    if (auto task = tryPop(worker, true)) {
+        return task;
+    }
+
+    if (_numQueuedTasks.load() == 0) {
+        return boost::none;
+    }
+
+    // Visit the other workers starting with our neighbour, so that thieves spread out.
+    for (size_t i = 1; i < _numWorkers; ++i) {
+        auto victim = _workers[(worker->index + i) % _numWorkers].get();
+        if (auto task = tryPop(victim, false)) {
+            _numTasksStolen.fetchAndAddRelaxed(1);
+            return task;
+        }
+    }
+
+    return boost::none;
+}
+
+bool ServiceExecutorThreadPerCore::_runWorker(Worker* worker) {
+    setThreadName(str::stream() << "ThreadPerCoreExecutor-" << worker->index);
+    pinCurrentThreadToCore(worker->index);
+
+    _localExecutor = this;
+    _localWorker = worker;
+
+    // A thread which was handed off stops serving the worker once its current task is done, and
+    // does not touch the executor again.
+    while (_localWorker == worker && _canScheduleWork.load()) {
+        if (auto task = _getNextTask(worker)) {
+            _localRecursionDepth = 1;
+            (*task)();
+            continue;
+        }
+
+        stdx::unique_lock<Latch> lk(_mutex);
+        _numSleepingWorkers.fetchAndAdd(1);
+        _workAvailable.wait(
+            lk, [&] { return _numQueuedTasks.load() > 0 || !_canScheduleWork.load(); });
+        _numSleepingWorkers.fetchAndSubtract(1);
+    }
+
+    const bool handedOff = _localWorker != worker;
+
+    // Outstanding tasks are not executed after shutdown.
+    if (!handedOff) {
+        std::deque<Task> droppedTasks;
+        {
+            stdx::lock_guard<Latch> lk(worker->mutex);
+            droppedTasks.swap(worker->tasks);
+        }
+        _numQueuedTasks.fetchAndSubtract(droppedTasks.size());
+        droppedTasks.clear();
+    }
+
+    _localWorker = nullptr;
+    _localExecutor = nullptr;
+    return handedOff;
+}
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,186 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/service_executor.h"
+#include "mongo/transport/transport_layer.h"
+#include "mongo/util/duration.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * A service executor that runs one worker thread per available CPU core, each pinned to its core
+ * (where the platform allows) and owning its own run queue.
+ *
+ * Tasks scheduled from a worker thread go onto that worker's queue, so a session keeps running on
+ * the core it last ran on. Tasks scheduled from any other thread are spread round-robin across the
+ * workers. A worker whose queue is empty steals from the back of the other workers' queues before
+ * going to sleep, so a long running task on one core does not hold up the sessions queued behind
+ * it while other cores are idle.
+ *
+ * Many sessions share each worker, so sessions must not block a worker on their sockets. The
+ * executor runs in asynchronous mode: sessions read and write through the ingress reactor, which a
+ * dedicated network thread runs, and their completions are scheduled onto the workers.
+ *
+ * Commands may still block, for example on a lock or in an awaitData getMore. When a task on a
+ * worker has been waiting on an Interruptible for longer than Interruptible::kFastWakeTimeout,
+ * the worker hands its core and run queue to a new thread and exits once that task is done, so a
+ * few blocked operations cannot hold up every session queued behind them.
+ */
+class ServiceExecutorThreadPerCore final : public ServiceExecutor {
+public:
+    /**
+     * Creates an executor with 'numWorkers' worker threads, or one per available core if
+     * 'numWorkers' is 0. If 'networkReactor' is set, the executor runs it on its own thread between
+     * start() and shutdown(); it must be the reactor that the sessions' sockets belong to.
+     */
+    explicit ServiceExecutorThreadPerCore(ReactorHandle networkReactor, size_t numWorkers = 0);
+    ~ServiceExecutorThreadPerCore();
+
+    Status start() override;
+    Status shutdown(Milliseconds timeout) override;
+    Status scheduleTask(Task task, ScheduleFlags flags) override;
+
+    void runOnDataAvailable(Session* session,
+                            OutOfLineExecutor::Task onCompletionCallback) override;
+
+    Mode transportMode() const override {
+        return Mode::kAsynchronous;
+    }
+
+    void appendStats(BSONObjBuilder* bob) const override;
+
+    /**
+     * Returns the index of the worker running the current thread, or -1 if the current thread is
+     * not one of this executor's workers.
+     */
+    int getWorkerIndexForCurrentThread() const;
+
+    /**
+     * Called when the current thread has been blocked for a while. If it is one of the workers of
+     * a running executor, and fewer than threadPerCoreServiceExecutorMaxHandedOffThreads threads
+     * are finishing a task after a hand off, a new thread takes over its core and run queue, and
+     * the current thread exits once it has finished its current task.
+     */
+    static void handOffCurrentWorker();
+
+private:
+    struct Worker {
+        explicit Worker(size_t index) : index(index) {}
+
+        const size_t index;
+
+        // Guards "tasks". The owning worker pops from the front; thieves take from the back.
+        Mutex mutex = MONGO_MAKE_LATCH("ServiceExecutorThreadPerCore::Worker::mutex");
+        std::deque<Task> tasks;
+    };
+
+    /**
+     * The worker threads which are running. It is shared with the threads, so that a thread which
+     * is still finishing a task when the executor is destroyed can report its exit.
+     */
+    struct Threads {
+        Mutex mutex = MONGO_MAKE_LATCH("ServiceExecutorThreadPerCore::Threads::mutex");
+        stdx::condition_variable exited;
+
+        // Number of worker threads, including those which were handed off and are finishing a
+        // task.
+        AtomicWord<size_t> numRunning{0};
+        // Number of threads which were handed off and are finishing a task.
+        AtomicWord<size_t> numHandedOff{0};
+
+        /**
+         * Waits up to 'timeout' for every thread to exit, and returns whether they all did.
+         */
+        bool waitForExit(Milliseconds timeout);
+    };
+
+    // Starts a thread which serves 'worker' until the executor shuts down or the thread is handed
+    // off.
+    Status _startWorkerThread(Worker* worker);
+
+    // Serves 'worker' on the current thread. Returns true if the thread was handed off, in which
+    // case the executor must not be touched anymore, as it may already have been destroyed.
+    bool _runWorker(Worker* worker);
+
+    // Pops a task from the worker's own queue, or steals one from another worker's queue.
+    boost::optional<Task> _getNextTask(Worker* worker);
+
+    void _push(Worker* worker, Task task);
+
+    const ReactorHandle _networkReactor;
+    stdx::thread _networkThread;
+
+    const size_t _numWorkers;
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    AtomicWord<bool> _canScheduleWork{false};
+
+    // Total number of tasks sitting in all of the worker queues. A task is counted before it is
+    // queued, so that it is never popped before it is counted.
+    AtomicWord<size_t> _numQueuedTasks{0};
+    AtomicWord<size_t> _nextWorker{0};
+
+    const std::shared_ptr<Threads> _threads = std::make_shared<Threads>();
+
+    AtomicWord<long long> _numTasksStolen{0};
+    AtomicWord<long long> _numTasksRecursed{0};
+    AtomicWord<long long> _numWorkersHandedOff{0};
+
+    // Guards sleeping and waking up of idle workers, as well as the state transitions.
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("ServiceExecutorThreadPerCore::_mutex");
+    stdx::condition_variable _workAvailable;
+    AtomicWord<size_t> _numSleepingWorkers{0};
+
+    /**
+     * State transition diagram: kNotStarted ---> kRunning ---> kStopped
+     */
+    enum State { kNotStarted, kRunning, kStopped } _state = kNotStarted;
+
+    // The worker served by the current thread. Reset when the thread is handed off.
+    static inline thread_local Worker* _localWorker = nullptr;
+    static inline thread_local ServiceExecutorThreadPerCore* _localExecutor = nullptr;
+    static inline thread_local int _localRecursionDepth = 0;
+};
+
+}  // namespace transport
+}  // namespace mongo
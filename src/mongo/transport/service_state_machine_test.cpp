@@ -31,6 +31,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/base/checked_cast.h"
@@ -44,13 +45,18 @@
 #include "mongo/transport/mock_session.h"
 #include "mongo/transport/service_entry_point.h"
 #include "mongo/transport/service_executor.h"
+#include "mongo/transport/service_executor_thread_per_core.h"
 #include "mongo/transport/service_executor_utils.h"
 #include "mongo/transport/service_state_machine.h"
+#include "mongo/transport/transport_layer_asio.h"
 #include "mongo/transport/transport_layer_mock.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/clock_source_mock.h"
 #include "mongo/util/tick_source_mock.h"
+#include "mongo/util/time_support.h"
+
+#include <asio.hpp>
 
 namespace mongo {
 namespace {
@@ -745,5 +751,127 @@ TEST_F(ServiceStateMachineFixture, SSMRunsRecursively) {
     ASSERT_EQ(_ssm->state(), State::Ended);
 }
 
+/**
+ * Runs every accepted session through a ServiceStateMachine, and replies to each command with the
+ * value of its "ping" field.
+ */
+class EchoPingSEP : public ServiceEntryPoint {
+public:
+    void startSession(transport::SessionHandle session) override {
+        auto svcCtx = getGlobalServiceContext();
+        auto ssm = ServiceStateMachine::create(
+            svcCtx, std::move(session), svcCtx->getServiceExecutor()->transportMode());
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _ssms.push_back(ssm);
+        }
+        ssm->start(ServiceStateMachine::Ownership::kOwned);
+    }
+
+    Future<DbResponse> handleRequest(OperationContext* opCtx,
+                                     const Message& request) noexcept override try {
+        auto ping = OpMsg::parse(request).body["ping"].numberInt();
+        DbResponse dbResponse;
+        dbResponse.response = buildOpMsg(BSON("ok" << 1 << "ping" << ping));
+        return Future<DbResponse>::makeReady(std::move(dbResponse));
+    } catch (const DBException& e) {
+        return e.toStatus();
+    }
+
+    void endAllSessions(transport::Session::TagMask tags) override {}
+
+    Status start() override {
+        return Status::OK();
+    }
+
+    bool shutdown(Milliseconds timeout) override {
+        return true;
+    }
+
+    void appendStats(BSONObjBuilder*) const override {}
+
+    size_t numOpenSessions() const override {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return _ssms.size();
+    }
+
+    /**
+     * Waits for every session to end and then destroys their state machines.
+     */
+    void waitForSessionsToEnd() {
+        auto allEnded = [&] {
+            stdx::lock_guard<Latch> lk(_mutex);
+            return std::all_of(_ssms.begin(), _ssms.end(), [](auto& ssm) {
+                return ssm->state() == State::Ended;
+            });
+        };
+        while (!allEnded()) {
+            sleepmillis(1);
+        }
+
+        stdx::lock_guard<Latch> lk(_mutex);
+        _ssms.clear();
+    }
+
+private:
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("EchoPingSEP::_mutex");
+    std::vector<std::shared_ptr<ServiceStateMachine>> _ssms;
+};
+
+TEST(ServiceStateMachineThreadPerCore, CommandsGetRepliesOverTheNetwork) {
+    setGlobalServiceContext(ServiceContext::make());
+    auto svcCtx = getGlobalServiceContext();
+
+    auto ownedSep = std::make_unique<EchoPingSEP>();
+    auto sep = ownedSep.get();
+    svcCtx->setServiceEntryPoint(std::move(ownedSep));
+
+    auto tla = [&] {
+        ServerGlobalParams params;
+        params.noUnixSocket = true;
+        TransportLayerASIO::Options opts(&params);
+        opts.port = 0;
+        opts.transportMode = Mode::kAsynchronous;
+        return std::make_unique<TransportLayerASIO>(opts, sep);
+    }();
+    ASSERT_OK(tla->setup());
+
+    svcCtx->setServiceExecutor(std::make_unique<ServiceExecutorThreadPerCore>(
+        tla->getReactor(TransportLayer::kIngress), 2));
+    ASSERT_OK(svcCtx->getServiceExecutor()->start());
+    ASSERT_OK(tla->start());
+
+    asio::io_context ioContext;
+    asio::ip::tcp::socket socket(ioContext);
+    socket.connect(asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), tla->listenerPort()));
+
+    // Each command is only sent once the previous reply has arrived, so the session goes back to
+    // waiting on the network reactor between commands.
+    constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
+    for (int i = 0; i < 3; ++i) {
+        auto request = buildOpMsg(BSON("ping" << i));
+        request.header().setId(i);
+        asio::write(socket, asio::buffer(request.buf(), request.size()));
+
+        auto buffer = SharedBuffer::allocate(kHeaderSize);
+        asio::read(socket, asio::buffer(buffer.get(), kHeaderSize));
+        const auto length = MSGHEADER::ConstView(buffer.get()).getMessageLength();
+        ASSERT_GT(length, static_cast<int>(kHeaderSize));
+        buffer.realloc(length);
+        asio::read(socket, asio::buffer(buffer.get() + kHeaderSize, length - kHeaderSize));
+
+        Message reply(std::move(buffer));
+        ASSERT_EQ(reply.header().getResponseToMsgId(), i);
+        ASSERT_BSONOBJ_EQ(OpMsg::parse(reply).body, BSON("ok" << 1 << "ping" << i));
+    }
+
+    // Closing the connection ends the session through the reactor as well.
+    socket.close();
+    sep->waitForSessionsToEnd();
+
+    tla->shutdown();
+    ASSERT_OK(svcCtx->getServiceExecutor()->shutdown(Seconds(10)));
+}
+
 }  // namespace
 }  // namespace mongo
@@ -37,6 +37,7 @@
 #include "mongo/transport/asio_utils.h"
 #include "mongo/transport/baton.h"
 #include "mongo/transport/transport_layer_asio.h"
+#include "mongo/transport/transport_options_gen.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/net/socket_utils.h"
 #ifdef MONGO_CONFIG_SSL
@@ -168,6 +169,10 @@ public:
     }
 
     Future<void> waitForData() override {
+        if (_readAheadBegin < _readAheadEnd) {
+            // The next message has already been pulled off of the socket.
+            return Future<void>::makeReady();
+        }
 #ifdef MONGO_CONFIG_SSL
         if (_sslSocket)
             return asio::async_read(*_sslSocket, asio::null_buffers(), UseFuture{}).ignoreValue();
@@ -222,6 +227,11 @@ public:
         if (!getSocket().is_open())
             return false;
 
+        // A peer which sent a message and then closed its end is still connected until the bytes
+        // which were read ahead of that message have been consumed.
+        if (_readAheadBegin < _readAheadEnd)
+            return true;
+
         auto swPollEvents = pollASIOSocket(getSocket(), POLLIN, Milliseconds{0});
         if (!swPollEvents.isOK()) {
             if (swPollEvents != ErrorCodes::NetworkTimeout) {
@@ -475,7 +485,70 @@ private:
                 });
         }
 #endif
-        return opportunisticRead(_socket, buffers, baton);
+        return plaintextRead(buffers, baton);
+    }
+
+    /**
+     * Reads into 'buffer' from a socket that is not using SSL. Small reads ask the kernel for up
+     * to transportLayerASIOReadAheadBytes at once and keep whatever is left over for the next
+     * read, so that a message's header and body (and often the next message) arrive in a single
+     * syscall rather than one per read.
+     */
+    Future<void> plaintextRead(asio::mutable_buffer buffer, const BatonHandle& baton) {
+        buffer += consumeReadAhead(buffer);
+        if (buffer.size() == 0) {
+            return Future<void>::makeReady();
+        }
+
+        const auto readAheadBytes = static_cast<size_t>(gTransportLayerASIOReadAheadBytes);
+        if (buffer.size() < readAheadBytes &&
+            MONGO_likely(!transportLayerASIOshortOpportunisticReadWrite.shouldFail())) {
+            auto readAheadBuffer = SharedBuffer::allocate(readAheadBytes);
+
+            std::error_code ec;
+            size_t size;
+            do {
+                size = _socket.read_some(asio::buffer(readAheadBuffer.get(), readAheadBytes), ec);
+            } while (ec == asio::error::interrupted);  // retry syscall EINTR
+
+            if (!ec) {
+                _readAheadBuffer = std::move(readAheadBuffer);
+                _readAheadBegin = 0;
+                _readAheadEnd = size;
+
+                buffer += consumeReadAhead(buffer);
+                if (buffer.size() == 0) {
+                    return Future<void>::makeReady();
+                }
+            } else if (!(((ec == asio::error::would_block) || (ec == asio::error::try_again)) &&
+                         (_blockingMode == Async))) {
+                return futurize(ec);
+            }
+        }
+
+        return opportunisticRead(_socket, buffer, baton);
+    }
+
+    /**
+     * Copies as many read-ahead bytes as fit into 'buffer' and returns how many were copied.
+     */
+    size_t consumeReadAhead(const asio::mutable_buffer& buffer) {
+        const auto available = _readAheadEnd - _readAheadBegin;
+        if (available == 0) {
+            return 0;
+        }
+
+        const auto size = std::min(available, buffer.size());
+        memcpy(buffer.data(), _readAheadBuffer.get() + _readAheadBegin, size);
+        _readAheadBegin += size;
+
+        if (_readAheadBegin == _readAheadEnd) {
+            // Release the buffer so that idle sessions do not hold on to read-ahead memory.
+            _readAheadBuffer = {};
+            _readAheadBegin = _readAheadEnd = 0;
+        }
+
+        return size;
     }
 
     template <typename ConstBufferSequence>
@@ -812,6 +885,13 @@ private:
     boost::optional<Milliseconds> _socketTimeout;
 
     GenericSocket _socket;
+
+    // Bytes which plaintextRead() pulled off of _socket ahead of the read that asked for them, in
+    // [_readAheadBegin, _readAheadEnd). The buffer is only held while some of those bytes are left.
+    SharedBuffer _readAheadBuffer;
+    size_t _readAheadBegin = 0;
+    size_t _readAheadEnd = 0;
+
 #ifdef MONGO_CONFIG_SSL
     boost::optional<asio::ssl::stream<decltype(_socket)>> _sslSocket;
     bool _ranHandshake = false;
@@ -36,9 +36,11 @@
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/op_msg.h"
 #include "mongo/transport/service_entry_point.h"
+#include "mongo/transport/transport_options_gen.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/net/sock.h"
+#include "mongo/util/scopeguard.h"
 
 #include "asio.hpp"
 
@@ -386,5 +388,90 @@ TEST(TransportLayerASIO, SwitchTimeoutModes) {
     tla->shutdown();
 }
 
+/* check that plaintext read-ahead returns every message intact, whatever the buffer boundaries */
+class ReadAheadSEP : public TimeoutSEP {
+public:
+    explicit ReadAheadSEP(std::vector<size_t> padSizes) : _padSizes(std::move(padSizes)) {}
+
+    void startSession(transport::SessionHandle session) override {
+        startWorkerThread([this, session = std::move(session)]() mutable {
+            for (size_t i = 0; i < _padSizes.size(); ++i) {
+                // The peer has closed its end by now, but the session must still report itself
+                // as connected while the rest of what the peer sent is left to read.
+                ASSERT_TRUE(session->isConnected());
+
+                auto swMessage = session->sourceMessage();
+                ASSERT_OK(swMessage.getStatus());
+                auto body = OpMsg::parse(swMessage.getValue()).body;
+                ASSERT_EQ(body["ping"].numberLong(), static_cast<long long>(i));
+                ASSERT_EQ(body["pad"].String().size(), _padSizes[i]);
+            }
+
+            session.reset();
+            notifyComplete();
+        });
+    }
+
+    static Message makePing(long long id, size_t padSize) {
+        OpMsgBuilder builder;
+        builder.setBody(BSON("ping" << id << "pad" << std::string(padSize, 'x')));
+        Message msg = builder.finish();
+        msg.header().setResponseToMsgId(0);
+        msg.header().setId(0);
+        OpMsg::appendChecksum(&msg);
+        return msg;
+    }
+
+private:
+    const std::vector<size_t> _padSizes;
+};
+
+/* sends a batch of pipelined messages with a single write and closes the connection */
+void sendPipelinedAndClose(int port, const std::vector<size_t>& padSizes) {
+    asio::io_context ctx;
+    asio::ip::tcp::socket sock(ctx);
+    std::error_code ec;
+    sock.connect(asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), port), ec);
+    ASSERT_EQ(ec, std::error_code());
+
+    std::string bytes;
+    for (size_t i = 0; i < padSizes.size(); ++i) {
+        auto msg = ReadAheadSEP::makePing(i, padSizes[i]);
+        bytes.append(msg.buf(), msg.size());
+    }
+    asio::write(sock, asio::buffer(bytes), ec);
+    ASSERT_FALSE(ec);
+    sock.close();
+}
+
+TEST(TransportLayerASIO, ReadAheadPacksMessagesIntoOneBuffer) {
+    // Every message fits in the default read-ahead buffer along with the ones after it.
+    const std::vector<size_t> padSizes{0, 10, 3, 100, 1};
+    ReadAheadSEP sep(padSizes);
+    auto tla = makeAndStartTL(&sep);
+
+    sendPipelinedAndClose(tla->listenerPort(), padSizes);
+
+    ASSERT_TRUE(sep.waitForTimeout(Milliseconds{10000}));
+    tla->shutdown();
+}
+
+TEST(TransportLayerASIO, ReadAheadSplitsMessagesAcrossBuffers) {
+    // A read-ahead buffer smaller than the messages splits their headers and bodies across
+    // buffers, and leaves the rest of large bodies to be read directly.
+    const auto oldReadAheadBytes = gTransportLayerASIOReadAheadBytes;
+    gTransportLayerASIOReadAheadBytes = 64;
+    ON_BLOCK_EXIT([&] { gTransportLayerASIOReadAheadBytes = oldReadAheadBytes; });
+
+    const std::vector<size_t> padSizes{0, 5, 100, 17, 1000, 3, 40};
+    ReadAheadSEP sep(padSizes);
+    auto tla = makeAndStartTL(&sep);
+
+    sendPipelinedAndClose(tla->listenerPort(), padSizes);
+
+    ASSERT_TRUE(sep.waitForTimeout(Milliseconds{10000}));
+    tla->shutdown();
+}
+
 }  // namespace
 }  // namespace mongo
@@ -42,7 +42,9 @@
 #include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
 #include "mongo/logv2/log.h"
+#include "mongo/transport/service_executor_gen.h"
 #include "mongo/transport/service_executor_synchronous.h"
+#include "mongo/transport/service_executor_thread_per_core.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/transport_layer_asio.h"
 #include "mongo/util/net/ssl_types.h"
@@ -134,12 +136,20 @@ std::unique_ptr<TransportLayer> TransportLayerManager::createWithConfig(
     auto sep = ctx->getServiceEntryPoint();
 
     transport::TransportLayerASIO::Options opts(config);
-    opts.transportMode = transport::Mode::kSynchronous;
-
-    ctx->setServiceExecutor(std::make_unique<ServiceExecutorSynchronous>(ctx));
+    opts.transportMode = gUseThreadPerCoreServiceExecutor ? transport::Mode::kAsynchronous
+                                                          : transport::Mode::kSynchronous;
+
+    auto tl = std::make_unique<transport::TransportLayerASIO>(opts, sep);
+    if (gUseThreadPerCoreServiceExecutor) {
+        // The executor runs the ingress reactor, on which its sessions wait for their messages.
+        ctx->setServiceExecutor(std::make_unique<ServiceExecutorThreadPerCore>(
+            tl->getReactor(TransportLayer::kIngress)));
+    } else {
+        ctx->setServiceExecutor(std::make_unique<ServiceExecutorSynchronous>(ctx));
+    }
 
     std::vector<std::unique_ptr<TransportLayer>> retVector;
-    retVector.emplace_back(std::make_unique<transport::TransportLayerASIO>(opts, sep));
+    retVector.emplace_back(std::move(tl));
     return std::make_unique<TransportLayerManager>(std::move(retVector));
 }
 
@@ -45,6 +45,7 @@
 
 #include "mongo/base/string_data.h"
 #include "mongo/logv2/log.h"
+#include "mongo/logv2/log_util.h"
 #include "mongo/platform/compiler.h"
 #include "mongo/stdx/exception.h"
 #include "mongo/stdx/thread.h"
@@ -200,11 +201,19 @@ void writeMallocFreeStreamToLog() {
     mallocFreeOStream.rewind();
 }
 
+// must hold MallocFreeOStreamGuard to call
+void printBacktraceAndFlushLogs() {
+    printStackTrace();
+    // The backtrace is logged at Info severity, which the asynchronous log writer only buffers.
+    // Write it out before the process ends.
+    logv2::flushLogs();
+}
+
 // must hold MallocFreeOStreamGuard to call
 void printSignalAndBacktrace(int signalNum) {
     mallocFreeOStream << "Got signal: " << signalNum << " (" << strsignal(signalNum) << ").\n";
     writeMallocFreeStreamToLog();
-    printStackTrace();
+    printBacktraceAndFlushLogs();
 }
 
 // this will be called in certain c++ error cases, for example if there are two active
@@ -252,7 +261,7 @@ void myTerminate() {
         mallocFreeOStream << "terminate() called. No exception is active";
     }
     writeMallocFreeStreamToLog();
-    printStackTrace();
+    printBacktraceAndFlushLogs();
     breakpoint();
     endProcessWithSignal(SIGABRT);
 }
@@ -373,7 +382,7 @@ void reportOutOfMemoryErrorAndExit() {
     MallocFreeOStreamGuard lk{};
     mallocFreeOStream << "out of memory.\n";
     writeMallocFreeStreamToLog();
-    printStackTrace();
+    printBacktraceAndFlushLogs();
     quickExit(EXIT_ABRUPT);
 }
 
@@ -0,0 +1,150 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+
+#include "mongo/base/status_with.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/interruptible.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * Merges identical concurrent calls into one. The first caller to run() for a given key (the
+ * leader) executes the work on its own thread; every caller which arrives with the same key while
+ * the leader is still running waits for and receives a copy of the leader's result instead of
+ * doing the work again.
+ *
+ * Callers are responsible for making the key capture everything that the result depends on, so
+ * that any result produced under a key is acceptable to every caller using that key.
+ *
+ * A failure seen by the leader may be specific to it (for example, its operation may have been
+ * killed), so callers which joined a failed call run the work themselves rather than propagating
+ * the leader's error. Likewise, each caller which joins waits only until its own deadline.
+ *
+ * This class is thread safe.
+ */
+template <typename Key,
+          typename Value,
+          typename Hash = typename stdx::unordered_map<Key, int>::hasher>
+class SingleFlight {
+    SingleFlight(const SingleFlight&) = delete;
+    SingleFlight& operator=(const SingleFlight&) = delete;
+
+public:
+    SingleFlight() = default;
+
+    /**
+     * Returns the result of 'work', which must be callable as StatusWith<Value>(), either by
+     * running it or by joining an identical in-flight call. Waiting for another caller's result is
+     * interruptible through 'interruptible' and gives up with MaxTimeMSExpired once 'deadline'
+     * passes, however long the in-flight call itself takes.
+     */
+    template <typename Work>
+    StatusWith<Value> run(Interruptible* interruptible,
+                          const Key& key,
+                          Date_t deadline,
+                          Work&& work) {
+        stdx::unique_lock lk(_mutex);
+        auto [it, isLeader] = _inFlight.emplace(key, nullptr);
+        if (isLeader) {
+            it->second = std::make_shared<InFlightCall>();
+        }
+        const auto inFlight = it->second;
+
+        if (!isLeader) {
+            _numJoined.fetchAndAdd(1);
+            if (!interruptible->waitForConditionOrInterruptUntil(
+                    inFlight->cv, lk, deadline, [&] { return inFlight->result.has_value(); })) {
+                return Status(ErrorCodes::MaxTimeMSExpired,
+                              "Deadline expired while waiting for an identical in-flight call");
+            }
+            if (inFlight->result->isOK()) {
+                return *inFlight->result;
+            }
+
+            // The leader's failure may be specific to it, so the waiter runs the work itself.
+            lk.unlock();
+            return _runWork(work);
+        }
+
+        lk.unlock();
+        auto swValue = _runWork(work);
+
+        lk.lock();
+        auto leaderIt = _inFlight.find(key);
+        invariant(leaderIt != _inFlight.end() && leaderIt->second == inFlight);
+        _inFlight.erase(leaderIt);
+        inFlight->result.emplace(swValue);
+        inFlight->cv.notify_all();
+        return swValue;
+    }
+
+    /**
+     * Returns the number of calls which were served by joining an in-flight call.
+     */
+    long long getNumJoined() const {
+        return _numJoined.load();
+    }
+
+private:
+    template <typename Work>
+    static StatusWith<Value> _runWork(Work& work) noexcept {
+        try {
+            return work();
+        } catch (...) {
+            return exceptionToStatus();
+        }
+    }
+
+    /**
+     * The state of a call shared by its leader and the callers which joined it.
+     */
+    struct InFlightCall {
+        stdx::condition_variable cv;
+        // Set by the leader once the work has finished
+        boost::optional<StatusWith<Value>> result;
+    };
+
+    // Protects _inFlight and the result of every InFlightCall
+    Mutex _mutex = MONGO_MAKE_LATCH("SingleFlight::_mutex");
+    stdx::unordered_map<Key, std::shared_ptr<InFlightCall>, Hash> _inFlight;
+
+    AtomicWord<long long> _numJoined{0};
+};
+
+}  // namespace mongo
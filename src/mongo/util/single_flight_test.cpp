@@ -0,0 +1,174 @@
+/**
+ *    Copyright (C) 2020-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/notification.h"
+#include "mongo/util/single_flight.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+using unittest::assertGet;
+
+using IntSingleFlight = SingleFlight<std::string, int>;
+
+void waitForJoiners(const IntSingleFlight& singleFlight, long long numJoined) {
+    while (singleFlight.getNumJoined() < numJoined) {
+        sleepmillis(1);
+    }
+}
+
+template <typename Work>
+StatusWith<int> runWithoutDeadline(IntSingleFlight& singleFlight,
+                                   const std::string& key,
+                                   Work&& work) {
+    return singleFlight.run(
+        Interruptible::notInterruptible(), key, Date_t::max(), std::forward<Work>(work));
+}
+
+TEST(SingleFlightTest, SequentialCallsEachRunTheWork) {
+    IntSingleFlight singleFlight;
+    int numCalls = 0;
+
+    auto work = [&]() -> StatusWith<int> { return ++numCalls; };
+    ASSERT_EQ(1, assertGet(runWithoutDeadline(singleFlight, "key", work)));
+    ASSERT_EQ(2, assertGet(runWithoutDeadline(singleFlight, "key", work)));
+    ASSERT_EQ(0, singleFlight.getNumJoined());
+}
+
+TEST(SingleFlightTest, ConcurrentIdenticalCallsShareOneResult) {
+    IntSingleFlight singleFlight;
+    Notification<void> leaderRunning;
+    Notification<void> unblockLeader;
+    int numCalls = 0;
+
+    StatusWith<int> leaderResult(ErrorCodes::InternalError, "not run");
+    stdx::thread leader([&] {
+        leaderResult = runWithoutDeadline(singleFlight, "key", [&]() -> StatusWith<int> {
+            leaderRunning.set();
+            unblockLeader.get();
+            return ++numCalls;
+        });
+    });
+
+    // The leader is now in flight, so this call must join it rather than run its own work
+    leaderRunning.get();
+    StatusWith<int> followerResult(ErrorCodes::InternalError, "not run");
+    stdx::thread follower([&] {
+        followerResult =
+            runWithoutDeadline(singleFlight, "key", []() -> StatusWith<int> { return -1; });
+    });
+
+    waitForJoiners(singleFlight, 1);
+    unblockLeader.set();
+    leader.join();
+    follower.join();
+
+    ASSERT_EQ(1, numCalls);
+    ASSERT_EQ(1, assertGet(leaderResult));
+    ASSERT_EQ(1, assertGet(followerResult));
+}
+
+TEST(SingleFlightTest, DifferentKeysDoNotShareResults) {
+    IntSingleFlight singleFlight;
+    ASSERT_EQ(1, assertGet(runWithoutDeadline(singleFlight, "a", [] {
+                  return StatusWith<int>(1);
+              })));
+    ASSERT_EQ(2, assertGet(runWithoutDeadline(singleFlight, "b", [] {
+                  return StatusWith<int>(2);
+              })));
+}
+
+TEST(SingleFlightTest, JoinerRetriesAfterLeaderFailure) {
+    IntSingleFlight singleFlight;
+    Notification<void> leaderRunning;
+    Notification<void> unblockLeader;
+
+    StatusWith<int> leaderResult(ErrorCodes::InternalError, "not run");
+    stdx::thread leader([&] {
+        leaderResult = runWithoutDeadline(singleFlight, "key", [&]() -> StatusWith<int> {
+            leaderRunning.set();
+            unblockLeader.get();
+            return Status(ErrorCodes::Interrupted, "leader was killed");
+        });
+    });
+
+    leaderRunning.get();
+    StatusWith<int> followerResult(ErrorCodes::InternalError, "not run");
+    stdx::thread follower([&] {
+        followerResult =
+            runWithoutDeadline(singleFlight, "key", []() -> StatusWith<int> { return 7; });
+    });
+
+    waitForJoiners(singleFlight, 1);
+    unblockLeader.set();
+    leader.join();
+    follower.join();
+
+    ASSERT_EQ(ErrorCodes::Interrupted, leaderResult.getStatus());
+    ASSERT_EQ(7, assertGet(followerResult));
+}
+
+TEST(SingleFlightTest, JoinerStopsWaitingAtItsOwnDeadline) {
+    IntSingleFlight singleFlight;
+    Notification<void> leaderRunning;
+    Notification<void> unblockLeader;
+
+    StatusWith<int> leaderResult(ErrorCodes::InternalError, "not run");
+    stdx::thread leader([&] {
+        leaderResult = runWithoutDeadline(singleFlight, "key", [&]() -> StatusWith<int> {
+            leaderRunning.set();
+            unblockLeader.get();
+            return 1;
+        });
+    });
+
+    // The follower gives up while the leader is still blocked, without running its own work
+    leaderRunning.get();
+    auto followerResult = singleFlight.run(Interruptible::notInterruptible(),
+                                           "key",
+                                           Date_t::now() + Milliseconds(10),
+                                           []() -> StatusWith<int> { return -1; });
+    ASSERT_EQ(ErrorCodes::MaxTimeMSExpired, followerResult.getStatus());
+    ASSERT_EQ(1, singleFlight.getNumJoined());
+
+    unblockLeader.set();
+    leader.join();
+    ASSERT_EQ(1, assertGet(leaderResult));
+}
+
+}  // namespace
+}  // namespace mongo